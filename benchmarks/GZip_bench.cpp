@@ -0,0 +1,66 @@
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <GZip.h>
+
+class GZipBench : public QObject {
+    Q_OBJECT
+
+    /* Compresses about as well as the version and asset index JSON files do. */
+    static QByteArray jsonLike(qsizetype size)
+    {
+        QRandomGenerator random(42);
+        QByteArray data;
+        data.reserve(size);
+        while (data.size() < size) {
+            data += QString(R"({"name":"org.example:library%1:%2","url":"https://libraries.example.com/","sha1":"%3"},)")
+                        .arg(random.bounded(500))
+                        .arg(random.bounded(20))
+                        .arg(random.generate64(), 16, 16, QChar('0'))
+                        .toUtf8();
+        }
+        data.truncate(size);
+        return data;
+    }
+
+    static void addSizeColumn()
+    {
+        QTest::addColumn<int>("size");
+        QTest::newRow("64 KiB") << 64 * 1024;
+        QTest::newRow("4 MiB") << 4 * 1024 * 1024;
+        QTest::newRow("32 MiB") << 32 * 1024 * 1024;
+    }
+
+   private slots:
+    void unzip_data() { addSizeColumn(); }
+    void unzip()
+    {
+        QFETCH(int, size);
+        QByteArray compressed;
+        QVERIFY(GZip::zip(jsonLike(size), compressed));
+
+        QBENCHMARK
+        {
+            QByteArray uncompressed;
+            QVERIFY(GZip::unzip(compressed, uncompressed));
+            QCOMPARE(uncompressed.size(), size);
+        }
+    }
+
+    void zip_data() { addSizeColumn(); }
+    void zip()
+    {
+        QFETCH(int, size);
+        auto data = jsonLike(size);
+
+        QBENCHMARK
+        {
+            QByteArray compressed;
+            QVERIFY(GZip::zip(data, compressed));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(GZipBench)
+
+#include "GZip_bench.moc"
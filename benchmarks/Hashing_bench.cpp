@@ -0,0 +1,78 @@
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <modplatform/helpers/HashUtils.h>
+
+Q_DECLARE_METATYPE(Hashing::Algorithm)
+
+class HashingBench : public QObject {
+    Q_OBJECT
+
+    static QByteArray randomData(qsizetype size)
+    {
+        QByteArray data(size, Qt::Uninitialized);
+        QRandomGenerator random(42);
+        random.fillRange(reinterpret_cast<quint32*>(data.data()), size / sizeof(quint32));
+        return data;
+    }
+
+    QTemporaryDir m_dir;
+    QString m_file;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_file = FS::PathCombine(m_dir.path(), "mod.jar");
+        FS::write(m_file, randomData(16 * 1024 * 1024));
+    }
+
+    void hashData_data()
+    {
+        QTest::addColumn<Hashing::Algorithm>("algorithm");
+        QTest::addColumn<int>("size");
+        for (auto algorithm : { Hashing::Algorithm::Md4, Hashing::Algorithm::Md5, Hashing::Algorithm::Sha1, Hashing::Algorithm::Sha256,
+                                Hashing::Algorithm::Sha512, Hashing::Algorithm::Murmur2 }) {
+            auto name = Hashing::algorithmToString(algorithm);
+            QTest::addRow("%s, 64 KiB", qPrintable(name)) << algorithm << 64 * 1024;
+            QTest::addRow("%s, 4 MiB", qPrintable(name)) << algorithm << 4 * 1024 * 1024;
+        }
+    }
+    void hashData()
+    {
+        QFETCH(Hashing::Algorithm, algorithm);
+        QFETCH(int, size);
+        auto data = randomData(size);
+
+        QBENCHMARK
+        {
+            QVERIFY(!Hashing::hash(data, algorithm).isEmpty());
+        }
+    }
+
+    void hashFile_data()
+    {
+        QTest::addColumn<Hashing::Algorithm>("algorithm");
+        for (auto algorithm : { Hashing::Algorithm::Md4, Hashing::Algorithm::Md5, Hashing::Algorithm::Sha1, Hashing::Algorithm::Sha256,
+                                Hashing::Algorithm::Sha512, Hashing::Algorithm::Murmur2 })
+            QTest::newRow(qPrintable(Hashing::algorithmToString(algorithm))) << algorithm;
+    }
+    void hashFile()
+    {
+        QFETCH(Hashing::Algorithm, algorithm);
+
+        // through the device, hashing by file name would only measure the cache after the first run
+        QBENCHMARK
+        {
+            QFile file(m_file);
+            QVERIFY(!Hashing::hash(&file, algorithm).isEmpty());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(HashingBench)
+
+#include "Hashing_bench.moc"
@@ -0,0 +1,86 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheBench : public QObject {
+    Q_OBJECT
+
+    /* An index shaped like the one a launcher that has been in use for a while ends up with. */
+    static QByteArray index(int entries)
+    {
+        QJsonArray array;
+        for (int i = 0; i < entries; i++) {
+            QJsonObject entry;
+            entry["base"] = i % 4 == 0 ? "meta" : "libraries";
+            entry["path"] = QString("net/example/artifact%1/%2/artifact%1-%2.jar").arg(i / 8).arg(i % 8);
+            entry["md5sum"] = QString("%1").arg(i, 32, 16, QChar('0'));
+            entry["etag"] = QString("\"%1\"").arg(i, 32, 16, QChar('0'));
+            entry["last_changed_timestamp"] = 1700000000000.0 + i;
+            entry["remote_changed_timestamp"] = "Tue, 14 Nov 2023 22:13:20 GMT";
+            entry["current_age"] = 0.0;
+            entry["max_age"] = 86400.0;
+            array.append(entry);
+        }
+        QJsonObject root;
+        root["version"] = "1";
+        root["entries"] = array;
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    }
+
+    static void addBases(HttpMetaCache& cache, const QString& root)
+    {
+        cache.addBase("meta", FS::PathCombine(root, "meta"));
+        cache.addBase("libraries", FS::PathCombine(root, "libraries"));
+    }
+
+    static void addEntriesColumn()
+    {
+        QTest::addColumn<int>("entries");
+        QTest::newRow("1000") << 1000;
+        QTest::newRow("10000") << 10000;
+        QTest::newRow("50000") << 50000;
+    }
+
+   private slots:
+    void load_data() { addEntriesColumn(); }
+    void load()
+    {
+        QFETCH(int, entries);
+        QTemporaryDir dir;
+        auto index_file = FS::PathCombine(dir.path(), "metacache");
+        FS::write(index_file, index(entries));
+
+        HttpMetaCache cache(index_file);
+        addBases(cache, dir.path());
+        QBENCHMARK
+        {
+            cache.Load();
+        }
+    }
+
+    void save_data() { addEntriesColumn(); }
+    void save()
+    {
+        QFETCH(int, entries);
+        QTemporaryDir dir;
+        auto index_file = FS::PathCombine(dir.path(), "metacache");
+        FS::write(index_file, index(entries));
+
+        HttpMetaCache cache(index_file);
+        addBases(cache, dir.path());
+        cache.Load();
+        QBENCHMARK
+        {
+            cache.SaveNow();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheBench)
+
+#include "HttpMetaCache_bench.moc"
@@ -0,0 +1,67 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <InstanceList.h>
+#include <settings/INISettingsObject.h>
+
+class InstanceListBench : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    SettingsObjectPtr m_settings;
+
+    /* A folder of plain vanilla instances, as the launcher writes them. */
+    QString instanceTree(int count)
+    {
+        auto root = FS::PathCombine(m_dir.path(), QString("instances-%1").arg(count));
+        for (int i = 0; i < count; i++) {
+            auto instance = FS::PathCombine(root, QString("instance%1").arg(i));
+            FS::ensureFolderPathExists(instance);
+            FS::write(FS::PathCombine(instance, "instance.cfg"),
+                      QString("[General]\nInstanceType=OneSix\nname=Instance %1\niconKey=default\ntotalTimePlayed=%2\n")
+                          .arg(i)
+                          .arg(i * 60)
+                          .toUtf8());
+            FS::write(FS::PathCombine(instance, "mmc-pack.json"),
+                      R"({"components": [{"cachedName": "Minecraft", "important": true, "uid": "net.minecraft", "version": "1.20.1"}], )"
+                      R"("formatVersion": 1})");
+        }
+        return root;
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_settings = std::make_shared<INISettingsObject>(FS::PathCombine(m_dir.path(), "launcher.cfg"));
+        // what every instance refers to in the global settings
+        for (auto name : { "ShowGameTime", "RecordGameTime", "PreLaunchCommand", "WrapperCommand", "PostExitCommand", "ShowConsole",
+                           "AutoCloseConsole", "ShowConsoleOnError", "LogPrePostOutput", "ConsoleMaxLines", "ConsoleOverflowStop" })
+            m_settings->registerSetting(QString(name), QVariant());
+    }
+
+    void loadList_data()
+    {
+        QTest::addColumn<QString>("root");
+        QTest::addColumn<int>("count");
+        for (auto count : { 10, 100, 1000 })
+            QTest::addRow("%d instances", count) << instanceTree(count) << count;
+    }
+    void loadList()
+    {
+        QFETCH(QString, root);
+        QFETCH(int, count);
+
+        QBENCHMARK
+        {
+            InstanceList list(m_settings, root);
+            QCOMPARE(list.loadList(), InstanceList::NoError);
+            QCOMPARE(list.count(), count);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceListBench)
+
+#include "InstanceList_bench.moc"
@@ -0,0 +1,106 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <quazip/quazipnewinfo.h>
+
+#include <FileSystem.h>
+#include <minecraft/mod/tasks/LocalModParseTask.h>
+
+class LocalModParseBench : public QObject {
+    Q_OBJECT
+
+    static constexpr auto s_fabricModJson = R"({
+    "schemaVersion": 1,
+    "id": "benchmod",
+    "version": "1.0.0",
+    "name": "Benchmark Mod",
+    "description": "A mod that only exists to be parsed.",
+    "authors": [ "Someone", "Someone Else" ],
+    "contact": { "homepage": "https://example.com", "issues": "https://example.com/issues" },
+    "icon": "assets/benchmod/icon.png",
+    "depends": { "fabricloader": ">=0.15.0", "minecraft": "~1.20.4" }
+})";
+
+    static constexpr auto s_modsToml = R"(modLoader="javafml"
+loaderVersion="[47,)"
+license="MIT"
+issueTrackerURL="https://example.com/issues"
+
+[[mods]]
+modId="benchmod"
+version="1.0.0"
+displayName="Benchmark Mod"
+authors="Someone, Someone Else"
+description='''
+A mod that only exists to be parsed.
+'''
+
+[[dependencies.benchmod]]
+modId="minecraft"
+mandatory=true
+versionRange="[1.20.1,1.21)"
+ordering="NONE"
+side="BOTH"
+)";
+
+    /* A JAR with the metadata file after a number of class files, like a real mod. */
+    static bool writeJar(const QString& path, const QString& metadata_name, const QByteArray& metadata, int classes)
+    {
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdCreate))
+            return false;
+        auto add = [&zip](const QString& name, const QByteArray& data) {
+            QuaZipFile file(&zip);
+            if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(name)))
+                return false;
+            file.write(data);
+            file.close();
+            return file.getZipError() == ZIP_OK;
+        };
+        if (!add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\nImplementation-Version: 1.0.0\r\n"))
+            return false;
+        for (int i = 0; i < classes; i++) {
+            QByteArray bytecode(2048 + (i * 37) % 4096, static_cast<char>(i));
+            if (!add(QString("com/example/benchmod/package%1/Class%2.class").arg(i % 16).arg(i), bytecode))
+                return false;
+        }
+        if (!add(metadata_name, metadata))
+            return false;
+        zip.close();
+        return zip.getZipError() == ZIP_OK;
+    }
+
+    QTemporaryDir m_dir;
+
+   private slots:
+    void parse_data()
+    {
+        QTest::addColumn<QString>("jar");
+        for (auto classes : { 10, 1000, 10000 }) {
+            auto fabric = FS::PathCombine(m_dir.path(), QString("fabric-%1.jar").arg(classes));
+            QVERIFY(writeJar(fabric, "fabric.mod.json", s_fabricModJson, classes));
+            QTest::addRow("fabric, %d classes", classes) << fabric;
+
+            auto forge = FS::PathCombine(m_dir.path(), QString("forge-%1.jar").arg(classes));
+            QVERIFY(writeJar(forge, "META-INF/mods.toml", s_modsToml, classes));
+            QTest::addRow("forge, %d classes", classes) << forge;
+        }
+    }
+    void parse()
+    {
+        QFETCH(QString, jar);
+
+        QBENCHMARK
+        {
+            LocalModParseTask task(0, ResourceType::ZIPFILE, QFileInfo(jar));
+            task.start();
+            QCOMPARE(task.result()->details.mod_id, "benchmod");
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LocalModParseBench)
+
+#include "LocalModParse_bench.moc"
@@ -0,0 +1,69 @@
+#include <QRegularExpression>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <MessageLevel.h>
+#include <logs/LogParser.h>
+
+class LogParserBench : public QObject {
+    Q_OBJECT
+
+    static QStringList lines(const QString& file, int copies)
+    {
+        auto log = QString::fromUtf8(FS::read(FS::PathCombine(QFINDTESTDATA("../tests/testdata/TestLogs"), file)));
+        auto lines = log.split(QRegularExpression("\n|\r\n|\r"));
+        QStringList out;
+        for (int i = 0; i < copies; i++)
+            out.append(lines);
+        return out;
+    }
+
+   private slots:
+    void parse_data()
+    {
+        QTest::addColumn<QStringList>("lines");
+        QTest::newRow("forge-plain, 10 copies") << lines("TerraFirmaGreg-Modern-forge.text.log", 10);
+        QTest::newRow("forge-xml, 10 copies") << lines("TerraFirmaGreg-Modern-forge.xml.log", 10);
+    }
+
+    /* Feeds the log a line at a time, like the game output arrives. */
+    void parse()
+    {
+        QFETCH(QStringList, lines);
+
+        qsizetype entries = 0;
+        QBENCHMARK
+        {
+            LogParser parser;
+            auto last = MessageLevel::Unknown;
+            for (auto& line : lines) {
+                parser.appendLine(line);
+                for (auto& item : parser.parseAvailable()) {
+                    if (auto entry = std::get_if<LogParser::LogEntry>(&item)) {
+                        last = entry->level;
+                    } else if (auto text = std::get_if<LogParser::PlainText>(&item)) {
+                        last = LogParser::guessLevel(text->message, last);
+                    }
+                    entries++;
+                }
+            }
+        }
+        QVERIFY(entries > 0);
+    }
+
+    void guessLevel()
+    {
+        auto plain = lines("TerraFirmaGreg-Modern-forge.text.log", 10);
+
+        QBENCHMARK
+        {
+            auto last = MessageLevel::Unknown;
+            for (auto& line : plain)
+                last = LogParser::guessLevel(line, last);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LogParserBench)
+
+#include "LogParser_bench.moc"
@@ -0,0 +1,70 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <quazip/quazipnewinfo.h>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+
+class MMCZipBench : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_archive;
+    int m_run = 0;
+
+   private slots:
+    /* Something shaped like a modpack: a few big JARs that are stored, and a lot of small configs that are deflated. */
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_archive = FS::PathCombine(m_dir.path(), "pack.zip");
+
+        QuaZip zip(m_archive);
+        QVERIFY(zip.open(QuaZip::mdCreate));
+        auto add = [&zip](const QString& name, const QByteArray& data, bool stored) {
+            QuaZipFile file(&zip);
+            QVERIFY(file.open(QIODevice::WriteOnly, QuaZipNewInfo(name), nullptr, 0, stored ? 0 : Z_DEFLATED));
+            file.write(data);
+            file.close();
+        };
+        for (int i = 0; i < 50; i++)
+            add(QString("overrides/mods/mod%1.jar").arg(i), QByteArray(512 * 1024 + i * 1024, static_cast<char>(i)), true);
+        for (int i = 0; i < 2000; i++)
+            add(QString("overrides/config/mod%1/config%2.toml").arg(i % 50).arg(i),
+                QString("[general]\nenabled = true\nvalue = %1\n").arg(i).repeated(20).toUtf8(), false);
+        zip.close();
+        QCOMPARE(zip.getZipError(), ZIP_OK);
+    }
+
+    void extract_data()
+    {
+        QTest::addColumn<int>("workers");
+        QTest::newRow("1 worker") << 1;
+        QTest::newRow("2 workers") << 2;
+        QTest::newRow("4 workers") << 4;
+        QTest::newRow("8 workers") << 8;
+    }
+    void extract()
+    {
+        QFETCH(int, workers);
+
+        QBENCHMARK
+        {
+            QuaZip zip(m_archive);
+            QVERIFY(zip.open(QuaZip::mdUnzip));
+            auto target = FS::PathCombine(m_dir.path(), QString("out%1").arg(m_run++));
+
+            MMCZip::ParallelExtractor extractor(&zip, "overrides/", target);
+            extractor.workers(workers);
+            QVERIFY(!extractor().has_value());
+            QCOMPARE(extractor.extracted().size(), 2050);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MMCZipBench)
+
+#include "MMCZip_bench.moc"
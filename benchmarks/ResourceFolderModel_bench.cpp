@@ -0,0 +1,69 @@
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <functional>
+
+#include <FileSystem.h>
+#include <minecraft/mod/ResourceFolderModel.h>
+
+class ResourceFolderModelBench : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    QString resourceFolder(int count)
+    {
+        auto root = FS::PathCombine(m_dir.path(), QString("resources-%1").arg(count));
+        FS::ensureFolderPathExists(root);
+        for (int i = 0; i < count; i++)
+            FS::write(FS::PathCombine(root, QString("resource%1.jar").arg(i)), "PK");
+        return root;
+    }
+
+    /* Marks one resource as changed, then runs the update and waits for it. */
+    static void changeAndWait(ResourceFolderModel& model, const std::function<bool()>& update, int round)
+    {
+        QFile file(model.dir().filePath("resource0.jar"));
+        if (file.open(QIODevice::ReadWrite))
+            file.setFileTime(QDateTime::currentDateTime().addSecs(round), QFileDevice::FileModificationTime);
+
+        QEventLoop loop;
+        connect(&model, &ResourceFolderModel::updateFinished, &loop, &QEventLoop::quit);
+        if (update())
+            loop.exec();
+    }
+
+   private slots:
+    void singleFileChange_data()
+    {
+        QTest::addColumn<QString>("root");
+        QTest::addColumn<bool>("incremental");
+        auto root = resourceFolder(1000);
+        QTest::addRow("full reload") << root << false;
+        QTest::addRow("incremental") << root << true;
+    }
+    void singleFileChange()
+    {
+        QFETCH(QString, root);
+        QFETCH(bool, incremental);
+
+        ResourceFolderModel model(QDir(root), nullptr, false, false);
+        changeAndWait(model, [&model] { return model.update(); }, 0);
+        QCOMPARE(model.size(), 1000);
+
+        int round = 1;
+        QBENCHMARK
+        {
+            if (incremental)
+                changeAndWait(model, [&model] { return model.update({ "resource0.jar" }); }, round++);
+            else
+                changeAndWait(model, [&model] { return model.update(); }, round++);
+        }
+        QCOMPARE(model.size(), 1000);
+    }
+};
+
+QTEST_GUILESS_MAIN(ResourceFolderModelBench)
+
+#include "ResourceFolderModel_bench.moc"
@@ -0,0 +1,98 @@
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <Version.h>
+
+#include <algorithm>
+
+class VersionBench : public QObject {
+    Q_OBJECT
+
+    // a mix of what the version lists actually contain: releases, pre-releases and snapshots
+    static QStringList versionStrings(int count)
+    {
+        QRandomGenerator random(42);
+        QStringList strings;
+        for (int i = 0; i < count; i++) {
+            auto minor = random.bounded(21);
+            auto patch = random.bounded(6);
+            switch (random.bounded(4)) {
+                case 0:
+                    strings.append(QString("1.%1-pre%2").arg(minor).arg(patch + 1));
+                    break;
+                case 1:
+                    strings.append(QString("1.%1.%2-rc%3").arg(minor).arg(patch).arg(random.bounded(1, 4)));
+                    break;
+                case 2:
+                    strings.append(QString("%1w%2a").arg(random.bounded(13, 25)).arg(random.bounded(1, 53), 2, 10, QChar('0')));
+                    break;
+                default:
+                    strings.append(QString("1.%1.%2").arg(minor).arg(patch));
+                    break;
+            }
+        }
+        return strings;
+    }
+
+    static QList<Version> versions(int count)
+    {
+        QList<Version> versions;
+        for (auto& string : versionStrings(count))
+            versions.append(Version(string));
+        return versions;
+    }
+
+    static void addCountColumn()
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("100") << 100;
+        QTest::newRow("1000") << 1000;
+        QTest::newRow("10000") << 10000;
+    }
+
+   private slots:
+    void parse_data() { addCountColumn(); }
+    void parse()
+    {
+        QFETCH(int, count);
+        auto strings = versionStrings(count);
+
+        QBENCHMARK
+        {
+            for (auto& string : strings)
+                Version version(string);
+        }
+    }
+
+    void compare_data() { addCountColumn(); }
+    void compare()
+    {
+        QFETCH(int, count);
+        auto list = versions(count);
+
+        int less = 0;
+        QBENCHMARK
+        {
+            for (int i = 1; i < list.size(); i++)
+                less += list.at(i - 1) < list.at(i);
+        }
+        QVERIFY(less >= 0);
+    }
+
+    void sort_data() { addCountColumn(); }
+    void sort()
+    {
+        QFETCH(int, count);
+        auto list = versions(count);
+
+        QBENCHMARK
+        {
+            auto sorted = list;
+            std::sort(sorted.begin(), sorted.end());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionBench)
+
+#include "Version_bench.moc"
@@ -46,9 +46,9 @@
 #include "DataMigrationTask.h"
 #include "java/JavaInstallList.h"
 #include "net/PasteUpload.h"
-#include "pathmatcher/MultiMatcher.h"
-#include "pathmatcher/SimplePrefixMatcher.h"
+#include "pathmatcher/CompiledMatcher.h"
 #include "tasks/Task.h"
+#include "tasks/TaskTrace.h"
 #include "tools/GenericProfiler.h"
 #include "ui/InstanceWindow.h"
 #include "ui/MainWindow.h"
@@ -104,11 +104,11 @@
 #include <QWindow>
 
 #include "InstanceList.h"
-#include "MTPixmapCache.h"
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "modplatform/helpers/ApiResponseCache.h"
 
 #include "java/JavaInstallList.h"
 
@@ -172,8 +172,6 @@
 
 static const QLatin1String liveCheckFile("live.check");
 
-PixmapCache* PixmapCache::s_instance = nullptr;
-
 static bool isANSIColorConsole;
 
 static QString defaultLogFormat = QStringLiteral(
@@ -669,6 +667,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_settings->registerSetting("NumberOfConcurrentDownloads", 6);
         m_settings->registerSetting("NumberOfManualRetries", 1);
         m_settings->registerSetting("RequestTimeout", 60);
+        // skip hashing cached files whose modification time changed, and download them again instead
+        m_settings->registerSetting("MetaCacheTrustFileStat", false);
 
         QString defaultMonospace;
         int defaultSize = 11;
@@ -903,6 +903,17 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         // Custom Technic Client ID
         m_settings->registerSetting("TechnicClientID", "");
 
+        // Task tracing, for finding out where the time goes
+        auto taskTracing = m_settings->registerSetting("TaskTracing", false);
+        TaskTrace::setEnabled(TaskTrace::enabledByEnvironment() || taskTracing->get().toBool());
+        connect(taskTracing.get(), &Setting::SettingChanged, this, [this](const Setting&, QVariant value) {
+            if (TaskTrace::enabledByEnvironment())
+                return;
+            TaskTrace::setEnabled(value.toBool());
+            if (!value.toBool())
+                TaskTrace::dump(FS::PathCombine(m_dataPath, "logs"));
+        });
+
         // Init page provider
         {
             m_globalSettingsProvider = std::make_shared<GenericPageProvider>(tr("Settings"));
@@ -917,8 +928,6 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
             m_globalSettingsProvider->addPage<ProxyPage>();
         }
 
-        PixmapCache::setInstance(new PixmapCache(this));
-
         qInfo() << "<> Settings loaded.";
     }
 
@@ -952,7 +961,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         auto setting = APPLICATION->settings()->getSetting("IconsDir");
         QStringList instFolders = { ":/icons/multimc/32x32/instances/", ":/icons/multimc/50x50/instances/",
                                     ":/icons/multimc/128x128/instances/", ":/icons/multimc/scalable/instances/" };
-        m_icons.reset(new IconList(instFolders, setting->get().toString()));
+        m_icons.reset(new IconList(instFolders, setting->get().toString(), QDir("cache/icons").absolutePath()));
         connect(setting.get(), &Setting::SettingChanged,
                 [this](const Setting&, QVariant value) { m_icons->directoryChanged(value.toString()); });
         qInfo() << "<> Instance icons initialized.";
@@ -1005,7 +1014,12 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_metacache->addBase("translations", QDir("translations").absolutePath());
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->addBase("java", QDir("cache/java").absolutePath());
+        m_metacache->addBase("ModPlatformAPI", QDir("cache/ModPlatformAPI").absolutePath());
+        m_metacache->setTrustFileStat(m_settings->get("MetaCacheTrustFileStat").toBool());
         m_metacache->Load();
+        m_metacache->prune("ModPlatformAPI", ApiResponseCache::KeepExpiredFor);
+
+        m_apiResponseCache.reset(new ApiResponseCache());
         qInfo() << "<> Cache initialized.";
     }
 
@@ -1034,6 +1048,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
+        TaskTrace::dump(FS::PathCombine(m_dataPath, "logs"));
         if (logFile) {
             logFile->flush();
             logFile->close();
@@ -1833,6 +1848,11 @@ shared_qobject_ptr<HttpMetaCache> Application::metacache()
     return m_metacache;
 }
 
+shared_qobject_ptr<ApiResponseCache> Application::apiResponseCache()
+{
+    return m_apiResponseCache;
+}
+
 shared_qobject_ptr<QNetworkAccessManager> Application::network()
 {
     return m_network;
@@ -1985,19 +2005,18 @@ bool Application::handleDataMigration(const QString& currentData,
 
     if (!currentExists) {
         // Migrate!
-        auto matcher = std::make_shared<MultiMatcher>();
-        matcher->add(std::make_shared<SimplePrefixMatcher>(configFile));
-        matcher->add(std::make_shared<SimplePrefixMatcher>(
-            BuildConfig.LAUNCHER_CONFIGFILE));  // it's possible that we already used that directory before
-        matcher->add(std::make_shared<SimplePrefixMatcher>("logs/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("accounts.json"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("accounts/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("assets/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("icons/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("instances/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("libraries/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("mods/"));
-        matcher->add(std::make_shared<SimplePrefixMatcher>("themes/"));
+        auto matcher = std::make_shared<CompiledMatcher>();
+        matcher->addPrefix(configFile);
+        matcher->addPrefix(BuildConfig.LAUNCHER_CONFIGFILE);  // it's possible that we already used that directory before
+        matcher->addPrefix("logs/");
+        matcher->addPrefix("accounts.json");
+        matcher->addPrefix("accounts/");
+        matcher->addPrefix("assets/");
+        matcher->addPrefix("icons/");
+        matcher->addPrefix("instances/");
+        matcher->addPrefix("libraries/");
+        matcher->addPrefix("mods/");
+        matcher->addPrefix("themes/");
 
         ProgressDialog diag;
         DataMigrationTask task(oldData, currentData, matcher);
@@ -60,6 +60,7 @@ class SetupWizard;
 class GenericPageProvider;
 class QFile;
 class HttpMetaCache;
+class ApiResponseCache;
 class SettingsObject;
 class InstanceList;
 class AccountList;
@@ -146,6 +147,8 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    shared_qobject_ptr<ApiResponseCache> apiResponseCache();
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     void updateCapabilities();
@@ -247,6 +250,7 @@ class Application : public QApplication {
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
+    shared_qobject_ptr<ApiResponseCache> m_apiResponseCache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
 
     std::shared_ptr<SettingsObject> m_settings;
@@ -10,62 +10,32 @@
 #include <QFileInfo>
 #include <QMap>
 
-#include <QtConcurrent>
-
 DataMigrationTask::DataMigrationTask(const QString& sourcePath, const QString& targetPath, const IPathMatcher::Ptr pathMatcher)
     : Task(), m_sourcePath(sourcePath), m_targetPath(targetPath), m_pathMatcher(pathMatcher), m_copy(sourcePath, targetPath)
 {
-    m_copy.matcher(m_pathMatcher).whitelist(true);
+    m_copy.matcher(m_pathMatcher).whitelist(true).cancelled(m_cancel.flag());
 }
 
 void DataMigrationTask::executeTask()
 {
     setStatus(tr("Scanning files..."));
 
-    // 1. Scan
-    // Check how many files we gotta copy
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this] {
-        return m_copy(true);  // dry run to collect amount of files
-    });
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-    m_copyFutureWatcher.setFuture(m_copyFuture);
-}
-
-void DataMigrationTask::dryRunFinished()
-{
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-
-    if (!m_copyFuture.isValid() || !m_copyFuture.result()) {
-        emitFailed(tr("Failed to scan source path."));
-        return;
-    }
-
-    // 2. Copy
-    // Actually copy all files now.
-    m_toCopy = m_copy.totalCopied();
-    connect(&m_copy, &FS::copy::fileCopied, [&, this](const QString& relativeName) {
+    // the copy walks the source once and tells us how much there is before it starts copying
+    connect(&m_copy, &FS::copy::scanned, [this](qsizetype, qint64 bytes) { setProgress(0, bytes); });
+    connect(&m_copy, &FS::copy::progress, [this](qint64 copied, qint64 total) { setProgress(copied, total); });
+    connect(&m_copy, &FS::copy::fileCopied, [this](const QString& relativeName) {
         QString shortenedName = relativeName;
         // shorten the filename to hopefully fit into one line
         if (shortenedName.length() > 50)
             shortenedName = relativeName.left(20) + "…" + relativeName.right(29);
-        setProgress(m_copy.totalCopied(), m_toCopy);
         setStatus(tr("Copying %1…").arg(shortenedName));
     });
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this] {
-        return m_copy(false);  // actually copy now
-    });
+    m_copyFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [this] { return m_copy(); });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::copyAborted);
     m_copyFutureWatcher.setFuture(m_copyFuture);
 }
 
-void DataMigrationTask::dryRunAborted()
-{
-    emitFailed(tr("Aborted"));
-}
-
 void DataMigrationTask::copyFinished()
 {
     disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
@@ -81,5 +51,16 @@ void DataMigrationTask::copyFinished()
 
 void DataMigrationTask::copyAborted()
 {
+    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
     emitFailed(tr("Aborted"));
 }
+
+bool DataMigrationTask::abort()
+{
+    if (m_copyFuture.isRunning()) {
+        // the copy stops at the next file, and the watcher reports the cancellation
+        m_cancel.cancel();
+        return true;
+    }
+    return false;
+}
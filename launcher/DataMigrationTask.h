@@ -6,6 +6,7 @@
 
 #include "FileSystem.h"
 #include "pathmatcher/IPathMatcher.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 #include <QFuture>
@@ -21,12 +22,13 @@ class DataMigrationTask : public Task {
     explicit DataMigrationTask(const QString& sourcePath, const QString& targetPath, IPathMatcher::Ptr pathmatcher);
     ~DataMigrationTask() override = default;
 
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
    protected:
     virtual void executeTask() override;
 
    protected slots:
-    void dryRunFinished();
-    void dryRunAborted();
     void copyFinished();
     void copyAborted();
 
@@ -36,7 +38,7 @@ class DataMigrationTask : public Task {
     const IPathMatcher::Ptr m_pathMatcher;
 
     FS::copy m_copy;
-    int m_toCopy = 0;
+    Executor::CancelToken m_cancel;
     QFuture<bool> m_copyFuture;
     QFutureWatcher<bool> m_copyFutureWatcher;
 };
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FileEvent.h"
+
+void FileEventQueue::put(const FileEvent& event)
+{
+    if (!m_events.contains(event.path))
+        m_order.append(event.path);
+    m_events.insert(event.path, event);
+}
+
+void FileEventQueue::drop(const QString& path)
+{
+    if (m_events.remove(path))
+        m_order.removeOne(path);
+}
+
+void FileEventQueue::add(FileEvent event)
+{
+    using Type = FileEvent::Type;
+
+    if (m_overflow)
+        return;
+    if (event.type == Type::Overflow) {
+        m_overflow = true;
+        m_overflowPath = event.path;
+        m_events.clear();
+        m_order.clear();
+        return;
+    }
+
+    if (event.type == Type::Moved) {
+        auto source_path = event.from;
+        auto source = m_events.constFind(source_path);
+        if (source != m_events.constEnd()) {
+            if (source->type == Type::Created) {
+                event.type = Type::Created;
+                event.from.clear();
+            } else if (source->type == Type::Moved) {
+                event.from = source->from;
+            }
+            drop(source_path);
+        }
+        // moved back to where it was
+        if (event.from == event.path) {
+            event.type = Type::Modified;
+            event.from.clear();
+        }
+        // whatever was queued for the target was overwritten
+        auto target = m_events.constFind(event.path);
+        if (target != m_events.constEnd() && target->type == Type::Deleted && event.type == Type::Created)
+            event.type = Type::Modified;
+        drop(event.path);
+        put(event);
+        return;
+    }
+
+    auto queued = m_events.find(event.path);
+    if (queued == m_events.end()) {
+        put(event);
+        return;
+    }
+
+    switch (event.type) {
+        case Type::Created:
+            if (queued->type == Type::Deleted)
+                *queued = { Type::Modified, event.path, {}, event.isDir };
+            break;
+        case Type::Modified:
+            // created, moved or modified before, the file gets read again either way
+            break;
+        case Type::Deleted:
+            if (queued->type == Type::Created) {
+                drop(event.path);
+            } else if (queued->type == Type::Moved) {
+                auto from = queued->from;
+                drop(event.path);
+                put({ Type::Deleted, from, {}, event.isDir });
+            } else {
+                *queued = event;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+QList<FileEvent> FileEventQueue::take()
+{
+    QList<FileEvent> events;
+    if (m_overflow) {
+        events.append({ FileEvent::Type::Overflow, m_overflowPath, {}, true });
+    } else {
+        for (const auto& path : m_order)
+            events.append(m_events.value(path));
+    }
+    m_events.clear();
+    m_order.clear();
+    m_overflow = false;
+    m_overflowPath.clear();
+    return events;
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/** A change to a file or folder below a watched folder. */
+struct FileEvent {
+    enum class Type {
+        Created,
+        Modified,
+        /// renamed or moved within the watched tree, from `from` to `path`
+        Moved,
+        Deleted,
+        /// events were lost, everything below `path` has to be looked at again
+        Overflow,
+    };
+
+    Type type;
+    /// absolute path
+    QString path;
+    QString from;
+    bool isDir = false;
+};
+
+/**
+ * Collects file events until they are taken, folding the events of one path into a single one.
+ *
+ * A file that is created and modified shows up as created, one that is deleted and created again as modified, and one
+ * that is created and deleted again not at all. Moves of a file that was only just created show up as a creation at
+ * the new place.
+ */
+class FileEventQueue {
+   public:
+    void add(FileEvent event);
+    bool isEmpty() const { return m_order.isEmpty() && !m_overflow; }
+    /** The folded events, in the order their paths first came up. An overflow replaces all of them. */
+    QList<FileEvent> take();
+
+   private:
+    void put(const FileEvent& event);
+    void drop(const QString& path);
+
+    QHash<QString, FileEvent> m_events;
+    QStringList m_order;
+    bool m_overflow = false;
+    QString m_overflowPath;
+};
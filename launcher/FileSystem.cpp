@@ -45,9 +45,12 @@
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
+#include <QSet>
 #include <QStandardPaths>
 #include <QStorageInfo>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QUrl>
 #include <QtNetwork>
 #include <system_error>
@@ -82,10 +85,13 @@ namespace fs = std::filesystem;
 
 // clone
 #if defined(Q_OS_LINUX)
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h> /* Definition of FICLONE* constants */
 #include <linux/fs.h>
+#include <string.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #elif defined(Q_OS_MACOS)
 #include <sys/attr.h>
@@ -299,6 +305,282 @@ void copyFolderAttributes(QString src, QString dst, QString relative)
     }
 }
 
+int defaultCopyWorkers()
+{
+    return qBound(1, QThread::idealThreadCount(), 8);
+}
+
+static bool reflink_file(const QString& src, const QString& dst, std::error_code& ec);
+
+namespace {
+
+/**
+ * The part copy and clone have in common.
+ *
+ * The source is walked once into a list of files and their sizes, then up to `maxWorkers` threads take files off the
+ * list until it is empty. The callbacks are never called concurrently.
+ */
+class TreeCopier {
+   public:
+    struct Entry {
+        QString src;
+        QString relative;
+        qint64 size;
+    };
+
+    IPathMatcher::Ptr matcher;
+    bool whitelist = false;
+    int maxWorkers = 1;
+    const std::atomic_bool* cancelled = nullptr;
+
+    //! copies a single file, `advance` takes the amount of bytes written since the last call
+    std::function<bool(const Entry&, const QString& dst_path, const std::function<void(qint64)>& advance, std::error_code& err)> copyFile;
+    std::function<void(qsizetype files, qint64 bytes)> scanned;
+    std::function<void(const Entry&, const QString& dst_path, const std::error_code& err)> fileDone;
+    std::function<void(qint64 done, qint64 total)> progress;
+
+    bool operator()(const QString& src, const QString& dst, bool dryRun);
+
+   private:
+    void work(const QString& dst);
+    void advance(qint64 bytes, bool force);
+
+    QList<Entry> m_entries;
+    qint64 m_totalBytes = 0;
+
+    std::atomic<qsizetype> m_next = 0;
+    std::atomic<qint64> m_doneBytes = 0;
+    std::atomic_bool m_ok = true;
+
+    QMutex m_lock;
+    //! written under m_lock, but read without it to skip the lock for small steps
+    std::atomic<qint64> m_reportedBytes = 0;
+};
+
+bool TreeCopier::operator()(const QString& src, const QString& dst, bool dryRun)
+{
+    auto add = [this](const QFileInfo& info, const QString& relative) {
+        if (matcher && (matcher->matches(relative) != whitelist))
+            return;
+        m_entries.append({ info.filePath(), relative, info.size() });
+        m_totalBytes += info.size();
+    };
+
+    // We can't use copy_opts::recursive because we need to take into account the
+    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
+    // match, we copy the file.
+    // Folders are walked one at a time, so the ones the matcher rules out entirely are never entered.
+    auto skipped = whitelist ? IPathMatcher::Subtree::None : IPathMatcher::Subtree::All;
+    QDir src_dir(src);
+    QStringList folders{ src };
+    while (!folders.isEmpty()) {
+        QDirIterator source_it(folders.takeLast(), QDir::Filter::Files | QDir::Filter::Dirs | QDir::Filter::Hidden | QDir::Filter::NoDotAndDotDot);
+        while (source_it.hasNext()) {
+            auto src_path = source_it.next();
+            auto info = source_it.fileInfo();
+            auto relative = src_dir.relativeFilePath(src_path);
+            if (!info.isDir()) {
+                add(info, relative);
+            } else if (!info.isSymLink() && !(matcher && matcher->matchesUnder(relative) == skipped)) {
+                folders.append(src_path);
+            }
+        }
+    }
+
+    // If the root src is not a directory, the previous iterator won't run.
+    if (!fs::is_directory(StringUtils::toStdString(src)))
+        add(QFileInfo(src), "");
+
+    if (scanned)
+        scanned(m_entries.size(), m_totalBytes);
+    if (dryRun) {
+        if (fileDone)
+            for (auto& entry : std::as_const(m_entries))
+                fileDone(entry, PathCombine(dst, entry.relative), {});
+        return true;
+    }
+
+    // make the folders up front, so the workers don't race each other for them
+    QSet<QString> folders;
+    for (auto& entry : m_entries) {
+        auto folder = QFileInfo(PathCombine(dst, entry.relative)).path();
+        if (!folders.contains(folder)) {
+            folders.insert(folder);
+            ensureFolderPathExists(folder);
+        }
+    }
+
+    auto workers = static_cast<int>(qMin<qsizetype>(maxWorkers, m_entries.size()));
+    if (workers <= 1) {
+        work(dst);
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(workers - 1);
+        for (int i = 0; i < workers - 1; i++)
+            pool.start([this, dst] { work(dst); });
+        // this thread would only be waiting otherwise
+        work(dst);
+        pool.waitForDone();
+    }
+
+    return m_ok;
+}
+
+void TreeCopier::work(const QString& dst)
+{
+    while (!(cancelled && *cancelled)) {
+        auto index = m_next++;
+        if (index >= m_entries.size())
+            return;
+        auto& entry = m_entries.at(index);
+        auto dst_path = PathCombine(dst, entry.relative);
+
+        qint64 written = 0;
+        std::error_code err;
+        bool copied = copyFile(entry, dst_path, [this, &written](qint64 bytes) {
+            written += bytes;
+            advance(bytes, false);
+        }, err);
+        if (!copied && !err)
+            err = std::make_error_code(std::errc::io_error);
+        if (err)
+            m_ok = false;
+
+        QMutexLocker locker(&m_lock);
+        if (fileDone)
+            fileDone(entry, dst_path, err);
+        locker.unlock();
+
+        // the file may have changed size since it was scanned, and failed files are done too
+        advance(entry.size - written, true);
+    }
+    // only a cancellation gets here, and it leaves files behind
+    m_ok = false;
+}
+
+void TreeCopier::advance(qint64 bytes, bool force)
+{
+    // reporting every chunk of every file would flood whoever listens
+    static constexpr qint64 s_reportInterval = 1024 * 1024;
+
+    auto done = m_doneBytes += bytes;
+    if (!progress || (!force && done - m_reportedBytes < s_reportInterval))
+        return;
+
+    QMutexLocker locker(&m_lock);
+    if (done <= m_reportedBytes && !force)
+        return;
+    auto reported = qMax(m_reportedBytes.load(), done);
+    m_reportedBytes = reported;
+    progress(reported, m_totalBytes);
+}
+
+#if defined(Q_OS_LINUX)
+/**
+ * Copies a regular file on Linux.
+ * A reflink is tried first, which is instant on btrfs, xfs and bcachefs. Then copy_file_range(), which keeps the data in
+ * the kernel (or on the server, for NFS and SMB) and falls back to plain reads and writes where it isn't supported.
+ */
+bool linuxCopyFile(const std::string& src_path,
+                   const std::string& dst_path,
+                   bool overwrite,
+                   const std::function<void(qint64)>& advance,
+                   const std::atomic_bool* cancelled,
+                   std::error_code& ec)
+{
+    static constexpr size_t s_chunkSize = 8 * 1024 * 1024;
+
+    int src_fd = ::open(src_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd == -1) {
+        ec = std::error_code(errno, std::generic_category());
+        return false;
+    }
+    struct stat st;
+    if (::fstat(src_fd, &st) == -1) {
+        ec = std::error_code(errno, std::generic_category());
+        ::close(src_fd);
+        return false;
+    }
+    int dst_fd = ::open(dst_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? O_TRUNC : O_EXCL), st.st_mode & 07777);
+    if (dst_fd == -1) {
+        ec = std::error_code(errno, std::generic_category());
+        ::close(src_fd);
+        return false;
+    }
+
+    bool done = ::ioctl(dst_fd, FICLONE, src_fd) == 0;
+    if (done) {
+        advance(st.st_size);
+    } else {
+        bool use_copy_file_range = true;
+        std::vector<char> buffer;
+        qint64 copied = 0;
+        while (!ec) {
+            if (cancelled && *cancelled) {
+                ec = std::make_error_code(std::errc::operation_canceled);
+                break;
+            }
+            ssize_t count;
+            if (use_copy_file_range) {
+                count = ::copy_file_range(src_fd, nullptr, dst_fd, nullptr, s_chunkSize, 0);
+                if (count == -1 && errno != EINTR) {
+                    // not supported between these two files, both offsets are untouched so just carry on without it
+                    if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP || errno == EBADF) {
+                        use_copy_file_range = false;
+                        continue;
+                    }
+                    ec = std::error_code(errno, std::generic_category());
+                    break;
+                }
+                // some filesystems report 0 instead of an error, only trust it at the size we expect
+                if (count == 0 && copied < st.st_size) {
+                    use_copy_file_range = false;
+                    continue;
+                }
+            } else {
+                if (buffer.empty())
+                    buffer.resize(s_chunkSize / 8);
+                count = ::read(src_fd, buffer.data(), buffer.size());
+                if (count == -1 && errno != EINTR) {
+                    ec = std::error_code(errno, std::generic_category());
+                    break;
+                }
+                for (ssize_t written = 0; count > 0 && written < count;) {
+                    auto result = ::write(dst_fd, buffer.data() + written, count - written);
+                    if (result == -1 && errno != EINTR) {
+                        ec = std::error_code(errno, std::generic_category());
+                        break;
+                    }
+                    written += qMax<ssize_t>(result, 0);
+                }
+            }
+            if (count == 0)
+                break;
+            if (count > 0 && !ec) {
+                copied += count;
+                advance(count);
+            }
+        }
+        done = !ec;
+    }
+
+    // the mode passed to open() is only used for new files, and umask applies to it
+    if (done && ::fchmod(dst_fd, st.st_mode & 07777) == -1)
+        qDebug() << "Failed to copy permissions to" << dst_path.c_str() << ":" << strerror(errno);
+
+    ::close(src_fd);
+    if (::close(dst_fd) == -1 && done) {
+        ec = std::error_code(errno, std::generic_category());
+        done = false;
+    }
+    if (!done)
+        ::unlink(dst_path.c_str());
+    return done;
+}
+#endif
+
+}  // namespace
+
 /**
  * @brief Copies a directory and it's contents from src to dest
  * @param offset subdirectory form src to copy to dest
@@ -318,8 +600,6 @@ bool copy::operator()(const QString& offset, bool dryRun)
     auto src = PathCombine(m_src.absolutePath(), offset);
     auto dst = PathCombine(m_dst.absolutePath(), offset);
 
-    std::error_code err;
-
     fs::copy_options opt = copy_opts::none;
 
     // The default behavior is to follow symlinks
@@ -329,49 +609,46 @@ bool copy::operator()(const QString& offset, bool dryRun)
     if (m_overwrite)
         opt |= copy_opts::overwrite_existing;
 
-    // Function that'll do the actual copying
-    auto copy_file = [this, dryRun, src, dst, opt, &err](QString src_path, QString relative_dst_path) {
-        if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
-            return;
+    TreeCopier copier;
+    copier.matcher = m_matcher;
+    copier.whitelist = m_whitelist;
+    copier.maxWorkers = m_maxWorkers;
+    copier.cancelled = m_cancelled;
 
-        auto dst_path = PathCombine(dst, relative_dst_path);
-        if (!dryRun) {
-            ensureFilePathExists(dst_path);
+    // Function that'll do the actual copying
+    copier.copyFile = [this, src, dst, opt](const TreeCopier::Entry& entry, const QString& dst_path,
+                                            const std::function<void(qint64)>& advance, std::error_code& err) {
 #ifdef Q_OS_WIN32
-            copyFolderAttributes(src, dst, relative_dst_path);
+        copyFolderAttributes(src, dst, entry.relative);
+#elif defined(Q_OS_LINUX)
+        // symlinks that are to stay symlinks are left to std::filesystem
+        if (m_followSymlinks || !QFileInfo(entry.src).isSymLink())
+            return linuxCopyFile(StringUtils::toStdString(entry.src), StringUtils::toStdString(dst_path), m_overwrite, advance, m_cancelled,
+                                 err);
 #endif
-            fs::copy(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), opt, err);
-        }
+        fs::copy(StringUtils::toStdString(entry.src), StringUtils::toStdString(dst_path), opt, err);
+        advance(entry.size);
+        return !err;
+    };
+    copier.scanned = [this](qsizetype files, qint64 bytes) {
+        m_totalBytes = bytes;
+        emit scanned(files, bytes);
+    };
+    copier.fileDone = [this](const TreeCopier::Entry& entry, const QString& dst_path, const std::error_code& err) {
         if (err) {
             qWarning() << "Failed to copy files:" << QString::fromStdString(err.message());
-            qDebug() << "Source file:" << src_path;
+            qDebug() << "Source file:" << entry.src;
             qDebug() << "Destination file:" << dst_path;
             m_failedPaths.append(dst_path);
-            emit copyFailed(relative_dst_path);
+            emit copyFailed(entry.relative);
             return;
         }
         m_copied++;
-        emit fileCopied(relative_dst_path);
+        emit fileCopied(entry.relative);
     };
+    copier.progress = [this](qint64 done, qint64 total) { emit progress(done, total); };
 
-    // We can't use copy_opts::recursive because we need to take into account the
-    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
-    // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        copy_file(src_path, relative_path);
-    }
-
-    // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
-        copy_file(src, "");
-
-    return err.value() == 0;
+    return copier(src, dst, dryRun) && m_failedPaths.isEmpty();
 }
 
 /// qDebug print support for the LinkPair struct
@@ -1273,48 +1550,39 @@ bool clone::operator()(const QString& offset, bool dryRun)
     auto src = PathCombine(m_src.absolutePath(), offset);
     auto dst = PathCombine(m_dst.absolutePath(), offset);
 
-    std::error_code err;
+    TreeCopier copier;
+    copier.matcher = m_matcher;
+    copier.whitelist = m_whitelist;
+    copier.maxWorkers = m_maxWorkers;
+    copier.cancelled = m_cancelled;
 
     // Function that'll do the actual cloneing
-    auto cloneFile = [this, dryRun, dst, &err](QString src_path, QString relative_dst_path) {
-        if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
-            return;
-
-        auto dst_path = PathCombine(dst, relative_dst_path);
-        if (!dryRun) {
-            ensureFilePathExists(dst_path);
-            clone_file(src_path, dst_path, err);
-        }
+    // the whole tree was checked above, no need to ask every file which filesystem it is on
+    copier.copyFile = [](const TreeCopier::Entry& entry, const QString& dst_path, const std::function<void(qint64)>& advance,
+                         std::error_code& err) {
+        bool cloned = reflink_file(entry.src, dst_path, err);
+        advance(entry.size);
+        return cloned;
+    };
+    copier.scanned = [this](qsizetype files, qint64 bytes) {
+        m_totalBytes = bytes;
+        emit scanned(files, bytes);
+    };
+    copier.fileDone = [this](const TreeCopier::Entry& entry, const QString& dst_path, const std::error_code& err) {
         if (err) {
             qDebug() << "Failed to clone files: error" << err.value() << "message" << QString::fromStdString(err.message());
-            qDebug() << "Source file:" << src_path;
+            qDebug() << "Source file:" << entry.src;
             qDebug() << "Destination file:" << dst_path;
-            m_failedClones.append(qMakePair(src_path, dst_path));
-            emit cloneFailed(src_path, dst_path);
+            m_failedClones.append(qMakePair(entry.src, dst_path));
+            emit cloneFailed(entry.src, dst_path);
             return;
         }
         m_cloned++;
-        emit fileCloned(src_path, dst_path);
+        emit fileCloned(entry.src, dst_path);
     };
+    copier.progress = [this](qint64 done, qint64 total) { emit progress(done, total); };
 
-    // We can't use copy_opts::recursive because we need to take into account the
-    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
-    // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        cloneFile(src_path, relative_path);
-    }
-
-    // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
-        cloneFile(src, "");
-
-    return err.value() == 0;
+    return copier(src, dst, dryRun) && m_failedClones.isEmpty();
 }
 
 /**
@@ -1323,9 +1591,6 @@ bool clone::operator()(const QString& offset, bool dryRun)
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
 {
-    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
-    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
-
     FilesystemInfo srcinfo = statFS(src);
     FilesystemInfo dstinfo = statFS(dst);
 
@@ -1335,6 +1600,15 @@ bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
         return false;
     }
 
+    return reflink_file(src, dst, ec);
+}
+
+// clone_file() without the filesystem check, for callers that checked the whole tree already
+static bool reflink_file(const QString& src, const QString& dst, std::error_code& ec)
+{
+    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
+    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
+
 #if defined(Q_OS_WIN)
 
     if (!win_ioctl_clone(src_path, dst_path, ec)) {
@@ -1701,4 +1975,72 @@ QString getUniqueResourceName(const QString& filePath)
 
     return newFileName;
 }
+#if defined(Q_OS_LINUX)
+// walks the directory with readdir (batched getdents64) and stats entries relative to the directory fd,
+// which avoids building a QFileInfo and resolving the full path for every single file
+static qint64 linuxDirectorySize(int dirFd, const std::atomic_bool* cancelled)
+{
+    DIR* dir = fdopendir(dirFd);
+    if (!dir) {
+        close(dirFd);
+        return 0;
+    }
+    qint64 total = 0;
+    while (auto entry = readdir(dir)) {
+        if (cancelled && *cancelled) {
+            break;
+        }
+        const char* name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type != DT_DIR) {
+            struct stat st;
+            if (fstatat(dirfd(dir), name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            if (S_ISREG(st.st_mode)) {
+                total += st.st_size;
+            }
+            // some filesystems do not fill d_type
+            isDir = entry->d_type == DT_UNKNOWN && S_ISDIR(st.st_mode);
+        }
+        if (isDir) {
+            int childFd = openat(dirfd(dir), name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (childFd != -1) {
+                total += linuxDirectorySize(childFd, cancelled);
+            }
+        }
+    }
+    closedir(dir);
+    return total;
+}
+#endif
+
+qint64 directorySize(const QString& path, const std::atomic_bool* cancelled)
+{
+#if defined(Q_OS_LINUX)
+    int fd = open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) {
+        return -1;
+    }
+    return linuxDirectorySize(fd, cancelled);
+#else
+    if (!QFileInfo(path).isDir()) {
+        return -1;
+    }
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    qint64 total = 0;
+    while (it.hasNext()) {
+        if (cancelled && *cancelled) {
+            break;
+        }
+        it.next();
+        total += it.fileInfo().size();
+    }
+    return total;
+#endif
+}
+
 }  // namespace FS
@@ -40,6 +40,7 @@
 #include "Exception.h"
 #include "pathmatcher/IPathMatcher.h"
 
+#include <atomic>
 #include <system_error>
 
 #include <QDir>
@@ -99,8 +100,17 @@ bool ensureFolderPathExists(const QFileInfo folderPath);
  */
 bool ensureFolderPathExists(const QString folderPathName);
 
+/**
+ * How many files copy and clone work on at the same time by default.
+ * Enough to keep an SSD or a network share busy, without drowning a spinning disk in seeks.
+ */
+int defaultCopyWorkers();
+
 /**
  * @brief Copies a directory and it's contents from src to dest
+ *
+ * The source is walked once into a list of files, which are then copied by up to maxWorkers() threads.
+ * Progress is reported in bytes.
  */
 class copy : public QObject {
     Q_OBJECT
@@ -130,14 +140,30 @@ class copy : public QObject {
         m_overwrite = overwrite;
         return *this;
     }
+    copy& maxWorkers(int workers)
+    {
+        m_maxWorkers = workers;
+        return *this;
+    }
+    /** When set, no new files are started and large files stop between chunks. */
+    copy& cancelled(const std::atomic_bool* cancelled)
+    {
+        m_cancelled = cancelled;
+        return *this;
+    }
 
     bool operator()(bool dryRun = false) { return operator()(QString(), dryRun); }
 
     qsizetype totalCopied() { return m_copied; }
     qsizetype totalFailed() { return m_failedPaths.length(); }
     QStringList failed() { return m_failedPaths; }
+    qint64 totalBytes() { return m_totalBytes; }
 
    signals:
+    /** Emitted once the source has been walked, before anything is copied. */
+    void scanned(qsizetype files, qint64 bytes);
+    /** Emitted from the copying threads. */
+    void progress(qint64 copiedBytes, qint64 totalBytes);
     void fileCopied(const QString& relativeName);
     void copyFailed(const QString& relativeName);
     // TODO: maybe add a "shouldCopy" signal in the future?
@@ -150,9 +176,12 @@ class copy : public QObject {
     IPathMatcher::Ptr m_matcher = nullptr;
     bool m_whitelist = false;
     bool m_overwrite = false;
+    int m_maxWorkers = defaultCopyWorkers();
+    const std::atomic_bool* m_cancelled = nullptr;
     QDir m_src;
     QDir m_dst;
     qsizetype m_copied;
+    qint64 m_totalBytes = 0;
     QStringList m_failedPaths;
 };
 
@@ -502,15 +531,31 @@ class clone : public QObject {
         m_whitelist = whitelist;
         return *this;
     }
+    clone& maxWorkers(int workers)
+    {
+        m_maxWorkers = workers;
+        return *this;
+    }
+    /** When set, no new files are started. */
+    clone& cancelled(const std::atomic_bool* cancelled)
+    {
+        m_cancelled = cancelled;
+        return *this;
+    }
 
     bool operator()(bool dryRun = false) { return operator()(QString(), dryRun); }
 
     qsizetype totalCloned() { return m_cloned; }
     qsizetype totalFailed() { return m_failedClones.length(); }
+    qint64 totalBytes() { return m_totalBytes; }
 
     QList<QPair<QString, QString>> failed() { return m_failedClones; }
 
    signals:
+    /** Emitted once the source has been walked, before anything is cloned. */
+    void scanned(qsizetype files, qint64 bytes);
+    /** Emitted from the cloning threads. */
+    void progress(qint64 clonedBytes, qint64 totalBytes);
     void fileCloned(const QString& src, const QString& dst);
     void cloneFailed(const QString& src, const QString& dst);
 
@@ -520,9 +565,12 @@ class clone : public QObject {
    private:
     IPathMatcher::Ptr m_matcher = nullptr;
     bool m_whitelist = false;
+    int m_maxWorkers = defaultCopyWorkers();
+    const std::atomic_bool* m_cancelled = nullptr;
     QDir m_src;
     QDir m_dst;
     qsizetype m_cloned;
+    qint64 m_totalBytes = 0;
     QList<QPair<QString, QString>> m_failedClones;
 };
 
@@ -566,4 +614,12 @@ QString getPathNameInLocal8bit(const QString& file);
 
 QString getUniqueResourceName(const QString& filePath);
 
+/**
+ * @brief total size of all the files below a directory, not following symlinks
+ * @param path the directory to measure
+ * @param cancelled when set, the walk stops early and returns what it has summed so far
+ * @return the size in bytes or -1 if the path is not a readable directory
+ */
+qint64 directorySize(const QString& path, const std::atomic_bool* cancelled = nullptr);
+
 }  // namespace FS
@@ -39,6 +39,9 @@
 #include <QDebug>
 #include <QFile>
 
+#include <algorithm>
+#include <limits>
+
 bool GZip::unzip(const QByteArray& compressedBytes, QByteArray& uncompressedBytes)
 {
     if (compressedBytes.size() == 0) {
@@ -215,4 +218,80 @@ QString GZip::readGzFileByBlocks(QFile* source, std::function<bool(const QByteAr
 {
     auto ret = inf(source, handleBlock);
     return zerr(ret);
-}
\ No newline at end of file
+}
+namespace GZip {
+
+InflateDevice::InflateDevice(QIODevice* source) : m_source(source) {}
+
+InflateDevice::~InflateDevice()
+{
+    close();
+}
+
+bool InflateDevice::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != ReadOnly) {
+        setErrorString(tr("Only reading is supported"));
+        return false;
+    }
+    if (!m_source->isOpen() && !m_source->open(QIODevice::ReadOnly)) {
+        setErrorString(m_source->errorString());
+        return false;
+    }
+
+    m_stream = std::make_unique<z_stream>();
+    // 16 + MAX_WBITS: expect a gzip header
+    if (inflateInit2(m_stream.get(), 16 + MAX_WBITS) != Z_OK) {
+        m_stream.reset();
+        setErrorString(tr("Could not initialize zlib"));
+        return false;
+    }
+    m_input.resize(64 * 1024);
+    m_ended = false;
+    return QIODevice::open(mode);
+}
+
+void InflateDevice::close()
+{
+    if (m_stream) {
+        inflateEnd(m_stream.get());
+        m_stream.reset();
+    }
+    QIODevice::close();
+}
+
+qint64 InflateDevice::readData(char* data, qint64 maxSize)
+{
+    qint64 produced = 0;
+    while (produced < maxSize && !m_ended) {
+        if (m_stream->avail_in == 0) {
+            auto read = m_source->read(m_input.data(), m_input.size());
+            if (read < 0) {
+                setErrorString(m_source->errorString());
+                return -1;
+            }
+            if (read == 0) {
+                setErrorString(tr("The compressed data ended unexpectedly"));
+                return -1;
+            }
+            m_stream->next_in = reinterpret_cast<Bytef*>(m_input.data());
+            m_stream->avail_in = static_cast<uInt>(read);
+        }
+
+        auto space = static_cast<uInt>(std::min<qint64>(maxSize - produced, std::numeric_limits<uInt>::max()));
+        m_stream->next_out = reinterpret_cast<Bytef*>(data + produced);
+        m_stream->avail_out = space;
+        auto ret = inflate(m_stream.get(), Z_NO_FLUSH);
+        produced += space - m_stream->avail_out;
+
+        if (ret == Z_STREAM_END) {
+            m_ended = true;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            setErrorString(zerr(ret == Z_NEED_DICT ? Z_DATA_ERROR : ret));
+            return -1;
+        }
+    }
+    return produced;
+}
+
+}  // namespace GZip
@@ -1,6 +1,12 @@
 #pragma once
 #include <QByteArray>
 #include <QFile>
+#include <QIODevice>
+
+#include <functional>
+#include <memory>
+
+struct z_stream_s;
 
 namespace GZip {
 
@@ -8,4 +14,29 @@ bool unzip(const QByteArray& compressedBytes, QByteArray& uncompressedBytes);
 bool zip(const QByteArray& uncompressedBytes, QByteArray& compressedBytes);
 QString readGzFileByBlocks(QFile* source, std::function<bool(const QByteArray&)> handleBlock);
 
+/**
+ * Read-only device that decompresses the gzip data read from another one, as it is read.
+ * Reads block until the requested amount is there or the gzip stream ends, so it can sit on top of a device that is
+ * still being filled.
+ */
+class InflateDevice : public QIODevice {
+   public:
+    explicit InflateDevice(QIODevice* source);
+    ~InflateDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+
+   protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+   private:
+    QIODevice* m_source;
+    std::unique_ptr<z_stream_s> m_stream;
+    QByteArray m_input;
+    bool m_ended = false;
+};
+
 }  // namespace GZip
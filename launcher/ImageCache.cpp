@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ImageCache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QPixmapCache>
+#include <QThread>
+
+#include <limits>
+
+ImageCache& ImageCache::instance()
+{
+    static ImageCache s_instance;
+    return s_instance;
+}
+
+static qint64 imageCost(const QImage& image)
+{
+    return qMax<qint64>(image.sizeInBytes(), 1);
+}
+
+static QString pixmapCacheKey(ImageCache::Key key)
+{
+    return QStringLiteral("ImageCache/%1").arg(key);
+}
+
+ImageCache::Key ImageCache::insert(const QImage& image)
+{
+    if (image.isNull()) {
+        return 0;
+    }
+    const auto cost = imageCost(image);
+    if (cost > shardLimit()) {
+        qWarning() << "Image of" << cost << "bytes does not fit in the image cache";
+        return 0;
+    }
+
+    const Key key = m_nextKey++;
+    auto& shard = shardFor(key);
+    QMutexLocker locker(&shard.lock);
+    shard.lru.push_front(key);
+    shard.entries.insert(key, { image, shard.lru.begin() });
+    shard.cost += cost;
+    evict(shard);
+    return key;
+}
+
+bool ImageCache::find(Key key, QImage* image)
+{
+    if (key == 0) {
+        return false;
+    }
+    auto& shard = shardFor(key);
+    QMutexLocker locker(&shard.lock);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->lruPosition);
+    if (image) {
+        *image = it->image;
+    }
+    return true;
+}
+
+bool ImageCache::find(Key key, QPixmap* pixmap)
+{
+    Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+    QImage image;
+    if (!find(key, &image)) {
+        return false;
+    }
+    // keys are never reused, so a pixmap under this key always belongs to this image
+    const auto pixmapKey = pixmapCacheKey(key);
+    if (QPixmapCache::find(pixmapKey, pixmap)) {
+        return true;
+    }
+    *pixmap = QPixmap::fromImage(image);
+    QPixmapCache::insert(pixmapKey, *pixmap);
+    return true;
+}
+
+void ImageCache::remove(Key key)
+{
+    if (key == 0) {
+        return;
+    }
+    // the pixmap, if any, ages out of the QPixmapCache on its own
+    auto& shard = shardFor(key);
+    QMutexLocker locker(&shard.lock);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return;
+    }
+    shard.cost -= imageCost(it->image);
+    shard.lru.erase(it->lruPosition);
+    shard.entries.erase(it);
+}
+
+void ImageCache::clear()
+{
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        shard.entries.clear();
+        shard.lru.clear();
+        shard.cost = 0;
+    }
+}
+
+void ImageCache::setCacheLimit(qint64 bytes)
+{
+    m_limit = bytes;
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        evict(shard);
+    }
+}
+
+qint64 ImageCache::totalCost() const
+{
+    qint64 total = 0;
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        total += shard.cost;
+    }
+    return total;
+}
+
+// the shard lock must be held
+void ImageCache::evict(Shard& shard)
+{
+    const auto limit = shardLimit();
+    while (shard.cost > limit && !shard.lru.empty()) {
+        auto key = shard.lru.back();
+        shard.lru.pop_back();
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            shard.cost -= imageCost(it->image);
+            shard.entries.erase(it);
+        }
+    }
+}
+
+bool ImageCache::markCacheMissByEviction()
+{
+    static constexpr qint64 maxCache = std::numeric_limits<int>::max();
+    static constexpr qint64 step = 10 * 1024 * 1024;
+    static constexpr int oneSecond = 1000;
+    static constexpr int threshold = 15;
+
+    QMutexLocker locker(&m_missLock);
+    auto now = QTime::currentTime();
+    if (!m_lastCacheMissByEviction.isNull()) {
+        auto diff = m_lastCacheMissByEviction.msecsTo(now);
+        if (diff < oneSecond) {  // less than a second ago
+            ++m_consecutiveFastEvictions;
+        } else {
+            m_consecutiveFastEvictions = 0;
+        }
+    }
+    m_lastCacheMissByEviction = now;
+    if (m_consecutiveFastEvictions < threshold) {
+        return false;
+    }
+    m_consecutiveFastEvictions = 0;
+
+    auto newLimit = qMin(cacheLimit() + step, maxCache);
+    if (newLimit == cacheLimit()) {
+        qDebug() << "image cache misses by eviction happened too fast, doing nothing as the cache size reached it's limit";
+        return false;
+    }
+    qDebug() << "image cache misses by eviction happened too fast, increasing cache size to" << newLimit;
+    setCacheLimit(newLimit);
+    return true;
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPixmap>
+#include <QTime>
+
+#include <array>
+#include <atomic>
+#include <list>
+
+/** A thread safe image cache.
+ *
+ *  Workers store decoded QImages directly, without a round trip through the GUI thread.
+ *  Entries are spread over independently locked shards, each with its own least recently used list, so threads
+ *  touching different entries almost never wait on each other.
+ *
+ *  QPixmaps can only be made on the GUI thread, so they are converted from the stored image the first time the GUI asks
+ *  for one and are then kept in the QPixmapCache.
+ */
+class ImageCache {
+   public:
+    /// 0 is never handed out, so a default initialized key is always invalid
+    using Key = quint64;
+
+    static ImageCache& instance();
+
+    /// store an image, from any thread. returns 0 if the image is bigger than a whole shard
+    Key insert(const QImage& image);
+    /// find an image, from any thread. marks it as recently used
+    bool find(Key key, QImage* image);
+    /// find an image as a pixmap. GUI thread only
+    bool find(Key key, QPixmap* pixmap);
+    void remove(Key key);
+    void clear();
+
+    /// the total limit in bytes, spread evenly over the shards
+    qint64 cacheLimit() const { return m_limit; }
+    void setCacheLimit(qint64 bytes);
+    /// the bytes currently in use by all shards
+    qint64 totalCost() const;
+
+    /**
+     *  Mark that a cache miss occurred because of a eviction if too many of these occur too fast the cache size is increased
+     * @return if the cache size was increased
+     */
+    bool markCacheMissByEviction();
+
+   private:
+    struct Entry {
+        QImage image;
+        std::list<Key>::iterator lruPosition;
+    };
+    struct Shard {
+        mutable QMutex lock;
+        QHash<Key, Entry> entries;
+        /// most recently used first
+        std::list<Key> lru;
+        qint64 cost = 0;
+    };
+    static constexpr int s_shardCount = 16;
+
+    Shard& shardFor(Key key) { return m_shards[key % s_shardCount]; }
+    qint64 shardLimit() const { return m_limit / s_shardCount; }
+    void evict(Shard& shard);
+
+    std::array<Shard, s_shardCount> m_shards;
+    std::atomic<Key> m_nextKey{ 1 };
+    std::atomic<qint64> m_limit{ 64 * 1024 * 1024 };
+
+    QMutex m_missLock;
+    QTime m_lastCacheMissByEviction;
+    int m_consecutiveFastEvictions = 0;
+};
@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "InotifyWatcher.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+static constexpr uint32_t s_mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                   IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+static bool isBelow(const QString& path, const QString& root)
+{
+    return path == root || path.startsWith(root + '/');
+}
+
+static int levelsBelow(const QString& path, const QString& root)
+{
+    return path.mid(root.size()).count('/');
+}
+
+// depth is the deepest watched folder, what is in it is one level further down
+static bool isReported(const QString& path, const QString& root, int depth)
+{
+    return isBelow(path, root) && (depth < 0 || levelsBelow(path, root) <= depth + 1);
+}
+
+InotifyWatcher* InotifyWatcher::instance()
+{
+    static InotifyWatcher* s_instance = []() -> InotifyWatcher* {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            qWarning() << "inotify is not available:" << strerror(errno);
+            return nullptr;
+        }
+        return new InotifyWatcher(fd);
+    }();
+    return s_instance;
+}
+
+InotifyWatcher::InotifyWatcher(int fd) : m_fd(fd), m_notifier(new QSocketNotifier(fd, QSocketNotifier::Read, this))
+{
+    connect(m_notifier, &QSocketNotifier::activated, this, &InotifyWatcher::readEvents);
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &InotifyWatcher::flush);
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+    close(m_fd);
+}
+
+int InotifyWatcher::watch(const QString& root, Callback callback, int depth)
+{
+    auto folder = QDir(root).absolutePath();
+    // the client has to be known for addFolder() to tell how deep to go
+    int id = m_nextId++;
+    m_clients.insert(id, { folder, depth, std::move(callback), {} });
+    if (!addFolder(folder, false)) {
+        m_clients.remove(id);
+        dropFolder(folder, true);
+        return -1;
+    }
+    return id;
+}
+
+bool InotifyWatcher::isWatching(int id) const
+{
+    return m_clients.contains(id);
+}
+
+void InotifyWatcher::unwatch(int id)
+{
+    auto client = m_clients.find(id);
+    if (client == m_clients.end())
+        return;
+    auto root = client->root;
+    m_clients.erase(client);
+    dropFolder(root, true);
+}
+
+bool InotifyWatcher::needsWatch(const QString& folder) const
+{
+    for (const auto& client : m_clients) {
+        if (isBelow(folder, client.root) && (client.depth < 0 || levelsBelow(folder, client.root) <= client.depth))
+            return true;
+    }
+    return false;
+}
+
+bool InotifyWatcher::addFolder(const QString& folder, bool reportContents)
+{
+    if (!needsWatch(folder))
+        return true;
+    int wd = inotify_add_watch(m_fd, QFile::encodeName(folder).constData(), s_mask);
+    if (wd < 0) {
+        qWarning() << "Unable to watch" << folder << ":" << strerror(errno);
+        // most likely out of watches, the trees this folder is in are handed back to be watched some other way
+        for (auto& client : m_clients) {
+            if (isBelow(folder, client.root) && !client.lost) {
+                client.lost = true;
+                client.queue.add({ FileEvent::Type::Overflow, client.root, {}, true });
+            }
+        }
+        if (!m_pendingSince.isValid())
+            m_pendingSince.start();
+        // not flushed right here, this may be called while the clients are gone through
+        if (!m_flushTimer.isActive())
+            m_flushTimer.start(s_debounceMs);
+        return false;
+    }
+    // the same folder under an older name
+    if (auto old = m_folders.value(wd); !old.isEmpty() && old != folder)
+        m_descriptors.remove(old);
+    m_folders.insert(wd, folder);
+    m_descriptors.insert(folder, wd);
+
+    // anything that got in before the watch was there was not reported
+    auto entries = QDir(folder).entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    for (const auto& entry : entries) {
+        if (reportContents)
+            queue({ FileEvent::Type::Created, entry.absoluteFilePath(), {}, entry.isDir() });
+        if (entry.isDir() && !entry.isSymLink())
+            addFolder(entry.absoluteFilePath(), reportContents);
+    }
+    return true;
+}
+
+void InotifyWatcher::dropFolder(const QString& folder, bool keepWatched)
+{
+    for (auto it = m_descriptors.begin(); it != m_descriptors.end();) {
+        if (!isBelow(it.key(), folder) || (keepWatched && needsWatch(it.key()))) {
+            ++it;
+            continue;
+        }
+        inotify_rm_watch(m_fd, it.value());
+        m_folders.remove(it.value());
+        it = m_descriptors.erase(it);
+    }
+}
+
+void InotifyWatcher::renameFolder(const QString& from, const QString& to)
+{
+    QHash<QString, int> renamed;
+    for (auto it = m_descriptors.begin(); it != m_descriptors.end();) {
+        if (!isBelow(it.key(), from)) {
+            ++it;
+            continue;
+        }
+        auto path = to + it.key().mid(from.size());
+        renamed.insert(path, it.value());
+        m_folders.insert(it.value(), path);
+        it = m_descriptors.erase(it);
+    }
+    m_descriptors.insert(renamed);
+}
+
+void InotifyWatcher::queue(const FileEvent& event)
+{
+    for (auto& client : m_clients) {
+        bool inside = isReported(event.path, client.root, client.depth);
+        if (event.type != FileEvent::Type::Moved) {
+            if (inside)
+                client.queue.add(event);
+            continue;
+        }
+        // a move across the edge of a tree is a creation or a deletion for it
+        bool fromInside = isReported(event.from, client.root, client.depth);
+        if (inside && fromInside)
+            client.queue.add(event);
+        else if (inside)
+            client.queue.add({ FileEvent::Type::Created, event.path, {}, event.isDir });
+        else if (fromInside)
+            client.queue.add({ FileEvent::Type::Deleted, event.from, {}, event.isDir });
+    }
+    if (!m_pendingSince.isValid())
+        m_pendingSince.start();
+}
+
+void InotifyWatcher::readEvents()
+{
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    // moves come as a pair of events with the same cookie, unpaired ones left the watched trees
+    QHash<uint32_t, FileEvent> moves;
+
+    for (;;) {
+        auto length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+        for (char* ptr = buffer; ptr < buffer + length;) {
+            auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                qWarning() << "inotify queue overflowed, events were lost";
+                for (auto& client : m_clients)
+                    client.queue.add({ FileEvent::Type::Overflow, client.root, {}, true });
+                continue;
+            }
+
+            auto folder = m_folders.value(event->wd);
+            if (folder.isEmpty())
+                continue;
+            if (event->mask & IN_IGNORED) {
+                m_folders.remove(event->wd);
+                if (m_descriptors.value(folder) == event->wd)
+                    m_descriptors.remove(folder);
+                continue;
+            }
+
+            bool is_dir = event->mask & IN_ISDIR;
+            auto path = event->len ? folder + '/' + QFile::decodeName(event->name) : folder;
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // everything but the roots is reported by the folder it is in
+                bool is_root = false;
+                for (auto& client : m_clients) {
+                    if (client.root == folder) {
+                        client.queue.add({ FileEvent::Type::Deleted, folder, {}, true });
+                        is_root = true;
+                    }
+                }
+                // a moved root keeps its watches, but they no longer are where the paths say
+                if ((event->mask & IN_MOVE_SELF) && is_root && !m_descriptors.contains(QFileInfo(folder).absolutePath()))
+                    dropFolder(folder, false);
+                continue;
+            }
+
+            if (event->mask & IN_MOVED_FROM) {
+                moves.insert(event->cookie, { FileEvent::Type::Moved, {}, path, is_dir });
+                continue;
+            }
+            if (event->mask & IN_MOVED_TO) {
+                auto move = moves.find(event->cookie);
+                if (move != moves.end()) {
+                    if (is_dir) {
+                        renameFolder(move->from, path);
+                        // it may have ended up at a different depth
+                        dropFolder(path, true);
+                        addFolder(path, false);
+                    }
+                    queue({ FileEvent::Type::Moved, path, move->from, is_dir });
+                    moves.erase(move);
+                } else {
+                    queue({ FileEvent::Type::Created, path, {}, is_dir });
+                    if (is_dir)
+                        addFolder(path, true);
+                }
+                continue;
+            }
+
+            if (event->mask & IN_CREATE) {
+                queue({ FileEvent::Type::Created, path, {}, is_dir });
+                if (is_dir)
+                    addFolder(path, true);
+            } else if (event->mask & IN_DELETE) {
+                queue({ FileEvent::Type::Deleted, path, {}, is_dir });
+            } else if ((event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) && !is_dir) {
+                queue({ FileEvent::Type::Modified, path, {}, false });
+            }
+        }
+    }
+
+    for (const auto& move : moves) {
+        if (move.isDir)
+            dropFolder(move.from, false);
+        queue({ FileEvent::Type::Deleted, move.from, {}, move.isDir });
+    }
+    scheduleFlush();
+}
+
+void InotifyWatcher::scheduleFlush()
+{
+    if (!m_pendingSince.isValid())
+        return;
+    if (m_pendingSince.elapsed() >= s_maxDelayMs) {
+        flush();
+        return;
+    }
+    m_flushTimer.start(s_debounceMs);
+}
+
+void InotifyWatcher::flush()
+{
+    m_flushTimer.stop();
+    m_pendingSince.invalidate();
+    // callbacks may start or stop watching trees
+    for (auto id : m_clients.keys()) {
+        auto client = m_clients.find(id);
+        if (client == m_clients.end() || client->queue.isEmpty())
+            continue;
+        auto events = client->queue.take();
+        auto callback = client->callback;
+        if (client->lost) {
+            auto root = client->root;
+            m_clients.erase(client);
+            dropFolder(root, true);
+        }
+        callback(events);
+    }
+}
+
+#else
+
+InotifyWatcher* InotifyWatcher::instance()
+{
+    return nullptr;
+}
+
+InotifyWatcher::InotifyWatcher(int fd) : m_fd(fd), m_notifier(nullptr) {}
+
+InotifyWatcher::~InotifyWatcher() = default;
+
+int InotifyWatcher::watch([[maybe_unused]] const QString& root, [[maybe_unused]] Callback callback, [[maybe_unused]] int depth)
+{
+    return -1;
+}
+
+void InotifyWatcher::unwatch([[maybe_unused]] int id) {}
+
+bool InotifyWatcher::isWatching([[maybe_unused]] int id) const
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+#include "FileEvent.h"
+
+class QSocketNotifier;
+
+/**
+ * Watches folder trees through a single inotify descriptor shared by the whole launcher. Linux only.
+ *
+ * Every folder below a watched root gets a watch, down to the depth asked for, including folders that are created or moved in later. The events of
+ * each root are folded by a FileEventQueue and handed out once the tree has been quiet for a moment, so a file being
+ * written in many small pieces is reported once.
+ */
+class InotifyWatcher : public QObject {
+    Q_OBJECT
+
+   public:
+    using Callback = std::function<void(const QList<FileEvent>&)>;
+
+    /** The shared watcher, or nullptr where inotify is not available. GUI thread only. */
+    static InotifyWatcher* instance();
+
+    /**
+     * Starts watching the tree below @p root. Returns an id for unwatch(), or -1 if the root can not be watched.
+     * With a @p depth of 0 or more only folders that many levels below the root are watched, and only what is in them is reported.
+     */
+    int watch(const QString& root, Callback callback, int depth = -1);
+    void unwatch(int id);
+    /**
+     * If the tree of @p id is still watched. A tree that can not be watched completely, usually because the system ran
+     * out of watches, is dropped after an Overflow event was handed out for it.
+     */
+    bool isWatching(int id) const;
+
+    /// how long a tree has to be quiet before its events are handed out
+    static constexpr int s_debounceMs = 100;
+    /// events are handed out after this long even if the tree keeps changing
+    static constexpr int s_maxDelayMs = 1000;
+
+   private:
+    explicit InotifyWatcher(int fd);
+    ~InotifyWatcher() override;
+
+    struct Client {
+        QString root;
+        int depth;
+        Callback callback;
+        FileEventQueue queue;
+        /// a folder in the tree could not be watched
+        bool lost = false;
+    };
+
+    void readEvents();
+    void flush();
+    void scheduleFlush();
+
+    /** Adds watches for @p folder and everything below it, reporting what is found in there as created if asked to. */
+    bool addFolder(const QString& folder, bool reportContents);
+    /** Removes the watches of @p folder and everything below it, except for folders other roots still need if asked to. */
+    void dropFolder(const QString& folder, bool keepWatched);
+    /** Keeps the watches of a folder that was moved within a watched tree. */
+    void renameFolder(const QString& from, const QString& to);
+    /** If @p folder is below one of the watched roots, and no deeper than that root is watched. */
+    bool needsWatch(const QString& folder) const;
+    void queue(const FileEvent& event);
+
+    int m_fd;
+    QSocketNotifier* m_notifier;
+    /// watch descriptor to folder and back
+    QHash<int, QString> m_folders;
+    QHash<QString, int> m_descriptors;
+    QHash<int, Client> m_clients;
+    int m_nextId = 0;
+
+    QTimer m_flushTimer;
+    QElapsedTimer m_pendingSince;
+};
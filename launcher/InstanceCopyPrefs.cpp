@@ -10,12 +10,7 @@ bool InstanceCopyPrefs::allTrue() const
            copyScreenshots;
 }
 
-// Returns a single RegEx string of the selected folders/files to filter out (ex: ".minecraft/saves|.minecraft/server.dat")
-QString InstanceCopyPrefs::getSelectedFiltersAsRegex() const
-{
-    return getSelectedFiltersAsRegex({});
-}
-QString InstanceCopyPrefs::getSelectedFiltersAsRegex(const QStringList& additionalFilters) const
+QStringList InstanceCopyPrefs::getSelectedFilters() const
 {
     QStringList filters;
 
@@ -45,18 +40,7 @@ QString InstanceCopyPrefs::getSelectedFiltersAsRegex(const QStringList& addition
     if (!copyScreenshots)
         filters << "screenshots";
 
-    for (auto filter : additionalFilters) {
-        filters << filter;
-    }
-
-    // If we have any filters to add, join them as a single regex string to return:
-    if (!filters.isEmpty()) {
-        const QString MC_ROOT = "[.]?minecraft/";
-        // Ensure first filter starts with root, then join other filters with OR regex before root (ex: ".minecraft/saves|.minecraft/mods"):
-        return MC_ROOT + filters.join("|" + MC_ROOT);
-    }
-
-    return {};
+    return filters;
 }
 
 // ======= Getters =======
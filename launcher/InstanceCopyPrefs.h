@@ -9,8 +9,8 @@
 struct InstanceCopyPrefs {
    public:
     bool allTrue() const;
-    QString getSelectedFiltersAsRegex() const;
-    QString getSelectedFiltersAsRegex(const QStringList& additionalFilters) const;
+    /// names of the files and folders in the game folder that should not be copied
+    QStringList getSelectedFilters() const;
     // Getters
     bool isCopySavesEnabled() const;
     bool isKeepPlaytimeEnabled() const;
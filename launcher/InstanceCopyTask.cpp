@@ -1,10 +1,9 @@
 #include "InstanceCopyTask.h"
 #include <QDebug>
-#include <QtConcurrentRun>
 #include <memory>
 #include "FileSystem.h"
 #include "NullInstance.h"
-#include "pathmatcher/RegexpMatcher.h"
+#include "pathmatcher/CompiledMatcher.h"
 #include "settings/INISettingsObject.h"
 #include "tasks/Task.h"
 
@@ -18,37 +17,36 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyP
     m_copySaves = prefs.isLinkRecursivelyEnabled() && prefs.isDontLinkSavesEnabled() && prefs.isCopySavesEnabled();
     m_useClone = prefs.isUseCloneEnabled();
 
-    QString filters = prefs.getSelectedFiltersAsRegex();
-    if (m_useLinks || m_useHardLinks) {
-        if (!filters.isEmpty())
-            filters += "|";
-        filters += "instance.cfg";
+    auto filters = prefs.getSelectedFilters();
+    auto linked = m_useLinks || m_useHardLinks;
+    if (!filters.isEmpty() || linked) {
+        // FIXME: get this from the original instance type...
+        // case-sensitive, like the RegexpMatcher it replaced
+        auto matcher = std::make_shared<CompiledMatcher>();
+        for (auto& filter : filters) {
+            for (auto root : { QString(".minecraft/"), QString("minecraft/") }) {
+                matcher->addPrefix(root + filter);
+                matcher->addPrefix(root + filter + "/");
+            }
+        }
+        if (linked)
+            matcher->addPrefix("instance.cfg");
+        m_matcher = matcher;
     }
 
     qDebug() << "CopyFilters:" << filters;
-
-    if (!filters.isEmpty()) {
-        // Set regex filter:
-        // FIXME: get this from the original instance type...
-        auto matcherReal = new RegexpMatcher(filters);
-        matcherReal->caseSensitive(false);
-        m_matcher.reset(matcherReal);
-    }
 }
 
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this] {
+    m_copyFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [this] {
         if (m_useClone) {
             FS::clone folderClone(m_origInstance->instanceRoot(), m_stagingPath);
-            folderClone.matcher(m_matcher);
+            folderClone.matcher(m_matcher).cancelled(m_cancel.flag());
 
-            folderClone(true);
-            setProgress(0, folderClone.totalCloned());
-            connect(&folderClone, &FS::clone::fileCloned,
-                    [this](QString src, QString dst) { setProgress(m_progress + 1, m_progressTotal); });
+            connect(&folderClone, &FS::clone::progress, [this](qint64 cloned, qint64 total) { setProgress(cloned, total); });
             return folderClone();
         }
         if (m_useLinks || m_useHardLinks) {
@@ -65,9 +63,10 @@ void InstanceCopyTask::executeTask()
 
                 savesCopy = std::make_unique<FS::copy>(FS::PathCombine(m_origInstance->gameRoot(), "saves"),
                                                        FS::PathCombine(staging_mc_dir, "saves"));
-                savesCopy->followSymlinks(true);
-                (*savesCopy)(true);
-                setProgress(0, savesCopy->totalCopied());
+                savesCopy->followSymlinks(true).cancelled(m_cancel.flag());
+                // the saves are copied after linking, and counted once they have been walked
+                connect(savesCopy.get(), &FS::copy::scanned,
+                        [this](qsizetype files, qint64) { setProgress(m_progress, m_progressTotal + files); });
                 connect(savesCopy.get(), &FS::copy::fileCopied, [this](QString src) { setProgress(m_progress + 1, m_progressTotal); });
             }
             FS::create_link folderLink(m_origInstance->instanceRoot(), m_stagingPath);
@@ -127,11 +126,9 @@ void InstanceCopyTask::executeTask()
             return !there_were_errors;
         }
         FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
-        folderCopy.followSymlinks(false).matcher(m_matcher);
+        folderCopy.followSymlinks(false).matcher(m_matcher).cancelled(m_cancel.flag());
 
-        folderCopy(true);
-        setProgress(0, folderCopy.totalCopied());
-        connect(&folderCopy, &FS::copy::fileCopied, [this](QString src) { setProgress(m_progress + 1, m_progressTotal); });
+        connect(&folderCopy, &FS::copy::progress, [this](qint64 copied, qint64 total) { setProgress(copied, total); });
         return folderCopy();
     });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
@@ -192,7 +189,7 @@ void InstanceCopyTask::copyAborted()
 bool InstanceCopyTask::abort()
 {
     if (m_copyFutureWatcher.isRunning()) {
-        m_copyFutureWatcher.cancel();
+        m_cancel.cancel();
         // NOTE: Here we don't do `emitAborted()` because it will be done when `m_copyFutureWatcher` actually cancels, which may not occur
         // immediately.
         return true;
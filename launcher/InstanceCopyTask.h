@@ -9,6 +9,7 @@
 #include "InstanceTask.h"
 #include "net/NetJob.h"
 #include "settings/SettingsObject.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 class InstanceCopyTask : public InstanceTask {
@@ -35,4 +36,6 @@ class InstanceCopyTask : public InstanceTask {
     bool m_copySaves = false;
     bool m_linkRecursively = false;
     bool m_useClone = false;
+    //! the running copy stops at the next file once this is cancelled
+    Executor::CancelToken m_cancel;
 };
@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "LZMA.h"
+
+#include <QCoreApplication>
+#include <QIODevice>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// This follows the structure of the LZMA specification's reference decoder.
+
+namespace LZMA {
+namespace {
+
+constexpr int s_probability_bits = 11;
+constexpr uint32_t s_probability_init = (1 << s_probability_bits) / 2;
+constexpr uint32_t s_top_value = 1 << 24;
+constexpr uint32_t s_min_dictionary = 1 << 12;
+
+constexpr int s_position_bits_max = 4;
+constexpr int s_states = 12;
+constexpr int s_len_to_pos_states = 4;
+constexpr int s_align_bits = 4;
+constexpr int s_start_pos_model = 4;
+constexpr int s_end_pos_model = 14;
+constexpr int s_full_distances = 1 << (s_end_pos_model >> 1);
+constexpr int s_match_min_len = 2;
+
+using Probability = uint16_t;
+
+struct Failure {
+    QString reason;
+};
+
+QString tr(const char* text)
+{
+    return QCoreApplication::translate("LZMA", text);
+}
+
+/** Buffered byte source, which fails once the input runs out. */
+class Input {
+   public:
+    Input(QIODevice* device, const std::atomic_bool* cancelled) : m_device(device), m_cancelled(cancelled), m_buffer(64 * 1024) {}
+
+    uint8_t next()
+    {
+        if (m_pos == m_end) {
+            if (m_cancelled && *m_cancelled)
+                throw Failure{ tr("Cancelled") };
+            auto read = m_device->read(m_buffer.data(), m_buffer.size());
+            if (read < 0)
+                throw Failure{ m_device->errorString() };
+            if (read == 0)
+                throw Failure{ tr("The compressed data ended unexpectedly") };
+            m_pos = 0;
+            m_end = read;
+        }
+        return static_cast<uint8_t>(m_buffer[m_pos++]);
+    }
+
+   private:
+    QIODevice* m_device;
+    const std::atomic_bool* m_cancelled;
+    std::vector<char> m_buffer;
+    qint64 m_pos = 0;
+    qint64 m_end = 0;
+};
+
+/**
+ * The sliding dictionary, written out each time it wraps around.
+ *
+ * It only grows as the data fills it, so a corrupt header can't make it allocate the 4 GiB a dictionary size allows.
+ */
+class Window {
+   public:
+    Window(QIODevice* device, uint32_t size) : m_device(device), m_size(size) {}
+
+    void put(uint8_t byte)
+    {
+        if (m_pos == m_buffer.size())
+            m_buffer.resize(std::min<size_t>(m_size, std::max<size_t>(m_buffer.size() * 2, 64 * 1024)));
+        m_total++;
+        m_buffer[m_pos++] = byte;
+        if (m_pos == m_size) {
+            flush();
+            m_pos = 0;
+            m_full = true;
+        }
+    }
+
+    uint8_t get(uint32_t distance) const { return m_buffer[distance <= m_pos ? m_pos - distance : m_buffer.size() - distance + m_pos]; }
+
+    void copyMatch(uint32_t distance, uint32_t length)
+    {
+        for (; length > 0; length--)
+            put(get(distance));
+    }
+
+    bool hasDistance(uint32_t distance) const { return distance <= m_pos || m_full; }
+    bool isEmpty() const { return m_pos == 0 && !m_full; }
+    uint64_t total() const { return m_total; }
+
+    void flush()
+    {
+        if (m_pos == m_flushed)
+            return;
+        auto size = static_cast<qint64>(m_pos - m_flushed);
+        if (m_device->write(reinterpret_cast<const char*>(m_buffer.data() + m_flushed), size) != size)
+            throw Failure{ m_device->errorString() };
+        m_flushed = m_pos == m_size ? 0 : m_pos;
+    }
+
+   private:
+    QIODevice* m_device;
+    size_t m_size;
+    std::vector<uint8_t> m_buffer;
+    size_t m_pos = 0;
+    size_t m_flushed = 0;
+    bool m_full = false;
+    uint64_t m_total = 0;
+};
+
+class RangeDecoder {
+   public:
+    explicit RangeDecoder(Input& input) : m_input(input)
+    {
+        if (m_input.next() != 0)
+            throw Failure{ tr("The compressed data is corrupt") };
+        for (int i = 0; i < 4; i++)
+            m_code = (m_code << 8) | m_input.next();
+        if (m_code == m_range)
+            throw Failure{ tr("The compressed data is corrupt") };
+    }
+
+    bool finishedOk() const { return m_code == 0; }
+
+    uint32_t directBits(int count)
+    {
+        uint32_t result = 0;
+        do {
+            m_range >>= 1;
+            m_code -= m_range;
+            uint32_t t = 0 - (m_code >> 31);
+            m_code += m_range & t;
+            if (m_code == m_range)
+                throw Failure{ tr("The compressed data is corrupt") };
+            normalize();
+            result = (result << 1) + (t + 1);
+        } while (--count);
+        return result;
+    }
+
+    unsigned bit(Probability* probability)
+    {
+        unsigned value = *probability;
+        uint32_t bound = (m_range >> s_probability_bits) * value;
+        unsigned symbol;
+        if (m_code < bound) {
+            value += ((1 << s_probability_bits) - value) >> 5;
+            m_range = bound;
+            symbol = 0;
+        } else {
+            value -= value >> 5;
+            m_code -= bound;
+            m_range -= bound;
+            symbol = 1;
+        }
+        *probability = static_cast<Probability>(value);
+        normalize();
+        return symbol;
+    }
+
+    unsigned tree(Probability* probabilities, int bits)
+    {
+        unsigned m = 1;
+        for (int i = 0; i < bits; i++)
+            m = (m << 1) + bit(&probabilities[m]);
+        return m - (1u << bits);
+    }
+
+    unsigned reverseTree(Probability* probabilities, int bits)
+    {
+        unsigned m = 1;
+        unsigned symbol = 0;
+        for (int i = 0; i < bits; i++) {
+            unsigned b = bit(&probabilities[m]);
+            m = (m << 1) + b;
+            symbol |= b << i;
+        }
+        return symbol;
+    }
+
+   private:
+    void normalize()
+    {
+        if (m_range < s_top_value) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | m_input.next();
+        }
+    }
+
+    Input& m_input;
+    uint32_t m_range = 0xFFFFFFFF;
+    uint32_t m_code = 0;
+};
+
+class LengthDecoder {
+   public:
+    LengthDecoder()
+    {
+        std::fill(std::begin(m_low), std::end(m_low), s_probability_init);
+        std::fill(std::begin(m_mid), std::end(m_mid), s_probability_init);
+        std::fill(std::begin(m_high), std::end(m_high), s_probability_init);
+    }
+
+    unsigned decode(RangeDecoder& rc, unsigned posState)
+    {
+        if (rc.bit(&m_choice) == 0)
+            return rc.tree(&m_low[posState << 3], 3);
+        if (rc.bit(&m_choice2) == 0)
+            return 8 + rc.tree(&m_mid[posState << 3], 3);
+        return 16 + rc.tree(m_high, 8);
+    }
+
+   private:
+    Probability m_choice = s_probability_init;
+    Probability m_choice2 = s_probability_init;
+    Probability m_low[(1 << s_position_bits_max) << 3];
+    Probability m_mid[(1 << s_position_bits_max) << 3];
+    Probability m_high[1 << 8];
+};
+
+class Decoder {
+   public:
+    Decoder(Input& input, Window& window, unsigned properties, uint32_t dictionary)
+        : m_rc(input), m_window(window), m_dictionary(dictionary)
+    {
+        m_lc = properties % 9;
+        properties /= 9;
+        m_lp = properties % 5;
+        m_pb = properties / 5;
+
+        m_literals.assign(0x300u << (m_lc + m_lp), s_probability_init);
+        for (auto& slot : m_pos_slot)
+            std::fill(std::begin(slot), std::end(slot), s_probability_init);
+        std::fill(std::begin(m_pos), std::end(m_pos), s_probability_init);
+        std::fill(std::begin(m_align), std::end(m_align), s_probability_init);
+        std::fill(std::begin(m_is_match), std::end(m_is_match), s_probability_init);
+        std::fill(std::begin(m_is_rep), std::end(m_is_rep), s_probability_init);
+        std::fill(std::begin(m_is_rep_g0), std::end(m_is_rep_g0), s_probability_init);
+        std::fill(std::begin(m_is_rep_g1), std::end(m_is_rep_g1), s_probability_init);
+        std::fill(std::begin(m_is_rep_g2), std::end(m_is_rep_g2), s_probability_init);
+        std::fill(std::begin(m_is_rep0_long), std::end(m_is_rep0_long), s_probability_init);
+    }
+
+    /** Decodes until the end marker, or until @p remaining bytes are out if the size is known. */
+    void run(bool sizeKnown, uint64_t remaining)
+    {
+        auto corrupt = [] { return Failure{ tr("The compressed data is corrupt") }; };
+        uint32_t rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+        unsigned state = 0;
+
+        for (;;) {
+            if (sizeKnown && remaining == 0 && m_rc.finishedOk())
+                return;
+
+            unsigned posState = m_window.total() & ((1u << m_pb) - 1);
+            if (m_rc.bit(&m_is_match[(state << s_position_bits_max) + posState]) == 0) {
+                if (sizeKnown && remaining == 0)
+                    throw corrupt();
+                literal(state, rep0);
+                state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+                remaining--;
+                continue;
+            }
+
+            unsigned length;
+            if (m_rc.bit(&m_is_rep[state]) != 0) {
+                if ((sizeKnown && remaining == 0) || m_window.isEmpty())
+                    throw corrupt();
+                if (m_rc.bit(&m_is_rep_g0[state]) == 0) {
+                    if (m_rc.bit(&m_is_rep0_long[(state << s_position_bits_max) + posState]) == 0) {
+                        // a single byte from the last distance
+                        state = state < 7 ? 9 : 11;
+                        m_window.put(m_window.get(rep0 + 1));
+                        remaining--;
+                        continue;
+                    }
+                } else {
+                    uint32_t distance;
+                    if (m_rc.bit(&m_is_rep_g1[state]) == 0) {
+                        distance = rep1;
+                    } else {
+                        if (m_rc.bit(&m_is_rep_g2[state]) == 0) {
+                            distance = rep2;
+                        } else {
+                            distance = rep3;
+                            rep3 = rep2;
+                        }
+                        rep2 = rep1;
+                    }
+                    rep1 = rep0;
+                    rep0 = distance;
+                }
+                length = m_rep_length.decode(m_rc, posState);
+                state = state < 7 ? 8 : 11;
+            } else {
+                rep3 = rep2;
+                rep2 = rep1;
+                rep1 = rep0;
+                length = m_length.decode(m_rc, posState);
+                state = state < 7 ? 7 : 10;
+                rep0 = distance(length);
+                if (rep0 == 0xFFFFFFFF) {
+                    // end marker
+                    if (!m_rc.finishedOk() || (sizeKnown && remaining != 0))
+                        throw corrupt();
+                    return;
+                }
+                if ((sizeKnown && remaining == 0) || rep0 >= m_dictionary || !m_window.hasDistance(rep0))
+                    throw corrupt();
+            }
+
+            length += s_match_min_len;
+            if (sizeKnown && remaining < length)
+                throw corrupt();
+            m_window.copyMatch(rep0 + 1, length);
+            remaining -= length;
+        }
+    }
+
+   private:
+    void literal(unsigned state, uint32_t rep0)
+    {
+        unsigned previous = m_window.isEmpty() ? 0 : m_window.get(1);
+        unsigned literalState = ((m_window.total() & ((1u << m_lp) - 1)) << m_lc) + (previous >> (8 - m_lc));
+        Probability* probabilities = &m_literals[0x300u * literalState];
+
+        unsigned symbol = 1;
+        if (state >= 7) {
+            unsigned matchByte = m_window.get(rep0 + 1);
+            do {
+                unsigned matchBit = (matchByte >> 7) & 1;
+                matchByte <<= 1;
+                unsigned b = m_rc.bit(&probabilities[((1 + matchBit) << 8) + symbol]);
+                symbol = (symbol << 1) | b;
+                if (matchBit != b)
+                    break;
+            } while (symbol < 0x100);
+        }
+        while (symbol < 0x100)
+            symbol = (symbol << 1) | m_rc.bit(&probabilities[symbol]);
+        m_window.put(static_cast<uint8_t>(symbol - 0x100));
+    }
+
+    uint32_t distance(unsigned length)
+    {
+        unsigned lenState = std::min(length, unsigned(s_len_to_pos_states - 1));
+        unsigned posSlot = m_rc.tree(m_pos_slot[lenState], 6);
+        if (posSlot < s_start_pos_model)
+            return posSlot;
+
+        int directBits = static_cast<int>(posSlot >> 1) - 1;
+        uint32_t distance = (2 | (posSlot & 1)) << directBits;
+        if (posSlot < s_end_pos_model) {
+            distance += m_rc.reverseTree(&m_pos[distance - posSlot], directBits);
+        } else {
+            distance += m_rc.directBits(directBits - s_align_bits) << s_align_bits;
+            distance += m_rc.reverseTree(m_align, s_align_bits);
+        }
+        return distance;
+    }
+
+    RangeDecoder m_rc;
+    Window& m_window;
+    uint32_t m_dictionary;
+    unsigned m_lc, m_lp, m_pb;
+
+    std::vector<Probability> m_literals;
+    Probability m_pos_slot[s_len_to_pos_states][1 << 6];
+    Probability m_pos[1 + s_full_distances - s_end_pos_model];
+    Probability m_align[1 << s_align_bits];
+    Probability m_is_match[s_states << s_position_bits_max];
+    Probability m_is_rep[s_states];
+    Probability m_is_rep_g0[s_states];
+    Probability m_is_rep_g1[s_states];
+    Probability m_is_rep_g2[s_states];
+    Probability m_is_rep0_long[s_states << s_position_bits_max];
+    LengthDecoder m_length;
+    LengthDecoder m_rep_length;
+};
+
+}  // namespace
+
+bool decode(QIODevice* in, QIODevice* out, QString* error, const std::atomic_bool* cancelled)
+{
+    try {
+        Input input(in, cancelled);
+
+        // 1 byte of literal/position properties, the dictionary size and the decoded size
+        unsigned properties = input.next();
+        if (properties >= 9 * 5 * 5)
+            throw Failure{ tr("The compressed data is corrupt") };
+        uint32_t dictionary = 0;
+        for (int i = 0; i < 4; i++)
+            dictionary |= uint32_t(input.next()) << (8 * i);
+        uint64_t size = 0;
+        bool sizeKnown = false;
+        for (int i = 0; i < 8; i++) {
+            uint8_t b = input.next();
+            if (b != 0xFF)
+                sizeKnown = true;
+            size |= uint64_t(b) << (8 * i);
+        }
+
+        // the window never needs to be larger than what it decodes to
+        uint64_t windowSize = std::max(dictionary, s_min_dictionary);
+        if (sizeKnown)
+            windowSize = std::max<uint64_t>(std::min<uint64_t>(windowSize, size), s_min_dictionary);
+
+        Window window(out, static_cast<uint32_t>(windowSize));
+        Decoder decoder(input, window, properties, std::max(dictionary, s_min_dictionary));
+        decoder.run(sizeKnown, size);
+        window.flush();
+    } catch (const Failure& failure) {
+        if (error)
+            *error = failure.reason;
+        return false;
+    } catch (const std::bad_alloc&) {
+        if (error)
+            *error = tr("Not enough memory to decompress the data");
+        return false;
+    }
+    return true;
+}
+
+}  // namespace LZMA
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+
+class QIODevice;
+
+/**
+ * Decoder for the legacy .lzma format (LZMA "alone"), which Mojang serves next to every raw file of its Java runtimes.
+ *
+ * The decoder only keeps the dictionary in memory, so files of any size stream from one device to the other.
+ */
+namespace LZMA {
+
+/**
+ * Decodes everything from @p in into @p out.
+ *
+ * Returns false on corrupt or truncated input, a write error or cancellation, with the reason in @p error.
+ */
+bool decode(QIODevice* in, QIODevice* out, QString* error = nullptr, const std::atomic_bool* cancelled = nullptr);
+
+}  // namespace LZMA
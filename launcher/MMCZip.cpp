@@ -43,11 +43,13 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFileInfo>
+#include <QMutex>
+#include <QThreadPool>
 #include <QUrl>
+#include <QWaitCondition>
+
+#include <zlib.h>
 
-#if defined(LAUNCHER_APPLICATION)
-#include <QtConcurrentRun>
-#endif
 
 namespace MMCZip {
 // ours
@@ -267,34 +269,135 @@ bool findFilesInZip(QuaZip* zip, const QString& what, QStringList& result, const
     return !result.isEmpty();
 }
 
-// ours
-std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, const QString& target)
+namespace {
+
+struct ExtractEntry {
+    int index;
+    QString name;
+    QString target;
+    bool stored;
+    qint64 size;
+    quint32 crc;
+};
+
+void fixPermissions(const QString& target_file_path)
+{
+    auto fileInfo = QFileInfo(target_file_path);
+    if (fileInfo.isFile()) {
+        auto permissions = fileInfo.permissions();
+        auto maxPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser |
+                             QFileDevice::Permission::ReadGroup | QFileDevice::Permission::ReadOther;
+        auto minPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
+
+        auto newPermisions = (permissions & maxPermisions) | minPermisions;
+        if (newPermisions != permissions) {
+            if (!QFile::setPermissions(target_file_path, newPermisions)) {
+                qWarning() << (QObject::tr("Could not fix permissions for %1").arg(target_file_path));
+            }
+        }
+    } else if (fileInfo.isDir()) {
+        // Ensure the folder has the minimal required permissions
+        QFile::Permissions minimalPermissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner | QFile::ReadGroup |
+                                                QFile::ExeGroup | QFile::ReadOther | QFile::ExeOther;
+
+        QFile::Permissions currentPermissions = fileInfo.permissions();
+        if ((currentPermissions & minimalPermissions) != minimalPermissions) {
+            if (!QFile::setPermissions(target_file_path, minimalPermissions)) {
+                qWarning() << (QObject::tr("Could not fix permissions for %1").arg(target_file_path));
+            }
+        }
+    }
+}
+
+//! moves the current file of the archive to the entry at index, only going back to the start if it has to
+bool seekEntry(QuaZip* zip, int& cursor, int index)
+{
+    if (cursor < 0 || index < cursor) {
+        if (!zip->goToFirstFile())
+            return false;
+        cursor = 0;
+    }
+    for (; cursor < index; cursor++) {
+        if (!zip->goToNextFile())
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Stored entries don't need inflating, so their data is read straight out of the archive from the offset the entry
+ * starts at, without going through QuaZipFile's small buffers.
+ */
+bool extractStored(QuaZip* zip, QFile& archive, const ExtractEntry& entry, const std::atomic_bool* cancelled)
+{
+    static constexpr qint64 s_bufferSize = 1024 * 1024;
+
+    QuaZipFileInfo64 info;
+    if (!zip->getCurrentFileInfo(&info))
+        return false;
+    QuaZipFile in(zip);
+    if (!in.open(QIODevice::ReadOnly))
+        return false;
+    auto offset = static_cast<qint64>(unzGetCurrentFileZStreamPos64(zip->getUnzFile()));
+    in.close();
+
+    QFile out(entry.target);
+    if (!archive.seek(offset) || !out.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray buffer(qMin(entry.size, s_bufferSize), Qt::Uninitialized);
+    uLong crc = crc32(0, nullptr, 0);
+    qint64 remaining = entry.size;
+    while (remaining > 0 && !(cancelled && *cancelled)) {
+        auto count = archive.read(buffer.data(), qMin<qint64>(remaining, buffer.size()));
+        if (count <= 0 || out.write(buffer.constData(), count) != count)
+            break;
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer.constData()), static_cast<uInt>(count));
+        remaining -= count;
+    }
+    out.close();
+    if (remaining > 0 || crc != entry.crc || out.error() != QFileDevice::NoError) {
+        out.remove();
+        return false;
+    }
+
+    if (auto permissions = info.getPermissions(); permissions != 0)
+        out.setPermissions(permissions);
+    return true;
+}
+
+}  // namespace
+
+ParallelExtractor::Error ParallelExtractor::operator()()
 {
-    auto target_top_dir = QUrl::fromLocalFile(target);
+    auto target_top_dir = QUrl::fromLocalFile(m_target);
 
-    QStringList extracted;
+    m_extracted.clear();
 
-    qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
-    auto numEntries = zip->getEntriesCount();
+    qDebug() << "Extracting subdir" << m_subdir << "from" << m_zip->getZipName() << "to" << m_target;
+    auto numEntries = m_zip->getEntriesCount();
     if (numEntries < 0) {
-        qWarning() << "Failed to enumerate files in archive";
-        return std::nullopt;
+        return QObject::tr("Failed to enumerate files in archive");
     } else if (numEntries == 0) {
         qDebug() << "Extracting empty archives seems odd...";
-        return extracted;
-    } else if (!zip->goToFirstFile()) {
-        qWarning() << "Failed to seek to first file in zip";
-        return std::nullopt;
+        return {};
+    } else if (!m_zip->goToFirstFile()) {
+        return QObject::tr("Failed to seek to first file in zip");
     }
 
+    // 1. Read the central directory and work out where everything goes
+    QList<ExtractEntry> entries;
+    QSet<QString> folders;
+    qint64 total_size = 0;
+    int index = 0;
     do {
-        QString file_name = zip->getCurrentFileName();
-        file_name = FS::RemoveInvalidPathChars(file_name);
-        if (!file_name.startsWith(subdir))
+        QString file_name = m_zip->getCurrentFileName();
+        if (m_removeInvalidPathChars)
+            file_name = FS::RemoveInvalidPathChars(file_name);
+        if (!file_name.startsWith(m_subdir))
             continue;
 
-        auto relative_file_name = QDir::fromNativeSeparators(file_name.mid(subdir.size()));
-        auto original_name = relative_file_name;
+        auto relative_file_name = QDir::fromNativeSeparators(file_name.mid(m_subdir.size()));
 
         // Fix subdirs/files ending with a / getting transformed into absolute paths
         if (relative_file_name.startsWith('/'))
@@ -304,14 +407,14 @@ std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, con
         QString sub_path;
         if (relative_file_name.contains('/') && !relative_file_name.endsWith('/')) {
             sub_path = relative_file_name.section('/', 0, -2) + '/';
-            FS::ensureFolderPathExists(FS::PathCombine(target, sub_path));
+            folders.insert(FS::PathCombine(m_target, sub_path));
 
             relative_file_name = relative_file_name.split('/').last();
         }
 
         QString target_file_path;
         if (relative_file_name.isEmpty()) {
-            target_file_path = target + '/';
+            target_file_path = m_target + '/';
         } else {
             target_file_path = FS::PathCombine(target_top_dir.toLocalFile(), sub_path, relative_file_name);
             if (relative_file_name.endsWith('/') && !target_file_path.endsWith('/'))
@@ -319,47 +422,120 @@ std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, con
         }
 
         if (!target_top_dir.isParentOf(QUrl::fromLocalFile(target_file_path))) {
-            qWarning() << "Extracting" << relative_file_name << "was cancelled, because it was effectively outside of the target path"
-                       << target;
-            return std::nullopt;
-        }
-
-        if (!JlCompress::extractFile(zip, "", target_file_path)) {
-            qWarning() << "Failed to extract file" << original_name << "to" << target_file_path;
-            JlCompress::removeFile(extracted);
-            return std::nullopt;
+            return QObject::tr("Extracting %1 was cancelled, because it was effectively outside of the target path %2")
+                .arg(relative_file_name, m_target);
         }
 
-        extracted.append(target_file_path);
-        auto fileInfo = QFileInfo(target_file_path);
-        if (fileInfo.isFile()) {
-            auto permissions = fileInfo.permissions();
-            auto maxPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser |
-                                 QFileDevice::Permission::ReadGroup | QFileDevice::Permission::ReadOther;
-            auto minPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-
-            auto newPermisions = (permissions & maxPermisions) | minPermisions;
-            if (newPermisions != permissions) {
-                if (!QFile::setPermissions(target_file_path, newPermisions)) {
-                    qWarning() << (QObject::tr("Could not fix permissions for %1").arg(target_file_path));
-                }
+        QuaZipFileInfo64 info;
+        if (!m_zip->getCurrentFileInfo(&info))
+            return QObject::tr("Failed to read the details of %1").arg(file_name);
+
+        // encrypted entries and links are left to JlCompress
+        bool stored = info.method == 0 && !(info.flags & 1) && !info.isSymbolicLink() && !target_file_path.endsWith('/');
+        entries.append({ index, sub_path + relative_file_name, target_file_path, stored, static_cast<qint64>(info.uncompressedSize),
+                         info.crc });
+        total_size += info.uncompressedSize;
+    } while (index++, m_zip->goToNextFile());
+
+    // 2. Make the folders, so the workers don't have to
+    for (auto& folder : folders)
+        FS::ensureFolderPathExists(folder);
+
+    // 3. Extract
+    // only an archive opened by name can be opened again for the other workers
+    auto archive_name = m_zip->getZipName();
+    bool by_name = !archive_name.isEmpty() && QFileInfo(archive_name).isFile();
+    auto workers = by_name ? static_cast<int>(qBound<qsizetype>(1, m_workers, entries.size())) : 1;
+
+    QMutex lock;
+    Error error;
+    std::atomic<qsizetype> next = 0;
+    std::atomic_bool failed = false;
+    qint64 extracted_size = 0;
+    QList<bool> done(entries.size(), false);
+
+    auto work = [&](QuaZip* zip) {
+        // stored entries are read through this, falling back to JlCompress without it
+        QFile archive(archive_name);
+        if (by_name)
+            archive.open(QIODevice::ReadOnly);
+        int cursor = -1;
+
+        while (!failed) {
+            if (m_cancelled && *m_cancelled) {
+                QMutexLocker locker(&lock);
+                if (!error)
+                    error = QObject::tr("Extraction was cancelled");
+                failed = true;
+                return;
             }
-        } else if (fileInfo.isDir()) {
-            // Ensure the folder has the minimal required permissions
-            QFile::Permissions minimalPermissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner | QFile::ReadGroup |
-                                                    QFile::ExeGroup | QFile::ReadOther | QFile::ExeOther;
-
-            QFile::Permissions currentPermissions = fileInfo.permissions();
-            if ((currentPermissions & minimalPermissions) != minimalPermissions) {
-                if (!QFile::setPermissions(target_file_path, minimalPermissions)) {
-                    qWarning() << (QObject::tr("Could not fix permissions for %1").arg(target_file_path));
-                }
+            auto i = next++;
+            if (i >= entries.size())
+                return;
+            auto& entry = entries.at(i);
+
+            bool ok = seekEntry(zip, cursor, entry.index);
+            if (ok && entry.stored && archive.isOpen())
+                ok = extractStored(zip, archive, entry, m_cancelled);
+            else if (ok)
+                ok = JlCompress::extractFile(zip, "", entry.target);
+            if (ok)
+                fixPermissions(entry.target);
+
+            QMutexLocker locker(&lock);
+            if (!ok) {
+                if (!error)
+                    error = QObject::tr("Failed to extract file %1 to %2").arg(entry.name, entry.target);
+                failed = true;
+                return;
             }
+            done[i] = true;
+            extracted_size += entry.size;
+            if (m_progress)
+                m_progress(extracted_size, total_size, entry.name);
         }
-        qDebug() << "Extracted file" << relative_file_name << "to" << target_file_path;
-    } while (zip->goToNextFile());
+    };
 
-    return extracted;
+    if (workers <= 1) {
+        work(m_zip);
+    } else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(workers - 1);
+        for (int i = 0; i < workers - 1; i++) {
+            pool.start([&work, &archive_name, this] {
+                QuaZip zip(archive_name);
+                zip.setUtf8Enabled(m_zip->isUtf8Enabled());
+                if (zip.open(QuaZip::mdUnzip))
+                    work(&zip);
+            });
+        }
+        work(m_zip);
+        pool.waitForDone();
+    }
+
+    for (qsizetype i = 0; i < entries.size(); i++) {
+        if (done[i])
+            m_extracted.append(entries[i].target);
+    }
+    if (error) {
+        JlCompress::removeFile(m_extracted);
+        m_extracted.clear();
+        return error;
+    }
+    qDebug() << "Extracted" << m_extracted.size() << "files to" << m_target;
+    return {};
+}
+
+// ours
+std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, const QString& target)
+{
+    ParallelExtractor extractor(zip, subdir, target);
+    extractor.removeInvalidPathChars(true);
+    if (auto error = extractor(); error.has_value()) {
+        qWarning() << error.value();
+        return std::nullopt;
+    }
+    return extractor.extracted();
 }
 
 // ours
@@ -418,6 +594,223 @@ bool extractFile(QString fileCompressed, QString file, QString target)
     return extractRelFile(&zip, file, target);
 }
 
+namespace {
+
+struct WriteBlock {
+    int entry;
+    qint64 offset;
+    bool first;
+    bool last;
+};
+
+struct WrittenBlock {
+    QByteArray data;
+    quint32 crc = 0;
+    qint64 size = 0;
+    QString error;
+};
+
+// big enough for deflate to find its matches, small enough that a few of them per thread don't matter
+constexpr qint64 s_blockSize = 1024 * 1024;
+// deflate's window, which is read along with every block to keep the ratio close to one continuous stream
+constexpr qint64 s_dictionarySize = 32 * 1024;
+
+/**
+ * Deflates a single block of an entry into a raw deflate stream that can be appended to the previous block's.
+ * Every block but the last is byte aligned with a sync flush, like pigz does.
+ */
+bool deflateBlock(const QByteArray& dictionary, const QByteArray& input, bool last, int level, QByteArray& output)
+{
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    if (!dictionary.isEmpty())
+        deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()), static_cast<uInt>(dictionary.size()));
+
+    // the bound doesn't cover the empty block a sync flush adds
+    output.resize(static_cast<qsizetype>(deflateBound(&stream, static_cast<uLong>(input.size()))) + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.constData()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result;
+    do {
+        if (stream.avail_out == 0) {
+            auto written = output.size();
+            output.resize(written * 2);
+            stream.next_out = reinterpret_cast<Bytef*>(output.data() + written);
+            stream.avail_out = static_cast<uInt>(output.size() - written);
+        }
+        result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    } while (result == Z_OK && (last || stream.avail_out == 0));
+
+    output.resize(static_cast<qsizetype>(stream.total_out));
+    deflateEnd(&stream);
+    return last ? result == Z_STREAM_END : (result == Z_OK || result == Z_BUF_ERROR);
+}
+
+}  // namespace
+
+bool ParallelZipWriter::isAlreadyCompressed(const QString& name)
+{
+    static const QStringList s_compressed = { "jar", "zip", "png", "ogg", "jpg", "jpeg", "gz", "xz", "7z", "mp3", "webp" };
+    return s_compressed.contains(QFileInfo(name).suffix(), Qt::CaseInsensitive);
+}
+
+void ParallelZipWriter::addFile(const QString& source, const QString& name)
+{
+    m_entries.append({ name, source, {} });
+}
+
+void ParallelZipWriter::addData(const QString& name, const QByteArray& data)
+{
+    m_entries.append({ name, {}, data });
+}
+
+ParallelZipWriter::Error ParallelZipWriter::operator()()
+{
+    // 1. Cut everything into blocks
+    QList<WriteBlock> blocks;
+    qint64 total_size = 0;
+    for (int i = 0; i < m_entries.size(); i++) {
+        auto& entry = m_entries.at(i);
+        qint64 size = entry.source.isEmpty() ? entry.data.size() : QFileInfo(entry.source).size();
+        total_size += size;
+        for (qint64 offset = 0; offset == 0 || offset < size; offset += s_blockSize)
+            blocks.append({ i, offset, offset == 0, offset + s_blockSize >= size });
+    }
+    auto storedEntry = [this](const Entry& entry) { return m_level == 0 || isAlreadyCompressed(entry.name); };
+
+    // 2. Deflate blocks on the pool, a few ahead of the block being written
+    QMutex lock;
+    QWaitCondition changed;
+    QHash<qsizetype, WrittenBlock> ready;
+    qsizetype next = 0;
+    qsizetype written = 0;
+    bool stop = false;
+    auto workers = qMax(1, m_workers);
+    auto window = 2 * workers;
+
+    auto work = [&] {
+        QMutexLocker locker(&lock);
+        while (true) {
+            while (!stop && next < blocks.size() && next >= written + window)
+                changed.wait(&lock);
+            if (stop || next >= blocks.size())
+                return;
+            auto index = next++;
+            locker.unlock();
+
+            auto& block = blocks.at(index);
+            auto& entry = m_entries.at(block.entry);
+            bool stored = storedEntry(entry);
+            WrittenBlock result;
+            QByteArray dictionary;
+            QByteArray input;
+            if (entry.source.isEmpty()) {
+                input = entry.data.mid(block.offset, s_blockSize);
+                if (!stored && block.offset > 0)
+                    dictionary = entry.data.mid(block.offset - s_dictionarySize, s_dictionarySize);
+            } else {
+                QFile file(entry.source);
+                auto dictionary_start = stored ? block.offset : qMax<qint64>(0, block.offset - s_dictionarySize);
+                if (!file.open(QIODevice::ReadOnly) || !file.seek(dictionary_start)) {
+                    result.error = QObject::tr("Could not read and compress %1").arg(entry.name);
+                } else {
+                    dictionary = file.read(block.offset - dictionary_start);
+                    // a file that grew since it was measured is cut off at the end of its last block
+                    input = file.read(s_blockSize);
+                    if (file.error() != QFileDevice::NoError)
+                        result.error = QObject::tr("Could not read and compress %1").arg(entry.name);
+                }
+            }
+            if (result.error.isEmpty()) {
+                result.crc = crc32(0, reinterpret_cast<const Bytef*>(input.constData()), static_cast<uInt>(input.size()));
+                result.size = input.size();
+                if (stored)
+                    result.data = input;
+                else if (!deflateBlock(dictionary, input, block.last, m_level, result.data))
+                    result.error = QObject::tr("Could not read and compress %1").arg(entry.name);
+            }
+
+            locker.relock();
+            ready.insert(index, result);
+            changed.wakeAll();
+        }
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(workers);
+    for (int i = 0; i < workers; i++)
+        pool.start(work);
+
+    // 3. Write the blocks in order as they come in
+    Error error;
+    std::unique_ptr<QuaZipFile> current;
+    uLong crc = 0;
+    qint64 size = 0;
+    qint64 written_size = 0;
+    for (qsizetype index = 0; index < blocks.size(); index++) {
+        if (m_cancelled && *m_cancelled) {
+            error = QObject::tr("Writing the archive was cancelled");
+            break;
+        }
+        QMutexLocker locker(&lock);
+        while (!ready.contains(index))
+            changed.wait(&lock);
+        auto result = ready.take(index);
+        written = index + 1;
+        changed.wakeAll();
+        locker.unlock();
+
+        auto& block = blocks.at(index);
+        auto& entry = m_entries.at(block.entry);
+        if (!result.error.isEmpty()) {
+            error = result.error;
+            break;
+        }
+
+        if (block.first) {
+            auto info = entry.source.isEmpty() ? QuaZipNewInfo(entry.name) : QuaZipNewInfo(entry.name, entry.source);
+            bool stored = storedEntry(entry);
+            current = std::make_unique<QuaZipFile>(m_zip);
+            if (!current->open(QIODevice::WriteOnly, info, nullptr, 0, stored ? 0 : Z_DEFLATED, stored ? 0 : m_level, true)) {
+                error = QObject::tr("Could not create: %1").arg(entry.name);
+                break;
+            }
+            crc = crc32(0, nullptr, 0);
+            size = 0;
+        }
+        if (current->write(result.data) != result.data.size()) {
+            error = QObject::tr("Could not write %1").arg(entry.name);
+            break;
+        }
+        crc = crc32_combine(crc, result.crc, result.size);
+        size += result.size;
+        if (block.last) {
+            current->closeRaw(size, crc);
+            if (current->getZipError() != ZIP_OK) {
+                error = QObject::tr("Could not write %1").arg(entry.name);
+                break;
+            }
+            current.reset();
+        }
+
+        written_size += result.size;
+        if (m_progress)
+            m_progress(written_size, total_size, entry.name);
+    }
+
+    {
+        QMutexLocker locker(&lock);
+        stop = true;
+        changed.wakeAll();
+    }
+    pool.waitForDone();
+    return error;
+}
+
 bool collectFileListRecursively(const QString& rootDir, const QString& subDir, QFileInfoList* files, FilterFileFunction excludeFilter)
 {
     QDir rootDirectory(rootDir);
@@ -458,8 +851,7 @@ bool collectFileListRecursively(const QString& rootDir, const QString& subDir, Q
 void ExportToZipTask::executeTask()
 {
     setStatus("Adding files...");
-    setProgress(0, m_files.length());
-    m_build_zip_future = QtConcurrent::run(QThreadPool::globalInstance(), [this]() { return exportZip(); });
+    m_build_zip_future = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [this]() { return exportZip(); });
     connect(&m_build_zip_watcher, &QFutureWatcher<ZipResult>::finished, this, &ExportToZipTask::finish);
     m_build_zip_watcher.setFuture(m_build_zip_future);
 }
@@ -473,34 +865,31 @@ auto ExportToZipTask::exportZip() -> ZipResult
         return ZipResult(tr("Could not create file"));
     }
 
-    for (auto fileName : m_extra_files.keys()) {
-        if (m_build_zip_future.isCanceled())
-            return ZipResult();
-        QuaZipFile indexFile(&m_output);
-        if (!indexFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName))) {
-            return ZipResult(tr("Could not create:") + fileName);
-        }
-        indexFile.write(m_extra_files[fileName]);
-    }
+    ParallelZipWriter writer(&m_output);
+    writer.cancelled(m_cancel.flag()).onProgress([this](qint64 written, qint64 total, const QString& fileName) {
+        setStatus("Compressing: " + fileName);
+        setProgress(written, total);
+    });
 
-    for (const QFileInfo& file : m_files) {
-        if (m_build_zip_future.isCanceled())
-            return ZipResult();
+    for (auto fileName : m_extra_files.keys())
+        writer.addData(fileName, m_extra_files[fileName]);
 
+    for (const QFileInfo& file : m_files) {
         auto absolute = file.absoluteFilePath();
         auto relative = m_dir.relativeFilePath(absolute);
-        setStatus("Compressing: " + relative);
-        setProgress(m_progress + 1, m_progressTotal);
+        if (m_exclude_files.contains(relative))
+            continue;
         if (m_follow_symlinks) {
             if (file.isSymLink())
                 absolute = file.symLinkTarget();
             else
                 absolute = file.canonicalFilePath();
         }
+        writer.addFile(absolute, m_destination_prefix + relative);
+    }
 
-        if (!m_exclude_files.contains(relative) && !JlCompress::compressFile(&m_output, absolute, m_destination_prefix + relative)) {
-            return ZipResult(tr("Could not read and compress %1").arg(relative));
-        }
+    if (auto error = writer(); error.has_value()) {
+        return m_build_zip_future.isCanceled() ? ZipResult() : error;
     }
 
     m_output.close();
@@ -526,7 +915,7 @@ void ExportToZipTask::finish()
 bool ExportToZipTask::abort()
 {
     if (m_build_zip_future.isRunning()) {
-        m_build_zip_future.cancel();
+        m_cancel.cancel();
         // NOTE: Here we don't do `emitAborted()` because it will be done when `m_build_zip_future` actually cancels, which may not occur
         // immediately.
         return true;
@@ -540,108 +929,24 @@ void ExtractZipTask::executeTask()
         emitFailed(tr("Unable to open supplied zip file."));
         return;
     }
-    m_zip_future = QtConcurrent::run(QThreadPool::globalInstance(), [this]() { return extractZip(); });
+    m_zip_future = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [this]() { return extractZip(); });
     connect(&m_zip_watcher, &QFutureWatcher<ZipResult>::finished, this, &ExtractZipTask::finish);
     m_zip_watcher.setFuture(m_zip_future);
 }
 
 auto ExtractZipTask::extractZip() -> ZipResult
 {
-    auto target = m_output_dir.absolutePath();
-    auto target_top_dir = QUrl::fromLocalFile(target);
-
-    QStringList extracted;
-
-    qDebug() << "Extracting subdir" << m_subdirectory << "from" << m_input->getZipName() << "to" << target;
-    auto numEntries = m_input->getEntriesCount();
-    if (numEntries < 0) {
-        return ZipResult(tr("Failed to enumerate files in archive"));
-    }
-    if (numEntries == 0) {
-        logWarning(tr("Extracting empty archives seems odd..."));
+    setStatus(tr("Extracting files..."));
+
+    ParallelExtractor extractor(m_input.get(), m_subdirectory, m_output_dir.absolutePath());
+    extractor.cancelled(m_cancel.flag()).onProgress([this](qint64 extracted, qint64 total, const QString& fileName) {
+        setStatus("Unpacking: " + fileName);
+        setProgress(extracted, total);
+    });
+    auto error = extractor();
+    if (m_zip_future.isCanceled())
         return ZipResult();
-    }
-    if (!m_input->goToFirstFile()) {
-        return ZipResult(tr("Failed to seek to first file in zip"));
-    }
-
-    setStatus("Extracting files...");
-    setProgress(0, numEntries);
-    do {
-        if (m_zip_future.isCanceled())
-            return ZipResult();
-        setProgress(m_progress + 1, m_progressTotal);
-        QString file_name = m_input->getCurrentFileName();
-        if (!file_name.startsWith(m_subdirectory))
-            continue;
-
-        auto relative_file_name = QDir::fromNativeSeparators(file_name.mid(m_subdirectory.size()));
-        auto original_name = relative_file_name;
-        setStatus("Unpacking: " + relative_file_name);
-
-        // Fix subdirs/files ending with a / getting transformed into absolute paths
-        if (relative_file_name.startsWith('/'))
-            relative_file_name = relative_file_name.mid(1);
-
-        // Fix weird "folders with a single file get squashed" thing
-        QString sub_path;
-        if (relative_file_name.contains('/') && !relative_file_name.endsWith('/')) {
-            sub_path = relative_file_name.section('/', 0, -2) + '/';
-            FS::ensureFolderPathExists(FS::PathCombine(target, sub_path));
-
-            relative_file_name = relative_file_name.split('/').last();
-        }
-
-        QString target_file_path;
-        if (relative_file_name.isEmpty()) {
-            target_file_path = target + '/';
-        } else {
-            target_file_path = FS::PathCombine(target_top_dir.toLocalFile(), sub_path, relative_file_name);
-            if (relative_file_name.endsWith('/') && !target_file_path.endsWith('/'))
-                target_file_path += '/';
-        }
-
-        if (!target_top_dir.isParentOf(QUrl::fromLocalFile(target_file_path))) {
-            return ZipResult(tr("Extracting %1 was cancelled, because it was effectively outside of the target path %2")
-                                 .arg(relative_file_name, target));
-        }
-
-        if (!JlCompress::extractFile(m_input.get(), "", target_file_path)) {
-            JlCompress::removeFile(extracted);
-            return ZipResult(tr("Failed to extract file %1 to %2").arg(original_name, target_file_path));
-        }
-
-        extracted.append(target_file_path);
-        auto fileInfo = QFileInfo(target_file_path);
-        if (fileInfo.isFile()) {
-            auto permissions = fileInfo.permissions();
-            auto maxPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser |
-                                 QFileDevice::Permission::ReadGroup | QFileDevice::Permission::ReadOther;
-            auto minPermisions = QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser;
-
-            auto newPermisions = (permissions & maxPermisions) | minPermisions;
-            if (newPermisions != permissions) {
-                if (!QFile::setPermissions(target_file_path, newPermisions)) {
-                    logWarning(tr("Could not fix permissions for %1").arg(target_file_path));
-                }
-            }
-        } else if (fileInfo.isDir()) {
-            // Ensure the folder has the minimal required permissions
-            QFile::Permissions minimalPermissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner | QFile::ReadGroup |
-                                                    QFile::ExeGroup | QFile::ReadOther | QFile::ExeOther;
-
-            QFile::Permissions currentPermissions = fileInfo.permissions();
-            if ((currentPermissions & minimalPermissions) != minimalPermissions) {
-                if (!QFile::setPermissions(target_file_path, minimalPermissions)) {
-                    logWarning(tr("Could not fix permissions for %1").arg(target_file_path));
-                }
-            }
-        }
-
-        qDebug() << "Extracted file" << relative_file_name << "to" << target_file_path;
-    } while (m_input->goToNextFile());
-
-    return ZipResult();
+    return error;
 }
 
 void ExtractZipTask::finish()
@@ -658,7 +963,7 @@ void ExtractZipTask::finish()
 bool ExtractZipTask::abort()
 {
     if (m_zip_future.isRunning()) {
-        m_zip_future.cancel();
+        m_cancel.cancel();
         // NOTE: Here we don't do `emitAborted()` because it will be done when `m_build_zip_future` actually cancels, which may not occur
         // immediately.
         return true;
@@ -45,6 +45,8 @@
 #include <QHash>
 #include <QSet>
 #include <QString>
+#include <QThread>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -52,6 +54,7 @@
 #if defined(LAUNCHER_APPLICATION)
 #include "minecraft/mod/Mod.h"
 #endif
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 namespace MMCZip {
@@ -152,6 +155,131 @@ bool extractFile(QString fileCompressed, QString file, QString dir);
  */
 bool collectFileListRecursively(const QString& rootDir, const QString& subDir, QFileInfoList* files, FilterFileFunction excludeFilter);
 
+/**
+ * Extracts a subdirectory of an archive on several threads.
+ *
+ * The central directory is read once and every folder is created up front, then up to workers() threads take the
+ * entries in turn, each with its own handle on the archive. Entries that would end up outside of the target are refused
+ * before anything is written.
+ */
+class ParallelExtractor {
+   public:
+    using Error = std::optional<QString>;
+    using ProgressFunction = std::function<void(qint64 extractedBytes, qint64 totalBytes, const QString& fileName)>;
+
+    /**
+     * \param zip an open archive, extra handles can only be opened if it was opened from a file name
+     */
+    ParallelExtractor(QuaZip* zip, const QString& subdir, const QString& target) : m_zip(zip), m_subdir(subdir), m_target(target) {}
+
+    ParallelExtractor& workers(int workers)
+    {
+        m_workers = workers;
+        return *this;
+    }
+    /** When set, no new entries are started and the extraction fails. */
+    ParallelExtractor& cancelled(const std::atomic_bool* cancelled)
+    {
+        m_cancelled = cancelled;
+        return *this;
+    }
+    ParallelExtractor& removeInvalidPathChars(bool remove)
+    {
+        m_removeInvalidPathChars = remove;
+        return *this;
+    }
+    /** Called after every entry, from the extracting threads, but never from two at once. */
+    ParallelExtractor& onProgress(ProgressFunction progress)
+    {
+        m_progress = std::move(progress);
+        return *this;
+    }
+
+    /**
+     * \return an error message, or nothing on success. Files extracted before a failure are removed again.
+     */
+    Error operator()();
+
+    /** The full paths of the extracted entries, in archive order. */
+    QStringList extracted() const { return m_extracted; }
+
+   private:
+    QuaZip* m_zip;
+    QString m_subdir;
+    QString m_target;
+    int m_workers = QThread::idealThreadCount();
+    const std::atomic_bool* m_cancelled = nullptr;
+    bool m_removeInvalidPathChars = false;
+    ProgressFunction m_progress;
+
+    QStringList m_extracted;
+};
+
+/**
+ * Writes files into an archive, deflating them on several threads while the archive itself is still written in order.
+ *
+ * Files are cut into blocks that are deflated independently, so a single large file is spread over all threads and
+ * only a few blocks are ever held in memory. Files that are already compressed are stored as they are.
+ */
+class ParallelZipWriter {
+   public:
+    using Error = std::optional<QString>;
+    using ProgressFunction = std::function<void(qint64 writtenBytes, qint64 totalBytes, const QString& fileName)>;
+
+    explicit ParallelZipWriter(QuaZip* zip) : m_zip(zip) {}
+
+    ParallelZipWriter& workers(int workers)
+    {
+        m_workers = workers;
+        return *this;
+    }
+    /** 0 stores everything, 1 to 9 trade speed for size like zlib does. */
+    ParallelZipWriter& compressionLevel(int level)
+    {
+        m_level = level;
+        return *this;
+    }
+    /** When set, no new blocks are written and the archive fails. */
+    ParallelZipWriter& cancelled(const std::atomic_bool* cancelled)
+    {
+        m_cancelled = cancelled;
+        return *this;
+    }
+    /** Called after every block, from the thread writing the archive. */
+    ParallelZipWriter& onProgress(ProgressFunction progress)
+    {
+        m_progress = std::move(progress);
+        return *this;
+    }
+
+    void addFile(const QString& source, const QString& name);
+    void addData(const QString& name, const QByteArray& data);
+
+    /**
+     * Writes everything that was added, in the order it was added. The archive is left open.
+     * \return an error message, or nothing on success
+     */
+    Error operator()();
+
+    /** Whether a file is stored as is, because compressing it again would only waste time. */
+    static bool isAlreadyCompressed(const QString& name);
+
+   private:
+    struct Entry {
+        QString name;
+        QString source;
+        QByteArray data;
+    };
+
+    QuaZip* m_zip;
+    int m_workers = QThread::idealThreadCount();
+    int m_level = -1;
+    const std::atomic_bool* m_cancelled = nullptr;
+    ProgressFunction m_progress;
+
+    QList<Entry> m_entries;
+};
+
 #if defined(LAUNCHER_APPLICATION)
 class ExportToZipTask : public Task {
     Q_OBJECT
@@ -203,6 +331,7 @@ class ExportToZipTask : public Task {
     bool m_follow_symlinks;
     QStringList m_exclude_files;
     QHash<QString, QByteArray> m_extra_files;
+    Executor::CancelToken m_cancel;
 
     QFuture<ZipResult> m_build_zip_future;
     QFutureWatcher<ZipResult> m_build_zip_watcher;
@@ -232,6 +361,7 @@ class ExtractZipTask : public Task {
     std::shared_ptr<QuaZip> m_input;
     QDir m_output_dir;
     QString m_subdirectory;
+    Executor::CancelToken m_cancel;
 
     QFuture<ZipResult> m_zip_future;
     QFutureWatcher<ZipResult> m_zip_watcher;
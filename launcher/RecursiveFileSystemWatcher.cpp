@@ -1,6 +1,14 @@
 #include "RecursiveFileSystemWatcher.h"
 
 #include <QDebug>
+#include <QDirIterator>
+
+#include "InotifyWatcher.h"
+
+static bool isBelow(const QString& path, const QString& root)
+{
+    return path == root || path.startsWith(root + '/');
+}
 
 RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject* parent) : QObject(parent), m_watcher(new QFileSystemWatcher(this))
 {
@@ -8,6 +16,11 @@ RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject* parent) : QObjec
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RecursiveFileSystemWatcher::directoryChange);
 }
 
+RecursiveFileSystemWatcher::~RecursiveFileSystemWatcher()
+{
+    disable();
+}
+
 void RecursiveFileSystemWatcher::setRootDir(const QDir& root)
 {
     bool wasEnabled = m_isEnabled;
@@ -28,13 +41,33 @@ void RecursiveFileSystemWatcher::setWatchFiles(const bool watchFiles)
     }
 }
 
+void RecursiveFileSystemWatcher::setMaxDepth(int depth)
+{
+    bool wasEnabled = m_isEnabled;
+    disable();
+    m_maxDepth = depth;
+    if (wasEnabled) {
+        enable();
+    }
+}
+
+bool RecursiveFileSystemWatcher::isTooDeep(const QString& folder) const
+{
+    return m_maxDepth >= 0 && folder.mid(m_root.absolutePath().size()).count('/') > m_maxDepth;
+}
+
 void RecursiveFileSystemWatcher::enable()
 {
     if (m_isEnabled) {
         return;
     }
     Q_ASSERT(m_root != QDir::root());
-    addFilesToWatcherRecursive(m_root);
+    if (auto inotify = InotifyWatcher::instance()) {
+        m_inotifyId = inotify->watch(m_root.absolutePath(), [this](const QList<FileEvent>& events) { handleEvents(events); }, m_maxDepth);
+    }
+    if (m_inotifyId < 0) {
+        addFilesToWatcherRecursive(m_root);
+    }
     m_isEnabled = true;
 }
 void RecursiveFileSystemWatcher::disable()
@@ -43,8 +76,14 @@ void RecursiveFileSystemWatcher::disable()
         return;
     }
     m_isEnabled = false;
+    if (m_inotifyId >= 0) {
+        InotifyWatcher::instance()->unwatch(m_inotifyId);
+        m_inotifyId = -1;
+        return;
+    }
     m_watcher->removePaths(m_watcher->files());
     m_watcher->removePaths(m_watcher->directories());
+    m_snapshots.clear();
 }
 
 void RecursiveFileSystemWatcher::setFiles(const QStringList& files)
@@ -55,17 +94,132 @@ void RecursiveFileSystemWatcher::setFiles(const QStringList& files)
     }
 }
 
-void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir& dir)
+void RecursiveFileSystemWatcher::updateFiles(const QList<FileEvent>& events)
 {
-    m_watcher->addPath(dir.absolutePath());
-    for (const QString& directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
-        addFilesToWatcherRecursive(dir.absoluteFilePath(directory));
+    if (!m_matcher) {
+        return;
+    }
+    auto files = m_files;
+    auto add = [this, &files](const QString& path) {
+        auto relPath = m_root.relativeFilePath(path);
+        if (m_matcher->matches(relPath) && !files.contains(relPath)) {
+            files.append(relPath);
+        }
+    };
+    auto remove = [this, &files](const QString& path, bool isDir) {
+        auto relPath = m_root.relativeFilePath(path);
+        if (isDir) {
+            files.removeIf([&relPath](const QString& file) { return file.startsWith(relPath + '/'); });
+        } else {
+            files.removeAll(relPath);
+        }
+    };
+
+    for (const auto& event : events) {
+        switch (event.type) {
+            case FileEvent::Type::Overflow:
+                setFiles(scanRecursive(m_root));
+                return;
+            case FileEvent::Type::Created:
+                // the contents of new folders come as events of their own
+                if (!event.isDir) {
+                    add(event.path);
+                }
+                break;
+            case FileEvent::Type::Deleted:
+                remove(event.path, event.isDir);
+                break;
+            case FileEvent::Type::Moved:
+                remove(event.from, event.isDir);
+                if (event.isDir) {
+                    QDirIterator it(event.path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+                    while (it.hasNext()) {
+                        add(it.next());
+                    }
+                } else {
+                    add(event.path);
+                }
+                break;
+            case FileEvent::Type::Modified:
+                break;
+        }
     }
-    if (m_watchFiles) {
-        for (const QFileInfo& info : dir.entryInfoList(QDir::Files)) {
+    setFiles(files);
+}
+
+void RecursiveFileSystemWatcher::handleEvents(const QList<FileEvent>& events)
+{
+    auto root = m_root.absolutePath();
+    QStringList folders;
+    auto touch = [&folders, &root](const QString& path) {
+        auto folder = path == root ? root : QFileInfo(path).absolutePath();
+        if (isBelow(folder, root) && !folders.contains(folder)) {
+            folders.append(folder);
+        }
+    };
+
+    bool overflow = false;
+    for (const auto& event : events) {
+        switch (event.type) {
+            case FileEvent::Type::Overflow:
+                overflow = true;
+                break;
+            case FileEvent::Type::Moved:
+                touch(event.from);
+                touch(event.path);
+                break;
+            default:
+                touch(event.path);
+                break;
+        }
+        if (event.type == FileEvent::Type::Modified && m_watchFiles) {
+            emit fileChanged(event.path);
+        }
+    }
+    // nothing is known about what changed, so everything did
+    if (overflow) {
+        if (m_inotifyId >= 0 && !InotifyWatcher::instance()->isWatching(m_inotifyId)) {
+            qWarning() << "Watching" << root << "without inotify from now on";
+            m_inotifyId = -1;
+            addFilesToWatcherRecursive(m_root);
+        }
+        folders = { root };
+        QDirIterator it(root, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            auto folder = it.next();
+            if (!isTooDeep(folder)) {
+                folders.append(folder);
+            }
+        }
+    }
+
+    updateFiles(events);
+    emit fileEvents(events);
+    for (const auto& folder : folders) {
+        emit directoryChanged(folder);
+    }
+}
+
+void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir& dir, QList<FileEvent>* created)
+{
+    auto folder = dir.absolutePath();
+    if (isTooDeep(folder)) {
+        return;
+    }
+    m_watcher->addPath(folder);
+    QHash<QString, Stamp> snapshot;
+    for (const QFileInfo& info : dir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden)) {
+        snapshot.insert(info.fileName(), { info.size(), info.lastModified().toMSecsSinceEpoch(), info.isDir() });
+        if (created) {
+            created->append({ FileEvent::Type::Created, info.absoluteFilePath(), {}, info.isDir() });
+        }
+        if (info.isDir()) {
+            addFilesToWatcherRecursive(info.absoluteFilePath(), created);
+        } else if (m_watchFiles) {
             m_watcher->addPath(info.absoluteFilePath());
         }
     }
+    m_snapshots.insert(folder, snapshot);
 }
 QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir& directory)
 {
@@ -87,9 +241,60 @@ QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir& directory)
 
 void RecursiveFileSystemWatcher::fileChange(const QString& path)
 {
-    emit fileChanged(path);
+    // deletions are picked up from the folder
+    if (QFileInfo::exists(path)) {
+        handleEvents({ { FileEvent::Type::Modified, path, {}, false } });
+    }
 }
-void RecursiveFileSystemWatcher::directoryChange([[maybe_unused]] const QString& path)
+void RecursiveFileSystemWatcher::directoryChange(const QString& path)
 {
-    setFiles(scanRecursive(m_root));
+    // without inotify only the folder is known, so compare it with how it was
+    QList<FileEvent> events;
+    const auto before = m_snapshots.take(path);
+    QDir dir(path);
+    if (!dir.exists()) {
+        for (auto it = m_snapshots.begin(); it != m_snapshots.end();) {
+            it = it.key().startsWith(path + '/') ? m_snapshots.erase(it) : std::next(it);
+        }
+        // anything below the root is reported by the folder it was in
+        if (path == m_root.absolutePath()) {
+            handleEvents({ { FileEvent::Type::Deleted, path, {}, true } });
+        }
+        return;
+    }
+
+    QHash<QString, Stamp> now;
+    for (const QFileInfo& info : dir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden)) {
+        Stamp stamp{ info.size(), info.lastModified().toMSecsSinceEpoch(), info.isDir() };
+        now.insert(info.fileName(), stamp);
+        auto old = before.constFind(info.fileName());
+        if (old == before.constEnd() || old->isDir != stamp.isDir) {
+            events.append({ FileEvent::Type::Created, info.absoluteFilePath(), {}, info.isDir() });
+            if (info.isDir()) {
+                addFilesToWatcherRecursive(info.absoluteFilePath(), &events);
+            } else if (m_watchFiles) {
+                m_watcher->addPath(info.absoluteFilePath());
+            }
+        } else if (!stamp.isDir && (old->size != stamp.size || old->modified != stamp.modified)) {
+            events.append({ FileEvent::Type::Modified, info.absoluteFilePath(), {}, false });
+        }
+    }
+    for (auto it = before.cbegin(); it != before.cend(); ++it) {
+        auto old = now.constFind(it.key());
+        if (old != now.constEnd() && old->isDir == it->isDir) {
+            continue;
+        }
+        auto removed = dir.absoluteFilePath(it.key());
+        events.prepend({ FileEvent::Type::Deleted, removed, {}, it->isDir });
+        if (it->isDir) {
+            for (auto snapshot = m_snapshots.begin(); snapshot != m_snapshots.end();) {
+                snapshot = isBelow(snapshot.key(), removed) ? m_snapshots.erase(snapshot) : std::next(snapshot);
+            }
+        }
+    }
+    m_snapshots.insert(path, now);
+
+    if (!events.isEmpty()) {
+        handleEvents(events);
+    }
 }
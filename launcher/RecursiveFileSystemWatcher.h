@@ -2,20 +2,28 @@
 
 #include <QDir>
 #include <QFileSystemWatcher>
+#include <QHash>
+#include "FileEvent.h"
 #include "pathmatcher/IPathMatcher.h"
 
 class RecursiveFileSystemWatcher : public QObject {
     Q_OBJECT
    public:
     RecursiveFileSystemWatcher(QObject* parent);
+    ~RecursiveFileSystemWatcher() override;
 
     void setRootDir(const QDir& root);
     QDir rootDir() const { return m_root; }
 
     // WARNING: setting this to true may be bad for performance
+    // only matters where inotify is not available, it reports changes to files without watching each of them
     void setWatchFiles(bool watchFiles);
     bool watchFiles() const { return m_watchFiles; }
 
+    /// how many levels of folders below the root are watched, -1 for all of them. what is in the deepest ones is still reported
+    void setMaxDepth(int depth);
+    int maxDepth() const { return m_maxDepth; }
+
     void setMatcher(IPathMatcher::Ptr matcher) { m_matcher = matcher; }
 
     QStringList files() const { return m_files; }
@@ -23,24 +31,42 @@ class RecursiveFileSystemWatcher : public QObject {
    signals:
     void filesChanged();
     void fileChanged(const QString& path);
+    /// something in this folder was added, removed, renamed or modified
+    void directoryChanged(const QString& path);
+    /// what changed below the root. folded and debounced with inotify, taken from the changed folders elsewhere
+    void fileEvents(const QList<FileEvent>& events);
 
    public slots:
     void enable();
     void disable();
 
    private:
+    struct Stamp {
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool isDir = false;
+    };
+
     QDir m_root;
     bool m_watchFiles = false;
+    int m_maxDepth = -1;
     bool m_isEnabled = false;
     IPathMatcher::Ptr m_matcher;
 
     QFileSystemWatcher* m_watcher;
+    /// the tree's id with the inotify watcher, -1 while QFileSystemWatcher is used instead
+    int m_inotifyId = -1;
+    /// what each watched folder held when it was last looked at, to tell what changed without inotify
+    QHash<QString, QHash<QString, Stamp>> m_snapshots;
 
     QStringList m_files;
     void setFiles(const QStringList& files);
+    void updateFiles(const QList<FileEvent>& events);
 
-    void addFilesToWatcherRecursive(const QDir& dir);
+    bool isTooDeep(const QString& folder) const;
+    void addFilesToWatcherRecursive(const QDir& dir, QList<FileEvent>* created = nullptr);
     QStringList scanRecursive(const QDir& dir);
+    void handleEvents(const QList<FileEvent>& events);
 
    private slots:
     void fileChange(const QString& path);
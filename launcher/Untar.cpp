@@ -39,6 +39,10 @@
 #include <QIODevice>
 #include <QString>
 #include "FileSystem.h"
+#include "StringUtils.h"
+
+#include <filesystem>
+#include <system_error>
 
 // adaptation of the:
 // - https://github.com/madler/zlib/blob/develop/contrib/untgz/untgz.c
@@ -145,7 +149,7 @@ bool Tar::extract(QIODevice* in, QString dst)
             }
         }
         if (symlink.isEmpty())
-            symlink = decodeName(buffer);
+            symlink = decodeName(buffer + 157);
         qint64 size = getOctal(buffer + 124, 12, &ok);
         if (!ok) {
             qCritical() << "The file size can't be read";
@@ -213,16 +217,37 @@ bool Tar::extract(QIODevice* in, QString dst)
                 }
                 break;
             }
-            case TypeFlag::Link:
-                /* fallthrough */
+            case TypeFlag::Link: {
+                // hard links name their target from the root of the archive
+                auto fileName = FS::PathCombine(dst, name);
+                if (!firstFolderName.isEmpty() && symlink.startsWith(firstFolderName))
+                    symlink = symlink.mid(firstFolderName.size());
+                auto target = FS::PathCombine(dst, symlink);
+                if (!FS::ensureFilePathExists(fileName)) {
+                    qCritical() << "Can't ensure the file path to exist: " << fileName;
+                    return false;
+                }
+                std::error_code err;
+                std::filesystem::create_hard_link(StringUtils::toStdString(target), StringUtils::toStdString(fileName), err);
+                if (err) {
+                    qCritical() << "Can't create link for:" << fileName << " to:" << target << QString::fromStdString(err.message());
+                    return false;
+                }
+                break;
+            }
             case TypeFlag::Symlink: {
+                // the target is kept as the archive has it, so relative links still resolve once dst is moved
                 auto fileName = FS::PathCombine(dst, name);
-                if (!FS::create_link(FS::PathCombine(QFileInfo(fileName).path(), symlink), fileName)()) {  // do not use symlinks
-                    qCritical() << "Can't create link for:" << fileName << " to:" << FS::PathCombine(QFileInfo(fileName).path(), symlink);
+                if (!FS::ensureFilePathExists(fileName)) {
+                    qCritical() << "Can't ensure the file path to exist: " << fileName;
+                    return false;
+                }
+                std::error_code err;
+                std::filesystem::create_symlink(StringUtils::toStdString(symlink), StringUtils::toStdString(fileName), err);
+                if (err) {
+                    qCritical() << "Can't create symlink for:" << fileName << " to:" << symlink << QString::fromStdString(err.message());
                     return false;
                 }
-                FS::ensureFilePathExists(fileName);
-                QFile::setPermissions(fileName, QFile::Permissions(mode));
                 break;
             }
             case TypeFlag::Character:
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FileIconEngine.h"
+
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+
+#include "FileSystem.h"
+
+static quint64 sizeKey(const QSize& size)
+{
+    return (quint64(quint32(size.width())) << 32) | quint32(size.height());
+}
+
+FileIconEngine::FileIconEngine(QString path, QString cacheDir) : m_path(std::move(path)), m_cacheDir(std::move(cacheDir))
+{
+    QFileInfo info(m_path);
+    m_signature = QString("%1-%2").arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+bool FileIconEngine::canRead(const QString& path)
+{
+    QImageReader reader(path);
+    return reader.canRead();
+}
+
+QString FileIconEngine::cacheFolder(const QString& cacheDir, const QString& path)
+{
+    auto hash = QCryptographicHash::hash(QFileInfo(path).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1);
+    return FS::PathCombine(cacheDir, QString::fromLatin1(hash.toHex()));
+}
+
+void FileIconEngine::readHeader()
+{
+    if (m_headerRead)
+        return;
+    m_headerRead = true;
+    QImageReader reader(m_path);
+    m_scalable = reader.format() == "svg" || reader.format() == "svgz";
+    m_size = reader.size();
+    // some formats only know their size once decoded
+    if (!m_size.isValid()) {
+        auto image = reader.read();
+        m_size = image.size();
+        if (!image.isNull())
+            m_pixmaps.insert(sizeKey(m_size), QPixmap::fromImage(image));
+    }
+}
+
+QImage FileIconEngine::rasterize(const QSize& size)
+{
+    QString cached;
+    if (!m_cacheDir.isEmpty()) {
+        cached = FS::PathCombine(cacheFolder(m_cacheDir, m_path), QString("%1-%2x%3.png").arg(m_signature).arg(size.width()).arg(size.height()));
+        QImage image(cached);
+        if (!image.isNull())
+            return image;
+    }
+
+    QImageReader reader(m_path);
+    // icon files can hold several sizes, start from the smallest one that is still big enough
+    if (reader.imageCount() > 1) {
+        int best = 0;
+        QSize best_size;
+        for (int i = 0; i < reader.imageCount() && reader.jumpToImage(i); i++) {
+            auto candidate = reader.size();
+            bool big_enough = candidate.width() >= size.width() && candidate.height() >= size.height();
+            bool best_big_enough = best_size.width() >= size.width() && best_size.height() >= size.height();
+            if (!best_size.isValid() || (big_enough && (!best_big_enough || candidate.width() < best_size.width())) ||
+                (!big_enough && !best_big_enough && candidate.width() > best_size.width())) {
+                best = i;
+                best_size = candidate;
+            }
+        }
+        reader.jumpToImage(best);
+    }
+    if (reader.size() != size)
+        reader.setScaledSize(size);
+    auto image = reader.read();
+    if (image.isNull())
+        return image;
+
+    // decoding an unscaled raster file again is as cheap as reading it from the cache
+    if (!cached.isEmpty() && (m_scalable || size != m_size)) {
+        FS::ensureFilePathExists(cached);
+        // sizes cached for an earlier version of the file are of no use anymore
+        QDir folder(QFileInfo(cached).absolutePath());
+        for (const auto& name : folder.entryList(QDir::Files)) {
+            if (!name.startsWith(m_signature + '-'))
+                folder.remove(name);
+        }
+        if (!image.save(cached, "PNG"))
+            qWarning() << "Unable to cache icon" << m_path << "at" << size;
+    }
+    return image;
+}
+
+void FileIconEngine::paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state)
+{
+    auto scale = painter->device()->devicePixelRatio();
+    auto size = actualSize(rect.size(), mode, state);
+    auto target = QRect(QPoint(), size);
+    target.moveCenter(rect.center());
+    painter->drawPixmap(target, scaledPixmap(size, mode, state, scale));
+}
+
+QPixmap FileIconEngine::pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state)
+{
+    return scaledPixmap(size, mode, state, 1.0);
+}
+
+QPixmap FileIconEngine::scaledPixmap(const QSize& size, QIcon::Mode mode, QIcon::State state, qreal scale)
+{
+    auto device_size = actualSize(size * scale, mode, state);
+    if (device_size.isEmpty())
+        return {};
+
+    auto key = sizeKey(device_size);
+    auto pixmap = m_pixmaps.value(key);
+    if (pixmap.isNull()) {
+        pixmap = QPixmap::fromImage(rasterize(device_size));
+        if (pixmap.isNull())
+            return {};
+        m_pixmaps.insert(key, pixmap);
+    }
+    if (mode != QIcon::Normal) {
+        QStyleOption option(0);
+        option.palette = QGuiApplication::palette();
+        pixmap = QApplication::style()->generatedIconPixmap(mode, pixmap, &option);
+    }
+    pixmap.setDevicePixelRatio(scale);
+    return pixmap;
+}
+
+QSize FileIconEngine::actualSize(const QSize& size, [[maybe_unused]] QIcon::Mode mode, [[maybe_unused]] QIcon::State state)
+{
+    readHeader();
+    if (!m_size.isValid())
+        return {};
+    // like Qt's own engines, only vector icons are scaled up
+    if (!m_scalable && m_size.width() <= size.width() && m_size.height() <= size.height())
+        return m_size;
+    return m_size.scaled(size, Qt::KeepAspectRatio);
+}
+
+QList<QSize> FileIconEngine::availableSizes([[maybe_unused]] QIcon::Mode mode, [[maybe_unused]] QIcon::State state)
+{
+    readHeader();
+    if (!m_size.isValid())
+        return {};
+    return { m_size };
+}
+
+QIconEngine* FileIconEngine::clone() const
+{
+    return new FileIconEngine(*this);
+}
+
+QString FileIconEngine::key() const
+{
+    return QStringLiteral("FileIconEngine");
+}
+
+bool FileIconEngine::isNull()
+{
+    readHeader();
+    return !m_size.isValid();
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QIconEngine>
+#include <QSize>
+#include <QString>
+
+/**
+ * Draws an icon file, decoding it only at the sizes that are actually asked for.
+ *
+ * Decoded sizes are kept with the engine and, when a cache folder is given, written there as PNGs. Vector icons and
+ * large pictures then do not have to be rendered or scaled again on the next start.
+ */
+class FileIconEngine : public QIconEngine {
+   public:
+    FileIconEngine(QString path, QString cacheDir);
+
+    /** If Qt can read an image from the file, judged by its header alone. */
+    static bool canRead(const QString& path);
+    /** Where the rasterized sizes of @p path are kept, to be dropped when the file changes. */
+    static QString cacheFolder(const QString& cacheDir, const QString& path);
+
+    void paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap scaledPixmap(const QSize& size, QIcon::Mode mode, QIcon::State state, qreal scale) override;
+    QSize actualSize(const QSize& size, QIcon::Mode mode, QIcon::State state) override;
+    QList<QSize> availableSizes(QIcon::Mode mode, QIcon::State state) override;
+    QIconEngine* clone() const override;
+    QString key() const override;
+    bool isNull() override;
+
+   private:
+    void readHeader();
+    QImage rasterize(const QSize& size);
+
+    QString m_path;
+    QString m_cacheDir;
+    /// size and modification time, so cached sizes of an older version of the file are never used
+    QString m_signature;
+    bool m_headerRead = false;
+    bool m_scalable = false;
+    QSize m_size;
+    QHash<quint64, QPixmap> m_pixmaps;
+};
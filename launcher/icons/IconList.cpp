@@ -37,16 +37,18 @@
 #include "IconList.h"
 #include <FileSystem.h>
 #include <QDebug>
-#include <QFileSystemWatcher>
 #include <QMap>
 #include <QMimeData>
 #include <QSet>
 #include <QUrl>
+#include "RecursiveFileSystemWatcher.h"
+#include "icons/FileIconEngine.h"
 #include "icons/IconUtils.h"
 
 #define MAX_SIZE 1024
 
-IconList::IconList(const QStringList& builtinPaths, const QString& path, QObject* parent) : QAbstractListModel(parent)
+IconList::IconList(const QStringList& builtinPaths, const QString& path, const QString& cachePath, QObject* parent)
+    : QAbstractListModel(parent), m_cachePath(cachePath)
 {
     QSet<QString> builtinNames;
 
@@ -62,10 +64,10 @@ IconList::IconList(const QStringList& builtinPaths, const QString& path, QObject
         addThemeIcon(builtinName);
     }
 
-    m_watcher.reset(new QFileSystemWatcher());
+    // one watcher for the whole tree, files are noticed through the folders they are in
+    m_watcher.reset(new RecursiveFileSystemWatcher(nullptr));
     m_isWatching = false;
-    connect(m_watcher.get(), &QFileSystemWatcher::directoryChanged, this, &IconList::directoryChanged);
-    connect(m_watcher.get(), &QFileSystemWatcher::fileChanged, this, &IconList::fileChanged);
+    connect(m_watcher.get(), &RecursiveFileSystemWatcher::directoryChanged, this, &IconList::directoryChanged);
 
     directoryChanged(path);
 
@@ -76,6 +78,12 @@ IconList::IconList(const QStringList& builtinPaths, const QString& path, QObject
 void IconList::sortIconList()
 {
     qDebug() << "Sorting icon list...";
+    emit layoutAboutToBeChanged();
+    auto persistent = persistentIndexList();
+    QStringList persistentKeys;
+    for (const auto& idx : persistent)
+        persistentKeys.append(m_icons[idx.row()].m_key);
+
     std::sort(m_icons.begin(), m_icons.end(), [](const MMCIcon& a, const MMCIcon& b) {
         bool aIsSubdir = a.m_key.contains(QDir::separator());
         bool bIsSubdir = b.m_key.contains(QDir::separator());
@@ -85,43 +93,12 @@ void IconList::sortIconList()
         return a.m_key.localeAwareCompare(b.m_key) < 0;
     });
     reindex();
-}
-
-// Helper function to add directories recursively
-bool IconList::addPathRecursively(const QString& path)
-{
-    QDir dir(path);
-    if (!dir.exists())
-        return false;
-
-    // Add the directory itself
-    bool watching = m_watcher->addPath(path);
 
-    // Add all subdirectories
-    QFileInfoList entries = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo& entry : entries) {
-        if (addPathRecursively(entry.absoluteFilePath())) {
-            watching = true;
-        }
-    }
-    return watching;
-}
-
-QStringList IconList::getIconFilePaths() const
-{
-    QStringList iconFiles{};
-    QStringList directories{ m_dir.absolutePath() };
-    while (!directories.isEmpty()) {
-        QString first = directories.takeFirst();
-        QDir dir(first);
-        for (QFileInfo& fileInfo : dir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot, QDir::Name)) {
-            if (fileInfo.isDir())
-                directories.push_back(fileInfo.absoluteFilePath());
-            else
-                iconFiles.push_back(fileInfo.absoluteFilePath());
-        }
-    }
-    return iconFiles;
+    QModelIndexList moved;
+    for (const auto& key : persistentKeys)
+        moved.append(index(m_nameIndex.value(key)));
+    changePersistentIndexList(persistent, moved);
+    emit layoutChanged();
 }
 
 QString formatName(const QDir& iconsDir, const QFileInfo& iconFile)
@@ -135,94 +112,141 @@ QString formatName(const QDir& iconsDir, const QFileInfo& iconFile)
     return relativePathWithoutExtension.replace(QDir::separator(), delimiter);
 }
 
-/// Split into a separate function because the preprocessing impedes readability
-QSet<QString> toStringSet(const QList<QString>& list)
+QString IconList::keyFor(const QString& path) const
 {
-    QSet<QString> set(list.begin(), list.end());
-    return set;
+    return QFileInfo(m_dir.relativeFilePath(path)).completeBaseName();
 }
 
 void IconList::directoryChanged(const QString& path)
 {
-    QDir newDir(path);
-    if (m_dir.absolutePath() != newDir.absolutePath()) {
-        if (!path.startsWith(m_dir.absolutePath()))
-            m_dir.setPath(path);
+    auto folder = QDir(path).absolutePath();
+    auto root = m_dir.absolutePath();
+    bool inside = !m_folders.isEmpty() && (folder == root || folder.startsWith(root + '/'));
+    if (!inside) {
+        if (!m_folders.isEmpty())
+            forgetFolder(root);
+        m_dir.setPath(path);
         m_dir.refresh();
         if (m_isWatching)
             stopWatching();
+        m_watcher->setRootDir(m_dir);
         startWatching();
+        folder = m_dir.absolutePath();
     }
     if (!m_dir.exists() && !FS::ensureFolderPathExists(m_dir.absolutePath()))
         return;
-    m_dir.refresh();
-    const QStringList newFileNamesList = getIconFilePaths();
-    const QSet<QString> newSet = toStringSet(newFileNamesList);
-    QSet<QString> currentSet;
-    for (const MMCIcon& it : m_icons) {
-        if (!it.has(IconType::FileBased))
-            continue;
-        QFileInfo icon(it.getFilePath());
-        currentSet.insert(icon.absoluteFilePath());
-    }
-    QSet<QString> toRemove = currentSet - newSet;
-    QSet<QString> toAdd = newSet - currentSet;
 
-    for (const QString& removedPath : toRemove) {
-        qDebug() << "Removing icon " << removedPath;
-        QFileInfo removedFile(removedPath);
-        QString relativePath = m_dir.relativeFilePath(removedFile.absoluteFilePath());
-        QString key = QFileInfo(relativePath).completeBaseName();
+    bool added = false;
+    if (QFileInfo(folder).isDir())
+        added = syncFolder(folder);
+    else
+        forgetFolder(folder);
+
+    if (added)
+        sortIconList();
+}
 
-        int idx = getIconIndex(key);
-        if (idx == -1)
+bool IconList::syncFolder(const QString& folder)
+{
+    QDir dir(folder);
+    // copied, the recursion below adds folders to m_folders
+    const auto known = m_folders.value(folder);
+    QHash<QString, FileStamp> seen;
+    QStringList subfolders;
+    bool added = false;
+
+    // only the stamps of the files are compared, nothing is decoded for files that did not change
+    for (const QFileInfo& info : dir.entryInfoList(QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot, QDir::Name)) {
+        if (info.isDir()) {
+            subfolders.append(info.absoluteFilePath());
             continue;
-        m_icons[idx].remove(FileBased);
-        if (m_icons[idx].type() == ToBeDeleted) {
-            beginRemoveRows(QModelIndex(), idx, idx);
-            m_icons.remove(idx);
-            reindex();
-            endRemoveRows();
-        } else {
-            dataChanged(index(idx), index(idx));
         }
-        m_watcher->removePath(removedPath);
-        emit iconUpdated(key);
+        FileStamp stamp{ info.size(), info.lastModified().toMSecsSinceEpoch() };
+        seen.insert(info.fileName(), stamp);
+        auto old = known.constFind(info.fileName());
+        if (old == known.constEnd()) {
+            fileAdded(info.absoluteFilePath());
+            added = true;
+        } else if (*old != stamp) {
+            fileReplaced(info.absoluteFilePath());
+        }
     }
+    for (auto it = known.cbegin(); it != known.cend(); ++it) {
+        if (!seen.contains(it.key()))
+            fileRemoved(FS::PathCombine(folder, it.key()));
+    }
+    m_folders.insert(folder, seen);
 
-    for (const QString& addedPath : toAdd) {
-        qDebug() << "Adding icon " << addedPath;
-
-        QFileInfo addfile(addedPath);
-        QString relativePath = m_dir.relativeFilePath(addfile.absoluteFilePath());
-        QString key = QFileInfo(relativePath).completeBaseName();
-        QString name = formatName(m_dir, addfile);
+    auto prefix = folder + '/';
+    for (const auto& knownFolder : m_folders.keys()) {
+        bool isChild = knownFolder.startsWith(prefix) && knownFolder.indexOf('/', prefix.size()) == -1;
+        if (isChild && !subfolders.contains(knownFolder))
+            forgetFolder(knownFolder);
+    }
+    for (const auto& subfolder : subfolders) {
+        if (!m_folders.contains(subfolder))
+            added |= syncFolder(subfolder);
+    }
+    return added;
+}
 
-        if (addIcon(key, name, addfile.filePath(), IconType::FileBased)) {
-            m_watcher->addPath(addedPath);
-            emit iconUpdated(key);
-        }
+void IconList::forgetFolder(const QString& folder)
+{
+    auto prefix = folder + '/';
+    for (const auto& knownFolder : m_folders.keys()) {
+        if (knownFolder != folder && !knownFolder.startsWith(prefix))
+            continue;
+        const auto files = m_folders.take(knownFolder);
+        for (auto it = files.cbegin(); it != files.cend(); ++it)
+            fileRemoved(FS::PathCombine(knownFolder, it.key()));
     }
+}
 
-    sortIconList();
+void IconList::fileAdded(const QString& path)
+{
+    qDebug() << "Adding icon " << path;
+    QFileInfo addfile(path);
+    QString key = keyFor(path);
+    if (addIcon(key, formatName(m_dir, addfile), addfile.filePath(), IconType::FileBased))
+        emit iconUpdated(key);
 }
 
-void IconList::fileChanged(const QString& path)
+void IconList::fileReplaced(const QString& path)
 {
     qDebug() << "Checking icon " << path;
-    QFileInfo checkfile(path);
-    if (!checkfile.exists())
-        return;
-    QString key = m_dir.relativeFilePath(checkfile.absoluteFilePath());
+    if (!m_cachePath.isEmpty())
+        FS::deletePath(FileIconEngine::cacheFolder(m_cachePath, path));
+    QString key = keyFor(path);
+    if (addIcon(key, formatName(m_dir, QFileInfo(path)), path, IconType::FileBased))
+        emit iconUpdated(key);
+    else
+        fileRemoved(path);
+}
+
+void IconList::fileRemoved(const QString& path)
+{
+    qDebug() << "Removing icon " << path;
+    if (!m_cachePath.isEmpty())
+        FS::deletePath(FileIconEngine::cacheFolder(m_cachePath, path));
+
+    QString key = keyFor(path);
     int idx = getIconIndex(key);
     if (idx == -1)
         return;
-    QIcon icon(path);
-    if (icon.availableSizes().empty())
+    // another folder may hold a file with the same name
+    auto& image = m_icons[idx].m_images[IconType::FileBased];
+    if (QFileInfo(image.filename).absoluteFilePath() != QFileInfo(path).absoluteFilePath())
         return;
 
-    m_icons[idx].m_images[IconType::FileBased].icon = icon;
-    dataChanged(index(idx), index(idx));
+    m_icons[idx].remove(FileBased);
+    if (m_icons[idx].type() == ToBeDeleted) {
+        beginRemoveRows(QModelIndex(), idx, idx);
+        m_icons.remove(idx);
+        reindex();
+        endRemoveRows();
+    } else {
+        dataChanged(index(idx), index(idx));
+    }
     emit iconUpdated(key);
 }
 
@@ -238,18 +262,14 @@ void IconList::startWatching()
 {
     auto abs_path = m_dir.absolutePath();
     FS::ensureFolderPathExists(abs_path);
-    m_isWatching = addPathRecursively(abs_path);
-    if (m_isWatching) {
-        qDebug() << "Started watching " << abs_path;
-    } else {
-        qDebug() << "Failed to start watching " << abs_path;
-    }
+    m_watcher->enable();
+    m_isWatching = true;
+    qDebug() << "Started watching " << abs_path;
 }
 
 void IconList::stopWatching()
 {
-    m_watcher->removePaths(m_watcher->files());
-    m_watcher->removePaths(m_watcher->directories());
+    m_watcher->disable();
     m_isWatching = false;
 }
 
@@ -394,10 +414,10 @@ bool IconList::addThemeIcon(const QString& key)
 
 bool IconList::addIcon(const QString& key, const QString& name, const QString& path, const IconType type)
 {
-    // replace the icon even? is the input valid?
-    QIcon icon(path);
-    if (icon.isNull())
+    // only the header is read here, the icon is decoded at the sizes it gets drawn at
+    if (!FileIconEngine::canRead(path))
         return false;
+    QIcon icon(new FileIconEngine(path, m_cachePath));
     auto iter = m_nameIndex.find(key);
     if (iter != m_nameIndex.end()) {
         auto& oldOne = m_icons[*iter];
@@ -431,7 +451,6 @@ void IconList::reindex()
     m_nameIndex.clear();
     for (int i = 0; i < m_icons.size(); i++) {
         m_nameIndex[m_icons[i].m_key] = i;
-        emit iconUpdated(m_icons[i].m_key);  // prevents incorrect indices with proxy model
     }
 }
 
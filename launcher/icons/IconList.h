@@ -37,6 +37,7 @@
 #include <QAbstractListModel>
 #include <QDir>
 #include <QFile>
+#include <QHash>
 #include <QMutex>
 #include <QtGui/QIcon>
 #include <memory>
@@ -46,12 +47,13 @@
 
 #include "QObjectPtr.h"
 
-class QFileSystemWatcher;
+class RecursiveFileSystemWatcher;
 
 class IconList : public QAbstractListModel {
     Q_OBJECT
    public:
-    explicit IconList(const QStringList& builtinPaths, const QString& path, QObject* parent = 0);
+    /// @param cachePath where rasterized icon sizes are kept between runs, none when empty
+    explicit IconList(const QStringList& builtinPaths, const QString& path, const QString& cachePath = {}, QObject* parent = 0);
     virtual ~IconList() {};
 
     QIcon getIcon(const QString& key) const;
@@ -92,20 +94,37 @@ class IconList : public QAbstractListModel {
     IconList& operator=(const IconList&) = delete;
     void reindex();
     void sortIconList();
-    bool addPathRecursively(const QString& path);
-    QStringList getIconFilePaths() const;
+
+    /// size and modification time of an icon file, to tell when it was replaced
+    struct FileStamp {
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool operator==(const FileStamp& other) const { return size == other.size && modified == other.modified; }
+        bool operator!=(const FileStamp& other) const { return !(*this == other); }
+    };
+    /// brings the icons of one folder up to date, returns whether icons were added
+    bool syncFolder(const QString& folder);
+    /// removes the icons of a folder that is gone, and of all folders below it
+    void forgetFolder(const QString& folder);
+    void fileAdded(const QString& path);
+    void fileReplaced(const QString& path);
+    void fileRemoved(const QString& path);
+    QString keyFor(const QString& path) const;
 
    public slots:
+    /// switches to another icons folder, or syncs a folder below the current one
     void directoryChanged(const QString& path);
 
    protected slots:
-    void fileChanged(const QString& path);
     void SettingChanged(const Setting& setting, const QVariant& value);
 
    private:
-    shared_qobject_ptr<QFileSystemWatcher> m_watcher;
+    shared_qobject_ptr<RecursiveFileSystemWatcher> m_watcher;
     bool m_isWatching;
     QMap<QString, int> m_nameIndex;
     QList<MMCIcon> m_icons;
     QDir m_dir;
+    QString m_cachePath;
+    /// every file seen in the icons folder, by folder and then by file name
+    QHash<QString, QHash<QString, FileStamp>> m_folders;
 };
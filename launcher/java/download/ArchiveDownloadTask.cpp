@@ -21,7 +21,7 @@
 #include "MMCZip.h"
 
 #include "Application.h"
-#include "Untar.h"
+#include "java/download/StreamingExtractor.h"
 #include "net/ChecksumValidator.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
@@ -29,10 +29,36 @@
 namespace Java {
 ArchiveDownloadTask::ArchiveDownloadTask(QUrl url, QString final_path, QString checksumType, QString checksumHash)
     : m_url(url), m_final_path(final_path), m_checksum_type(checksumType), m_checksum_hash(checksumHash)
-{}
+{
+    m_progress_timer.setInterval(100);
+    connect(&m_progress_timer, &QTimer::timeout, this, &ArchiveDownloadTask::updateStreamProgress);
+}
+
+ArchiveDownloadTask::~ArchiveDownloadTask() = default;
+
+static Net::Validator* checksumValidator(const QString& type, const QString& hash)
+{
+    if (hash.isEmpty() || type.isEmpty())
+        return nullptr;
+    auto hashType = QCryptographicHash::Algorithm::Sha1;
+    if (type == "sha256") {
+        hashType = QCryptographicHash::Algorithm::Sha256;
+    }
+    return new Net::ChecksumValidator(hashType, QByteArray::fromHex(hash.toUtf8()));
+}
 
 void ArchiveDownloadTask::executeTask()
 {
+    auto fileName = m_url.fileName();
+    if (fileName.endsWith("tar")) {
+        streamTar(false);
+        return;
+    }
+    if (fileName.endsWith("tar.gz") || fileName.endsWith("taz") || fileName.endsWith("tgz")) {
+        streamTar(true);
+        return;
+    }
+
     // JRE found ! download the zip
     setStatus(tr("Downloading Java"));
 
@@ -40,13 +66,8 @@ void ArchiveDownloadTask::executeTask()
 
     auto download = makeShared<NetJob>(QString("JRE::DownloadJava"), APPLICATION->network());
     auto action = Net::Download::makeCached(m_url, entry);
-    if (!m_checksum_hash.isEmpty() && !m_checksum_type.isEmpty()) {
-        auto hashType = QCryptographicHash::Algorithm::Sha1;
-        if (m_checksum_type == "sha256") {
-            hashType = QCryptographicHash::Algorithm::Sha256;
-        }
-        action->addValidator(new Net::ChecksumValidator(hashType, QByteArray::fromHex(m_checksum_hash.toUtf8())));
-    }
+    if (auto validator = checksumValidator(m_checksum_type, m_checksum_hash))
+        action->addValidator(validator);
     download->addNetAction(action);
     auto fullPath = entry->getFullPath();
 
@@ -64,31 +85,123 @@ void ArchiveDownloadTask::executeTask()
     m_task->start();
 }
 
-void ArchiveDownloadTask::extractJava(QString input)
+void ArchiveDownloadTask::streamTar(bool gzipped)
 {
-    setStatus(tr("Extracting Java"));
-    if (input.endsWith("tar")) {
-        setStatus(tr("Extracting Java (Progress is not reported for tar archives)"));
-        QFile in(input);
-        if (!in.open(QFile::ReadOnly)) {
-            emitFailed(tr("Unable to open supplied tar file."));
-            return;
-        }
-        if (!Tar::extract(&in, QDir(m_final_path).absolutePath())) {
-            emitFailed(tr("Unable to extract supplied tar file."));
-            return;
-        }
-        emitSucceeded();
+    // The archive is unpacked on a worker thread while it downloads, and nothing of it is kept on disk.
+    // The checksum can only be checked once the last byte is in, so the files wait in a staging folder until then.
+    setStatus(tr("Downloading and extracting Java"));
+
+    m_downloaded = false;
+    m_extracted = false;
+    m_extract_step = std::make_shared<TaskStepProgress>();
+    m_extract_step->status = tr("Extracting Java");
+
+    auto download = makeShared<NetJob>(QString("JRE::StreamJava"), APPLICATION->network());
+    auto action = Net::Download::makeStream(
+        m_url,
+        [this, gzipped] {
+            // a retried request starts over, and so does the extraction.
+            // Both use the same staging folder, so the old one has to be cleaned up before the new one starts writing.
+            m_extracted = false;
+            m_extractor.reset();
+            m_extractor = std::make_unique<StreamingExtractor>(m_final_path, gzipped);
+            connect(m_extractor.get(), &StreamingExtractor::finished, this, [this](bool ok) {
+                if (!isRunning())
+                    return;
+                if (!ok) {
+                    m_progress_timer.stop();
+                    m_task->disconnect(this);
+                    m_task->abort();
+                    m_extract_step->state = TaskStepState::Failed;
+                    emit stepProgress(*m_extract_step);
+                    emitFailed(tr("Unable to extract the Java archive."));
+                    return;
+                }
+                m_extracted = true;
+                streamFinished();
+            });
+            // a fast network does not get to pile the archive up in memory while a slow disk catches up
+            connect(m_extractor.get(), &StreamingExtractor::readyForData, m_stream.get(), &Net::NetRequest::resumeReading);
+            return true;
+        },
+        [this](const QByteArray& data) {
+            m_extractor->write(data);
+            return true;
+        },
+        [this] { return m_extractor->canWrite(); });
+    if (auto validator = checksumValidator(m_checksum_type, m_checksum_hash))
+        action->addValidator(validator);
+    m_stream = action;
+    download->addNetAction(action);
+
+    auto stop = [this] {
+        m_progress_timer.stop();
+        if (m_extractor)
+            m_extractor->cancel();
+    };
+    connect(download.get(), &Task::failed, this, [this, stop](QString reason) {
+        stop();
+        emitFailed(reason);
+    });
+    connect(download.get(), &Task::aborted, this, [this, stop] {
+        stop();
+        emitAborted();
+    });
+    connect(download.get(), &Task::progress, this, [this](qint64 current, qint64 total) {
+        m_bytes_downloaded = current;
+        m_bytes_total = total;
+    });
+    connect(download.get(), &Task::stepProgress, this, &ArchiveDownloadTask::propagateStepProgress);
+    connect(download.get(), &Task::details, this, &ArchiveDownloadTask::setDetails);
+    connect(download.get(), &Task::succeeded, this, [this] {
+        m_downloaded = true;
+        m_extractor->endOfData();
+        streamFinished();
+    });
+    m_task = download;
+    m_progress_timer.start();
+    m_task->start();
+}
+
+void ArchiveDownloadTask::streamFinished()
+{
+    if (!m_downloaded || !m_extracted)
         return;
-    } else if (input.endsWith("tar.gz") || input.endsWith("taz") || input.endsWith("tgz")) {
-        setStatus(tr("Extracting Java (Progress is not reported for tar archives)"));
-        if (!GZTar::extract(input, QDir(m_final_path).absolutePath())) {
-            emitFailed(tr("Unable to extract supplied tar file."));
-            return;
-        }
-        emitSucceeded();
+
+    m_progress_timer.stop();
+    updateStreamProgress();
+
+    if (!m_extractor->commit()) {
+        m_extract_step->state = TaskStepState::Failed;
+        emit stepProgress(*m_extract_step);
+        emitFailed(tr("Unable to move the extracted Java into place."));
         return;
-    } else if (input.endsWith("zip")) {
+    }
+    m_extract_step->state = TaskStepState::Succeeded;
+    emit stepProgress(*m_extract_step);
+    emitSucceeded();
+}
+
+void ArchiveDownloadTask::updateStreamProgress()
+{
+    auto consumed = m_extractor ? m_extractor->consumed() : 0;
+    if (m_bytes_total <= 0) {
+        setProgress(0, 0);
+        return;
+    }
+    if (consumed != m_extract_step->current) {
+        m_extract_step->update(consumed, m_bytes_total);
+        emit stepProgress(*m_extract_step);
+    }
+    // both stages count the archive's bytes
+    setProgress(m_bytes_downloaded + consumed, m_bytes_total * 2);
+}
+
+void ArchiveDownloadTask::extractJava(QString input)
+{
+    setStatus(tr("Extracting Java"));
+    // tar archives are streamed instead, see streamTar()
+    if (input.endsWith("zip")) {
         auto zip = std::make_shared<QuaZip>(input);
         if (!zip->open(QuaZip::mdUnzip)) {
             emitFailed(tr("Unable to open supplied zip file."));
@@ -134,6 +247,8 @@ void ArchiveDownloadTask::extractJava(QString input)
 bool ArchiveDownloadTask::abort()
 {
     auto aborted = canAbort();
+    if (m_extractor)
+        m_extractor->cancel();
     if (m_task)
         aborted = m_task->abort();
     return aborted;
@@ -18,15 +18,24 @@
 
 #pragma once
 
+#include <QTimer>
 #include <QUrl>
+#include <memory>
+#include "QObjectPtr.h"
 #include "tasks/Task.h"
 
+namespace Net {
+class Download;
+}
+
 namespace Java {
+class StreamingExtractor;
+
 class ArchiveDownloadTask : public Task {
     Q_OBJECT
    public:
     ArchiveDownloadTask(QUrl url, QString final_path, QString checksumType = "", QString checksumHash = "");
-    virtual ~ArchiveDownloadTask() = default;
+    virtual ~ArchiveDownloadTask();
 
     bool canAbort() const override { return true; }
     void executeTask() override;
@@ -35,11 +44,27 @@ class ArchiveDownloadTask : public Task {
    private slots:
     void extractJava(QString input);
 
+   private:
+    //! Downloads and unpacks tar archives at the same time
+    void streamTar(bool gzipped);
+    void streamFinished();
+    void updateStreamProgress();
+
    protected:
     QUrl m_url;
     QString m_final_path;
     QString m_checksum_type;
     QString m_checksum_hash;
     Task::Ptr m_task;
+
+   private:
+    std::unique_ptr<StreamingExtractor> m_extractor;
+    shared_qobject_ptr<Net::Download> m_stream;
+    bool m_downloaded = false;
+    bool m_extracted = false;
+    qint64 m_bytes_downloaded = 0;
+    qint64 m_bytes_total = 0;
+    std::shared_ptr<TaskStepProgress> m_extract_step;
+    QTimer m_progress_timer;
 };
-}  // namespace Java
\ No newline at end of file
+}  // namespace Java
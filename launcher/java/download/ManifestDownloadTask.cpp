@@ -17,23 +17,48 @@
  */
 #include "java/download/ManifestDownloadTask.h"
 
+#include <QSet>
+
 #include "Application.h"
 #include "FileSystem.h"
 #include "Json.h"
+#include "LZMA.h"
+#include "java/download/RuntimeStore.h"
 #include "net/ChecksumValidator.h"
 #include "net/NetJob.h"
 
-struct File {
-    QString path;
-    QString url;
-    QByteArray hash;
-    bool isExec;
-};
-
 namespace Java {
 ManifestDownloadTask::ManifestDownloadTask(QUrl url, QString final_path, QString checksumType, QString checksumHash)
     : m_url(url), m_final_path(final_path), m_checksum_type(checksumType), m_checksum_hash(checksumHash)
-{}
+{
+    connect(&m_install_watcher, &QFutureWatcher<QString>::finished, this, &ManifestDownloadTask::installFinished);
+}
+
+/** Decodes a downloaded lzma object into the store. Returns why it failed, if it did. */
+static QString unpackObject(const RuntimeStore& store, const QString& sha1, const QString& packed, const Executor::CancelToken& cancel)
+{
+    auto staging = store.stagingPath(sha1, ".part");
+    QString error;
+    {
+        QFile in(packed);
+        QFile out(staging);
+        if (!in.open(QIODevice::ReadOnly)) {
+            error = in.errorString();
+        } else if (!out.open(QIODevice::WriteOnly)) {
+            error = out.errorString();
+        } else if (LZMA::decode(&in, &out, &error, cancel.flag()) && !RuntimeStore::verify(staging, sha1)) {
+            error = QObject::tr("Checksum mismatch");
+        }
+    }
+    QFile::remove(packed);
+    if (!error.isEmpty()) {
+        QFile::remove(staging);
+        return QObject::tr("Unable to unpack %1: %2").arg(sha1, error);
+    }
+    if (!store.insert(staging, sha1))
+        return QObject::tr("Unable to store %1").arg(sha1);
+    return {};
+}
 
 void ManifestDownloadTask::executeTask()
 {
@@ -76,7 +101,13 @@ void ManifestDownloadTask::downloadJava(const QJsonDocument& doc)
 {
     // valid json doc, begin making jre spot
     FS::ensureFolderPathExists(m_final_path);
-    std::vector<File> toDownload;
+    // the runtimes share most of their files, so each is only fetched once for all of them
+    auto store = RuntimeStore::forJavaDir();
+    QSet<QString> queued;
+    m_files.clear();
+    m_unpacking.clear();
+
+    auto elementDownload = makeShared<NetJob>("JRE::FileDownload", APPLICATION->network());
     auto list = Json::ensureObject(Json::ensureObject(doc.object()), "files");
     for (const auto& paths : list.keys()) {
         auto file = FS::PathCombine(m_final_path, paths);
@@ -92,43 +123,110 @@ void ManifestDownloadTask::downloadJava(const QJsonDocument& doc)
                 QFile::link(path, file);
             }
         } else if (type == "file") {
-            // TODO download compressed version if it exists ?
-            auto raw = Json::ensureObject(Json::ensureObject(meta, "downloads"), "raw");
+            auto downloads = Json::ensureObject(meta, "downloads");
+            auto raw = Json::ensureObject(downloads, "raw");
             auto isExec = Json::ensureBoolean(meta, "executable", false);
             auto url = Json::ensureString(raw, "url");
-            if (!url.isEmpty() && QUrl(url).isValid()) {
-                auto f = File{ file, url, QByteArray::fromHex(Json::ensureString(raw, "sha1").toLatin1()), isExec };
-                toDownload.push_back(f);
+            auto sha1 = Json::ensureString(raw, "sha1").toLower();
+            if (url.isEmpty() || !QUrl(url).isValid()) {
+                continue;
+            }
+            if (sha1.isEmpty()) {
+                // nothing to share it by
+                auto dl = Net::Download::makeFile(url, file);
+                if (isExec) {
+                    connect(dl.get(), &Net::Download::succeeded,
+                            [file] { QFile(file).setPermissions(QFile(file).permissions() | QFileDevice::Permissions(0x1111)); });
+                }
+                elementDownload->addNetAction(dl);
+                continue;
+            }
+
+            m_files.push_back(File{ file, sha1, isExec });
+            auto size = static_cast<qint64>(Json::ensureDouble(raw, "size", -1));
+            if (queued.contains(sha1) || store->contains(sha1, size)) {
+                continue;
+            }
+            queued.insert(sha1);
+
+            auto lzma = Json::ensureObject(downloads, "lzma");
+            auto lzmaUrl = Json::ensureString(lzma, "url");
+            if (!lzmaUrl.isEmpty() && QUrl(lzmaUrl).isValid()) {
+                auto packed = store->stagingPath(sha1, ".lzma");
+                auto dl = Net::Download::makeFile(lzmaUrl, packed);
+                auto lzmaSha1 = Json::ensureString(lzma, "sha1");
+                if (!lzmaSha1.isEmpty()) {
+                    dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(lzmaSha1.toLatin1())));
+                }
+                connect(dl.get(), &Net::Download::succeeded, this, [this, store, sha1, packed] {
+                    // unpack while the other files are still downloading
+                    m_unpacking.append(Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel,
+                                                     [store, sha1, packed, cancel = m_cancel] { return unpackObject(*store, sha1, packed, cancel); }));
+                });
+                elementDownload->addNetAction(dl);
+            } else {
+                auto staging = store->stagingPath(sha1, ".part");
+                auto dl = Net::Download::makeFile(url, staging);
+                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(sha1.toLatin1())));
+                connect(dl.get(), &Net::Download::succeeded, this, [store, sha1, staging] { store->insert(staging, sha1); });
+                elementDownload->addNetAction(dl);
             }
         }
     }
-    auto elementDownload = makeShared<NetJob>("JRE::FileDownload", APPLICATION->network());
-    for (const auto& file : toDownload) {
-        auto dl = Net::Download::makeFile(file.url, file.path);
-        if (!file.hash.isEmpty()) {
-            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, file.hash));
-        }
-        if (file.isExec) {
-            connect(dl.get(), &Net::Download::succeeded,
-                    [file] { QFile(file.path).setPermissions(QFile(file.path).permissions() | QFileDevice::Permissions(0x1111)); });
-        }
-        elementDownload->addNetAction(dl);
-    }
 
-    connect(elementDownload.get(), &Task::failed, this, &ManifestDownloadTask::emitFailed);
+    connect(elementDownload.get(), &Task::failed, this, [this](QString reason) {
+        m_cancel.cancel();
+        emitFailed(reason);
+    });
     connect(elementDownload.get(), &Task::progress, this, &ManifestDownloadTask::setProgress);
     connect(elementDownload.get(), &Task::stepProgress, this, &ManifestDownloadTask::propagateStepProgress);
     connect(elementDownload.get(), &Task::status, this, &ManifestDownloadTask::setStatus);
     connect(elementDownload.get(), &Task::details, this, &ManifestDownloadTask::setDetails);
 
-    connect(elementDownload.get(), &Task::succeeded, this, &ManifestDownloadTask::emitSucceeded);
+    connect(elementDownload.get(), &Task::succeeded, this, [this, store] {
+        setStatus(tr("Installing Java"));
+        setProgress(0, 0);
+        auto unpacking = m_unpacking;
+        auto files = m_files;
+        m_install_watcher.setFuture(Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [store, unpacking, files] {
+            for (auto future : unpacking) {
+                future.waitForFinished();
+                if (future.isCanceled())
+                    return tr("Java installation was cancelled");
+                if (auto error = future.result(); !error.isEmpty())
+                    return error;
+            }
+            for (const auto& file : files) {
+                if (!store->materialize(file.sha1, file.path, file.isExec))
+                    return tr("Unable to place %1").arg(file.path);
+            }
+            return QString();
+        }));
+    });
     m_task = elementDownload;
     m_task->start();
 }
 
+void ManifestDownloadTask::installFinished()
+{
+    if (!isRunning())
+        return;
+    auto future = m_install_watcher.future();
+    if (future.isCanceled()) {
+        emitAborted();
+        return;
+    }
+    if (auto error = future.result(); !error.isEmpty()) {
+        emitFailed(error);
+        return;
+    }
+    emitSucceeded();
+}
+
 bool ManifestDownloadTask::abort()
 {
     auto aborted = canAbort();
+    m_cancel.cancel();
     if (m_task)
         aborted = m_task->abort();
     emitAborted();
@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <QFutureWatcher>
 #include <QUrl>
+#include <vector>
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 namespace Java {
@@ -35,6 +38,7 @@ class ManifestDownloadTask : public Task {
 
    private slots:
     void downloadJava(const QJsonDocument& doc);
+    void installFinished();
 
    protected:
     QUrl m_url;
@@ -42,5 +46,18 @@ class ManifestDownloadTask : public Task {
     QString m_checksum_type;
     QString m_checksum_hash;
     Task::Ptr m_task;
+
+   private:
+    struct File {
+        QString path;
+        QString sha1;
+        bool isExec;
+    };
+    //! Files to place from the runtime store once everything is in it
+    std::vector<File> m_files;
+    //! Objects being unpacked from their lzma downloads
+    QList<QFuture<QString>> m_unpacking;
+    QFutureWatcher<QString> m_install_watcher;
+    Executor::CancelToken m_cancel;
 };
 }  // namespace Java
\ No newline at end of file
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "java/download/RuntimeStore.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QUuid>
+
+#include <filesystem>
+#include <system_error>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "StringUtils.h"
+
+namespace Java {
+
+RuntimeStore::RuntimeStore(QString root) : m_root(std::move(root)) {}
+
+std::shared_ptr<RuntimeStore> RuntimeStore::forJavaDir()
+{
+    return std::make_shared<RuntimeStore>(FS::PathCombine(APPLICATION->javaPath(), ".objects"));
+}
+
+QString RuntimeStore::objectPath(const QString& sha1) const
+{
+    auto hash = sha1.toLower();
+    return FS::PathCombine(m_root, hash.left(2), hash);
+}
+
+bool RuntimeStore::contains(const QString& sha1, qint64 size) const
+{
+    QFileInfo info(objectPath(sha1));
+    return info.isFile() && (size < 0 || info.size() == size);
+}
+
+QString RuntimeStore::stagingPath(const QString& sha1, const QString& suffix) const
+{
+    // runtimes installed at once may fetch the same object, each into its own file
+    return QString("%1.%2%3").arg(objectPath(sha1), QUuid::createUuid().toString(QUuid::Id128).left(12), suffix);
+}
+
+bool RuntimeStore::insert(const QString& file, const QString& sha1) const
+{
+    auto object = objectPath(sha1);
+    if (!FS::ensureFilePathExists(object))
+        return false;
+    // a file may appear in several runtimes being installed at once: the rename replaces their equal copy in one step
+    std::error_code err;
+    std::filesystem::rename(StringUtils::toStdString(file), StringUtils::toStdString(object), err);
+    if (err) {
+        QFile::remove(file);
+        // where the object cannot be replaced, e.g. while it is open on Windows, the copy already there does just as well
+        if (!QFileInfo(object).isFile()) {
+            qWarning() << "Unable to move" << file << "into the Java runtime store:" << QString::fromStdString(err.message());
+            return false;
+        }
+    }
+    QMutexLocker locker(&m_lock);
+    m_verified.insert(sha1.toLower());
+    return true;
+}
+
+bool RuntimeStore::checkObject(const QString& sha1) const
+{
+    auto hash = sha1.toLower();
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_verified.contains(hash))
+            return true;
+    }
+    // contains() only compares sizes, so objects stored by an earlier run are hashed once before being linked
+    auto object = objectPath(hash);
+    if (!verify(object, hash)) {
+        qWarning() << "Java runtime object" << hash << "does not match its sha1, removing it";
+        QFile::remove(object);
+        return false;
+    }
+    QMutexLocker locker(&m_lock);
+    m_verified.insert(hash);
+    return true;
+}
+
+bool RuntimeStore::materialize(const QString& sha1, const QString& dest, bool executable)
+{
+    auto object = objectPath(sha1);
+    if (!checkObject(sha1))
+        return false;
+
+    auto exec = QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup | QFileDevice::ExeOther;
+    if (executable) {
+        // links share the permissions of the object, and an executable bit does not hurt the runtimes that share it
+        QFile::setPermissions(object, QFile::permissions(object) | exec);
+    }
+
+    if (!FS::ensureFilePathExists(dest))
+        return false;
+    QFile::remove(dest);
+
+    if (m_method == Method::Unknown)
+        m_method = FS::canClone(object, dest) ? Method::Clone : Method::HardLink;
+
+    if (m_method == Method::Clone) {
+        std::error_code err;
+        if (FS::clone_file(object, dest, err))
+            return true;
+        qDebug() << "Unable to clone Java runtime files, falling back to hard links:" << QString::fromStdString(err.message());
+        m_method = Method::HardLink;
+    }
+
+    if (m_method == Method::HardLink) {
+        std::error_code err;
+        std::filesystem::create_hard_link(StringUtils::toStdString(object), StringUtils::toStdString(dest), err);
+        if (!err)
+            return true;
+        qDebug() << "Unable to hard link Java runtime files, falling back to copies:" << QString::fromStdString(err.message());
+        m_method = Method::Copy;
+    }
+
+    if (!QFile::copy(object, dest))
+        return false;
+    if (executable)
+        QFile::setPermissions(dest, QFile::permissions(dest) | exec);
+    return true;
+}
+
+bool RuntimeStore::verify(const QString& file, const QString& sha1)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&f))
+        return false;
+    return hash.result().toHex() == sha1.toLower().toLatin1();
+}
+
+}  // namespace Java
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <memory>
+
+namespace Java {
+
+/**
+ * Files of Mojang's Java runtimes, kept once by their sha1 and shared by every runtime that contains them.
+ *
+ * Runtimes are built from reflinks or hard links to the objects where the filesystem allows, and from copies where it
+ * does not. Only files that were checked against their hash get in.
+ */
+class RuntimeStore {
+   public:
+    explicit RuntimeStore(QString root);
+
+    /** The store next to the managed runtimes, so that links into it stay on one filesystem. */
+    static std::shared_ptr<RuntimeStore> forJavaDir();
+
+    QString objectPath(const QString& sha1) const;
+    /** If the object is stored, with the size the manifest lists for it (-1 when unknown). */
+    bool contains(const QString& sha1, qint64 size = -1) const;
+    /** Where to download or unpack an object to before it gets inserted, unique to each call. */
+    QString stagingPath(const QString& sha1, const QString& suffix) const;
+
+    /** Moves a checked file into the store. Storing an object that is already there succeeds. */
+    bool insert(const QString& file, const QString& sha1) const;
+    /** Places the object at @p dest, replacing what is there. Objects not checked since the launch are hashed first. */
+    bool materialize(const QString& sha1, const QString& dest, bool executable);
+
+    static bool verify(const QString& file, const QString& sha1);
+
+   private:
+    /** If the stored object matches its sha1. Removes it when it does not. */
+    bool checkObject(const QString& sha1) const;
+
+    enum class Method { Unknown, Clone, HardLink, Copy };
+
+    QString m_root;
+    Method m_method = Method::Unknown;
+
+    mutable QMutex m_lock;
+    //! objects known to match their sha1
+    mutable QSet<QString> m_verified;
+};
+
+}  // namespace Java
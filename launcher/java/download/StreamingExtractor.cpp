@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "java/download/StreamingExtractor.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+
+#include "FileSystem.h"
+#include "GZip.h"
+#include "Untar.h"
+
+namespace Java {
+
+/**
+ * Bytes written on one thread and read on another. Reads wait until the requested amount is there or the data ended.
+ *
+ * Writes never block, so the writer is expected to hold back while hasRoom() says no. The reader calls the drained
+ * callback once it made room again.
+ */
+class BlockingPipe : public QIODevice {
+   public:
+    //! How much may be queued before the writer should hold back
+    static constexpr qint64 s_capacity = 8 * 1024 * 1024;
+
+    void push(const QByteArray& data)
+    {
+        QMutexLocker locker(&m_lock);
+        m_chunks.enqueue(data);
+        m_queued += data.size();
+        m_ready.wakeAll();
+    }
+    bool hasRoom()
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_queued < s_capacity)
+            return true;
+        m_writer_waiting = true;
+        return false;
+    }
+    //! Called on the reading thread, must be set before the reader starts
+    void setDrained(std::function<void()> drained) { m_drained = std::move(drained); }
+    void endOfData()
+    {
+        QMutexLocker locker(&m_lock);
+        m_ended = true;
+        m_ready.wakeAll();
+    }
+    void cancel()
+    {
+        QMutexLocker locker(&m_lock);
+        m_cancelled = true;
+        m_chunks.clear();
+        m_queued = 0;
+        m_ready.wakeAll();
+    }
+
+    qint64 consumed() const { return m_consumed; }
+    bool isSequential() const override { return true; }
+
+   protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        QMutexLocker locker(&m_lock);
+        qint64 copied = 0;
+        while (copied < maxSize) {
+            while (m_chunks.isEmpty() && !m_ended && !m_cancelled)
+                m_ready.wait(&m_lock);
+            if (m_cancelled) {
+                setErrorString(QStringLiteral("Cancelled"));
+                return -1;
+            }
+            if (m_chunks.isEmpty())
+                break;
+
+            auto& chunk = m_chunks.head();
+            auto count = std::min<qint64>(maxSize - copied, chunk.size() - m_offset);
+            std::memcpy(data + copied, chunk.constData() + m_offset, count);
+            copied += count;
+            m_offset += count;
+            m_queued -= count;
+            if (m_offset == chunk.size()) {
+                m_chunks.dequeue();
+                m_offset = 0;
+            }
+        }
+        m_consumed += copied;
+
+        // wake the writer once half of the pipe is free, not on every read
+        bool drained = m_writer_waiting && m_queued <= s_capacity / 2;
+        if (drained)
+            m_writer_waiting = false;
+        locker.unlock();
+        if (drained && m_drained)
+            m_drained();
+        return copied;
+    }
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+   private:
+    QMutex m_lock;
+    QWaitCondition m_ready;
+    QQueue<QByteArray> m_chunks;
+    qint64 m_offset = 0;
+    qint64 m_queued = 0;
+    bool m_writer_waiting = false;
+    std::function<void()> m_drained;
+    bool m_ended = false;
+    bool m_cancelled = false;
+    std::atomic<qint64> m_consumed = 0;
+};
+
+StreamingExtractor::StreamingExtractor(QString target, bool gzipped, QObject* parent)
+    : QObject(parent), m_target(QDir(target).absolutePath()), m_pipe(std::make_shared<BlockingPipe>())
+{
+    QFileInfo info(m_target);
+    m_staging = FS::PathCombine(info.path(), "." + info.fileName() + ".partial");
+    // leftovers of an earlier attempt that did not get to clean up
+    FS::deletePath(m_staging);
+
+    m_pipe->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    // the worker outlives neither the pipe nor this object, see the destructor
+    m_pipe->setDrained([this] { QMetaObject::invokeMethod(this, &StreamingExtractor::readyForData, Qt::QueuedConnection); });
+
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, &StreamingExtractor::workerFinished);
+    m_future = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, m_cancel, [pipe = m_pipe, staging = m_staging, gzipped] {
+        if (!gzipped)
+            return Tar::extract(pipe.get(), staging);
+
+        GZip::InflateDevice inflated(pipe.get());
+        if (!inflated.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            qWarning() << "Could not read the compressed archive:" << inflated.errorString();
+            return false;
+        }
+        return Tar::extract(&inflated, staging);
+    });
+    m_watcher.setFuture(m_future);
+}
+
+StreamingExtractor::~StreamingExtractor()
+{
+    cancel();
+    m_watcher.disconnect(this);
+    m_future.waitForFinished();
+    if (!m_committed)
+        FS::deletePath(m_staging);
+}
+
+void StreamingExtractor::write(const QByteArray& data)
+{
+    m_pipe->push(data);
+}
+
+bool StreamingExtractor::canWrite() const
+{
+    return m_pipe->hasRoom();
+}
+
+void StreamingExtractor::endOfData()
+{
+    m_pipe->endOfData();
+}
+
+void StreamingExtractor::cancel()
+{
+    m_pipe->cancel();
+    m_cancel.cancel();
+}
+
+qint64 StreamingExtractor::consumed() const
+{
+    return m_pipe->consumed();
+}
+
+void StreamingExtractor::workerFinished()
+{
+    bool ok = !m_future.isCanceled() && m_future.result();
+    if (!ok)
+        FS::deletePath(m_staging);
+    emit finished(ok);
+}
+
+bool StreamingExtractor::commit()
+{
+    if (m_committed)
+        return true;
+    if (!m_future.isFinished() || m_future.isCanceled() || !m_future.result())
+        return false;
+
+    if (QFileInfo::exists(m_target) && !FS::deletePath(m_target)) {
+        qWarning() << "Could not remove the previous contents of" << m_target;
+        return false;
+    }
+    if (!QDir().rename(m_staging, m_target)) {
+        qWarning() << "Could not move" << m_staging << "to" << m_target;
+        return false;
+    }
+    m_committed = true;
+    return true;
+}
+
+}  // namespace Java
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+#include "tasks/Executor.h"
+
+namespace Java {
+class BlockingPipe;
+
+/**
+ * Unpacks a tar archive, gzip compressed or not, on a worker thread while its bytes are still arriving.
+ *
+ * Everything lands in a hidden folder next to the target first. commit() moves it into place in one rename, and it is
+ * removed when the extraction fails or is cancelled, so the target never ends up half written.
+ */
+class StreamingExtractor : public QObject {
+    Q_OBJECT
+   public:
+    StreamingExtractor(QString target, bool gzipped, QObject* parent = nullptr);
+    ~StreamingExtractor() override;
+
+    //! Hands over the next part of the archive, never blocks
+    void write(const QByteArray& data);
+    //! If the worker keeps up with what was written. When it does not, readyForData() tells when it caught up.
+    bool canWrite() const;
+    //! No more data is coming
+    void endOfData();
+    //! Stops the worker, what it extracted is thrown away
+    void cancel();
+
+    //! How much of the archive the worker went through so far
+    qint64 consumed() const;
+
+    //! Moves the extracted files to the target, replacing what was there. Only valid after finished(true).
+    bool commit();
+
+   signals:
+    //! The worker stopped, after reading the whole archive or because it failed
+    void finished(bool ok);
+    //! The worker made room for more data after canWrite() said no
+    void readyForData();
+
+   private:
+    void workerFinished();
+
+   private:
+    QString m_target;
+    QString m_staging;
+    bool m_committed = false;
+
+    std::shared_ptr<BlockingPipe> m_pipe;
+    Executor::CancelToken m_cancel;
+    QFuture<bool> m_future;
+    QFutureWatcher<bool> m_watcher;
+};
+}  // namespace Java
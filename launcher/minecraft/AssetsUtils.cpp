@@ -52,6 +52,7 @@
 
 #include "Application.h"
 #include "net/NetRequest.h"
+#include "tasks/Executor.h"
 
 namespace {
 QSet<QString> collectPathsFromDir(QString dirPath)
@@ -277,10 +278,16 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
 
 }  // namespace AssetsUtils
 
+bool AssetObject::isMissing()
+{
+    QFileInfo objectFile(getLocalPath());
+    return !objectFile.isFile() || objectFile.size() != size;
+}
+
 Net::NetRequest::Ptr AssetObject::getDownloadAction()
 {
     QFileInfo objectFile(getLocalPath());
-    if ((!objectFile.isFile()) || (objectFile.size() != size)) {
+    if (isMissing()) {
         auto objectDL = Net::ApiDownload::makeFile(getUrl(), objectFile.filePath());
         if (hash.size()) {
             objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, hash));
@@ -310,7 +317,10 @@ QString AssetObject::getRelPath()
 NetJob::Ptr AssetsIndex::getDownloadJob()
 {
     auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto& object : objects.values()) {
+    // thousands of stat calls, which mostly wait on the disk, so make many at once
+    auto missing = QtConcurrent::blockingFiltered(Executor::pool(Executor::Kind::IO, Executor::Priority::Interactive), objects.values(),
+                                                  [](AssetObject object) { return object.isMissing(); });
+    for (auto& object : missing) {
         auto dl = object.getDownloadAction();
         if (dl) {
             job->addNetAction(dl);
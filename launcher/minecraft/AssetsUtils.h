@@ -24,6 +24,8 @@ struct AssetObject {
     QString getRelPath();
     QUrl getUrl();
     QString getLocalPath();
+    /// if the object is not on disk yet, or has the wrong size
+    bool isMissing();
     Net::NetRequest::Ptr getDownloadAction();
 
     QString hash;
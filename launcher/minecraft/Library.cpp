@@ -158,6 +158,18 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         return true;
     };
 
+    forEachDownload(runtimeContext, add_download);
+    return out;
+}
+
+/**
+ * @brief Visit the storage path, URL and SHA-1 of every file the library is made of.
+ *
+ * @param runtimeContext The current runtime context.
+ * @param visit Called once per file.
+ */
+void Library::forEachDownload(const RuntimeContext& runtimeContext, const std::function<void(QString, QString, QString)>& visit) const
+{
     QString raw_storage = storageSuffix(runtimeContext);
     if (m_mojangDownloads) {
         if (isNative()) {
@@ -172,18 +184,18 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
                     if (nat32info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "32");
-                        add_download(cooked_storage, nat32info->url, nat32info->sha1);
+                        visit(cooked_storage, nat32info->url, nat32info->sha1);
                     }
                     auto nat64info = m_mojangDownloads->getDownloadInfo(nat64Classifier);
                     if (nat64info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "64");
-                        add_download(cooked_storage, nat64info->url, nat64info->sha1);
+                        visit(cooked_storage, nat64info->url, nat64info->sha1);
                     }
                 } else {
                     auto info = m_mojangDownloads->getDownloadInfo(nativeClassifier);
                     if (info) {
-                        add_download(raw_storage, info->url, info->sha1);
+                        visit(raw_storage, info->url, info->sha1);
                     }
                 }
             } else {
@@ -192,7 +204,7 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         } else {
             if (m_mojangDownloads->artifact) {
                 auto artifact = m_mojangDownloads->artifact;
-                add_download(raw_storage, artifact->url, artifact->sha1);
+                visit(raw_storage, artifact->url, artifact->sha1);
             } else {
                 qDebug() << "Ignoring java library" << m_name.serialize() << "because it has no artifact";
             }
@@ -216,15 +228,31 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         if (raw_storage.contains("${arch}")) {
             QString cooked_storage = raw_storage;
             QString cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
+            visit(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
             cooked_storage = raw_storage;
             cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
+            visit(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
         } else {
-            add_download(raw_storage, raw_dl, QString());
+            visit(raw_storage, raw_dl, QString());
         }
     }
-    return out;
+}
+
+/**
+ * @brief Get the paths in the "libraries" cache base that getDownloads() resolves.
+ *
+ * Lets callers resolve the cache entries of many libraries in one batch first.
+ *
+ * @param runtimeContext The current runtime context.
+ * @return QStringList Empty for local libraries, which are not cached.
+ */
+QStringList Library::getCacheStoragePaths(const RuntimeContext& runtimeContext) const
+{
+    QStringList paths;
+    if (isLocal())
+        return paths;
+    forEachDownload(runtimeContext, [&paths](QString storage, QString, QString) { paths.append(storage); });
+    return paths;
 }
 
 /**
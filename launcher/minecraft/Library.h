@@ -41,6 +41,7 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <functional>
 #include <memory>
 
 #include "GradleSpecifier.h"
@@ -149,9 +150,14 @@ class Library {
                                              QStringList& failedLocalFiles,
                                              const QString& overridePath) const;
 
+    // Get the paths getDownloads() looks up in the metacache
+    QStringList getCacheStoragePaths(const RuntimeContext& runtimeContext) const;
+
     QString getCompatibleNative(const RuntimeContext& runtimeContext) const;
 
    private: /* methods */
+    void forEachDownload(const RuntimeContext& runtimeContext, const std::function<void(QString, QString, QString)>& visit) const;
+
     /// the default storage prefix used by ALLauncher
     static QString defaultStoragePrefix();
 
@@ -36,16 +36,19 @@
 #include "WorldList.h"
 
 #include <FileSystem.h>
+#include <QDateTime>
 #include <QDebug>
 #include <QDirIterator>
 #include <QFileSystemWatcher>
 #include <QMimeData>
 #include <QString>
-#include <QThreadPool>
 #include <QUrl>
 #include <QUuid>
 #include <Qt>
 
+#include "Exception.h"
+#include "Json.h"
+
 WorldList::WorldList(const QString& dir, BaseInstance* instance) : QAbstractListModel(), m_instance(instance), m_dir(dir)
 {
     FS::ensureFolderPathExists(m_dir.absolutePath());
@@ -56,6 +59,13 @@ WorldList::WorldList(const QString& dir, BaseInstance* instance) : QAbstractList
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &WorldList::directoryChanged);
 }
 
+WorldList::~WorldList()
+{
+    auto scans = m_sizeScans;
+    cancelSizeScans();
+    scans.waitForFinished();
+}
+
 void WorldList::startWatching()
 {
     if (m_isWatching) {
@@ -72,6 +82,8 @@ void WorldList::startWatching()
 
 void WorldList::stopWatching()
 {
+    // nobody is looking anymore
+    cancelSizeScans();
     if (!m_isWatching) {
         return;
     }
@@ -419,39 +431,158 @@ int64_t calculateWorldSize(const QFileInfo& file)
     if (file.isFile() && file.suffix() == "zip") {
         return file.size();
     } else if (file.isDir()) {
-        QDirIterator it(file.absoluteFilePath(), QDir::Files, QDirIterator::Subdirectories);
-        int64_t total = 0;
-        while (it.hasNext()) {
-            it.next();
-            total += it.fileInfo().size();
-        }
-        return total;
+        return FS::directorySize(file.absoluteFilePath());
     }
     return -1;
 }
 
+// Minecraft rewrites level.dat on every save and adds files to the region folders as chunks get generated,
+// so the size of a world can not have changed as long as none of these changed
+static QString worldSizeStamp(const QFileInfo& world)
+{
+    static const QStringList s_paths = { ".", "level.dat", "region", "entities", "poi", "DIM-1/region", "DIM1/region" };
+    QDir dir(world.absoluteFilePath());
+    QStringList stamp;
+    for (auto& path : s_paths) {
+        QFileInfo info(dir.filePath(path));
+        stamp << (info.exists() ? QString::number(info.lastModified().toMSecsSinceEpoch()) : "-");
+    }
+    return stamp.join(':');
+}
+
+QString WorldList::sizeCachePath() const
+{
+    return FS::PathCombine(QDir("cache").absolutePath(), "worldsizes", m_instance->id() + ".json");
+}
+
+void WorldList::loadSizeCache()
+{
+    if (m_sizeCacheLoaded) {
+        return;
+    }
+    m_sizeCacheLoaded = true;
+    if (!QFileInfo::exists(sizeCachePath())) {
+        return;
+    }
+    try {
+        auto doc = Json::requireDocument(sizeCachePath(), "World size cache");
+        m_sizeCache = Json::ensureObject(Json::requireObject(doc), "worlds");
+    } catch (const Exception& e) {
+        qWarning() << "Failed to read world size cache:" << e.cause();
+    }
+}
+
+void WorldList::saveSizeCache()
+{
+    if (!m_sizeCacheDirty) {
+        return;
+    }
+    m_sizeCacheDirty = false;
+    QJsonObject toplevel;
+    toplevel.insert("version", 1);
+    toplevel.insert("worlds", m_sizeCache);
+    try {
+        Json::write(toplevel, sizeCachePath());
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write world size cache:" << e.cause();
+    }
+}
+
+void WorldList::cancelSizeScans()
+{
+    // drops whatever did not start yet, running scans notice the flag
+    m_sizeScans.cancel();
+    m_sizeScans = {};
+    m_pendingSizeScans = 0;
+    saveSizeCache();
+}
+
 void WorldList::loadWorldsAsync()
 {
+    cancelSizeScans();
+    loadSizeCache();
+
+    auto scans = m_sizeScans;
+
+    // forget worlds that are gone
+    QStringList folders;
+    for (auto& world : m_worlds) {
+        folders << world.container().fileName();
+    }
+    for (auto& key : m_sizeCache.keys()) {
+        if (!folders.contains(key)) {
+            m_sizeCache.remove(key);
+            m_sizeCacheDirty = true;
+        }
+    }
+
+    bool anyKnown = false;
     for (int i = 0; i < m_worlds.size(); ++i) {
         auto file = m_worlds.at(i).container();
-        int row = i;
-        QThreadPool::globalInstance()->start([this, file, row]() mutable {
-            auto size = calculateWorldSize(file);
+        if (!file.isDir()) {
+            m_worlds[i].setSize(calculateWorldSize(file));
+            anyKnown = true;
+            continue;
+        }
 
+        auto stamp = worldSizeStamp(file);
+        auto cached = m_sizeCache.value(file.fileName()).toObject();
+        if (cached.value("stamp").toString() == stamp) {
+            m_worlds[i].setSize(cached.value("size").toInteger(-1));
+            anyKnown = true;
+            continue;
+        }
+
+        m_pendingSizeScans++;
+        Executor::run(Executor::Kind::IO, Executor::Priority::Background, scans, [this, file, stamp, scans] {
+            auto size = FS::directorySize(file.absoluteFilePath(), scans.flag());
+            if (scans.isCancelled()) {
+                return;
+            }
             QMetaObject::invokeMethod(
                 this,
-                [this, size, row, file]() {
-                    if (row < m_worlds.size() && m_worlds[row].container() == file) {
-                        m_worlds[row].setSize(size);
-
-                        // Notify views
-                        QModelIndex modelIndex = index(row);
-                        emit dataChanged(modelIndex, modelIndex, { SizeRole });
+                [this, file, stamp, size, scans] {
+                    if (!scans.isCancelled()) {
+                        worldSizeScanned(file, stamp, size);
                     }
                 },
                 Qt::QueuedConnection);
         });
     }
+
+    if (anyKnown && !m_worlds.isEmpty()) {
+        emit dataChanged(index(0), index(m_worlds.size() - 1), { SizeRole });
+    }
+    if (m_pendingSizeScans == 0) {
+        saveSizeCache();
+    }
+}
+
+void WorldList::worldSizeScanned(const QFileInfo& file, const QString& stamp, int64_t size)
+{
+    m_pendingSizeScans--;
+    if (size >= 0) {
+        QJsonObject entry;
+        entry.insert("stamp", stamp);
+        entry.insert("size", static_cast<qint64>(size));
+        m_sizeCache.insert(file.fileName(), entry);
+        m_sizeCacheDirty = true;
+    }
+
+    for (int row = 0; row < m_worlds.size(); ++row) {
+        if (m_worlds[row].container() == file) {
+            m_worlds[row].setSize(size);
+
+            // Notify views
+            QModelIndex modelIndex = index(row);
+            emit dataChanged(modelIndex, modelIndex, { SizeRole });
+            break;
+        }
+    }
+
+    if (m_pendingSizeScans <= 0) {
+        saveSizeCache();
+    }
 }
 
 #include "WorldList.moc"
@@ -17,11 +17,13 @@
 
 #include <QAbstractListModel>
 #include <QDir>
+#include <QJsonObject>
 #include <QList>
 #include <QMimeData>
 #include <QString>
 #include "BaseInstance.h"
 #include "minecraft/World.h"
+#include "tasks/Executor.h"
 
 class QFileSystemWatcher;
 
@@ -33,6 +35,7 @@ class WorldList : public QAbstractListModel {
     enum Roles { ObjectRole = Qt::UserRole + 1, FolderRole, SeedRole, NameRole, GameModeRole, LastPlayedRole, SizeRole, IconFileRole };
 
     WorldList(const QString& dir, BaseInstance* instance);
+    virtual ~WorldList();
 
     virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
 
@@ -91,10 +94,27 @@ class WorldList : public QAbstractListModel {
    signals:
     void changed();
 
+   private:
+    /// stops all running size scans, their results are discarded
+    void cancelSizeScans();
+    void worldSizeScanned(const QFileInfo& file, const QString& stamp, int64_t size);
+
+    QString sizeCachePath() const;
+    void loadSizeCache();
+    void saveSizeCache();
+
    protected:
     BaseInstance* m_instance;
     QFileSystemWatcher* m_watcher;
     bool m_isWatching;
     QDir m_dir;
     QList<World> m_worlds;
+
+    /// world sizes from previous scans, by folder name
+    QJsonObject m_sizeCache;
+    bool m_sizeCacheLoaded = false;
+    bool m_sizeCacheDirty = false;
+    int m_pendingSizeScans = 0;
+    /// walking large saves is slow, so the scans run as background work
+    Executor::CancelToken m_sizeScans;
 };
@@ -51,6 +51,7 @@
 
 #include <FileSystem.h>
 #include <QSaveFile>
+#include <algorithm>
 
 enum AccountListVersion { MojangMSA = 3 };
 
@@ -634,8 +635,22 @@ void AccountList::tryNext()
         }
         qDebug() << "RefreshSchedule: Account with with internal ID " << accountId << " not found.";
     }
-    // if we get here, no account needed refreshing. Schedule refresh in an hour.
-    m_refreshTimer->start(1000 * 3600);
+    // if we get here, no account needed refreshing. Schedule refresh for when the next one is due, at most in an hour.
+    m_refreshTimer->start(msecsToNextRefresh());
+}
+
+int AccountList::msecsToNextRefresh() const
+{
+    auto now = QDateTime::currentDateTimeUtc();
+    qint64 interval = 1000 * 3600;
+    for (auto& account : m_accounts) {
+        auto dueAt = account->refreshDueAt();
+        if (dueAt.isValid()) {
+            interval = std::min(interval, now.msecsTo(dueAt));
+        }
+    }
+    // don't hammer the servers with an account that keeps failing to refresh
+    return static_cast<int>(std::max<qint64>(interval, 1000 * 600));
 }
 
 void AccountList::authSucceeded()
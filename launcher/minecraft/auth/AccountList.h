@@ -142,6 +142,8 @@ class AccountList : public QAbstractListModel {
     void authFailed(QString reason);
 
    protected:
+    int msecsToNextRefresh() const;
+
     QList<QString> m_refreshQueue;
     QTimer* m_refreshTimer;
     QTimer* m_nextTimer;
@@ -1,6 +1,7 @@
 #include <QDebug>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <algorithm>
 
 #include "minecraft/auth/AccountData.h"
 #include "minecraft/auth/steps/EntitlementsStep.h"
@@ -21,29 +22,41 @@
 AuthFlow::AuthFlow(AccountData* data, Action action) : Task(), m_data(data)
 {
     if (data->type == AccountType::MSA) {
+        AuthStep::Ptr oauthStep;
         if (action == Action::DeviceCode) {
-            auto oauthStep = makeShared<MSADeviceCodeStep>(m_data);
-            connect(oauthStep.get(), &MSADeviceCodeStep::authorizeWithBrowser, this, &AuthFlow::authorizeWithBrowserWithExtra);
-            connect(this, &Task::aborted, oauthStep.get(), &MSADeviceCodeStep::abort);
-            m_steps.append(oauthStep);
+            auto deviceCodeStep = makeShared<MSADeviceCodeStep>(m_data);
+            connect(deviceCodeStep.get(), &MSADeviceCodeStep::authorizeWithBrowser, this, &AuthFlow::authorizeWithBrowserWithExtra);
+            connect(this, &Task::aborted, deviceCodeStep.get(), &MSADeviceCodeStep::abort);
+            oauthStep = addStep(deviceCodeStep);
         } else {
-            auto oauthStep = makeShared<MSAStep>(m_data, action == Action::Refresh);
-            connect(oauthStep.get(), &MSAStep::authorizeWithBrowser, this, &AuthFlow::authorizeWithBrowser);
-            m_steps.append(oauthStep);
+            auto msaStep = makeShared<MSAStep>(m_data, action == Action::Refresh);
+            connect(msaStep.get(), &MSAStep::authorizeWithBrowser, this, &AuthFlow::authorizeWithBrowser);
+            oauthStep = addStep(msaStep);
         }
-        m_steps.append(makeShared<XboxUserStep>(m_data));
-        m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"));
-        m_steps.append(
-            makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"));
-        m_steps.append(makeShared<LauncherLoginStep>(m_data));
-        m_steps.append(makeShared<XboxProfileStep>(m_data));
-        m_steps.append(makeShared<EntitlementsStep>(m_data));
-        m_steps.append(makeShared<MinecraftProfileStep>(m_data));
-        m_steps.append(makeShared<GetSkinStep>(m_data));
+        auto userStep = addStep(makeShared<XboxUserStep>(m_data), { oauthStep });
+        auto xboxStep =
+            addStep(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"), { userStep });
+        auto mojangStep = addStep(
+            makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"),
+            { userStep });
+        auto loginStep = addStep(makeShared<LauncherLoginStep>(m_data), { mojangStep });
+        addStep(makeShared<XboxProfileStep>(m_data), { xboxStep });
+        addStep(makeShared<EntitlementsStep>(m_data), { loginStep });
+        auto profileStep = addStep(makeShared<MinecraftProfileStep>(m_data), { loginStep });
+        addStep(makeShared<GetSkinStep>(m_data), { profileStep });
     }
     changeState(AccountTaskState::STATE_CREATED);
 }
 
+AuthStep::Ptr AuthFlow::addStep(AuthStep::Ptr step, const QList<AuthStep::Ptr>& dependencies)
+{
+    QList<AuthStep*> depends;
+    for (auto& dependency : dependencies)
+        depends.append(dependency.get());
+    m_steps.append({ step, depends });
+    return step;
+}
+
 void AuthFlow::succeed()
 {
     m_data->validity_ = Validity::Certain;
@@ -53,32 +66,70 @@ void AuthFlow::succeed()
 void AuthFlow::executeTask()
 {
     changeState(AccountTaskState::STATE_WORKING, tr("Initializing"));
-    nextStep();
+    startReadySteps();
 }
 
-void AuthFlow::nextStep()
+void AuthFlow::startReadySteps()
 {
-    if (!Task::isRunning()) {
-        return;
+    // a step may finish while being started, so look for the next ready one from scratch every time
+    while (Task::isRunning()) {
+        auto ready = std::find_if(m_steps.begin(), m_steps.end(), [this](const PendingStep& pending) {
+            return std::all_of(pending.dependencies.begin(), pending.dependencies.end(),
+                               [this](AuthStep* dependency) { return m_finishedSteps.contains(dependency); });
+        });
+        if (ready == m_steps.end())
+            break;
+
+        auto step = ready->step;
+        m_steps.erase(ready);
+        m_startedSteps.append(step);
+        m_currentStep = step;
+        qDebug() << "AuthFlow:" << step->describe();
+        connect(step.get(), &AuthStep::finished, this,
+                [this, step = step.get()](AccountTaskState resultingState, QString message) { stepFinished(step, resultingState, message); });
+        step->perform();
     }
-    if (m_steps.size() == 0) {
+
+    if (Task::isRunning() && !hasRunningSteps()) {
+        if (!m_steps.isEmpty()) {
+            // can only happen when a step depends on one that was never added
+            changeState(AccountTaskState::STATE_FAILED_SOFT, tr("Some authentication steps could not be run"));
+            return;
+        }
         // we got to the end without an incident... assume this is all.
         m_currentStep.reset();
         succeed();
+    }
+}
+
+void AuthFlow::stepFinished(AuthStep* step, AccountTaskState resultingState, QString message)
+{
+    if (!Task::isRunning() || m_finishedSteps.contains(step))
+        return;
+    m_finishedSteps.insert(step);
+
+    if (changeState(resultingState, message)) {
+        startReadySteps();
         return;
     }
-    m_currentStep = m_steps.front();
-    qDebug() << "AuthFlow:" << m_currentStep->describe();
-    m_steps.pop_front();
-    connect(m_currentStep.get(), &AuthStep::finished, this, &AuthFlow::stepFinished);
+    // the first failure decides the result, the others are not needed anymore
+    abortRunningSteps();
+}
 
-    m_currentStep->perform();
+bool AuthFlow::hasRunningSteps() const
+{
+    return std::any_of(m_startedSteps.begin(), m_startedSteps.end(),
+                       [this](const AuthStep::Ptr& step) { return !m_finishedSteps.contains(step.get()); });
 }
 
-void AuthFlow::stepFinished(AccountTaskState resultingState, QString message)
+void AuthFlow::abortRunningSteps()
 {
-    if (changeState(resultingState, message))
-        nextStep();
+    // aborting a step can finish it, which must not change the list being walked
+    auto started = m_startedSteps;
+    for (auto& step : started) {
+        if (!m_finishedSteps.contains(step.get()))
+            step->abort();
+    }
 }
 
 bool AuthFlow::changeState(AccountTaskState newState, QString reason)
@@ -149,7 +200,6 @@ bool AuthFlow::changeState(AccountTaskState newState, QString reason)
 bool AuthFlow::abort()
 {
     emitAborted();
-    if (m_currentStep)
-        m_currentStep->abort();
+    abortRunningSteps();
     return true;
 }
\ No newline at end of file
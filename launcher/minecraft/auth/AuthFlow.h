@@ -31,17 +31,34 @@ class AuthFlow : public Task {
     void authorizeWithBrowserWithExtra(QString url, QString code, int expiresIn);
 
    protected:
+    /**
+     * Adds a step that is started once all of its dependencies have finished.
+     * Steps that don't depend on each other run at the same time.
+     */
+    AuthStep::Ptr addStep(AuthStep::Ptr step, const QList<AuthStep::Ptr>& dependencies = {});
+
     void succeed();
-    void nextStep();
+    void startReadySteps();
+    bool hasRunningSteps() const;
+    void abortRunningSteps();
 
    private slots:
     // NOTE: true -> non-terminal state, false -> terminal state
     bool changeState(AccountTaskState newState, QString reason = QString());
-    void stepFinished(AccountTaskState resultingState, QString message);
+    void stepFinished(AuthStep* step, AccountTaskState resultingState, QString message);
 
    private:
+    struct PendingStep {
+        AuthStep::Ptr step;
+        QList<AuthStep*> dependencies;
+    };
+
     AccountTaskState m_taskState = AccountTaskState::STATE_CREATED;
-    QList<AuthStep::Ptr> m_steps;
+    QList<PendingStep> m_steps;
+    // started steps are kept alive until the flow is gone, they may still be emitting
+    QList<AuthStep::Ptr> m_startedSteps;
+    QSet<AuthStep*> m_finishedSteps;
+    // the last step that was started, for the status
     AuthStep::Ptr m_currentStep;
     AccountData* m_data = nullptr;
 };
@@ -34,6 +34,7 @@ class AuthStep : public QObject {
 
    public slots:
     virtual void perform() = 0;
+    /** Stops the step's requests. The flow no longer listens to it, so the step does not need to report back. */
     virtual void abort() {}
 
    signals:
@@ -198,6 +198,15 @@ bool MinecraftAccount::isActive() const
     return !m_currentTask.isNull();
 }
 
+static QDateTime tokenExpiry(const AccountData& data)
+{
+    auto expiresTimestamp = data.yggdrasilToken.notAfter;
+    if (!expiresTimestamp.isValid()) {
+        expiresTimestamp = data.yggdrasilToken.issueInstant.addSecs(24 * 3600);
+    }
+    return expiresTimestamp;
+}
+
 bool MinecraftAccount::shouldRefresh() const
 {
     /*
@@ -221,18 +230,24 @@ bool MinecraftAccount::shouldRefresh() const
         }
     }
     auto now = QDateTime::currentDateTimeUtc();
-    auto issuedTimestamp = data.yggdrasilToken.issueInstant;
-    auto expiresTimestamp = data.yggdrasilToken.notAfter;
-
-    if (!expiresTimestamp.isValid()) {
-        expiresTimestamp = issuedTimestamp.addSecs(24 * 3600);
-    }
-    if (now.secsTo(expiresTimestamp) < (12 * 3600)) {
+    if (now.secsTo(tokenExpiry(data)) < (12 * 3600)) {
         return true;
     }
     return false;
 }
 
+QDateTime MinecraftAccount::refreshDueAt() const
+{
+    if (isInUse() || data.validity_ != Validity::Certain) {
+        return {};
+    }
+    auto expiresTimestamp = tokenExpiry(data);
+    if (!expiresTimestamp.isValid()) {
+        return {};
+    }
+    return expiresTimestamp.addSecs(-12 * 3600);
+}
+
 void MinecraftAccount::fillSession(AuthSessionPtr session)
 {
     static const QRegularExpression s_removeChars("[{}-]");
@@ -144,6 +144,9 @@ class MinecraftAccount : public QObject, public Usable {
 
     bool shouldRefresh() const;
 
+    //! When shouldRefresh() starts returning true because the token gets close to expiring, invalid if that isn't known
+    QDateTime refreshDueAt() const;
+
     void fillSession(AuthSessionPtr session);
 
     QString lastError() const { return data.lastError(); }
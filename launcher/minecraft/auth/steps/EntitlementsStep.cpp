@@ -45,6 +45,14 @@ void EntitlementsStep::perform()
     qDebug() << "Getting entitlements...";
 }
 
+void EntitlementsStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void EntitlementsStep::onRequestDone()
 {
     qCDebug(authCredentials()) << *m_response;
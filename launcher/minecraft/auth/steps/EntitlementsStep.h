@@ -17,6 +17,9 @@ class EntitlementsStep : public AuthStep {
 
     QString describe() override;
 
+   public slots:
+    void abort() override;
+
    private slots:
     void onRequestDone();
 
@@ -28,6 +28,14 @@ void GetSkinStep::perform()
     m_task->start();
 }
 
+void GetSkinStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void GetSkinStep::onRequestDone()
 {
     if (m_request->error() == QNetworkReply::NoError)
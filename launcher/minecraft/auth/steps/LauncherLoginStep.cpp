@@ -50,6 +50,14 @@ void LauncherLoginStep::perform()
     qDebug() << "Getting Minecraft access token...";
 }
 
+void LauncherLoginStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void LauncherLoginStep::onRequestDone()
 {
     qCDebug(authCredentials()) << *m_response;
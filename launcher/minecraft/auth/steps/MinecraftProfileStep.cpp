@@ -34,6 +34,14 @@ void MinecraftProfileStep::perform()
     m_task->start();
 }
 
+void MinecraftProfileStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void MinecraftProfileStep::onRequestDone()
 {
     if (m_request->error() == QNetworkReply::ContentNotFoundError) {
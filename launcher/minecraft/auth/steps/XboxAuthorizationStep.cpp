@@ -55,6 +55,14 @@ void XboxAuthorizationStep::perform()
     qDebug() << "Getting authorization token for " << m_relyingParty;
 }
 
+void XboxAuthorizationStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void XboxAuthorizationStep::onRequestDone()
 {
     qCDebug(authCredentials()) << *m_response;
@@ -17,6 +17,9 @@ class XboxAuthorizationStep : public AuthStep {
 
     QString describe() override;
 
+   public slots:
+    void abort() override;
+
    private:
     bool processSTSError();
 
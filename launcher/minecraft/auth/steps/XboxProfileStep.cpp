@@ -47,6 +47,14 @@ void XboxProfileStep::perform()
     qDebug() << "Getting Xbox profile...";
 }
 
+void XboxProfileStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void XboxProfileStep::onRequestDone()
 {
     if (m_request->error() != QNetworkReply::NoError) {
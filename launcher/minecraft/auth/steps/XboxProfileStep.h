@@ -17,6 +17,9 @@ class XboxProfileStep : public AuthStep {
 
     QString describe() override;
 
+   public slots:
+    void abort() override;
+
    private slots:
     void onRequestDone();
 
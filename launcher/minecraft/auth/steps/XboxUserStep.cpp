@@ -51,6 +51,14 @@ void XboxUserStep::perform()
     qDebug() << "First layer of XBox auth ... commencing.";
 }
 
+void XboxUserStep::abort()
+{
+    if (m_task) {
+        m_task->disconnect(this);
+        m_task->abort();
+    }
+}
+
 void XboxUserStep::onRequestDone()
 {
     if (m_request->error() != QNetworkReply::NoError) {
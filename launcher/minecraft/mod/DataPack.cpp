@@ -25,7 +25,7 @@
 #include <QMap>
 #include <QRegularExpression>
 
-#include "MTPixmapCache.h"
+#include "ImageCache.h"
 #include "Version.h"
 #include "minecraft/mod/tasks/LocalDataPackParseTask.h"
 
@@ -101,18 +101,16 @@ void DataPack::setImage(QImage new_image) const
 
     Q_ASSERT(!new_image.isNull());
 
-    if (m_pack_image_cache_key.key.isValid())
-        PixmapCache::instance().remove(m_pack_image_cache_key.key);
+    ImageCache::instance().remove(m_pack_image_cache_key.key);
 
-    // scale the image to avoid flooding the pixmapcache
-    auto pixmap =
-        QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+    // scale the image to avoid flooding the cache
+    auto image = new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
 
-    m_pack_image_cache_key.key = PixmapCache::instance().insert(pixmap);
+    m_pack_image_cache_key.key = ImageCache::instance().insert(image);
     m_pack_image_cache_key.was_ever_used = true;
 
     // This can happen if the pixmap is too big to fit in the cache :c
-    if (!m_pack_image_cache_key.key.isValid()) {
+    if (m_pack_image_cache_key.key == 0) {
         qWarning() << "Could not insert a image cache entry! Ignoring it.";
         m_pack_image_cache_key.was_ever_used = false;
     }
@@ -121,7 +119,7 @@ void DataPack::setImage(QImage new_image) const
 QPixmap DataPack::image(QSize size, Qt::AspectRatioMode mode) const
 {
     QPixmap cached_image;
-    if (PixmapCache::instance().find(m_pack_image_cache_key.key, &cached_image)) {
+    if (ImageCache::instance().find(m_pack_image_cache_key.key, &cached_image)) {
         if (size.isNull())
             return cached_image;
         return cached_image.scaled(size, mode, Qt::SmoothTransformation);
@@ -132,7 +130,7 @@ QPixmap DataPack::image(QSize size, Qt::AspectRatioMode mode) const
         return {};
     } else {
         qDebug() << "Data Pack" << name() << "Had it's image evicted from the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        ImageCache::instance().markCacheMissByEviction();
     }
 
     // Imaged got evicted from the cache. Re-process it and retry.
@@ -24,7 +24,7 @@
 #include "Resource.h"
 
 #include <QMutex>
-#include <QPixmapCache>
+#include "ImageCache.h"
 
 class Version;
 
@@ -78,13 +78,13 @@ class DataPack : public Resource {
      */
     QString m_description;
 
-    /** The data pack's image file cache key, for access in the QPixmapCache global instance.
+    /** The data pack's image file cache key, for access in the ImageCache global instance.
      *
      *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
      *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
      */
     struct {
-        QPixmapCache::Key key;
+        ImageCache::Key key = 0;
         bool was_ever_used = false;
     } mutable m_pack_image_cache_key;
 };
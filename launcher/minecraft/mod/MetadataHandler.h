@@ -24,6 +24,11 @@
 namespace Metadata {
 using ModStruct = Packwiz::V1::Mod;
 
+inline Packwiz::Index::Ptr index(const QDir& index_dir)
+{
+    return Packwiz::Index::of(index_dir);
+}
+
 inline ModStruct create(const QDir& index_dir, ModPlatform::IndexedPack& mod_pack, ModPlatform::IndexedVersion& mod_version)
 {
     return Packwiz::V1::createModFormat(index_dir, mod_pack, mod_version);
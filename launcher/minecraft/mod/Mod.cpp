@@ -42,7 +42,7 @@
 #include <QRegularExpression>
 #include <QString>
 
-#include "MTPixmapCache.h"
+#include "ImageCache.h"
 #include "MetadataHandler.h"
 #include "Resource.h"
 #include "Version.h"
@@ -231,23 +231,21 @@ auto Mod::issueTracker() const -> QString
     return details().issue_tracker;
 }
 
-QPixmap Mod::setIcon(QImage new_image) const
+QImage Mod::setIcon(QImage new_image) const
 {
     QMutexLocker locker(&m_data_lock);
 
     Q_ASSERT(!new_image.isNull());
 
-    if (m_packImageCacheKey.key.isValid())
-        PixmapCache::remove(m_packImageCacheKey.key);
+    ImageCache::instance().remove(m_packImageCacheKey.key);
 
-    // scale the image to avoid flooding the pixmapcache
-    auto pixmap =
-        QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+    // scale the image to avoid flooding the cache
+    auto image = new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
 
-    m_packImageCacheKey.key = PixmapCache::insert(pixmap);
+    m_packImageCacheKey.key = ImageCache::instance().insert(image);
     m_packImageCacheKey.wasEverUsed = true;
     m_packImageCacheKey.wasReadAttempt = true;
-    return pixmap;
+    return image;
 }
 
 QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
@@ -259,7 +257,7 @@ QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
     };
 
     QPixmap cached_image;
-    if (PixmapCache::find(m_packImageCacheKey.key, &cached_image)) {
+    if (ImageCache::instance().find(m_packImageCacheKey.key, &cached_image)) {
         return pixmap_transform(cached_image);
     }
 
@@ -269,12 +267,13 @@ QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
 
     if (m_packImageCacheKey.wasEverUsed) {
         qDebug() << "Mod" << name() << "Had it's icon evicted from the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        ImageCache::instance().markCacheMissByEviction();
     }
     // Image got evicted from the cache or an attempt to load it has not been made. load it and retry.
     m_packImageCacheKey.wasReadAttempt = true;
-    if (ModUtils::loadIconFile(*this, &cached_image)) {
-        return pixmap_transform(cached_image);
+    QImage loaded_image;
+    if (ModUtils::loadIconFile(*this, &loaded_image)) {
+        return pixmap_transform(QPixmap::fromImage(loaded_image));
     }
     // Image failed to load
     return {};
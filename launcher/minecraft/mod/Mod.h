@@ -42,7 +42,7 @@
 #include <QList>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
+#include "ImageCache.h"
 
 #include <optional>
 
@@ -78,7 +78,7 @@ class Mod : public Resource {
     /** Gets the icon of the mod, converted to a QPixmap for drawing, and scaled to size. */
     QPixmap icon(QSize size, Qt::AspectRatioMode mode = Qt::AspectRatioMode::IgnoreAspectRatio) const;
     /** Thread-safe. */
-    QPixmap setIcon(QImage new_image) const;
+    QImage setIcon(QImage new_image) const;
 
     void setDetails(const ModDetails& details);
 
@@ -100,7 +100,7 @@ class Mod : public Resource {
     mutable QMutex m_data_lock;
 
     struct {
-        QPixmapCache::Key key;
+        ImageCache::Key key = 0;
         bool wasEverUsed = false;
         bool wasReadAttempt = false;
     } mutable m_packImageCacheKey;
@@ -9,7 +9,6 @@
 #include <QMenu>
 #include <QMimeData>
 #include <QStyle>
-#include <QThreadPool>
 #include <QUrl>
 #include <utility>
 
@@ -23,6 +22,7 @@
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
 #include "settings/Setting.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 #include "ui/dialogs/CustomMessageBox.h"
 
@@ -36,7 +36,9 @@ ResourceFolderModel::ResourceFolderModel(const QDir& dir, BaseInstance* instance
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 
-    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ResourceFolderModel::directoryChanged);
+    m_watcher.setRootDir(m_dir);
+    m_watcher.setMaxDepth(1);
+    connect(&m_watcher, &RecursiveFileSystemWatcher::fileEvents, this, &ResourceFolderModel::filesChanged);
     connect(&m_helper_thread_task, &ConcurrentTask::finished, this, [this] { m_helper_thread_task.clear(); });
     if (APPLICATION_DYN) {  // in tests the application macro doesn't work
         m_helper_thread_task.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
@@ -45,11 +47,14 @@ ResourceFolderModel::ResourceFolderModel(const QDir& dir, BaseInstance* instance
 
 ResourceFolderModel::~ResourceFolderModel()
 {
-    while (!QThreadPool::globalInstance()->waitForDone(100))
-        QCoreApplication::processEvents();
+    // the update and parse tasks may still be running on these
+    for (auto pool : { Executor::pool(Executor::Kind::IO), Executor::pool(Executor::Kind::Compute) }) {
+        while (!pool->waitForDone(100))
+            QCoreApplication::processEvents();
+    }
 }
 
-bool ResourceFolderModel::startWatching(const QStringList& paths)
+bool ResourceFolderModel::startWatching()
 {
     // Remove orphaned metadata next time
     m_first_folder_load = true;
@@ -57,35 +62,26 @@ bool ResourceFolderModel::startWatching(const QStringList& paths)
     if (m_is_watching)
         return false;
 
-    auto couldnt_be_watched = m_watcher.addPaths(paths);
-    for (auto path : paths) {
-        if (couldnt_be_watched.contains(path))
-            qDebug() << "Failed to start watching " << path;
-        else
-            qDebug() << "Started watching " << path;
-    }
+    // the metadata is one level down, and a folder resource only changes with what is at its top
+    m_watcher.enable();
+    qDebug() << "Started watching" << m_dir.absolutePath();
 
     update();
 
-    m_is_watching = !m_is_watching;
-    return m_is_watching;
+    m_is_watching = true;
+    return true;
 }
 
-bool ResourceFolderModel::stopWatching(const QStringList& paths)
+bool ResourceFolderModel::stopWatching()
 {
     if (!m_is_watching)
         return false;
 
-    auto couldnt_be_stopped = m_watcher.removePaths(paths);
-    for (auto path : paths) {
-        if (couldnt_be_stopped.contains(path))
-            qDebug() << "Failed to stop watching " << path;
-        else
-            qDebug() << "Stopped watching " << path;
-    }
+    m_watcher.disable();
+    qDebug() << "Stopped watching" << m_dir.absolutePath();
 
-    m_is_watching = !m_is_watching;
-    return !m_is_watching;
+    m_is_watching = false;
+    return true;
 }
 
 bool ResourceFolderModel::installResource(QString original_path)
@@ -210,7 +206,7 @@ bool ResourceFolderModel::uninstallResource(QString file_name, bool preserve_met
         if (resource->fileinfo().fileName() == file_name) {
             auto res = resource->destroy(indexDir(), preserve_metadata, false);
 
-            update();
+            update({ file_name });
 
             return res;
         }
@@ -223,15 +219,17 @@ bool ResourceFolderModel::deleteResources(const QModelIndexList& indexes)
     if (indexes.isEmpty())
         return true;
 
+    QSet<QString> file_names;
     for (auto i : indexes) {
         if (i.column() != 0)
             continue;
 
         auto& resource = m_resources.at(i.row());
+        file_names.insert(resource->fileinfo().fileName());
         resource->destroy(indexDir());
     }
 
-    update();
+    update(file_names);
 
     return true;
 }
@@ -241,15 +239,17 @@ void ResourceFolderModel::deleteMetadata(const QModelIndexList& indexes)
     if (indexes.isEmpty())
         return;
 
+    QSet<QString> file_names;
     for (auto i : indexes) {
         if (i.column() != 0)
             continue;
 
         auto& resource = m_resources.at(i.row());
+        file_names.insert(resource->fileinfo().fileName());
         resource->destroyMetadata(indexDir());
     }
 
-    update();
+    update(file_names);
 }
 
 bool ResourceFolderModel::setResourceEnabled(const QModelIndexList& indexes, EnableAction action)
@@ -296,7 +296,33 @@ bool ResourceFolderModel::update()
         return false;
     }
 
-    m_current_update_task.reset(createUpdateTask());
+    return startUpdateTask(createUpdateTask());
+}
+
+bool ResourceFolderModel::update(QSet<QString> file_names, const QSet<QString>& slugs)
+{
+    QMutexLocker lock(&s_update_task_mutex);
+
+    if (m_current_update_task) {
+        m_scheduled_files.unite(file_names);
+        m_scheduled_slugs.unite(slugs);
+        return false;
+    }
+
+    // metadata that is gone can only be matched with the rows that still have it
+    if (!slugs.isEmpty()) {
+        for (auto const& resource : qAsConst(m_resources)) {
+            if (auto metadata = resource->metadata(); metadata && slugs.contains(metadata->slug))
+                file_names.insert(resource->fileinfo().fileName());
+        }
+    }
+
+    return startUpdateTask(createUpdateTask(file_names, slugs));
+}
+
+bool ResourceFolderModel::startUpdateTask(Task* task)
+{
+    m_current_update_task.reset(task);
     if (!m_current_update_task)
         return false;
 
@@ -308,15 +334,21 @@ bool ResourceFolderModel::update()
         [this] {
             m_current_update_task.reset();
             if (m_scheduled_update) {
+                // a full update covers whatever changed meanwhile
                 m_scheduled_update = false;
+                m_scheduled_files.clear();
+                m_scheduled_slugs.clear();
                 update();
+            } else if (!m_scheduled_files.isEmpty() || !m_scheduled_slugs.isEmpty()) {
+                update(std::exchange(m_scheduled_files, {}), std::exchange(m_scheduled_slugs, {}));
             } else {
                 emit updateFinished();
             }
         },
         Qt::ConnectionType::QueuedConnection);
 
-    QThreadPool::globalInstance()->start(m_current_update_task.get());
+    // someone is usually looking at the list
+    Executor::start(Executor::Kind::IO, Executor::Priority::Interactive, m_current_update_task.get());
 
     return true;
 }
@@ -353,7 +385,7 @@ void ResourceFolderModel::resolveResource(Resource::Ptr res)
     m_helper_thread_task.addTask(task);
 
     if (!m_helper_thread_task.isRunning()) {
-        QThreadPool::globalInstance()->start(&m_helper_thread_task);
+        Executor::start(Executor::Kind::Compute, Executor::Priority::Interactive, &m_helper_thread_task);
     }
 }
 
@@ -363,8 +395,17 @@ void ResourceFolderModel::onUpdateSucceeded()
 
     auto& new_resources = update_results->resources;
 
-    auto current_list = m_resources_index.keys();
-    QSet<QString> current_set(current_list.begin(), current_list.end());
+    QSet<QString> current_set;
+    if (update_results->ids) {
+        // the rows the load didn't look at are left alone
+        for (auto const& id : *update_results->ids) {
+            if (m_resources_index.contains(id))
+                current_set.insert(id);
+        }
+    } else {
+        auto current_list = m_resources_index.keys();
+        current_set = QSet<QString>(current_list.begin(), current_list.end());
+    }
 
     auto new_list = new_resources.keys();
     QSet<QString> new_set(new_list.begin(), new_list.end());
@@ -391,14 +432,51 @@ Task* ResourceFolderModel::createUpdateTask()
     return task;
 }
 
+Task* ResourceFolderModel::createUpdateTask(const QSet<QString>& file_names, const QSet<QString>& slugs)
+{
+    return new ResourceFolderLoadTask(dir(), indexDir(), m_is_indexed, file_names, slugs,
+                                      [this](const QFileInfo& file) { return createResource(file); });
+}
+
 bool ResourceFolderModel::hasPendingParseTasks() const
 {
     return !m_active_parse_tasks.isEmpty();
 }
 
-void ResourceFolderModel::directoryChanged(QString path)
+void ResourceFolderModel::filesChanged(const QList<FileEvent>& events)
 {
-    update();
+    auto root = m_dir.absolutePath();
+    auto index_path = indexDir().absolutePath();
+
+    QSet<QString> file_names;
+    QSet<QString> slugs;
+    for (auto const& event : events) {
+        if (event.type == FileEvent::Type::Overflow) {
+            update();
+            return;
+        }
+        for (auto const& path : { event.path, event.from }) {
+            if (path.isEmpty())
+                continue;
+            if (!path.startsWith(root + '/')) {
+                // the folder itself went away or was replaced
+                update();
+                return;
+            }
+            if (path.startsWith(index_path + '/')) {
+                auto name = path.mid(index_path.size() + 1);
+                if (name.endsWith(".pw.toml") && !name.contains('/'))
+                    slugs.insert(name.chopped(8));
+                continue;
+            }
+            // anything inside a folder resource is a change of that resource
+            file_names.insert(path.mid(root.size() + 1).section('/', 0, 0));
+        }
+    }
+    file_names.remove(indexDir().dirName());
+
+    if (!file_names.isEmpty() || !slugs.isEmpty())
+        update(file_names, slugs);
 }
 
 Qt::DropActions ResourceFolderModel::supportedDropActions() const
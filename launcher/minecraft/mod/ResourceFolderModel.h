@@ -3,7 +3,6 @@
 #include <QAbstractListModel>
 #include <QAction>
 #include <QDir>
-#include <QFileSystemWatcher>
 #include <QHeaderView>
 #include <QMutex>
 #include <QSet>
@@ -13,6 +12,7 @@
 #include "Resource.h"
 
 #include "BaseInstance.h"
+#include "RecursiveFileSystemWatcher.h"
 
 #include "tasks/ConcurrentTask.h"
 #include "tasks/Task.h"
@@ -66,23 +66,17 @@ class ResourceFolderModel : public QAbstractListModel {
 
     virtual QString id() const { return "resource"; }
 
-    /** Starts watching the paths for changes.
+    /** Starts watching the folder, including its metadata, for changes.
      *
-     *  Returns whether starting to watch all the paths was successful.
-     *  If one or more fails, it returns false.
+     *  Returns false if it was being watched already.
      */
-    bool startWatching(const QStringList& paths);
+    virtual bool startWatching();
 
-    /** Stops watching the paths for changes.
+    /** Stops watching the folder for changes.
      *
-     *  Returns whether stopping to watch all the paths was successful.
-     *  If one or more fails, it returns false.
+     *  Returns false if it wasn't being watched.
      */
-    bool stopWatching(const QStringList& paths);
-
-    /* Helper methods for subclasses, using a predetermined list of paths. */
-    virtual bool startWatching() { return startWatching({ indexDir().absolutePath(), m_dir.absolutePath() }); }
-    virtual bool stopWatching() { return stopWatching({ indexDir().absolutePath(), m_dir.absolutePath() }); }
+    virtual bool stopWatching();
 
     QDir indexDir() { return { QString("%1/.index").arg(dir().absolutePath()) }; }
 
@@ -112,6 +106,11 @@ class ResourceFolderModel : public QAbstractListModel {
     /** Creates a new update task and start it. Returns false if no update was done, like when an update is already underway. */
     virtual bool update();
 
+    /** Creates a new update task for only the resources with these file names, and the ones whose metadata has one of these
+     *  slugs, and start it. The other rows are left as they are. Returns false if it got scheduled after the running update.
+     */
+    bool update(QSet<QString> file_names, const QSet<QString>& slugs = {});
+
     /** Creates a new parse task, if needed, for 'res' and start it.*/
     virtual void resolveResource(Resource::Ptr res);
 
@@ -196,6 +195,8 @@ class ResourceFolderModel : public QAbstractListModel {
      *  If such work is needed, try using it in the Task create by createParseTask() instead!
      */
     [[nodiscard]] Task* createUpdateTask();
+    [[nodiscard]] Task* createUpdateTask(const QSet<QString>& file_names, const QSet<QString>& slugs);
+    bool startUpdateTask(Task* task);
 
     [[nodiscard]] virtual Resource* createResource(const QFileInfo& info) { return new Resource(info); }
 
@@ -215,7 +216,7 @@ class ResourceFolderModel : public QAbstractListModel {
     void applyUpdates(QSet<QString>& current_set, QSet<QString>& new_set, QMap<QString, Resource::Ptr>& new_resources);
 
    protected slots:
-    void directoryChanged(QString);
+    void filesChanged(const QList<FileEvent>& events);
 
     /** Called when the update task is successful.
      *
@@ -246,7 +247,7 @@ class ResourceFolderModel : public QAbstractListModel {
 
     QDir m_dir;
     BaseInstance* m_instance;
-    QFileSystemWatcher m_watcher;
+    RecursiveFileSystemWatcher m_watcher;
     bool m_is_watching = false;
 
     bool m_is_indexed;
@@ -254,6 +255,9 @@ class ResourceFolderModel : public QAbstractListModel {
 
     Task::Ptr m_current_update_task = nullptr;
     bool m_scheduled_update = false;
+    // what changed while an update was running, loaded right after it
+    QSet<QString> m_scheduled_files;
+    QSet<QString> m_scheduled_slugs;
 
     QList<Resource::Ptr> m_resources;
 
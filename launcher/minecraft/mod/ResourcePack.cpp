@@ -3,7 +3,6 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QMap>
-#include "MTPixmapCache.h"
 #include "Version.h"
 
 // Values taken from:
@@ -6,7 +6,6 @@
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 class Version;
 
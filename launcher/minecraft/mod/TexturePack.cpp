@@ -21,7 +21,7 @@
 
 #include <QDebug>
 #include <QMap>
-#include "MTPixmapCache.h"
+#include "ImageCache.h"
 
 #include "minecraft/mod/tasks/LocalTexturePackParseTask.h"
 
@@ -38,21 +38,19 @@ void TexturePack::setImage(QImage new_image) const
 
     Q_ASSERT(!new_image.isNull());
 
-    if (m_pack_image_cache_key.key.isValid())
-        PixmapCache::remove(m_pack_image_cache_key.key);
+    ImageCache::instance().remove(m_pack_image_cache_key.key);
 
-    // scale the image to avoid flooding the pixmapcache
-    auto pixmap =
-        QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+    // scale the image to avoid flooding the cache
+    auto image = new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
 
-    m_pack_image_cache_key.key = PixmapCache::insert(pixmap);
+    m_pack_image_cache_key.key = ImageCache::instance().insert(image);
     m_pack_image_cache_key.was_ever_used = true;
 }
 
 QPixmap TexturePack::image(QSize size, Qt::AspectRatioMode mode) const
 {
     QPixmap cached_image;
-    if (PixmapCache::find(m_pack_image_cache_key.key, &cached_image)) {
+    if (ImageCache::instance().find(m_pack_image_cache_key.key, &cached_image)) {
         if (size.isNull())
             return cached_image;
         return cached_image.scaled(size, mode, Qt::SmoothTransformation);
@@ -63,7 +61,7 @@ QPixmap TexturePack::image(QSize size, Qt::AspectRatioMode mode) const
         return {};
     } else {
         qDebug() << "Texture Pack" << name() << "Had it's image evicted from the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        ImageCache::instance().markCacheMissByEviction();
     }
 
     // Imaged got evicted from the cache. Re-process it and retry.
@@ -24,7 +24,7 @@
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
+#include "ImageCache.h"
 
 class Version;
 
@@ -57,13 +57,13 @@ class TexturePack : public Resource {
      */
     QString m_description;
 
-    /** The texture pack's image file cache key, for access in the QPixmapCache global instance.
+    /** The texture pack's image file cache key, for access in the ImageCache global instance.
      *
      *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
      *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
      */
     struct {
-        QPixmapCache::Key key;
+        ImageCache::Key key = 0;
         bool was_ever_used = false;
     } mutable m_pack_image_cache_key;
 };
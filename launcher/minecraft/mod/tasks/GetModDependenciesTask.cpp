@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <algorithm>
 #include <memory>
+#include "Application.h"
 #include "Json.h"
 #include "QObjectPtr.h"
 #include "minecraft/PackProfile.h"
@@ -29,7 +30,7 @@
 #include "modplatform/ResourceAPI.h"
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
-#include "tasks/SequentialTask.h"
+#include "tasks/ConcurrentTask.h"
 #include "ui/pages/modplatform/ModModel.h"
 #include "ui/pages/modplatform/flame/FlameResourceModels.h"
 #include "ui/pages/modplatform/modrinth/ModrinthResourceModels.h"
@@ -52,19 +53,38 @@ static bool checkDependencies(std::shared_ptr<GetModDependenciesTask::PackDepend
            (!loaders || !sel->version.loaders || sel->version.loaders & loaders);
 }
 
+static QString dependencyKey(const ModPlatform::Dependency& dep, ModPlatform::ResourceProvider provider)
+{
+    auto addonId = dep.addonId.toString();
+    return QString("%1:%2").arg(ModPlatform::ProviderCapabilities::name(provider), addonId.isEmpty() ? "version/" + dep.version : addonId);
+}
+
 GetModDependenciesTask::GetModDependenciesTask(BaseInstance* instance,
                                                ModFolderModel* folder,
                                                QList<std::shared_ptr<PackDependency>> selected)
-    : SequentialTask(tr("Get dependencies"))
-    , m_selected(selected)
-    , m_flame_provider{ ModPlatform::ResourceProvider::FLAME, std::make_shared<ResourceDownload::FlameModModel>(*instance),
-                        std::make_shared<FlameAPI>() }
-    , m_modrinth_provider{ ModPlatform::ResourceProvider::MODRINTH, std::make_shared<ResourceDownload::ModrinthModModel>(*instance),
-                           std::make_shared<ModrinthAPI>() }
-    , m_version(mcVersion(instance))
-    , m_loaderType(mcLoaders(instance))
+    : GetModDependenciesTask(mcVersion(instance),
+                             mcLoaders(instance),
+                             folder->allMods(),
+                             selected,
+                             { ModPlatform::ResourceProvider::FLAME, std::make_shared<ResourceDownload::FlameModModel>(*instance),
+                               std::make_shared<FlameAPI>() },
+                             { ModPlatform::ResourceProvider::MODRINTH, std::make_shared<ResourceDownload::ModrinthModModel>(*instance),
+                               std::make_shared<ModrinthAPI>() })
+{}
+
+GetModDependenciesTask::GetModDependenciesTask(Version version,
+                                               ModPlatform::ModLoaderTypes loaders,
+                                               QList<Mod*> installed,
+                                               QList<std::shared_ptr<PackDependency>> selected,
+                                               Provider flame,
+                                               Provider modrinth)
+    : m_selected(selected)
+    , m_flame_provider(std::move(flame))
+    , m_modrinth_provider(std::move(modrinth))
+    , m_version(version)
+    , m_loaderType(loaders)
 {
-    for (auto mod : folder->allMods()) {
+    for (auto mod : installed) {
         m_mods_file_names << mod->fileinfo().fileName();
         if (auto meta = mod->metadata(); meta)
             m_mods.append(meta);
@@ -77,11 +97,74 @@ void GetModDependenciesTask::prepare()
     for (auto sel : m_selected) {
         if (checkDependencies(sel, m_version, m_loaderType))
             for (auto dep : getDependenciesForVersion(sel->version, sel->pack->provider)) {
-                addTask(prepareDependencyTask(dep, sel->pack->provider, 20));
+                prepareDependency(dep, sel->pack->provider, 20);
             }
     }
 }
 
+auto GetModDependenciesTask::getProvider(ModPlatform::ResourceProvider providerName) const -> const Provider&
+{
+    return providerName == m_flame_provider.name ? m_flame_provider : m_modrinth_provider;
+}
+
+void GetModDependenciesTask::executeTask()
+{
+    setStatus(tr("Getting dependencies..."));
+    startLevel();
+}
+
+bool GetModDependenciesTask::abort()
+{
+    // the level task tells how it ended, see startLevel()
+    if (m_level_task && m_level_task->isRunning())
+        return m_level_task->abort();
+    return true;
+}
+
+/* Look up everything found by the previous level at once:
+ * - the project info in bulk, one request per provider
+ * - the version of each dependency, concurrently
+ * The dependencies of the versions found make up the next level.
+ * */
+void GetModDependenciesTask::startLevel()
+{
+    if (m_next_level.isEmpty() && m_missing_info.isEmpty()) {
+        m_level_task.reset();
+        emitSucceeded();
+        return;
+    }
+    auto level = m_next_level;
+    auto missingInfo = m_missing_info;
+    m_next_level.clear();
+    m_missing_info.clear();
+
+    auto job = makeShared<ConcurrentTask>(tr("Get dependencies"));
+    if (APPLICATION_DYN)
+        job->setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    for (auto providerName : { m_flame_provider.name, m_modrinth_provider.name }) {
+        QList<std::shared_ptr<PackDependency>> infoDeps;
+        for (auto& pDep : missingInfo)
+            if (pDep->pack->provider == providerName)
+                infoDeps.append(pDep);
+        for (auto& pending : level)
+            if (pending.provider == providerName && !pending.pack_dependency->dependency.addonId.toString().isEmpty())
+                infoDeps.append(pending.pack_dependency);
+        if (!infoDeps.isEmpty())
+            job->addTask(getProjectInfoTask(providerName, infoDeps));
+    }
+    for (auto& pending : level)
+        job->addTask(getDependencyVersionTask(pending.pack_dependency, pending.provider, pending.level));
+
+    connect(job.get(), &Task::succeeded, this, &GetModDependenciesTask::startLevel);
+    connect(job.get(), &Task::failed, this, &GetModDependenciesTask::emitFailed);
+    connect(job.get(), &Task::aborted, this, &GetModDependenciesTask::emitAborted);
+    connect(job.get(), &Task::progress, this, &GetModDependenciesTask::setProgress);
+    connect(job.get(), &Task::stepProgress, this, &GetModDependenciesTask::propagateStepProgress);
+    connect(job.get(), &Task::details, this, &GetModDependenciesTask::setDetails);
+    m_level_task = job;
+    m_level_task->start();
+}
+
 ModPlatform::Dependency GetModDependenciesTask::getOverride(const ModPlatform::Dependency& dep,
                                                             const ModPlatform::ResourceProvider providerName)
 {
@@ -142,38 +225,69 @@ QList<ModPlatform::Dependency> GetModDependenciesTask::getDependenciesForVersion
     return c_dependencies;
 }
 
-Task::Ptr GetModDependenciesTask::getProjectInfoTask(std::shared_ptr<PackDependency> pDep)
+Task::Ptr GetModDependenciesTask::getProjectInfoTask(ModPlatform::ResourceProvider providerName,
+                                                     QList<std::shared_ptr<PackDependency>> deps)
 {
-    auto provider = pDep->pack->provider == m_flame_provider.name ? m_flame_provider : m_modrinth_provider;
+    auto& provider = getProvider(providerName);
+    QStringList addonIds;
+    for (auto& pDep : deps)
+        addonIds.append(pDep->pack->addonId.toString());
+
     auto responseInfo = std::make_shared<QByteArray>();
-    auto info = provider.api->getProject(pDep->pack->addonId.toString(), responseInfo);
-    connect(info.get(), &NetJob::succeeded, [this, responseInfo, provider, pDep] {
+    // a single project goes through the cached project lookup
+    auto info = addonIds.size() == 1 ? provider.api->getProject(addonIds.first(), responseInfo)
+                                     : provider.api->getProjects(addonIds, responseInfo);
+    connect(info.get(), &Task::succeeded, this, [this, responseInfo, providerName, deps] {
+        auto& provider = getProvider(providerName);
+        QHash<QString, std::shared_ptr<PackDependency>> pending;
+        for (auto& pDep : deps)
+            pending.insert(pDep->pack->addonId.toString(), pDep);
+
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*responseInfo, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
-            removePack(pDep->pack->addonId);
             qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
                        << " reason: " << parse_error.errorString();
             qDebug() << *responseInfo;
-            return;
+        } else {
+            try {
+                // the bulk endpoints answer with a list, the single project ones with the project itself
+                auto data = providerName == ModPlatform::ResourceProvider::FLAME ? Json::requireObject(doc).value("data")
+                                                                                 : doc.isArray() ? QJsonValue(doc.array())
+                                                                                                 : QJsonValue(doc.object());
+                auto arr = data.isArray() ? data.toArray() : QJsonArray{ data };
+                for (auto entry : arr) {
+                    auto obj = Json::requireObject(entry);
+                    auto id = obj.value("id");
+                    auto pDep = pending.take(id.isDouble() ? QString::number(id.toInt()) : id.toString());
+                    if (!pDep)
+                        pDep = pending.take(obj.value("slug").toString());
+                    if (!pDep)
+                        continue;
+                    provider.mod->loadIndexedPack(*pDep->pack, obj);
+                }
+            } catch (const JSONValidationError& e) {
+                qDebug() << doc;
+                qWarning() << "Error while reading mod info: " << e.cause();
+            }
         }
-        try {
-            auto obj = provider.name == ModPlatform::ResourceProvider::FLAME ? Json::requireObject(Json::requireObject(doc), "data")
-                                                                             : Json::requireObject(doc);
-            provider.mod->loadIndexedPack(*pDep->pack, obj);
-        } catch (const JSONValidationError& e) {
+        // whatever is left could not be read
+        for (auto& pDep : pending)
             removePack(pDep->pack->addonId);
-            qDebug() << doc;
-            qWarning() << "Error while reading mod info: " << e.cause();
-        }
     });
     return info;
 }
 
-Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Dependency& dep,
-                                                        const ModPlatform::ResourceProvider providerName,
-                                                        int level)
+void GetModDependenciesTask::prepareDependency(const ModPlatform::Dependency& dep,
+                                               const ModPlatform::ResourceProvider providerName,
+                                               int level)
 {
+    // shared dependencies are only looked up for the first mod that needs them
+    if (auto key = dependencyKey(dep, providerName); !m_looked_up.contains(key))
+        m_looked_up.insert(key);
+    else
+        return;
+
     auto pDep = std::make_shared<PackDependency>();
     pDep->dependency = dep;
     pDep->pack = std::make_shared<ModPlatform::IndexedPack>();
@@ -181,14 +295,15 @@ Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Depen
     pDep->pack->provider = providerName;
 
     m_pack_dependencies.append(pDep);
-    auto provider = providerName == m_flame_provider.name ? m_flame_provider : m_modrinth_provider;
-
-    auto tasks = makeShared<SequentialTask>(
-        QString("DependencyInfo: %1").arg(dep.addonId.toString().isEmpty() ? dep.version : dep.addonId.toString()));
+    m_next_level.append({ pDep, providerName, level });
+}
 
-    if (!dep.addonId.toString().isEmpty()) {
-        tasks->addTask(getProjectInfoTask(pDep));
-    }
+Task::Ptr GetModDependenciesTask::getDependencyVersionTask(std::shared_ptr<PackDependency> pDep,
+                                                           const ModPlatform::ResourceProvider providerName,
+                                                           int level)
+{
+    auto dep = pDep->dependency;
+    auto provider = getProvider(providerName);
 
     ResourceAPI::DependencySearchArgs args = { dep, m_version, m_loaderType };
     ResourceAPI::DependencySearchCallbacks callbacks;
@@ -212,7 +327,7 @@ Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Depen
                     });
                     if (over != overide.cend()) {
                         removePack(dep.addonId);
-                        addTask(prepareDependencyTask({ over->fabric, dep.type }, provider.name, level));
+                        prepareDependency({ over->fabric, dep.type }, provider.name, level);
                         return;
                     }
                 }
@@ -241,23 +356,28 @@ Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Depen
             auto dep_ = getOverride({ pDep->version.addonId, pDep->dependency.type }, provider.name);
             if (dep_.addonId != pDep->version.addonId) {
                 removePack(pDep->version.addonId);
-                addTask(prepareDependencyTask(dep_, provider.name, level));
+                prepareDependency(dep_, provider.name, level);
+                return;
+            }
+            if (auto key = dependencyKey(dep_, provider.name); m_looked_up.contains(key)) {
+                m_pack_dependencies.removeAll(pDep);  // another mod already asked for this project by its id
+                return;
             } else {
-                addTask(getProjectInfoTask(pDep));
+                m_looked_up.insert(key);
             }
         }
         if (isLocalyInstalled(pDep)) {
             removePack(pDep->version.addonId);
             return;
         }
+        if (dep.addonId.toString().isEmpty())
+            m_missing_info.append(pDep);
         for (auto dep_ : getDependenciesForVersion(pDep->version, provider.name)) {
-            addTask(prepareDependencyTask(dep_, provider.name, level - 1));
+            prepareDependency(dep_, provider.name, level - 1);
         }
     };
 
-    auto version = provider.api->getDependencyVersion(std::move(args), std::move(callbacks));
-    tasks->addTask(version);
-    return tasks;
+    return provider.api->getDependencyVersion(std::move(args), std::move(callbacks));
 }
 
 void GetModDependenciesTask::removePack(const QVariant& addonId)
@@ -20,6 +20,7 @@
 
 #include <QDir>
 #include <QList>
+#include <QSet>
 #include <QVariant>
 #include <functional>
 #include <memory>
@@ -28,11 +29,15 @@
 #include "minecraft/mod/ModFolderModel.h"
 #include "modplatform/ModIndex.h"
 #include "modplatform/ResourceAPI.h"
-#include "tasks/SequentialTask.h"
 #include "tasks/Task.h"
 #include "ui/pages/modplatform/ModModel.h"
 
-class GetModDependenciesTask : public SequentialTask {
+/** Resolves the dependencies of the selected mods breadth-first.
+ *
+ *  Each level of the dependency tree is looked up concurrently, with the project info of a level
+ *  fetched in bulk per provider. A dependency shared by several mods is only looked up once.
+ */
+class GetModDependenciesTask : public Task {
     Q_OBJECT
    public:
     using Ptr = shared_qobject_ptr<GetModDependenciesTask>;
@@ -61,16 +66,32 @@ class GetModDependenciesTask : public SequentialTask {
     };
 
     explicit GetModDependenciesTask(BaseInstance* instance, ModFolderModel* folder, QList<std::shared_ptr<PackDependency>> selected);
+    /** Resolves for the game @p version and mod @p loaders, next to the @p installed mods, through the given providers. */
+    GetModDependenciesTask(Version version,
+                           ModPlatform::ModLoaderTypes loaders,
+                           QList<Mod*> installed,
+                           QList<std::shared_ptr<PackDependency>> selected,
+                           Provider flame,
+                           Provider modrinth);
 
     auto getDependecies() const -> QList<std::shared_ptr<PackDependency>> { return m_pack_dependencies; }
     QHash<QString, PackDependencyExtraInfo> getExtraInfo();
 
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
    protected slots:
-    Task::Ptr prepareDependencyTask(const ModPlatform::Dependency&, ModPlatform::ResourceProvider, int);
+    void executeTask() override;
+    void startLevel();
+
+    void prepareDependency(const ModPlatform::Dependency&, ModPlatform::ResourceProvider, int);
     QList<ModPlatform::Dependency> getDependenciesForVersion(const ModPlatform::IndexedVersion&,
                                                              ModPlatform::ResourceProvider providerName);
     void prepare();
-    Task::Ptr getProjectInfoTask(std::shared_ptr<PackDependency> pDep);
+    Task::Ptr getProjectInfoTask(ModPlatform::ResourceProvider providerName, QList<std::shared_ptr<PackDependency>> deps);
+    Task::Ptr getDependencyVersionTask(std::shared_ptr<PackDependency> pDep, ModPlatform::ResourceProvider providerName, int level);
     ModPlatform::Dependency getOverride(const ModPlatform::Dependency&, ModPlatform::ResourceProvider providerName);
     void removePack(const QVariant& addonId);
 
@@ -78,6 +99,14 @@ class GetModDependenciesTask : public SequentialTask {
     bool maybeInstalled(std::shared_ptr<PackDependency> pDep);
 
    private:
+    const Provider& getProvider(ModPlatform::ResourceProvider providerName) const;
+
+    struct PendingDependency {
+        std::shared_ptr<PackDependency> pack_dependency;
+        ModPlatform::ResourceProvider provider;
+        int level;
+    };
+
     QList<std::shared_ptr<PackDependency>> m_pack_dependencies;
     QList<std::shared_ptr<Metadata::ModStruct>> m_mods;
     QList<std::shared_ptr<PackDependency>> m_selected;
@@ -85,6 +114,14 @@ class GetModDependenciesTask : public SequentialTask {
     Provider m_flame_provider;
     Provider m_modrinth_provider;
 
+    //! dependencies to look up in the next level
+    QList<PendingDependency> m_next_level;
+    //! dependencies whose project was only known once their version was found
+    QList<std::shared_ptr<PackDependency>> m_missing_info;
+    //! every dependency looked up so far, see dependencyKey()
+    QSet<QString> m_looked_up;
+    Task::Ptr m_level_task;
+
     Version m_version;
     ModPlatform::ModLoaderTypes m_loaderType;
 };
@@ -654,11 +654,11 @@ bool validate(QFileInfo file)
     return ModUtils::process(mod, ProcessingLevel::BasicInfoOnly) && mod.valid();
 }
 
-bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap)
+bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QImage* image)
 {
     auto img = QImage::fromData(raw_data);
     if (!img.isNull()) {
-        *pixmap = mod.setIcon(img);
+        *image = mod.setIcon(img);
     } else {
         qWarning() << "Failed to parse mod logo:" << mod.iconPath() << "from" << mod.name();
         return false;
@@ -666,7 +666,7 @@ bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap)
     return true;
 }
 
-bool loadIconFile(const Mod& mod, QPixmap* pixmap)
+bool loadIconFile(const Mod& mod, QImage* image)
 {
     if (mod.iconPath().isEmpty()) {
         qWarning() << "No Iconfile set, be sure to parse the mod first";
@@ -688,7 +688,7 @@ bool loadIconFile(const Mod& mod, QPixmap* pixmap)
                 }
                 auto data = icon.readAll();
 
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), pixmap);
+                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), image);
 
                 icon.close();
 
@@ -715,7 +715,7 @@ bool loadIconFile(const Mod& mod, QPixmap* pixmap)
 
                 auto data = file.readAll();
 
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), pixmap);
+                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), image);
 
                 file.close();
                 if (!icon_result) {
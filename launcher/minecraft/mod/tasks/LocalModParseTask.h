@@ -26,8 +26,8 @@ bool processLitemod(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 /** Checks whether a file is valid as a mod or not. */
 bool validate(QFileInfo file);
 
-bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap);
-bool loadIconFile(const Mod& mod, QPixmap* pixmap);
+bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QImage* image);
+bool loadIconFile(const Mod& mod, QImage* image);
 }  // namespace ModUtils
 
 class LocalModParseTask : public Task {
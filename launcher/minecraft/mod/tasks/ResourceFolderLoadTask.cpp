@@ -57,6 +57,42 @@ ResourceFolderLoadTask::ResourceFolderLoadTask(const QDir& resource_dir,
     , m_thread_to_spawn_into(thread())
 {}
 
+ResourceFolderLoadTask::ResourceFolderLoadTask(const QDir& resource_dir,
+                                               const QDir& index_dir,
+                                               bool is_indexed,
+                                               const QSet<QString>& file_names,
+                                               const QSet<QString>& slugs,
+                                               std::function<Resource*(const QFileInfo&)> create_function)
+    : ResourceFolderLoadTask(resource_dir, index_dir, is_indexed, false, std::move(create_function))
+{
+    m_ids.emplace();
+    for (auto& file_name : file_names)
+        addId(file_name);
+    m_slugs = slugs;
+}
+
+void ResourceFolderLoadTask::addId(const QString& file_name)
+{
+    // enabling or disabling a resource renames it, and a disabled file takes the metadata of the enabled name
+    m_ids->insert(file_name);
+    m_ids->insert(file_name.endsWith(".disabled") ? file_name.chopped(9) : file_name + ".disabled");
+}
+
+QFileInfoList ResourceFolderLoadTask::entries() const
+{
+    if (!m_ids)
+        return m_resource_dir.entryInfoList();
+
+    // what the folder's filter would have listed of them
+    QFileInfoList entries;
+    for (auto& id : *m_ids) {
+        QFileInfo entry(m_resource_dir.filePath(id));
+        if (entry.exists() && entry.isReadable() && !entry.isHidden())
+            entries.append(entry);
+    }
+    return entries;
+}
+
 void ResourceFolderLoadTask::executeTask()
 {
     if (thread() != m_thread_to_spawn_into)
@@ -69,7 +105,7 @@ void ResourceFolderLoadTask::executeTask()
 
     // Read JAR files that don't have metadata
     m_resource_dir.refresh();
-    for (auto entry : m_resource_dir.entryInfoList()) {
+    for (auto entry : entries()) {
         auto filePath = entry.absoluteFilePath();
         if (auto app = APPLICATION_DYN; app && app->checkQSavePath(filePath)) {
             continue;
@@ -78,6 +114,8 @@ void ResourceFolderLoadTask::executeTask()
         if (newFilePath != filePath) {
             FS::move(filePath, newFilePath);
             entry = QFileInfo(newFilePath);
+            if (m_ids)
+                addId(entry.fileName());
         }
 
         Resource* resource = m_create_func(entry);
@@ -125,6 +163,7 @@ void ResourceFolderLoadTask::executeTask()
 
     for (auto mod : m_result->resources)
         mod->moveToThread(m_thread_to_spawn_into);
+    m_result->ids = m_ids;
 
     if (m_aborted)
         emit finished();
@@ -134,13 +173,13 @@ void ResourceFolderLoadTask::executeTask()
 
 void ResourceFolderLoadTask::getFromMetadata()
 {
-    m_index_dir.refresh();
-    for (auto entry : m_index_dir.entryList(QDir::Files)) {
-        auto metadata = Metadata::get(m_index_dir, entry);
-
-        if (!metadata.isValid())
-            continue;
-
+    for (auto& metadata : Metadata::index(m_index_dir)->mods()) {
+        if (m_ids) {
+            if (m_slugs.contains(metadata.slug))
+                addId(metadata.filename);
+            else if (!m_ids->contains(metadata.filename))
+                continue;
+        }
         auto* resource = m_create_func(QFileInfo(m_resource_dir.filePath(metadata.filename)));
         resource->setMetadata(metadata);
         resource->setStatus(ResourceStatus::NOT_INSTALLED);
@@ -40,7 +40,9 @@
 #include <QMap>
 #include <QObject>
 #include <QRunnable>
+#include <QSet>
 #include <memory>
+#include <optional>
 #include "minecraft/mod/Mod.h"
 #include "tasks/Task.h"
 
@@ -49,6 +51,8 @@ class ResourceFolderLoadTask : public Task {
    public:
     struct Result {
         QMap<QString, Resource::Ptr> resources;
+        /// for a load of a few files, the ids it looked at. resources with other ids were not looked at
+        std::optional<QSet<QString>> ids;
     };
     using ResultPtr = std::shared_ptr<Result>;
     ResultPtr result() const { return m_result; }
@@ -59,6 +63,13 @@ class ResourceFolderLoadTask : public Task {
                            bool is_indexed,
                            bool clean_orphan,
                            std::function<Resource*(const QFileInfo&)> create_function);
+    /** Loads only the resources with these file names, and the ones whose metadata has one of these slugs. */
+    ResourceFolderLoadTask(const QDir& resource_dir,
+                           const QDir& index_dir,
+                           bool is_indexed,
+                           const QSet<QString>& file_names,
+                           const QSet<QString>& slugs,
+                           std::function<Resource*(const QFileInfo&)> create_function);
 
     bool canAbort() const override { return true; }
     bool abort() override
@@ -71,12 +82,17 @@ class ResourceFolderLoadTask : public Task {
 
    private:
     void getFromMetadata();
+    QFileInfoList entries() const;
+    void addId(const QString& file_name);
 
    private:
     QDir m_resource_dir, m_index_dir;
     bool m_is_indexed;
     bool m_clean_orphan;
     std::function<Resource*(QFileInfo const&)> m_create_func;
+    /// only set when loading a few files, with both the enabled and the disabled name of each
+    std::optional<QSet<QString>> m_ids;
+    QSet<QString> m_slugs;
     ResultPtr m_result;
 
     std::atomic<bool> m_aborted = false;
@@ -25,15 +25,16 @@
 #include "Json.h"
 #include "minecraft/skins/SkinModel.h"
 
-SkinList::SkinList(QObject* parent, QString path, MinecraftAccountPtr acct) : QAbstractListModel(parent), m_acct(acct)
+SkinList::SkinList(QObject* parent, QString path, MinecraftAccountPtr acct) : QAbstractListModel(parent), m_watcher(this), m_acct(acct)
 {
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-    m_watcher.reset(new QFileSystemWatcher(this));
+    // the skins are all at the top, a change to one of them changes the folder
+    m_watcher.setMaxDepth(0);
     m_isWatching = false;
-    connect(m_watcher.get(), &QFileSystemWatcher::directoryChanged, this, &SkinList::directoryChanged);
-    connect(m_watcher.get(), &QFileSystemWatcher::fileChanged, this, &SkinList::fileChanged);
+    connect(&m_watcher, &RecursiveFileSystemWatcher::directoryChanged, this, &SkinList::directoryChanged);
+    connect(&m_watcher, &RecursiveFileSystemWatcher::fileChanged, this, &SkinList::fileChanged);
     directoryChanged(path);
 }
 
@@ -43,12 +44,10 @@ void SkinList::startWatching()
         return;
     }
     update();
-    m_isWatching = m_watcher->addPath(m_dir.absolutePath());
-    if (m_isWatching) {
-        qDebug() << "Started watching " << m_dir.absolutePath();
-    } else {
-        qDebug() << "Failed to start watching " << m_dir.absolutePath();
-    }
+    m_watcher.setRootDir(m_dir);
+    m_watcher.enable();
+    m_isWatching = true;
+    qDebug() << "Started watching " << m_dir.absolutePath();
 }
 
 void SkinList::stopWatching()
@@ -57,12 +56,9 @@ void SkinList::stopWatching()
     if (!m_isWatching) {
         return;
     }
-    m_isWatching = !m_watcher->removePath(m_dir.absolutePath());
-    if (!m_isWatching) {
-        qDebug() << "Stopped watching " << m_dir.absolutePath();
-    } else {
-        qDebug() << "Failed to stop watching " << m_dir.absolutePath();
-    }
+    m_watcher.disable();
+    m_isWatching = false;
+    qDebug() << "Stopped watching " << m_dir.absolutePath();
 }
 
 bool SkinList::update()
@@ -20,9 +20,9 @@
 
 #include <QAbstractListModel>
 #include <QDir>
-#include <QFileSystemWatcher>
 
 #include "QObjectPtr.h"
+#include "RecursiveFileSystemWatcher.h"
 #include "SkinModel.h"
 #include "minecraft/auth/MinecraftAccount.h"
 
@@ -72,7 +72,7 @@ class SkinList : public QAbstractListModel {
     bool update();
 
    private:
-    shared_qobject_ptr<QFileSystemWatcher> m_watcher;
+    RecursiveFileSystemWatcher m_watcher;
     bool m_isWatching;
     QList<SkinModel> m_skinList;
     QDir m_dir;
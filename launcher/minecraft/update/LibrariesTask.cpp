@@ -48,6 +48,15 @@ void LibrariesTask::executeTask()
         libArtifactPool.append(agent->library());
     }
     libArtifactPool.append(profile->getMainJar());
+
+    // check the cached files of every library at once, so getDownloads() only has to stat them
+    QStringList cachedPaths;
+    for (auto lib : libArtifactPool) {
+        if (lib)
+            cachedPaths.append(lib->getCacheStoragePaths(inst->runtimeContext()));
+    }
+    metacache->resolveEntries("libraries", cachedPaths);
+
     processArtifactPool(libArtifactPool, failedLocalLibraries, inst->getLocalLibraryPath());
 
     QStringList failedLocalJarMods;
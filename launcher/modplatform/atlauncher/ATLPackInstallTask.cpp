@@ -36,7 +36,7 @@
 
 #include "ATLPackInstallTask.h"
 
-#include <QtConcurrent>
+#include "tasks/Executor.h"
 #include <algorithm>
 
 #include <quazip/quazip.h>
@@ -682,8 +682,8 @@ void PackInstallTask::extractConfigs()
         return;
     }
 
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath,
-                                        extractDir.absolutePath() + "/minecraft");
+    m_extractFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal,
+                                    [archivePath, target = extractDir.absolutePath() + "/minecraft"] { return MMCZip::extractDir(archivePath, target); });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, [this]() { downloadMods(); });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [this]() { emitAborted(); });
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -896,8 +896,9 @@ void PackInstallTask::onModsDownloaded()
     jobPtr.reset();
 
     if (!modsToExtract.empty() || !modsToDecomp.empty() || !modsToCopy.empty()) {
-        m_modExtractFuture =
-            QtConcurrent::run(QThreadPool::globalInstance(), &PackInstallTask::extractMods, this, modsToExtract, modsToDecomp, modsToCopy);
+        m_modExtractFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, [this, modsToExtract, modsToDecomp, modsToCopy] {
+            return extractMods(modsToExtract, modsToDecomp, modsToCopy);
+        });
         connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
         connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::emitAborted);
         m_modExtractFutureWatcher.setFuture(m_modExtractFuture);
@@ -13,7 +13,9 @@
 #include "modplatform/ModIndex.h"
 #include "net/ApiDownload.h"
 #include "net/ApiUpload.h"
+#include "modplatform/helpers/ApiResponseCache.h"
 #include "net/NetJob.h"
+#include "tasks/ConcurrentTask.h"
 
 Task::Ptr FlameAPI::matchFingerprints(const QList<uint>& fingerprints, std::shared_ptr<QByteArray> response)
 {
@@ -35,72 +37,77 @@ Task::Ptr FlameAPI::matchFingerprints(const QList<uint>& fingerprints, std::shar
     return netJob;
 }
 
-QString FlameAPI::getModFileChangelog(int modId, int fileId)
+Task::Ptr FlameAPI::getModFileChangelog(int modId, int fileId, std::shared_ptr<QByteArray> response) const
 {
-    QEventLoop lock;
-    QString changelog;
-
-    auto netJob = makeShared<NetJob>(QString("Flame::FileChangelog"), APPLICATION->network());
-    auto response = std::make_shared<QByteArray>();
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(
-        QString(BuildConfig.FLAME_BASE_URL + "/mods/%1/files/%2/changelog")
-            .arg(QString::fromStdString(std::to_string(modId)), QString::fromStdString(std::to_string(fileId))),
-        response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [&netJob, response, &changelog] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Flame::FileChangelog at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-
-            netJob->failed(parse_error.errorString());
-            return;
-        }
+    return APPLICATION->apiResponseCache()->get(
+        QString(BuildConfig.FLAME_BASE_URL + "/mods/%1/files/%2/changelog").arg(QString::number(modId), QString::number(fileId)),
+        response);
+}
 
-        changelog = Json::ensureString(doc.object(), "data");
-    });
+Task::Ptr FlameAPI::getModDescription(int modId, std::shared_ptr<QByteArray> response) const
+{
+    return APPLICATION->apiResponseCache()->get(QString(BuildConfig.FLAME_BASE_URL + "/mods/%1/description").arg(QString::number(modId)),
+                                                response);
+}
 
-    QObject::connect(netJob.get(), &NetJob::finished, [&lock] { lock.quit(); });
+QString FlameAPI::loadDataString(const QByteArray& response)
+{
+    if (response.isEmpty())
+        return {};
 
-    netJob->start();
-    lock.exec();
+    QJsonParseError parse_error{};
+    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError) {
+        qWarning() << "Error while parsing JSON response from Flame at " << parse_error.offset << " reason: " << parse_error.errorString();
+        qWarning() << response;
+        return {};
+    }
 
-    return changelog;
+    return Json::ensureString(doc.object(), "data");
 }
 
-QString FlameAPI::getModDescription(int modId)
+Task::Ptr FlameAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfoCallbacks&& callbacks) const
 {
-    QEventLoop lock;
-    QString description;
-
-    auto netJob = makeShared<NetJob>(QString("Flame::ModDescription"), APPLICATION->network());
     auto response = std::make_shared<QByteArray>();
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(
-        QString(BuildConfig.FLAME_BASE_URL + "/mods/%1/description").arg(QString::number(modId)), response));
+    auto project = getProject(args.pack.addonId.toString(), response);
+    if (!project)
+        return nullptr;
+
+    // The description has an endpoint of its own. Fetch it alongside the project and hand it over in the project's
+    // "data" object, so FlameMod::loadBody() has nothing left to request.
+    auto description = std::make_shared<QByteArray>();
+    auto job = makeShared<ConcurrentTask>(QString("Flame::ProjectInfo"), 2);
+    job->addTask(project);
+    job->addTask(getModDescription(args.pack.addonId.toInt(), description));
+
+    QObject::connect(job.get(), &Task::aborted, [callbacks] { callbacks.on_abort(); });
+    QObject::connect(job.get(), &Task::finished, [project, response, description, callbacks, args] {
+        // a missing description is not worth failing over, so only the project decides how this ends
+        if (project->getState() == Task::State::Failed) {
+            callbacks.on_fail(project->failReason());
+            return;
+        }
+        if (!project->wasSuccessful())
+            return;
 
-    QObject::connect(netJob.get(), &NetJob::succeeded, [&netJob, response, &description] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from Flame::ModDescription at " << parse_error.offset
+            qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
                        << " reason: " << parse_error.errorString();
             qWarning() << *response;
-
-            netJob->failed(parse_error.errorString());
             return;
         }
 
-        description = Json::ensureString(doc.object(), "data");
-    });
+        auto obj = doc.object();
+        auto data = obj["data"].toObject();
+        data["description"] = loadDataString(*description);
+        obj["data"] = data;
+        doc.setObject(obj);
 
-    QObject::connect(netJob.get(), &NetJob::finished, [&lock] { lock.quit(); });
-
-    netJob->start();
-    lock.exec();
-
-    return description;
+        callbacks.on_succeed(doc, args.pack);
+    });
+    return job;
 }
 
 Task::Ptr FlameAPI::getProjects(QStringList addonIds, std::shared_ptr<QByteArray> response) const
@@ -13,8 +13,12 @@
 
 class FlameAPI : public NetworkResourceAPI {
    public:
-    QString getModFileChangelog(int modId, int fileId);
-    QString getModDescription(int modId);
+    Task::Ptr getModFileChangelog(int modId, int fileId, std::shared_ptr<QByteArray> response) const;
+    Task::Ptr getModDescription(int modId, std::shared_ptr<QByteArray> response) const;
+    /** Reads the changelog / description out of a response from the two methods above. */
+    static QString loadDataString(const QByteArray& response);
+
+    Task::Ptr getProjectInfo(ProjectInfoArgs&&, ProjectInfoCallbacks&&) const override;
 
     std::optional<ModPlatform::IndexedVersion> getLatestVersion(QList<ModPlatform::IndexedVersion> versions,
                                                                 QList<ModPlatform::ModLoaderType> instanceLoaders,
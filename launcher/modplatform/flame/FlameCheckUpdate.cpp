@@ -14,6 +14,7 @@
 #include "minecraft/mod/tasks/GetModDependenciesTask.h"
 
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/VersionIndex.h"
 #include "net/ApiDownload.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
@@ -30,8 +31,27 @@ bool FlameCheckUpdate::abort()
     return result;
 }
 
+QString FlameCheckUpdate::versionKey(Resource* resource) const
+{
+    // the loaders of the resource itself and those of the instance decide between versions too
+    return VersionIndex::key(ModPlatform::ResourceProvider::FLAME, resource->metadata()->project_id.toString(),
+                             resource->metadata()->loaders, m_game_versions, m_loaders_list);
+}
+
+void FlameCheckUpdate::startStep(Task::Ptr task)
+{
+    connect(task.get(), &Task::progress, this, &FlameCheckUpdate::setProgress);
+    connect(task.get(), &Task::stepProgress, this, &FlameCheckUpdate::propagateStepProgress);
+    connect(task.get(), &Task::details, this, &FlameCheckUpdate::setDetails);
+    m_task = task;
+    m_task->start();
+}
+
 /* Check for update:
  * - Get latest version available
+ *   - from what a recent check found
+ *   - from the latest files the projects list for each game version and loader, looked up in bulk
+ *   - from all the versions of the project, if it lists none of them
  * - Compare hash of the latest version with the current hash
  * - If equal, no updates, else, there's updates, so add to the list
  * */
@@ -39,13 +59,160 @@ void FlameCheckUpdate::executeTask()
 {
     setStatus(tr("Preparing resources for CurseForge..."));
 
-    auto netJob = new NetJob("Get latest versions", APPLICATION->network());
-    connect(netJob, &Task::finished, this, &FlameCheckUpdate::collectBlockedMods);
+    m_changelogs.reset(new ConcurrentTask("Get changelogs"));
 
-    connect(netJob, &Task::progress, this, &FlameCheckUpdate::setProgress);
-    connect(netJob, &Task::stepProgress, this, &FlameCheckUpdate::propagateStepProgress);
-    connect(netJob, &Task::details, this, &FlameCheckUpdate::setDetails);
     for (auto* resource : m_resources) {
+        if (auto file = VersionIndex::instance().find(versionKey(resource)))
+            checkLatestFile(resource, *file);
+        else
+            m_unknown[resource->metadata()->project_id.toString()].append(resource);
+    }
+
+    getLatestFileIndexes();
+}
+
+void FlameCheckUpdate::getLatestFileIndexes()
+{
+    if (m_unknown.isEmpty()) {
+        collectChangelogs();
+        return;
+    }
+    setStatus(tr("Getting the latest versions from CurseForge..."));
+
+    QStringList game_versions;
+    for (auto& version : m_game_versions)
+        game_versions.append(version.toString());
+
+    auto project_ids = m_unknown.keys();
+    auto job = makeShared<ConcurrentTask>("GetFlameProjects", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    for (qsizetype i = 0; i < project_ids.size(); i += s_idsPerRequest) {
+        auto response = std::make_shared<QByteArray>();
+        auto request = api.getProjects(project_ids.mid(i, s_idsPerRequest), response);
+        connect(request.get(), &Task::succeeded, this, [this, response, game_versions] {
+            QJsonParseError parse_error{};
+            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from Flame projects task at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+                return;
+            }
+            try {
+                for (auto project : Json::requireArray(Json::requireObject(doc), "data")) {
+                    auto project_obj = Json::requireObject(project);
+                    auto id = QString::number(Json::requireInteger(project_obj, "id"));
+                    // the latest file of each game version, mod loader and release type
+                    QStringList files;
+                    for (auto index : Json::ensureArray(project_obj, "latestFilesIndexes")) {
+                        auto index_obj = Json::requireObject(index);
+                        if (game_versions.contains(Json::ensureString(index_obj, "gameVersion")))
+                            files.append(QString::number(Json::requireInteger(index_obj, "fileId")));
+                    }
+                    files.removeDuplicates();
+                    m_latest_files.insert(id, files);
+                }
+            } catch (Json::JsonException& e) {
+                qDebug() << e.cause();
+                qDebug() << doc;
+            }
+        });
+        job->addTask(request);
+    }
+
+    // projects that could not be looked up list their versions one by one
+    connect(job.get(), &Task::succeeded, this, &FlameCheckUpdate::getLatestFiles);
+    connect(job.get(), &Task::failed, this, &FlameCheckUpdate::getLatestFiles);
+    startStep(job);
+}
+
+void FlameCheckUpdate::getLatestFiles()
+{
+    QStringList file_ids;
+    for (auto& files : m_latest_files)
+        file_ids.append(files);
+
+    auto found = std::make_shared<QHash<QString, QJsonObject>>();
+    auto job = makeShared<ConcurrentTask>("GetFlameFiles", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    for (qsizetype i = 0; i < file_ids.size(); i += s_idsPerRequest) {
+        auto response = std::make_shared<QByteArray>();
+        auto request = api.getFiles(file_ids.mid(i, s_idsPerRequest), response);
+        connect(request.get(), &Task::succeeded, this, [response, found] {
+            QJsonParseError parse_error{};
+            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from Flame files task at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+                return;
+            }
+            try {
+                for (auto file : Json::requireArray(Json::requireObject(doc), "data")) {
+                    auto file_obj = Json::requireObject(file);
+                    found->insert(QString::number(Json::requireInteger(file_obj, "id")), file_obj);
+                }
+            } catch (Json::JsonException& e) {
+                qDebug() << e.cause();
+                qDebug() << doc;
+            }
+        });
+        job->addTask(request);
+    }
+
+    auto check = [this, found] {
+        setStatus(tr("Parsing the API response from CurseForge..."));
+        for (auto project = m_unknown.cbegin(); project != m_unknown.cend(); ++project) {
+            QHash<QString, QJsonObject> files;
+            for (auto& file_id : m_latest_files.value(project.key())) {
+                if (found->contains(file_id))
+                    files.insert(file_id, found->value(file_id));
+            }
+            if (files.isEmpty()) {
+                m_fallback.append(project.value());
+                continue;
+            }
+
+            QList<ModPlatform::IndexedVersion> versions;
+            for (auto file : files) {
+                try {
+                    auto version = FlameMod::loadIndexedPackVersion(file);
+                    if (!version.addonId.isValid())
+                        version.addonId = project.key();
+                    if (version.fileId.isValid())
+                        versions.append(version);
+                } catch (Json::JsonException& e) {
+                    qDebug() << e.cause();
+                }
+            }
+
+            for (auto resource : project.value()) {
+                auto latest_ver = api.getLatestVersion(versions, m_loaders_list, resource->metadata()->loaders);
+                auto latest_file = latest_ver.has_value() ? files.value(latest_ver->fileId.toString()) : QJsonObject();
+                VersionIndex::instance().insert(versionKey(resource), latest_file);
+                checkLatestVersion(resource, latest_ver);
+            }
+        }
+        getVersions();
+    };
+    if (file_ids.isEmpty()) {
+        check();
+        return;
+    }
+    connect(job.get(), &Task::succeeded, this, check);
+    connect(job.get(), &Task::failed, this, check);
+    startStep(job);
+}
+
+void FlameCheckUpdate::getVersions()
+{
+    if (m_fallback.isEmpty()) {
+        collectChangelogs();
+        return;
+    }
+
+    auto netJob = makeShared<NetJob>("Get latest versions", APPLICATION->network());
+    connect(netJob.get(), &Task::finished, this, &FlameCheckUpdate::collectChangelogs);
+
+    for (auto* resource : m_fallback) {
         auto versions_url_optional = api.getVersionsURL({ { resource->metadata()->project_id.toString() }, m_game_versions });
         if (!versions_url_optional.has_value())
             continue;
@@ -56,8 +223,7 @@ void FlameCheckUpdate::executeTask()
         connect(task.get(), &Task::succeeded, this, [this, resource, response] { getLatestVersionCallback(resource, response); });
         netJob->addNetAction(task);
     }
-    m_task.reset(netJob);
-    m_task->start();
+    startStep(netJob);
 }
 
 void FlameCheckUpdate::getLatestVersionCallback(Resource* resource, std::shared_ptr<QByteArray> response)
@@ -71,23 +237,57 @@ void FlameCheckUpdate::getLatestVersionCallback(Resource* resource, std::shared_
         return;
     }
 
-    // Fake pack with the necessary info to pass to the download task :)
-    auto pack = std::make_shared<ModPlatform::IndexedPack>();
-    pack->name = resource->name();
-    pack->slug = resource->metadata()->slug;
-    pack->addonId = resource->metadata()->project_id;
-    pack->provider = ModPlatform::ResourceProvider::FLAME;
+    ModPlatform::IndexedPack pack;
+    pack.addonId = resource->metadata()->project_id;
+    QJsonArray arr;
     try {
         auto obj = Json::requireObject(doc);
-        auto arr = Json::requireArray(obj, "data");
+        arr = Json::requireArray(obj, "data");
 
-        FlameMod::loadIndexedPackVersions(*pack.get(), arr);
+        FlameMod::loadIndexedPackVersions(pack, arr);
     } catch (Json::JsonException& e) {
         qCritical() << "Failed to parse response from a version request.";
         qCritical() << e.what();
         qDebug() << doc;
     }
-    auto latest_ver = api.getLatestVersion(pack->versions, m_loaders_list, resource->metadata()->loaders);
+    auto latest_ver = api.getLatestVersion(pack.versions, m_loaders_list, resource->metadata()->loaders);
+
+    QJsonObject latest_file;
+    if (latest_ver.has_value()) {
+        for (auto file : arr) {
+            if (file.toObject().value("id").toVariant().toString() == latest_ver->fileId.toString())
+                latest_file = file.toObject();
+        }
+    }
+    VersionIndex::instance().insert(versionKey(resource), latest_file);
+
+    checkLatestVersion(resource, latest_ver);
+}
+
+void FlameCheckUpdate::checkLatestFile(Resource* resource, QJsonObject file)
+{
+    std::optional<ModPlatform::IndexedVersion> latest_ver;
+    if (!file.isEmpty()) {
+        try {
+            auto version = FlameMod::loadIndexedPackVersion(file);
+            if (!version.addonId.isValid())
+                version.addonId = resource->metadata()->project_id;
+            latest_ver = version;
+        } catch (Json::JsonException& e) {
+            qDebug() << e.cause();
+        }
+    }
+    checkLatestVersion(resource, latest_ver);
+}
+
+void FlameCheckUpdate::checkLatestVersion(Resource* resource, std::optional<ModPlatform::IndexedVersion> latest_ver)
+{
+    // Fake pack with the necessary info to pass to the download task :)
+    auto pack = std::make_shared<ModPlatform::IndexedPack>();
+    pack->name = resource->name();
+    pack->slug = resource->metadata()->slug;
+    pack->addonId = resource->metadata()->project_id;
+    pack->provider = ModPlatform::ResourceProvider::FLAME;
 
     setStatus(tr("Parsing the API response from CurseForge for '%1'...").arg(resource->name()));
 
@@ -121,12 +321,31 @@ void FlameCheckUpdate::getLatestVersionCallback(Resource* resource, std::shared_
 
         auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver.value(), m_resource_model);
         m_updates.emplace_back(pack->name, resource->metadata()->hash, old_version, latest_ver->version, latest_ver->version_type,
-                               api.getModFileChangelog(latest_ver->addonId.toInt(), latest_ver->fileId.toInt()),
-                               ModPlatform::ResourceProvider::FLAME, download_task, resource->enabled());
+                               QString(), ModPlatform::ResourceProvider::FLAME, download_task, resource->enabled());
+
+        // the changelogs are fetched together once all the versions are in
+        auto changelog = std::make_shared<QByteArray>();
+        auto index = m_updates.size() - 1;
+        auto changelog_task = api.getModFileChangelog(latest_ver->addonId.toInt(), latest_ver->fileId.toInt(), changelog);
+        connect(changelog_task.get(), &Task::succeeded, this,
+                [this, index, changelog] { m_updates[index].changelog = FlameAPI::loadDataString(*changelog); });
+        m_changelogs->addTask(changelog_task);
     }
     m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, latest_ver.value()));
 }
 
+void FlameCheckUpdate::collectChangelogs()
+{
+    setStatus(tr("Getting changelogs from CurseForge..."));
+
+    connect(m_changelogs.get(), &Task::finished, this, &FlameCheckUpdate::collectBlockedMods);  // changelogs are optional
+    connect(m_changelogs.get(), &Task::progress, this, &FlameCheckUpdate::setProgress);
+    connect(m_changelogs.get(), &Task::stepProgress, this, &FlameCheckUpdate::propagateStepProgress);
+    connect(m_changelogs.get(), &Task::details, this, &FlameCheckUpdate::setDetails);
+    m_task = m_changelogs;
+    m_task->start();
+}
+
 void FlameCheckUpdate::collectBlockedMods()
 {
     QStringList addonIds;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "modplatform/CheckUpdateTask.h"
+#include "tasks/ConcurrentTask.h"
 
 class FlameCheckUpdate : public CheckUpdateTask {
     Q_OBJECT
@@ -19,11 +20,32 @@ class FlameCheckUpdate : public CheckUpdateTask {
    protected slots:
     void executeTask() override;
    private slots:
+    void getLatestFileIndexes();
+    void getLatestFiles();
+    void getVersions();
     void getLatestVersionCallback(Resource* resource, std::shared_ptr<QByteArray> response);
+    void collectChangelogs();
     void collectBlockedMods();
 
    private:
+    QString versionKey(Resource* resource) const;
+    /** Compares the resource with the latest version of its project, as the API describes it. */
+    void checkLatestFile(Resource* resource, QJsonObject file);
+    void checkLatestVersion(Resource* resource, std::optional<ModPlatform::IndexedVersion> latest_ver);
+    void startStep(Task::Ptr task);
+
+    //! how many projects or files are looked up with one request, the requests themselves run side by side
+    static constexpr int s_idsPerRequest = 50;
+
     Task::Ptr m_task = nullptr;
+    ConcurrentTask::Ptr m_changelogs = nullptr;
+
+    //! the resources that were not checked recently, by project
+    QHash<QString, QList<Resource*>> m_unknown;
+    //! the files the projects list as their latest ones for the game versions
+    QHash<QString, QStringList> m_latest_files;
+    //! the resources whose projects have to list all their versions
+    QList<Resource*> m_fallback;
 
     QHash<Resource*, QString> m_blocked;
 };
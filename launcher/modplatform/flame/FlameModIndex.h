@@ -14,6 +14,6 @@ void loadIndexedPack(ModPlatform::IndexedPack& m, QJsonObject& obj);
 void loadURLs(ModPlatform::IndexedPack& m, QJsonObject& obj);
 void loadBody(ModPlatform::IndexedPack& m, QJsonObject& obj);
 void loadIndexedPackVersions(ModPlatform::IndexedPack& pack, QJsonArray& arr);
-ModPlatform::IndexedVersion loadIndexedPackVersion(QJsonObject& obj, bool load_changelog = false);
+ModPlatform::IndexedVersion loadIndexedPackVersion(QJsonObject& obj);
 ModPlatform::IndexedVersion loadDependencyVersions(const ModPlatform::Dependency& m, QJsonArray& arr, const BaseInstance* inst);
 }  // namespace FlameMod
\ No newline at end of file
@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "ApiResponseCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "StringUtils.h"
+#include "net/ApiDownload.h"
+#include "net/NetJob.h"
+
+ApiResponseTask::ApiResponseTask(ApiResponseCache* cache, QUrl url, std::shared_ptr<QByteArray> response, qint64 max_age)
+    : Task(false), m_cache(cache), m_url(std::move(url)), m_response(std::move(response)), m_max_age(max_age)
+{}
+
+ApiResponseTask::~ApiResponseTask()
+{
+    if (m_attached && m_cache)
+        m_cache->detach(this);
+}
+
+void ApiResponseTask::executeTask()
+{
+    if (!m_cache) {
+        emitFailed(tr("The response cache is gone"));
+        return;
+    }
+    setStatus(tr("Requesting %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
+    m_cache->attach(this);
+}
+
+bool ApiResponseTask::abort()
+{
+    if (m_attached && m_cache)
+        m_cache->detach(this);
+    emitAborted();
+    return true;
+}
+
+void ApiResponseTask::finish(const QByteArray& data)
+{
+    m_attached = false;
+    *m_response = data;
+    emitSucceeded();
+}
+
+void ApiResponseTask::fail(const QString& reason, int status_code)
+{
+    m_attached = false;
+    m_reply_status_code = status_code;
+    emitFailed(reason);
+}
+
+ApiResponseCache::~ApiResponseCache()
+{
+    for (auto& request : m_in_flight) {
+        disconnect(request->job.get(), nullptr, this, nullptr);
+        for (auto& waiter : request->waiters)
+            if (waiter)
+                waiter->m_attached = false;
+        request->job->abort();
+    }
+}
+
+ApiResponseTask::Ptr ApiResponseCache::get(const QUrl& url, std::shared_ptr<QByteArray> response, qint64 max_age)
+{
+    return makeShared<ApiResponseTask>(this, url, std::move(response), max_age);
+}
+
+QString ApiResponseCache::pathFor(const QUrl& url)
+{
+    auto hash = QCryptographicHash::hash(keyFor(url).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString("%1/%2.json").arg(url.host(), QString::fromLatin1(hash));
+}
+
+void ApiResponseCache::attach(ApiResponseTask* task)
+{
+    auto key = keyFor(task->url());
+    if (auto it = m_in_flight.find(key); it != m_in_flight.end()) {
+        task->m_attached = true;
+        (*it)->waiters.append(task);
+        return;
+    }
+
+    auto metacache = APPLICATION->metacache();
+    auto path = pathFor(task->url());
+
+    // resolveEntry() forgets entries that expired, but their validators are what lets us revalidate instead of re-download
+    auto previous = metacache->getEntry("ModPlatformAPI", path);
+    auto entry = metacache->resolveEntry("ModPlatformAPI", path);
+    if (!entry->isStale()) {
+        QFile file(entry->getFullPath());
+        if (file.open(QIODevice::ReadOnly)) {
+            task->finish(file.readAll());
+            return;
+        }
+    } else if (previous) {
+        entry->setETag(previous->getETag());
+        entry->setRemoteChangedTimestamp(previous->getRemoteChangedTimestamp());
+        entry->setMD5Sum(previous->getMD5Sum());
+    }
+
+    auto request = std::make_shared<Request>();
+    request->entry = entry;
+    request->max_age = task->maxAge();
+    request->waiters.append(task);
+    task->m_attached = true;
+
+    // if the API can't be reached, whatever we got the last time is better than nothing
+    auto job = makeShared<NetJob>(QString("ApiResponseCache::%1").arg(task->url().host()), APPLICATION->network());
+    job->addNetAction(Net::ApiDownload::makeCached(task->url(), entry, Net::Download::Option::AcceptLocalFiles));
+    request->job = job;
+    m_in_flight.insert(key, request);
+
+    auto* raw_job = job.get();
+    connect(raw_job, &Task::progress, this, [request](qint64 current, qint64 total) {
+        for (auto& waiter : request->waiters)
+            if (waiter)
+                waiter->setProgress(current, total);
+    });
+    connect(raw_job, &Task::finished, this, [this, key, raw_job] { requestFinished(key, raw_job); });
+
+    job->start();
+}
+
+void ApiResponseCache::detach(ApiResponseTask* task)
+{
+    task->m_attached = false;
+
+    auto it = m_in_flight.find(keyFor(task->url()));
+    if (it == m_in_flight.end())
+        return;
+
+    auto request = *it;
+    request->waiters.removeAll(task);
+    if (!request->waiters.isEmpty())
+        return;
+
+    m_in_flight.erase(it);
+    disconnect(request->job.get(), nullptr, this, nullptr);
+    request->job->abort();
+}
+
+void ApiResponseCache::requestFinished(const QString& key, Task* job)
+{
+    auto it = m_in_flight.find(key);
+    if (it == m_in_flight.end() || (*it)->job.get() != job)
+        return;
+
+    auto request = *it;
+    m_in_flight.erase(it);
+
+    if (job->getState() == Task::State::AbortedByUser) {
+        for (auto& waiter : request->waiters) {
+            if (waiter) {
+                waiter->m_attached = false;
+                waiter->emitAborted();
+            }
+        }
+        return;
+    }
+
+    if (!job->wasSuccessful()) {
+        int status_code = -1;
+        if (auto failed = static_cast<NetJob*>(job)->getFailedActions(); !failed.isEmpty() && failed.first())
+            status_code = failed.first()->replyStatusCode();
+        for (auto& waiter : request->waiters)
+            if (waiter)
+                waiter->fail(job->failReason(), status_code);
+        return;
+    }
+
+    auto entry = request->entry;
+    auto path = entry->getFullPath();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        for (auto& waiter : request->waiters)
+            if (waiter)
+                waiter->fail(tr("Could not read the cached response at %1").arg(path), -1);
+        return;
+    }
+    auto data = file.readAll();
+
+    // the entry stays stale when the request failed and AcceptLocalFiles handed us an old response
+    if (!entry->isStale()) {
+        // the age of an entry is counted from its file's modification time, which a 304 leaves untouched
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+        file.close();
+
+        QFileInfo info(path);
+        entry->setLocalChangedTimestamp(info.lastModified().toUTC().toMSecsSinceEpoch());
+        entry->setLocalSize(info.size());
+        entry->setMaximumAge(qMin(entry->getMaximumAge(), request->max_age));
+        APPLICATION->metacache()->updateEntry(entry);
+    }
+
+    for (auto& waiter : request->waiters)
+        if (waiter)
+            waiter->finish(data);
+}
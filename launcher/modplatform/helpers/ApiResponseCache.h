@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+#include <memory>
+
+#include "QObjectPtr.h"
+#include "net/HttpMetaCache.h"
+#include "tasks/Task.h"
+
+class ApiResponseCache;
+
+/** Task handed out by ApiResponseCache::get.
+ *
+ *  Several of these can share a single network request. Aborting one only detaches it; the request itself is aborted
+ *  once nobody is waiting on it anymore.
+ */
+class ApiResponseTask : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<ApiResponseTask>;
+
+    ApiResponseTask(ApiResponseCache* cache, QUrl url, std::shared_ptr<QByteArray> response, qint64 max_age);
+    ~ApiResponseTask() override;
+
+    QUrl url() const { return m_url; }
+    qint64 maxAge() const { return m_max_age; }
+    //! HTTP status code of the failed request, or -1 if there was none
+    int replyStatusCode() const { return m_reply_status_code; }
+
+    bool canAbort() const override { return true; }
+
+   public slots:
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    friend class ApiResponseCache;
+    void finish(const QByteArray& data);
+    void fail(const QString& reason, int status_code);
+
+    QPointer<ApiResponseCache> m_cache;
+    QUrl m_url;
+    std::shared_ptr<QByteArray> m_response;
+    qint64 m_max_age;
+    int m_reply_status_code = -1;
+    bool m_attached = false;
+};
+
+/** Response cache for the mod platform APIs.
+ *
+ *  GET requests made through here are stored in the "ModPlatformAPI" metacache base. A response is served from disk
+ *  while it is fresh, and once it is stale it is revalidated with its ETag / Last-Modified, so an unchanged response
+ *  costs a 304 instead of a full download. Identical requests that are in flight at the same time share one network
+ *  request.
+ */
+class ApiResponseCache : public QObject {
+    Q_OBJECT
+   public:
+    //! How long, in seconds, a response is served without asking the server, unless it asks for less.
+    static constexpr qint64 DefaultMaxAge = 60 * 60;
+    static constexpr qint64 SearchMaxAge = 10 * 60;
+    //! How long, in seconds, an expired response is kept to be revalidated, before it is pruned on startup.
+    static constexpr qint64 KeepExpiredFor = 7 * 24 * 60 * 60;
+
+    explicit ApiResponseCache(QObject* parent = nullptr) : QObject(parent) {}
+    ~ApiResponseCache() override;
+
+    /** Returns a task that fills `response` with the body of `url` when it succeeds. */
+    ApiResponseTask::Ptr get(const QUrl& url, std::shared_ptr<QByteArray> response, qint64 max_age = DefaultMaxAge);
+
+   private:
+    friend class ApiResponseTask;
+    struct Request {
+        MetaEntryPtr entry;
+        Task::Ptr job;
+        qint64 max_age;
+        QList<QPointer<ApiResponseTask>> waiters;
+    };
+
+    void attach(ApiResponseTask* task);
+    void detach(ApiResponseTask* task);
+    void requestFinished(const QString& key, Task* job);
+
+    static QString keyFor(const QUrl& url) { return url.toString(QUrl::FullyEncoded); }
+    static QString pathFor(const QUrl& url);
+
+    QHash<QString, std::shared_ptr<Request>> m_in_flight;
+};
@@ -1,12 +1,18 @@
 #include "HashUtils.h"
 
 #include <QBuffer>
+#include <QDateTime>
 #include <QDebug>
 #include <QFile>
-#include <QtConcurrentRun>
+#include <QFileInfo>
+#include <QMutex>
 
 #include <MurmurHash2.h>
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 namespace Hashing {
 
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
@@ -80,6 +86,24 @@ Algorithm algorithmFromString(QString type)
     return Algorithm::Unknown;
 }
 
+static std::optional<QCryptographicHash::Algorithm> cryptographicAlgorithm(Algorithm type)
+{
+    switch (type) {
+        case Algorithm::Md4:
+            return QCryptographicHash::Algorithm::Md4;
+        case Algorithm::Md5:
+            return QCryptographicHash::Algorithm::Md5;
+        case Algorithm::Sha1:
+            return QCryptographicHash::Algorithm::Sha1;
+        case Algorithm::Sha256:
+            return QCryptographicHash::Algorithm::Sha256;
+        case Algorithm::Sha512:
+            return QCryptographicHash::Algorithm::Sha512;
+        default:
+            return {};
+    }
+}
+
 QString hash(QIODevice* device, Algorithm type)
 {
     if (!device->isOpen() && !device->open(QFile::ReadOnly))
@@ -87,19 +111,11 @@ QString hash(QIODevice* device, Algorithm type)
     QCryptographicHash::Algorithm alg = QCryptographicHash::Sha1;
     switch (type) {
         case Algorithm::Md4:
-            alg = QCryptographicHash::Algorithm::Md4;
-            break;
         case Algorithm::Md5:
-            alg = QCryptographicHash::Algorithm::Md5;
-            break;
         case Algorithm::Sha1:
-            alg = QCryptographicHash::Algorithm::Sha1;
-            break;
         case Algorithm::Sha256:
-            alg = QCryptographicHash::Algorithm::Sha256;
-            break;
         case Algorithm::Sha512:
-            alg = QCryptographicHash::Algorithm::Sha512;
+            alg = *cryptographicAlgorithm(type);
             break;
         case Algorithm::Murmur2: {  // CF-specific
             auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
@@ -125,8 +141,7 @@ QString hash(QIODevice* device, Algorithm type)
 
 QString hash(QString fileName, Algorithm type)
 {
-    QFile file(fileName);
-    return hash(&file, type);
+    return hashFile(fileName, { type }).value(type);
 }
 
 QString hash(QByteArray data, Algorithm type)
@@ -135,10 +150,89 @@ QString hash(QByteArray data, Algorithm type)
     return hash(&buff, type);
 }
 
+namespace {
+struct CachedHashes {
+    qint64 size;
+    QDateTime lastModified;
+    QMap<Algorithm, QString> hashes;
+};
+
+// hashing the same mods again for every export and update check adds up quickly
+QMutex s_cacheLock;
+QHash<QString, CachedHashes> s_cache;
+constexpr qsizetype s_maxCachedFiles = 16384;
+}  // namespace
+
+QMap<Algorithm, QString> hashFile(const QString& fileName, const QList<Algorithm>& types)
+{
+    QFileInfo info(fileName);
+    auto key = info.absoluteFilePath();
+    auto size = info.size();
+    auto lastModified = info.lastModified();
+
+    QMap<Algorithm, QString> result;
+    QList<Algorithm> missing;
+    {
+        QMutexLocker locker(&s_cacheLock);
+        auto cached = s_cache.constFind(key);
+        bool fresh = cached != s_cache.constEnd() && cached->size == size && cached->lastModified == lastModified;
+        for (auto type : types) {
+            if (fresh && cached->hashes.contains(type))
+                result.insert(type, cached->hashes.value(type));
+            else if (!missing.contains(type))
+                missing.append(type);
+        }
+    }
+    if (missing.isEmpty())
+        return result;
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << "Could not open" << fileName << "for hashing";
+        return result;
+    }
+
+    // every cryptographic hash is fed from the same buffer, murmur2 filters whitespace and needs a pass of its own
+    std::vector<std::pair<Algorithm, std::unique_ptr<QCryptographicHash>>> hashers;
+    for (auto type : missing) {
+        if (auto alg = cryptographicAlgorithm(type))
+            hashers.emplace_back(type, std::make_unique<QCryptographicHash>(*alg));
+    }
+    if (!hashers.empty()) {
+        QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+        qint64 count;
+        while ((count = file.read(buffer.data(), buffer.size())) > 0) {
+            for (auto& [type, hasher] : hashers)
+                hasher->addData(QByteArrayView(buffer.constData(), count));
+        }
+        if (count < 0) {
+            qWarning() << "Could not read" << fileName << "for hashing:" << file.errorString();
+            return result;
+        }
+        for (auto& [type, hasher] : hashers)
+            result.insert(type, hasher->result().toHex());
+    }
+    if (missing.contains(Algorithm::Murmur2)) {
+        file.seek(0);
+        result.insert(Algorithm::Murmur2, hash(&file, Algorithm::Murmur2));
+    }
+    if (missing.contains(Algorithm::Unknown))
+        result.insert(Algorithm::Unknown, "");
+
+    QMutexLocker locker(&s_cacheLock);
+    if (s_cache.size() >= s_maxCachedFiles)
+        s_cache.clear();
+    auto& cached = s_cache[key];
+    if (cached.size != size || cached.lastModified != lastModified)
+        cached = { size, lastModified, {} };
+    cached.hashes.insert(result);
+    return result;
+}
+
 void Hasher::executeTask()
 {
-    m_future = QtConcurrent::run(
-        QThreadPool::globalInstance(), [](QString fileName, Algorithm type) { return hash(fileName, type); }, m_path, m_alg);
+    m_future = Executor::run(Executor::Kind::Compute, Executor::Priority::Normal, m_cancel,
+                             [fileName = m_path, type = m_alg] { return hash(fileName, type); });
     connect(&m_watcher, &QFutureWatcher<QString>::finished, this, [this] {
         if (m_future.isCanceled()) {
             emitAborted();
@@ -155,7 +249,7 @@ void Hasher::executeTask()
 bool Hasher::abort()
 {
     if (m_future.isRunning()) {
-        m_future.cancel();
+        m_cancel.cancel();
         // NOTE: Here we don't do `emitAborted()` because it will be done when `m_build_zip_future` actually cancels, which may not
         // occur immediately.
         return true;
@@ -3,9 +3,11 @@
 #include <QCryptographicHash>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QMap>
 #include <QString>
 
 #include "modplatform/ModIndex.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 namespace Hashing {
@@ -18,6 +20,13 @@ QString hash(QIODevice* device, Algorithm type);
 QString hash(QString fileName, Algorithm type);
 QString hash(QByteArray data, Algorithm type);
 
+/**
+ * Computes every requested hash of a file, reading it only once with a fixed size buffer.
+ * Results are remembered for as long as the launcher runs, and reused while the file keeps its size and modification time.
+ * Missing entries mean the file could not be read.
+ */
+QMap<Algorithm, QString> hashFile(const QString& fileName, const QList<Algorithm>& types);
+
 class Hasher : public Task {
     Q_OBJECT
    public:
@@ -41,6 +50,7 @@ class Hasher : public Task {
     QString m_path;
     Algorithm m_alg;
 
+    Executor::CancelToken m_cancel;
     QFuture<QString> m_future;
     QFutureWatcher<QString> m_watcher;
 };
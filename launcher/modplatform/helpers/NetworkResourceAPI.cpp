@@ -6,11 +6,9 @@
 #include <memory>
 
 #include "Application.h"
-#include "net/NetJob.h"
 
 #include "modplatform/ModIndex.h"
-
-#include "net/ApiDownload.h"
+#include "modplatform/helpers/ApiResponseCache.h"
 
 Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&& callbacks) const
 {
@@ -23,11 +21,9 @@ Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&
     auto search_url = search_url_optional.value();
 
     auto response = std::make_shared<QByteArray>();
-    auto netJob = makeShared<NetJob>(QString("%1::Search").arg(debugName()), APPLICATION->network());
-
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(search_url), response));
+    auto job = APPLICATION->apiResponseCache()->get(QUrl(search_url), response, ApiResponseCache::SearchMaxAge);
 
-    QObject::connect(netJob.get(), &NetJob::succeeded, [this, response, callbacks] {
+    QObject::connect(job.get(), &Task::succeeded, [this, response, callbacks] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -43,21 +39,15 @@ Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&
         callbacks.on_succeed(doc);
     });
 
-    // Capture a weak_ptr instead of a shared_ptr to avoid circular dependency issues.
-    // This prevents the lambda from extending the lifetime of the shared resource,
-    // as it only temporarily locks the resource when needed.
-    auto weak = netJob.toWeakRef();
-    QObject::connect(netJob.get(), &NetJob::failed, [weak, callbacks](const QString& reason) {
-        int network_error_code = -1;
-        if (auto netJob = weak.lock()) {
-            if (auto* failed_action = netJob->getFailedActions().at(0); failed_action)
-                network_error_code = failed_action->replyStatusCode();
-        }
-        callbacks.on_fail(reason, network_error_code);
+    // Capture a raw pointer instead of a shared_ptr to avoid circular dependency issues.
+    // The lambda only ever runs while the task itself emits failed(), so the pointer is always valid there.
+    auto* raw_job = job.get();
+    QObject::connect(raw_job, &Task::failed, [raw_job, callbacks](const QString& reason) {
+        callbacks.on_fail(reason, raw_job->replyStatusCode());
     });
-    QObject::connect(netJob.get(), &NetJob::aborted, [callbacks] { callbacks.on_abort(); });
+    QObject::connect(job.get(), &Task::aborted, [callbacks] { callbacks.on_abort(); });
 
-    return netJob;
+    return job;
 }
 
 Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfoCallbacks&& callbacks) const
@@ -65,7 +55,7 @@ Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfo
     auto response = std::make_shared<QByteArray>();
     auto job = getProject(args.pack.addonId.toString(), response);
 
-    QObject::connect(job.get(), &NetJob::succeeded, [response, callbacks, args] {
+    QObject::connect(job.get(), &Task::succeeded, [response, callbacks, args] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -77,8 +67,8 @@ Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfo
 
         callbacks.on_succeed(doc, args.pack);
     });
-    QObject::connect(job.get(), &NetJob::failed, [callbacks](QString reason) { callbacks.on_fail(reason); });
-    QObject::connect(job.get(), &NetJob::aborted, [callbacks] { callbacks.on_abort(); });
+    QObject::connect(job.get(), &Task::failed, [callbacks](QString reason) { callbacks.on_fail(reason); });
+    QObject::connect(job.get(), &Task::aborted, [callbacks] { callbacks.on_abort(); });
     return job;
 }
 
@@ -90,12 +80,10 @@ Task::Ptr NetworkResourceAPI::getProjectVersions(VersionSearchArgs&& args, Versi
 
     auto versions_url = versions_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::Versions").arg(args.pack.name), APPLICATION->network());
     auto response = std::make_shared<QByteArray>();
+    auto job = APPLICATION->apiResponseCache()->get(versions_url, response);
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(versions_url, response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, callbacks, args] {
+    QObject::connect(job.get(), &Task::succeeded, [response, callbacks, args] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -108,20 +96,14 @@ Task::Ptr NetworkResourceAPI::getProjectVersions(VersionSearchArgs&& args, Versi
         callbacks.on_succeed(doc, args.pack);
     });
 
-    // Capture a weak_ptr instead of a shared_ptr to avoid circular dependency issues.
-    // This prevents the lambda from extending the lifetime of the shared resource,
-    // as it only temporarily locks the resource when needed.
-    auto weak = netJob.toWeakRef();
-    QObject::connect(netJob.get(), &NetJob::failed, [weak, callbacks](const QString& reason) {
-        int network_error_code = -1;
-        if (auto netJob = weak.lock()) {
-            if (auto* failed_action = netJob->getFailedActions().at(0); failed_action)
-                network_error_code = failed_action->replyStatusCode();
-        }
-        callbacks.on_fail(reason, network_error_code);
+    // Capture a raw pointer instead of a shared_ptr to avoid circular dependency issues.
+    // The lambda only ever runs while the task itself emits failed(), so the pointer is always valid there.
+    auto* raw_job = job.get();
+    QObject::connect(raw_job, &Task::failed, [raw_job, callbacks](const QString& reason) {
+        callbacks.on_fail(reason, raw_job->replyStatusCode());
     });
 
-    return netJob;
+    return job;
 }
 
 Task::Ptr NetworkResourceAPI::getProject(QString addonId, std::shared_ptr<QByteArray> response) const
@@ -132,11 +114,7 @@ Task::Ptr NetworkResourceAPI::getProject(QString addonId, std::shared_ptr<QByteA
 
     auto project_url = project_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::GetProject").arg(addonId), APPLICATION->network());
-
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(project_url), response));
-
-    return netJob;
+    return APPLICATION->apiResponseCache()->get(QUrl(project_url), response);
 }
 
 Task::Ptr NetworkResourceAPI::getDependencyVersion(DependencySearchArgs&& args, DependencySearchCallbacks&& callbacks) const
@@ -147,12 +125,10 @@ Task::Ptr NetworkResourceAPI::getDependencyVersion(DependencySearchArgs&& args,
 
     auto versions_url = versions_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::Dependency").arg(args.dependency.addonId.toString()), APPLICATION->network());
     auto response = std::make_shared<QByteArray>();
+    auto job = APPLICATION->apiResponseCache()->get(versions_url, response);
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(versions_url, response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, callbacks, args] {
+    QObject::connect(job.get(), &Task::succeeded, [response, callbacks, args] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -165,17 +141,11 @@ Task::Ptr NetworkResourceAPI::getDependencyVersion(DependencySearchArgs&& args,
         callbacks.on_succeed(doc, args.dependency);
     });
 
-    // Capture a weak_ptr instead of a shared_ptr to avoid circular dependency issues.
-    // This prevents the lambda from extending the lifetime of the shared resource,
-    // as it only temporarily locks the resource when needed.
-    auto weak = netJob.toWeakRef();
-    QObject::connect(netJob.get(), &NetJob::failed, [weak, callbacks](const QString& reason) {
-        int network_error_code = -1;
-        if (auto netJob = weak.lock()) {
-            if (auto* failed_action = netJob->getFailedActions().at(0); failed_action)
-                network_error_code = failed_action->replyStatusCode();
-        }
-        callbacks.on_fail(reason, network_error_code);
+    // Capture a raw pointer instead of a shared_ptr to avoid circular dependency issues.
+    // The lambda only ever runs while the task itself emits failed(), so the pointer is always valid there.
+    auto* raw_job = job.get();
+    QObject::connect(raw_job, &Task::failed, [raw_job, callbacks](const QString& reason) {
+        callbacks.on_fail(reason, raw_job->replyStatusCode());
     });
-    return netJob;
+    return job;
 }
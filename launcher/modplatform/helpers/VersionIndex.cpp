@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "VersionIndex.h"
+
+#include <QDateTime>
+
+VersionIndex& VersionIndex::instance()
+{
+    static VersionIndex s_instance;
+    return s_instance;
+}
+
+QString VersionIndex::key(ModPlatform::ResourceProvider provider,
+                          const QString& project_id,
+                          std::optional<ModPlatform::ModLoaderTypes> loaders,
+                          const std::list<Version>& game_versions,
+                          const QList<ModPlatform::ModLoaderType>& preferred_loaders)
+{
+    QStringList versions;
+    for (auto& version : game_versions)
+        versions.append(version.toString());
+    auto loader_part = loaders.has_value() ? QString::number(static_cast<int>(loaders.value())) : QString("any");
+    QStringList preferred;
+    for (auto loader : preferred_loaders)
+        preferred.append(QString::number(static_cast<int>(loader)));
+    return QString("%1/%2/%3/%4/%5")
+        .arg(ModPlatform::ProviderCapabilities::name(provider), project_id, loader_part, versions.join(','), preferred.join(','));
+}
+
+std::optional<QJsonObject> VersionIndex::find(const QString& key) const
+{
+    QMutexLocker locker(&m_lock);
+    auto entry = m_entries.constFind(key);
+    if (entry == m_entries.constEnd())
+        return {};
+    if (QDateTime::currentSecsSinceEpoch() - entry->found_at >= m_ttl)
+        return {};
+    return entry->version;
+}
+
+void VersionIndex::insert(const QString& key, const QJsonObject& version)
+{
+    QMutexLocker locker(&m_lock);
+    m_entries.insert(key, { version, QDateTime::currentSecsSinceEpoch() });
+}
+
+void VersionIndex::clear()
+{
+    QMutexLocker locker(&m_lock);
+    m_entries.clear();
+}
+
+void VersionIndex::setTtl(qint64 seconds)
+{
+    QMutexLocker locker(&m_lock);
+    m_ttl = seconds;
+    // nothing older than that is going to be served again
+    auto now = QDateTime::currentSecsSinceEpoch();
+    m_entries.removeIf([this, now](const QHash<QString, Entry>::iterator& entry) { return now - entry->found_at >= m_ttl; });
+}
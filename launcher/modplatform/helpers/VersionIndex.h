@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+#include <list>
+#include <optional>
+
+#include "Version.h"
+#include "modplatform/ModIndex.h"
+
+/** The latest versions update checks found, by provider, project, mod loaders and game versions.
+ *
+ *  Entries are served for a while after they were found, so checking for updates again right away doesn't ask the
+ *  platforms again, while new releases still show up later on. A project without any matching version is stored too.
+ */
+class VersionIndex {
+   public:
+    //! How long, in seconds, a found version is served.
+    static constexpr qint64 DefaultTtl = 10 * 60;
+
+    static VersionIndex& instance();
+
+    /** @p preferred_loaders are the instance's loaders in the order they pick between versions, where the check uses them. */
+    static QString key(ModPlatform::ResourceProvider provider,
+                       const QString& project_id,
+                       std::optional<ModPlatform::ModLoaderTypes> loaders,
+                       const std::list<Version>& game_versions,
+                       const QList<ModPlatform::ModLoaderType>& preferred_loaders = {});
+
+    /** The version as the platform's API describes it, an empty object if there is none, or nothing if it isn't known. */
+    std::optional<QJsonObject> find(const QString& key) const;
+    void insert(const QString& key, const QJsonObject& version);
+    void clear();
+
+    qint64 ttl() const { return m_ttl; }
+    void setTtl(qint64 seconds);
+
+   private:
+    struct Entry {
+        QJsonObject version;
+        qint64 found_at;
+    };
+
+    mutable QMutex m_lock;
+    QHash<QString, Entry> m_entries;
+    qint64 m_ttl = DefaultTtl;
+};
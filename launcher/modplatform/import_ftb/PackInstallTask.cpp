@@ -18,7 +18,7 @@
 
 #include "PackInstallTask.h"
 
-#include <QtConcurrent>
+#include "tasks/Executor.h"
 
 #include "BaseInstance.h"
 #include "FileSystem.h"
@@ -36,9 +36,10 @@ void PackInstallTask::executeTask()
     setAbortable(false);
     progress(1, 2);
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this] {
+    m_copyFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, [this] {
         FS::copy folderCopy(m_pack.path, FS::PathCombine(m_stagingPath, "minecraft"));
         folderCopy.followSymlinks(true);
+        connect(&folderCopy, &FS::copy::progress, [this](qint64 copied, qint64 total) { setProgress(copied, total); });
         return folderCopy();
     });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &PackInstallTask::copySettings);
@@ -35,7 +35,7 @@
 
 #include "PackInstallTask.h"
 
-#include <QtConcurrent>
+#include "tasks/Executor.h"
 
 #include "BaseInstance.h"
 #include "FileSystem.h"
@@ -108,8 +108,8 @@ void PackInstallTask::unzip()
         return;
     }
 
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath,
-                                        extractDir.absolutePath() + "/unzip");
+    m_extractFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal,
+                                    [archivePath, target = extractDir.absolutePath() + "/unzip"] { return MMCZip::extractDir(archivePath, target); });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onUnzipFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::onUnzipCanceled);
     m_extractFutureWatcher.setFuture(m_extractFuture);
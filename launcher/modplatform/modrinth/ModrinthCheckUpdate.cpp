@@ -10,6 +10,7 @@
 
 #include "modplatform/ModIndex.h"
 #include "modplatform/helpers/HashUtils.h"
+#include "modplatform/helpers/VersionIndex.h"
 
 #include "tasks/ConcurrentTask.h"
 
@@ -32,8 +33,7 @@ void ModrinthCheckUpdate::executeTask()
     setStatus(tr("Preparing resources for Modrinth..."));
     setProgress(0, (m_loaders_list.isEmpty() ? 1 : m_loaders_list.length()) * 2 + 1);
 
-    auto hashing_task =
-        makeShared<ConcurrentTask>("MakeModrinthHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    QList<Task::Ptr> hash_tasks;
     for (auto* resource : m_resources) {
         auto hash = resource->metadata()->hash;
 
@@ -44,50 +44,100 @@ void ModrinthCheckUpdate::executeTask()
             auto hash_task = Hashing::createHasher(resource->fileinfo().absoluteFilePath(), ModPlatform::ResourceProvider::MODRINTH);
             connect(hash_task.get(), &Hashing::Hasher::resultsReady, [this, resource](QString hash) { m_mappings.insert(hash, resource); });
             connect(hash_task.get(), &Task::failed, [this] { failed("Failed to generate hash"); });
-            hashing_task->addTask(hash_task);
+            hash_tasks.append(hash_task);
         } else {
             m_mappings.insert(hash, resource);
         }
     }
 
+    if (hash_tasks.isEmpty()) {
+        checkNextLoader();
+        return;
+    }
+
+    auto hashing_task =
+        makeShared<ConcurrentTask>("MakeModrinthHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    for (auto& hash_task : hash_tasks)
+        hashing_task->addTask(hash_task);
+
     connect(hashing_task.get(), &Task::finished, this, &ModrinthCheckUpdate::checkNextLoader);
     m_job = hashing_task;
     hashing_task->start();
 }
 
+QString ModrinthCheckUpdate::versionKey(Resource* resource, std::optional<ModPlatform::ModLoaderTypes> loader) const
+{
+    return VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, resource->metadata()->project_id.toString(), loader,
+                             m_game_versions);
+}
+
 void ModrinthCheckUpdate::getUpdateModsForLoader(std::optional<ModPlatform::ModLoaderTypes> loader)
 {
     setStatus(tr("Waiting for the API response from Modrinth..."));
     setProgress(m_progress + 1, m_progressTotal);
 
-    auto response = std::make_shared<QByteArray>();
-    QStringList hashes = m_mappings.keys();
-    auto job = api.latestVersions(hashes, m_hash_type, m_game_versions, loader, response);
+    // what a recent check found is still good
+    auto versions = std::make_shared<QJsonObject>();
+    QStringList hashes;
+    for (auto iter = m_mappings.constBegin(); iter != m_mappings.constEnd(); ++iter) {
+        if (auto version = VersionIndex::instance().find(versionKey(iter.value(), loader)))
+            versions->insert(iter.key(), *version);
+        else
+            hashes.append(iter.key());
+    }
+    if (hashes.isEmpty()) {
+        checkVersionsResponse(*versions, loader);
+        return;
+    }
 
-    connect(job.get(), &Task::succeeded, this, [this, response, loader] { checkVersionsResponse(response, loader); });
+    auto job = makeShared<ConcurrentTask>("GetModrinthLatestVersions", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    auto parse_error_reason = std::make_shared<QString>();
+    for (qsizetype i = 0; i < hashes.size(); i += s_hashesPerRequest) {
+        auto chunk = hashes.mid(i, s_hashesPerRequest);
+        auto response = std::make_shared<QByteArray>();
+        auto request = api.latestVersions(chunk, m_hash_type, m_game_versions, loader, response);
+
+        connect(request.get(), &Task::succeeded, this, [this, chunk, response, versions, loader, parse_error_reason] {
+            QJsonParseError parse_error{};
+            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+                *parse_error_reason = parse_error.errorString();
+                return;
+            }
+            // the hashes that are missing have no version for this loader
+            auto found = doc.object();
+            for (auto& hash : chunk) {
+                auto version = found.value(hash).toObject();
+                versions->insert(hash, version);
+                if (auto resource = m_mappings.value(hash))
+                    VersionIndex::instance().insert(versionKey(resource, loader), version);
+            }
+        });
+        job->addTask(request);
+    }
 
-    connect(job.get(), &Task::failed, this, &ModrinthCheckUpdate::checkNextLoader);
+    // a chunk that wasn't answered says nothing about whether its resources have updates
+    connect(job.get(), &Task::succeeded, this, [this, versions, loader, parse_error_reason] {
+        if (!parse_error_reason->isEmpty()) {
+            emitFailed(tr("Failed to parse the response from Modrinth: %1").arg(*parse_error_reason));
+            return;
+        }
+        checkVersionsResponse(*versions, loader);
+    });
+    connect(job.get(), &Task::failed, this, [this](const QString& reason) { emitFailed(reason); });
 
     m_job = job;
     job->start();
 }
 
-void ModrinthCheckUpdate::checkVersionsResponse(std::shared_ptr<QByteArray> response, std::optional<ModPlatform::ModLoaderTypes> loader)
+void ModrinthCheckUpdate::checkVersionsResponse(const QJsonObject& versions, std::optional<ModPlatform::ModLoaderTypes> loader)
 {
     setStatus(tr("Parsing the API response from Modrinth..."));
     setProgress(m_progress + 1, m_progressTotal);
 
-    QJsonParseError parse_error{};
-    QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-    if (parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
-                   << " reason: " << parse_error.errorString();
-        qWarning() << *response;
-
-        emitFailed(parse_error.errorString());
-        return;
-    }
-
     try {
         auto iter = m_mappings.begin();
 
@@ -95,7 +145,7 @@ void ModrinthCheckUpdate::checkVersionsResponse(std::shared_ptr<QByteArray> resp
             const QString hash = iter.key();
             Resource* resource = iter.value();
 
-            auto project_obj = doc[hash].toObject();
+            auto project_obj = versions.value(hash).toObject();
 
             // If the returned project is empty, but we have Modrinth metadata,
             // it means this specific version is not available
@@ -166,15 +216,15 @@ void ModrinthCheckUpdate::checkNextLoader()
         return;
     }
 
+    // versions the index already knows come back right away, so move on to the next loader first
     if (m_loaders_list.isEmpty() && m_loader_idx == 0) {
-        getUpdateModsForLoader({});
         m_loader_idx++;
+        getUpdateModsForLoader({});
         return;
     }
 
     if (m_loader_idx < m_loaders_list.size()) {
-        getUpdateModsForLoader(m_loaders_list.at(m_loader_idx));
-        m_loader_idx++;
+        getUpdateModsForLoader(m_loaders_list.at(m_loader_idx++));
         return;
     }
 
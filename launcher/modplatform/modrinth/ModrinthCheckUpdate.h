@@ -20,10 +20,15 @@ class ModrinthCheckUpdate : public CheckUpdateTask {
    protected slots:
     void executeTask() override;
     void getUpdateModsForLoader(std::optional<ModPlatform::ModLoaderTypes> loader);
-    void checkVersionsResponse(std::shared_ptr<QByteArray> response, std::optional<ModPlatform::ModLoaderTypes> loader);
+    void checkVersionsResponse(const QJsonObject& versions, std::optional<ModPlatform::ModLoaderTypes> loader);
     void checkNextLoader();
 
    private:
+    QString versionKey(Resource* resource, std::optional<ModPlatform::ModLoaderTypes> loader) const;
+
+    //! how many hashes are looked up with one request, the requests themselves run side by side
+    static constexpr int s_hashesPerRequest = 100;
+
     Task::Ptr m_job = nullptr;
     QHash<QString, Resource*> m_mappings;
     QString m_hash_type;
@@ -22,7 +22,7 @@
 #include <QCryptographicHash>
 #include <QFileInfo>
 #include <QMessageBox>
-#include <QtConcurrentRun>
+#include <QtConcurrentMap>
 #include "Json.h"
 #include "MMCZip.h"
 #include "minecraft/PackProfile.h"
@@ -30,6 +30,7 @@
 #include "minecraft/mod/ModFolderModel.h"
 #include "modplatform/ModIndex.h"
 #include "modplatform/helpers/HashUtils.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 const QStringList ModrinthPackExportTask::PREFIXES({ "mods/", "coremods/", "resourcepacks/", "texturepacks/", "shaderpacks/" });
@@ -62,6 +63,10 @@ void ModrinthPackExportTask::executeTask()
 
 bool ModrinthPackExportTask::abort()
 {
+    if (hashWatcher.isRunning()) {
+        hashFuture.cancel();
+        return true;
+    }
     if (task) {
         task->abort();
         return true;
@@ -93,9 +98,10 @@ void ModrinthPackExportTask::collectFiles()
 void ModrinthPackExportTask::collectHashes()
 {
     setStatus(tr("Finding file hashes..."));
-    for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
 
+    QList<HashedFile> toHash;
+    auto allMods = mcInstance ? mcInstance->loaderModList()->allMods() : QList<Mod*>();
+    for (const QFileInfo& file : files) {
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
         // require sensible file types
         if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
@@ -105,20 +111,7 @@ void ModrinthPackExportTask::collectHashes()
             }))
             continue;
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
-            continue;
-        }
-
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
-            continue;
-        }
-        auto sha512 = Hashing::hash(data, Hashing::Algorithm::Sha512);
-
-        auto allMods = mcInstance->loaderModList()->allMods();
+        HashedFile hashedFile{ relative, file.absoluteFilePath() };
         if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
             modIter != allMods.end()) {
             const Mod* mod = *modIter;
@@ -126,25 +119,70 @@ void ModrinthPackExportTask::collectHashes()
                 const QUrl& url = mod->metadata()->url;
                 // ensure the url is permitted on modrinth.com
                 if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
-                    qDebug() << "Resolving" << relative << "from index";
+                    hashedFile.url = url;
+                    hashedFile.side = mod->metadata()->side;
+                    hashedFile.indexHashFormat = Hashing::algorithmFromString(mod->metadata()->hash_format);
+                    hashedFile.indexHash = mod->metadata()->hash;
+                }
+            }
+        }
+        toHash.append(hashedFile);
+    }
+
+    setAbortable(true);
+    setProgress(0, toHash.size());
+    hashFuture = QtConcurrent::mapped(Executor::pool(Executor::Kind::Compute), toHash, [](HashedFile file) {
+        // Both digests come from the file itself, in one read, which the hash cache skips for files it has seen unchanged.
+        // Files that have to be looked up on Modrinth get their sha1 from there.
+        QList<Hashing::Algorithm> types{ Hashing::Algorithm::Sha512 };
+        if (!file.url.isEmpty()) {
+            types.append(Hashing::Algorithm::Sha1);
+            if (file.indexHashFormat != Hashing::Algorithm::Unknown && !types.contains(file.indexHashFormat))
+                types.append(file.indexHashFormat);
+        }
 
-                    auto sha1 = Hashing::hash(data, Hashing::Algorithm::Sha1);
+        auto hashes = Hashing::hashFile(file.path, types);
+        file.sha512 = hashes.value(Hashing::Algorithm::Sha512);
+        file.sha1 = hashes.value(Hashing::Algorithm::Sha1);
+        file.size = QFileInfo(file.path).size();
+        // a file replaced by hand is no longer the one the index points to, so it is looked up like any other
+        if (!file.url.isEmpty() && hashes.value(file.indexHashFormat) != file.indexHash.toLower())
+            file.url.clear();
+        return file;
+    });
+    connect(&hashWatcher, &QFutureWatcher<HashedFile>::progressValueChanged, this,
+            [this](int value) { setProgress(value, m_progressTotal); });
+    connect(&hashWatcher, &QFutureWatcher<HashedFile>::finished, this, &ModrinthPackExportTask::hashesCollected);
+    hashWatcher.setFuture(hashFuture);
+}
 
-                    ResolvedFile resolvedFile{ sha1, sha512, url.toEncoded(), openFile.size(), mod->metadata()->side };
-                    resolvedFiles[relative] = resolvedFile;
+void ModrinthPackExportTask::hashesCollected()
+{
+    disconnect(&hashWatcher, nullptr, this, nullptr);
+    if (hashFuture.isCanceled()) {
+        emitAborted();
+        return;
+    }
 
-                    // nice! we've managed to resolve based on local metadata!
-                    // no need to enqueue it
-                    continue;
-                }
-            }
+    for (const HashedFile& file : hashFuture.results()) {
+        if (file.sha512.isEmpty()) {
+            qWarning() << "Could not read" << file.path << "for hashing";
+            continue;
         }
 
-        qDebug() << "Enqueueing" << relative << "for Modrinth query";
-        pendingHashes[relative] = sha512;
+        if (!file.url.isEmpty() && !file.sha1.isEmpty()) {
+            qDebug() << "Resolving" << file.relative << "from index";
+
+            // nice! we've managed to resolve based on local metadata!
+            // no need to enqueue it
+            resolvedFiles[file.relative] = ResolvedFile{ file.sha1, file.sha512, file.url.toEncoded(), file.size, file.side };
+            continue;
+        }
+
+        qDebug() << "Enqueueing" << file.relative << "for Modrinth query";
+        pendingHashes[file.relative] = file.sha512;
     }
 
-    setAbortable(true);
     makeApiRequest();
 }
 
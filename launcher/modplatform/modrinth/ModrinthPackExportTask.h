@@ -20,10 +20,12 @@
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QUrl>
 #include "BaseInstance.h"
 #include "MMCZip.h"
 #include "minecraft/MinecraftInstance.h"
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/HashUtils.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "tasks/Task.h"
 
@@ -49,6 +51,18 @@ class ModrinthPackExportTask : public Task {
         ModPlatform::Side side;
     };
 
+    struct HashedFile {
+        QString relative, path;
+        // where the mod index says the file comes from, if it is allowed in a mrpack
+        QUrl url;
+        ModPlatform::Side side = ModPlatform::Side::UniversalSide;
+        // what the index says the file hashes to, the url only holds while the file still does
+        Hashing::Algorithm indexHashFormat = Hashing::Algorithm::Unknown;
+        QString indexHash;
+        QString sha1, sha512;
+        qint64 size = 0;
+    };
+
     static const QStringList PREFIXES;
     static const QStringList FILE_EXTENSIONS;
 
@@ -66,9 +80,12 @@ class ModrinthPackExportTask : public Task {
     QMap<QString, QString> pendingHashes;
     QMap<QString, ResolvedFile> resolvedFiles;
     Task::Ptr task;
+    QFuture<HashedFile> hashFuture;
+    QFutureWatcher<HashedFile> hashWatcher;
 
     void collectFiles();
     void collectHashes();
+    void hashesCollected();
     void makeApiRequest();
     void parseApiResponse(std::shared_ptr<QByteArray> response);
     void buildZip();
@@ -21,7 +21,11 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QObject>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+#include <algorithm>
 #include <sstream>
 #include <string>
 
@@ -125,39 +129,14 @@ auto V1::createModFormat([[maybe_unused]] const QDir& index_dir,
     return mod;
 }
 
-void V1::updateModIndex(const QDir& index_dir, Mod& mod)
+auto V1::writeModIndex(const QString& path, const Mod& mod) -> bool
 {
-    if (!mod.isValid()) {
-        qCritical() << QString("Tried to update metadata of an invalid mod!");
-        return;
-    }
-
-    // Ensure the corresponding mod's info exists, and create it if not
-
-    auto normalized_fname = indexFileName(mod.slug);
-    auto real_fname = getRealIndexName(index_dir, normalized_fname);
-
-    QFile index_file(index_dir.absoluteFilePath(real_fname));
-
-    if (real_fname != normalized_fname)
-        index_file.rename(normalized_fname);
-
-    // There's already data on there!
-    // TODO: We should do more stuff here, as the user is likely trying to
-    // override a file. In this case, check versions and ask the user what
-    // they want to do!
-    if (index_file.exists()) {
-        index_file.remove();
-    } else {
-        FS::ensureFilePathExists(index_file.fileName());
-    }
-
     toml::table update;
     switch (mod.provider) {
         case (ModPlatform::ResourceProvider::FLAME):
             if (mod.file_id.toInt() == 0 || mod.project_id.toInt() == 0) {
-                qCritical() << QString("Did not write file %1 because missing information!").arg(normalized_fname);
-                return;
+                qCritical() << QString("Did not write file %1 because missing information!").arg(path);
+                return false;
             }
             update = toml::table{
                 { "file-id", mod.file_id.toInt() },
@@ -165,13 +144,13 @@ void V1::updateModIndex(const QDir& index_dir, Mod& mod)
             };
             break;
         case (ModPlatform::ResourceProvider::MODRINTH):
-            if (mod.mod_id().toString().isEmpty() || mod.version().toString().isEmpty()) {
-                qCritical() << QString("Did not write file %1 because missing information!").arg(normalized_fname);
-                return;
+            if (mod.project_id.toString().isEmpty() || mod.file_id.toString().isEmpty()) {
+                qCritical() << QString("Did not write file %1 because missing information!").arg(path);
+                return false;
             }
             update = toml::table{
-                { "mod-id", mod.mod_id().toString().toStdString() },
-                { "version", mod.version().toString().toStdString() },
+                { "mod-id", mod.project_id.toString().toStdString() },
+                { "version", mod.file_id.toString().toStdString() },
             };
             break;
     }
@@ -185,9 +164,10 @@ void V1::updateModIndex(const QDir& index_dir, Mod& mod)
         mcVersions.push_back(version.toStdString());
     }
 
-    if (!index_file.open(QIODevice::ReadWrite)) {
-        qCritical() << QString("Could not open file %1!").arg(normalized_fname);
-        return;
+    QFile index_file(path);
+    if (!index_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << QString("Could not open file %1!").arg(path);
+        return false;
     }
 
     // Put TOML data into the file
@@ -215,57 +195,32 @@ void V1::updateModIndex(const QDir& index_dir, Mod& mod)
 
     index_file.flush();
     index_file.close();
+    return index_file.error() == QFileDevice::NoError;
 }
 
-void V1::deleteModIndex(const QDir& index_dir, QString& mod_slug)
-{
-    auto normalized_fname = indexFileName(mod_slug);
-    auto real_fname = getRealIndexName(index_dir, normalized_fname);
-    if (real_fname.isEmpty())
-        return;
-
-    QFile index_file(index_dir.absoluteFilePath(real_fname));
-
-    if (!index_file.exists()) {
-        qWarning() << QString("Tried to delete non-existent mod metadata for %1!").arg(mod_slug);
-        return;
-    }
-
-    if (!index_file.remove()) {
-        qWarning() << QString("Failed to remove metadata for mod %1!").arg(mod_slug);
-    }
-}
-
-auto V1::getIndexForMod(const QDir& index_dir, QString slug) -> Mod
+auto V1::readModIndex(const QString& path, const QString& slug) -> Mod
 {
     Mod mod;
 
-    auto normalized_fname = indexFileName(slug);
-    auto real_fname = getRealIndexName(index_dir, normalized_fname, true);
-    if (real_fname.isEmpty())
-        return {};
-
     toml::table table;
 #if TOML_EXCEPTIONS
     try {
-        table = toml::parse_file(StringUtils::toStdString(index_dir.absoluteFilePath(real_fname)));
+        table = toml::parse_file(StringUtils::toStdString(path));
     } catch (const toml::parse_error& err) {
-        qWarning() << QString("Could not open file %1!").arg(normalized_fname);
+        qWarning() << QString("Could not open file %1!").arg(path);
         qWarning() << "Reason: " << QString(err.what());
         return {};
     }
 #else
-    toml::parse_result result = toml::parse_file(StringUtils::toStdString(index_dir.absoluteFilePath(real_fname)));
+    toml::parse_result result = toml::parse_file(StringUtils::toStdString(path));
     if (!result) {
-        qWarning() << QString("Could not open file %1!").arg(normalized_fname);
+        qWarning() << QString("Could not open file %1!").arg(path);
         qWarning() << "Reason: " << result.error().description();
         return {};
     }
     table = result.table();
 #endif
 
-    // index_file.close();
-
     mod.slug = slug;
 
     {  // Basic info
@@ -334,16 +289,221 @@ auto V1::getIndexForMod(const QDir& index_dir, QString slug) -> Mod
     return mod;
 }
 
+void V1::updateModIndex(const QDir& index_dir, Mod& mod)
+{
+    auto index = Index::of(index_dir);
+    index->update(mod);
+    index->flush();
+}
+
+void V1::deleteModIndex(const QDir& index_dir, QString& mod_slug)
+{
+    auto index = Index::of(index_dir);
+    index->remove(mod_slug);
+    index->flush();
+}
+
+auto V1::getIndexForMod(const QDir& index_dir, QString slug) -> Mod
+{
+    return Index::of(index_dir)->get(slug);
+}
+
 auto V1::getIndexForMod(const QDir& index_dir, QVariant& mod_id) -> Mod
 {
-    for (auto& file_name : index_dir.entryList(QDir::Filter::Files)) {
-        auto mod = getIndexForMod(index_dir, file_name);
+    return Index::of(index_dir)->get(mod_id);
+}
+
+auto Index::of(const QDir& index_dir) -> Ptr
+{
+    static QMutex s_lock;
+    static QHash<QString, Ptr> s_indexes;
+
+    QMutexLocker locker(&s_lock);
+    auto& index = s_indexes[QDir::cleanPath(index_dir.absolutePath())];
+    if (!index)
+        index = std::make_shared<Index>(index_dir);
+    return index;
+}
 
-        if (mod.mod_id() == mod_id)
-            return mod;
+void Index::refresh()
+{
+    auto modified = QFileInfo(m_dir.absolutePath()).lastModified();
+    if (m_listedAt && *m_listedAt == modified)
+        return;
+    m_listedAt = modified;
+
+    QHash<QString, Entry> entries;
+    for (auto& info : QDir(m_dir.absolutePath()).entryInfoList(QDir::Files)) {
+        auto key = info.fileName().toCaseFolded();
+        // removed, but not flushed yet
+        if (m_removed.contains(key))
+            continue;
+        if (auto old = m_entries.constFind(key);
+            old != m_entries.constEnd() && (old->dirty || (old->diskName == info.fileName() && old->lastModified == info.lastModified()))) {
+            entries.insert(key, *old);
+            continue;
+        }
+        entries.insert(key, { info.fileName(), info.fileName(), info.lastModified() });
     }
+    // changed, but not flushed yet
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); it++) {
+        if (it->dirty && !entries.contains(it.key()))
+            entries.insert(it.key(), it.value());
+    }
+    m_entries = entries;
+}
 
+bool Index::isStale(const Entry& entry) const
+{
+    // a file can be edited without its folder changing
+    return !entry.dirty && QFileInfo(m_dir.absoluteFilePath(entry.diskName)).lastModified() != entry.lastModified;
+}
+
+void Index::parse(const QList<Entry*>& entries)
+{
+    auto read = [this](Entry* entry) {
+        entry->lastModified = QFileInfo(m_dir.absoluteFilePath(entry->diskName)).lastModified();
+        entry->mod = V1::readModIndex(m_dir.absoluteFilePath(entry->diskName), entry->fileName);
+    };
+    // not worth the threads for the odd file
+    if (entries.size() < 8) {
+        std::for_each(entries.begin(), entries.end(), read);
+        return;
+    }
+    QThreadPool pool;
+    auto pending = entries;
+    QtConcurrent::blockingMap(&pool, pending, read);
+}
+
+void Index::parseAll()
+{
+    refresh();
+    QList<Entry*> pending;
+    for (auto& entry : m_entries) {
+        if (!entry.mod || isStale(entry))
+            pending.append(&entry);
+    }
+    parse(pending);
+}
+
+QList<V1::Mod> Index::mods()
+{
+    QMutexLocker locker(&m_lock);
+    parseAll();
+
+    QList<V1::Mod> mods;
+    for (auto& entry : m_entries) {
+        if (entry.mod->isValid())
+            mods.append(*entry.mod);
+    }
+    return mods;
+}
+
+V1::Mod Index::get(const QString& slug)
+{
+    QMutexLocker locker(&m_lock);
+    refresh();
+
+    auto entry = m_entries.find(indexFileName(slug).toCaseFolded());
+    if (entry == m_entries.end())
+        return {};
+    if (!entry->mod || isStale(*entry))
+        parse({ &*entry });
+    if (!entry->mod->isValid())
+        return {};
+
+    auto mod = *entry->mod;
+    mod.slug = slug;
+    return mod;
+}
+
+V1::Mod Index::get(const QVariant& mod_id)
+{
+    QMutexLocker locker(&m_lock);
+    parseAll();
+
+    for (auto& entry : m_entries) {
+        if (entry.mod->isValid() && entry.mod->project_id == mod_id)
+            return *entry.mod;
+    }
     return {};
 }
 
+void Index::update(const V1::Mod& mod)
+{
+    if (!mod.isValid()) {
+        qCritical() << QString("Tried to update metadata of an invalid mod!");
+        return;
+    }
+
+    QMutexLocker locker(&m_lock);
+    refresh();
+
+    auto file_name = indexFileName(mod.slug);
+    auto key = file_name.toCaseFolded();
+    auto& entry = m_entries[key];
+    if (entry.diskName.isEmpty())
+        entry.diskName = m_removed.take(key);
+    entry.fileName = file_name;
+    entry.mod = mod;
+    entry.mod->slug = file_name;
+    entry.dirty = true;
+}
+
+void Index::remove(const QString& slug)
+{
+    QMutexLocker locker(&m_lock);
+    refresh();
+
+    auto key = indexFileName(slug).toCaseFolded();
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end()) {
+        qWarning() << QString("Tried to delete non-existent mod metadata for %1!").arg(slug);
+        return;
+    }
+    if (!entry->diskName.isEmpty())
+        m_removed.insert(key, entry->diskName);
+    m_entries.erase(entry);
+}
+
+void Index::flush()
+{
+    QMutexLocker locker(&m_lock);
+
+    for (auto& file_name : m_removed) {
+        if (!QFile::remove(m_dir.absoluteFilePath(file_name)))
+            qWarning() << QString("Failed to remove metadata file %1!").arg(file_name);
+    }
+    m_removed.clear();
+
+    bool ensured = false;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        auto& entry = it.value();
+        if (!entry.dirty) {
+            it++;
+            continue;
+        }
+        if (!ensured)
+            ensured = FS::ensureFolderPathExists(m_dir.absolutePath());
+
+        // the file may have been there with a different case
+        if (!entry.diskName.isEmpty() && entry.diskName != entry.fileName)
+            QFile::remove(m_dir.absoluteFilePath(entry.diskName));
+
+        auto path = m_dir.absoluteFilePath(entry.fileName);
+        if (!V1::writeModIndex(path, *entry.mod)) {
+            QFile::remove(path);
+            it = m_entries.erase(it);
+            continue;
+        }
+        entry.diskName = entry.fileName;
+        entry.lastModified = QFileInfo(path).lastModified();
+        entry.dirty = false;
+        it++;
+    }
+
+    // these changes don't need the folder to be listed again
+    m_listedAt = QFileInfo(m_dir.absolutePath()).lastModified();
+}
+
 }  // namespace Packwiz
@@ -21,11 +21,16 @@
 
 #include "modplatform/ModIndex.h"
 
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
 #include <QString>
 #include <QUrl>
 #include <QVariant>
 
-class QDir;
+#include <memory>
+#include <optional>
 
 namespace Packwiz {
 
@@ -70,6 +75,12 @@ class V1 {
      * */
     static auto createModFormat(const QDir& index_dir, ModPlatform::IndexedPack& mod_pack, ModPlatform::IndexedVersion& mod_version) -> Mod;
 
+    /* Parses a single metadata file. Returns an empty Mod object if it can't be read. */
+    static auto readModIndex(const QString& path, const QString& slug) -> Mod;
+
+    /* Writes a single metadata file, replacing whatever was there. */
+    static auto writeModIndex(const QString& path, const Mod& mod) -> bool;
+
     /* Updates the mod index for the provided mod.
      * This creates a new index if one does not exist already
      * TODO: Ask the user if they want to override, and delete the old mod's files, or keep the old one.
@@ -90,4 +101,53 @@ class V1 {
     static auto getIndexForMod(const QDir& index_dir, QVariant& mod_id) -> Mod;
 };
 
+/**
+ * The metadata files of one index folder.
+ *
+ * The folder is only listed again when it changes, and files are parsed the first time they are needed, in parallel
+ * when there are many. Lookups by slug ignore case like the file names do. Changes stay in memory until flush().
+ */
+class Index {
+   public:
+    using Ptr = std::shared_ptr<Index>;
+
+    /** The index of a folder, shared by everything that reads or writes it. */
+    static Ptr of(const QDir& index_dir);
+
+    explicit Index(const QDir& index_dir) : m_dir(index_dir) {}
+
+    /** Every valid metadata in the folder, the slugs being the file names. */
+    QList<V1::Mod> mods();
+    /** An empty Mod object if there is none for the slug. */
+    V1::Mod get(const QString& slug);
+    V1::Mod get(const QVariant& mod_id);
+
+    void update(const V1::Mod& mod);
+    void remove(const QString& slug);
+    /** Writes and deletes the files changed since the last flush. */
+    void flush();
+
+   private:
+    struct Entry {
+        // the name it should have, and the name it has on disk if it was written already
+        QString fileName;
+        QString diskName;
+        QDateTime lastModified;
+        std::optional<V1::Mod> mod;
+        bool dirty = false;
+    };
+
+    void refresh();
+    bool isStale(const Entry& entry) const;
+    void parse(const QList<Entry*>& entries);
+    void parseAll();
+
+    const QDir m_dir;
+    QMutex m_lock;
+    std::optional<QDateTime> m_listedAt;
+    // by case folded file name
+    QHash<QString, Entry> m_entries;
+    QHash<QString, QString> m_removed;
+};
+
 }  // namespace Packwiz
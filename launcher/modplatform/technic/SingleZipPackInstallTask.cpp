@@ -15,7 +15,7 @@
 
 #include "SingleZipPackInstallTask.h"
 
-#include <QtConcurrent>
+#include "tasks/Executor.h"
 
 #include "FileSystem.h"
 #include "MMCZip.h"
@@ -71,8 +71,9 @@ void Technic::SingleZipPackInstallTask::downloadSucceeded()
         emitFailed(tr("Unable to open supplied modpack zip file."));
         return;
     }
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), QString(""), extractDir.absolutePath());
+    m_extractFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, [zip = m_packZip.get(), target = extractDir.absolutePath()] {
+        return MMCZip::extractSubDir(zip, QString(""), target);
+    });
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SingleZipPackInstallTask::extractFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SingleZipPackInstallTask::extractAborted);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -38,7 +38,7 @@
 #include <FileSystem.h>
 #include <Json.h>
 #include <MMCZip.h>
-#include <QtConcurrentRun>
+#include "tasks/Executor.h"
 
 #include "SolderPackManifest.h"
 #include "TechnicPackProcessor.h"
@@ -137,7 +137,7 @@ void Technic::SolderPackInstallTask::downloadSucceeded()
 
     setStatus(tr("Extracting modpack"));
     m_filesNetJob.reset();
-    m_extractFuture = QtConcurrent::run([this]() {
+    m_extractFuture = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, [this]() {
         int i = 0;
         QString extractDir = FS::PathCombine(m_stagingPath, "minecraft");
         FS::ensureFolderPathExists(extractDir);
@@ -83,6 +83,17 @@ auto Download::makeFile(QUrl url, QString path, Options options) -> Download::Pt
     return dl;
 }
 
+auto Download::makeStream(QUrl url, StreamSink::Begin begin, StreamSink::Consume consume, StreamSink::Ready ready, Options options)
+    -> Download::Ptr
+{
+    auto dl = makeShared<Download>();
+    dl->m_url = url;
+    dl->setObjectName(QString("STREAM:") + url.toString());
+    dl->m_options = options;
+    dl->m_sink.reset(new StreamSink(std::move(begin), std::move(consume), std::move(ready)));
+    return dl;
+}
+
 QNetworkReply* Download::getReply(QNetworkRequest& request)
 {
     return m_network->get(request);
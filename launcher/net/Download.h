@@ -42,6 +42,7 @@
 
 #include "QObjectPtr.h"
 #include "net/NetRequest.h"
+#include "net/StreamSink.h"
 
 namespace Net {
 class Download : public NetRequest {
@@ -56,6 +57,12 @@ class Download : public NetRequest {
 
     static auto makeByteArray(QUrl url, std::shared_ptr<QByteArray> output, Options options = Option::NoOptions) -> Download::Ptr;
     static auto makeFile(QUrl url, QString path, Options options = Option::NoOptions) -> Download::Ptr;
+    //! Hands the data to the consumer as it arrives, see StreamSink
+    static auto makeStream(QUrl url,
+                           StreamSink::Begin begin,
+                           StreamSink::Consume consume,
+                           StreamSink::Ready ready = {},
+                           Options options = Option::NoOptions) -> Download::Ptr;
 
    protected:
     virtual QNetworkReply* getReply(QNetworkRequest&) override;
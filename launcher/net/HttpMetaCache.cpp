@@ -39,12 +39,18 @@
 
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <QDebug>
 
 #include "net/Logging.h"
+#include "tasks/Executor.h"
 
 auto MetaEntry::getFullPath() -> QString
 {
@@ -68,18 +74,51 @@ HttpMetaCache::~HttpMetaCache()
 
 auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
-    // no base. no base path. can't store
-    if (!m_entries.contains(base)) {
-        // TODO: log problem
-        return {};
-    }
+    auto& shard = shardFor({ base, resource_path });
+    QMutexLocker locker(&shard.lock);
+    return shard.entries.value({ base, resource_path });
+}
+
+bool HttpMetaCache::checkFile(const QString& real_path, MetaEntry& entry, bool& touched) const
+{
+    QFileInfo finfo(real_path);
+
+    // is the file really there? if not -> stale
+    if (!finfo.isFile() || !finfo.isReadable())
+        return false;
 
-    EntryMap& map = m_entries[base];
-    if (map.entry_list.contains(resource_path)) {
-        return map.entry_list[resource_path];
+    qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
+    if (file_last_changed == entry.m_local_changed_timestamp)
+        return entry.m_local_size < 0 || entry.m_local_size == finfo.size();
+    if (m_trust_file_stat)
+        return false;
+
+    // the file changed, check md5sum
+    QFile input(real_path);
+    if (!input.open(QIODevice::ReadOnly))
+        return false;
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    qint64 read;
+    while ((read = input.read(buffer.data(), buffer.size())) > 0) {
+        hash.addData(QByteArrayView(buffer.constData(), read));
     }
+    if (read < 0 || entry.m_md5sum != QString::fromLatin1(hash.result().toHex()))
+        return false;
 
-    return {};
+    // md5sums matched... keep entry and save the new state to file
+    entry.m_local_changed_timestamp = file_last_changed;
+    entry.m_local_size = finfo.size();
+    touched = true;
+    return true;
+}
+
+void HttpMetaCache::forget(const Key& key, const MetaEntryPtr& entry)
+{
+    auto& shard = shardFor(key);
+    QMutexLocker locker(&shard.lock);
+    if (shard.entries.value(key) == entry)
+        shard.entries.remove(key);
 }
 
 auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
@@ -91,56 +130,61 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
         return staleEntry(base, resource_path);
     }
 
-    auto& selected_base = m_entries[base];
-    QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
-    QFileInfo finfo(real_path);
-
-    // is the file really there? if not -> stale
-    if (!finfo.isFile() || !finfo.isReadable()) {
-        // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
-        return staleEntry(base, resource_path);
-    }
+    Key key{ base, resource_path };
+    auto base_path = getBasePath(base);
+    QString real_path = FS::PathCombine(base_path, resource_path);
 
     if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
         // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        forget(key, entry);
         return staleEntry(base, resource_path);
     }
 
-    // if the file changed, check md5sum
-    qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
-    if (file_last_changed != entry->m_local_changed_timestamp) {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
-        if (entry->m_md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
-            return staleEntry(base, resource_path);
-        }
-
-        // md5sums matched... keep entry and save the new state to file
-        entry->m_local_changed_timestamp = file_last_changed;
-        SaveEventually();
+    // look at the file without holding the lock, it may need hashing. a copy keeps other threads from seeing it half updated
+    MetaEntry checked;
+    {
+        QMutexLocker locker(&shardFor(key).lock);
+        checked = *entry;
+    }
+    bool touched = false;
+    if (!checkFile(real_path, checked, touched)) {
+        // if the file doesn't exist or changed, we disown the entry
+        forget(key, entry);
+        return staleEntry(base, resource_path);
     }
 
     // Get rid of old entries, to prevent cache problems
     auto current_time = QDateTime::currentSecsSinceEpoch();
-    if (entry->isExpired(current_time - (file_last_changed / 1000))) {
+    if (checked.isExpired(current_time - (checked.m_local_changed_timestamp / 1000))) {
         qCWarning(taskNetLogC) << "[HttpMetaCache]"
                                << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
+        forget(key, entry);
         return staleEntry(base, resource_path);
     }
 
     // entry passed all the checks we cared about.
-    entry->m_basePath = getBasePath(base);
+    {
+        QMutexLocker locker(&shardFor(key).lock);
+        entry->m_local_changed_timestamp = checked.m_local_changed_timestamp;
+        entry->m_local_size = checked.m_local_size;
+        entry->m_basePath = base_path;
+    }
+    if (touched)
+        SaveEventually();
     return entry;
 }
 
+auto HttpMetaCache::resolveEntries(QString base, QStringList resource_paths) -> QList<MetaEntryPtr>
+{
+    // most of the time goes to waiting on the disk, so check many files at once
+    return QtConcurrent::blockingMapped<QList<MetaEntryPtr>>(Executor::pool(Executor::Kind::IO, Executor::Priority::Interactive),
+                                                             resource_paths,
+                                                             [this, base](const QString& path) { return resolveEntry(base, path); });
+}
+
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
-    if (!m_entries.contains(stale_entry->m_baseId)) {
+    if (getBasePath(stale_entry->m_baseId).isNull()) {
         qCCritical(taskHttpMetaCacheLogC) << "Cannot add entry with unknown base: " << stale_entry->m_baseId.toLocal8Bit();
         return false;
     }
@@ -150,7 +194,15 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
         return false;
     }
 
-    m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
+    if (stale_entry->m_local_size < 0)
+        stale_entry->m_local_size = QFileInfo(stale_entry->getFullPath()).size();
+
+    Key key{ stale_entry->m_baseId, stale_entry->m_relativePath };
+    {
+        auto& shard = shardFor(key);
+        QMutexLocker locker(&shard.lock);
+        shard.entries[key] = stale_entry;
+    }
     SaveEventually();
 
     return true;
@@ -169,21 +221,69 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
 // returns true on success, false otherwise
 auto HttpMetaCache::evictAll() -> bool
 {
-    bool ret = true;
-    for (QString& base : m_entries.keys()) {
-        EntryMap& map = m_entries[base];
-        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
-        for (MetaEntryPtr entry : map.entry_list) {
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        for (MetaEntryPtr entry : shard.entries) {
             if (!evictEntry(entry))
                 qCWarning(taskHttpMetaCacheLogC) << "Unexpected missing cache entry" << entry->m_basePath;
         }
-        map.entry_list.clear();
+        shard.entries.clear();
+    }
+
+    bool ret = true;
+    QReadLocker locker(&m_bases_lock);
+    for (auto it = m_bases.cbegin(); it != m_bases.cend(); ++it) {
+        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << it.key();
         // AND all return codes together so the result is true iff all runs of deletePath() are true
-        ret &= FS::deletePath(map.base_path);
+        ret &= FS::deletePath(it.value());
     }
     return ret;
 }
 
+void HttpMetaCache::prune(QString base, qint64 keep_expired_for)
+{
+    auto base_path = getBasePath(base);
+    if (base_path.isNull())
+        return;
+
+    auto now = QDateTime::currentSecsSinceEpoch();
+    QSet<QString> kept;
+    int pruned = 0;
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            auto entry = it.value();
+            if (it.key().first != base) {
+                ++it;
+                continue;
+            }
+            auto stored_for = now - entry->m_local_changed_timestamp / 1000;
+            if (!entry->m_stale && !entry->isExpired(stored_for - keep_expired_for)) {
+                kept.insert(entry->m_relativePath);
+                ++it;
+                continue;
+            }
+            QFile::remove(FS::PathCombine(base_path, entry->m_relativePath));
+            it = shard.entries.erase(it);
+            pruned++;
+        }
+    }
+
+    // left behind by entries that were dropped without their files
+    QDir base_dir(base_path);
+    QDirIterator files(base_path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (files.hasNext()) {
+        auto path = files.next();
+        if (!kept.contains(base_dir.relativeFilePath(path)) && QFile::remove(path))
+            pruned++;
+    }
+
+    if (pruned > 0) {
+        qCDebug(taskHttpMetaCacheLogC) << "Pruned" << pruned << "expired files from" << base;
+        SaveEventually();
+    }
+}
+
 auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
     auto foo = new MetaEntry();
@@ -197,23 +297,19 @@ auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntry
 
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
+    QWriteLocker locker(&m_bases_lock);
     // TODO: report error
-    if (m_entries.contains(base))
+    if (m_bases.contains(base))
         return;
 
     // TODO: check if the base path is valid
-    EntryMap foo;
-    foo.base_path = base_root;
-    m_entries[base] = foo;
+    m_bases[base] = base_root;
 }
 
 auto HttpMetaCache::getBasePath(QString base) -> QString
 {
-    if (m_entries.contains(base)) {
-        return m_entries[base].base_path;
-    }
-
-    return {};
+    QReadLocker locker(&m_bases_lock);
+    return m_bases.value(base);
 }
 
 void HttpMetaCache::Load()
@@ -254,17 +350,16 @@ void HttpMetaCache::Load()
     for (auto element : array) {
         auto element_obj = Json::ensureObject(element);
         auto base = Json::ensureString(element_obj, "base");
-        if (!m_entries.contains(base))
+        if (getBasePath(base).isNull())
             continue;
 
-        auto& entrymap = m_entries[base];
-
         auto foo = new MetaEntry();
         foo->m_baseId = base;
         foo->m_relativePath = Json::ensureString(element_obj, "path");
         foo->m_md5sum = Json::ensureString(element_obj, "md5sum");
         foo->m_etag = Json::ensureString(element_obj, "etag");
         foo->m_local_changed_timestamp = Json::ensureDouble(element_obj, "last_changed_timestamp");
+        foo->m_local_size = Json::ensureDouble(element_obj, "size", -1);
         foo->m_remote_changed_timestamp = Json::ensureString(element_obj, "remote_changed_timestamp");
 
         foo->makeEternal(Json::ensureBoolean(element_obj, (const QString)QStringLiteral("eternal"), false));
@@ -276,12 +371,19 @@ void HttpMetaCache::Load()
         // presumed innocent until closer examination
         foo->m_stale = false;
 
-        entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+        Key key{ base, foo->m_relativePath };
+        auto& shard = shardFor(key);
+        QMutexLocker locker(&shard.lock);
+        shard.entries[key] = MetaEntryPtr(foo);
     }
 }
 
 void HttpMetaCache::SaveEventually()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &HttpMetaCache::SaveEventually, Qt::QueuedConnection);
+        return;
+    }
     // reset the save timer
     saveBatchingTimer.stop();
     saveBatchingTimer.start(30000);
@@ -292,14 +394,13 @@ void HttpMetaCache::SaveNow()
     if (m_index_file.isNull())
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
-
     QJsonObject toplevel;
     Json::writeString(toplevel, "version", "1");
 
     QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
+    for (auto& shard : m_shards) {
+        QMutexLocker locker(&shard.lock);
+        for (auto entry : shard.entries) {
             // do not save stale entries. they are dead.
             if (entry->m_stale) {
                 continue;
@@ -311,6 +412,8 @@ void HttpMetaCache::SaveNow()
             Json::writeString(entryObj, "md5sum", entry->m_md5sum);
             Json::writeString(entryObj, "etag", entry->m_etag);
             entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->m_local_changed_timestamp)));
+            if (entry->m_local_size >= 0)
+                entryObj.insert("size", QJsonValue(double(entry->m_local_size)));
             if (!entry->m_remote_changed_timestamp.isEmpty())
                 entryObj.insert("remote_changed_timestamp", QJsonValue(entry->m_remote_changed_timestamp));
             if (entry->isEternal()) {
@@ -323,6 +426,7 @@ void HttpMetaCache::SaveNow()
         }
     }
     toplevel.insert("entries", entriesArr);
+    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << entriesArr.size() << "entries";
 
     try {
         Json::write(toplevel, m_index_file);
@@ -35,9 +35,15 @@
 
 #pragma once
 
+#include <QHash>
 #include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
+#include <array>
+#include <atomic>
 #include <memory>
 
 class HttpMetaCache;
@@ -57,6 +63,7 @@ class MetaEntry {
     auto getRemoteChangedTimestamp() -> QString { return m_remote_changed_timestamp; }
     void setRemoteChangedTimestamp(QString remote_changed_timestamp) { m_remote_changed_timestamp = remote_changed_timestamp; }
     void setLocalChangedTimestamp(qint64 timestamp) { m_local_changed_timestamp = timestamp; }
+    void setLocalSize(qint64 size) { m_local_size = size; }
 
     auto getETag() -> QString { return m_etag; }
     void setETag(QString etag) { m_etag = etag; }
@@ -84,6 +91,7 @@ class MetaEntry {
     QString m_etag;
 
     qint64 m_local_changed_timestamp = 0;
+    qint64 m_local_size = -1;  // -1 for entries written before the size was recorded
     QString m_remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 m_current_age = 0;
     qint64 m_max_age = 0;
@@ -106,14 +114,25 @@ class HttpMetaCache : public QObject {
     auto getEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
     // get the entry from cache and verify that it isn't stale (within reason)
+    // safe to call from any thread
     auto resolveEntry(QString base, QString resource_path, QString expected_etag = QString()) -> MetaEntryPtr;
 
+    // resolveEntry() for many files at once, checked in parallel. the entries are in the order of the paths
+    auto resolveEntries(QString base, QStringList resource_paths) -> QList<MetaEntryPtr>;
+
+    // trust a file whose size and modification time match the entry, and drop it otherwise
+    // instead of hashing it to find out if it really changed
+    void setTrustFileStat(bool trust) { m_trust_file_stat = trust; }
+
     // add a previously resolved stale entry
     auto updateEntry(MetaEntryPtr stale_entry) -> bool;
 
     // evict selected entry from cache
     auto evictEntry(MetaEntryPtr entry) -> bool;
     bool evictAll();
+    // drop the entries of a base that expired more than keep_expired_for seconds ago, along with their files
+    // and any file in the base that no entry refers to
+    void prune(QString base, qint64 keep_expired_for);
 
     void addBase(QString base, QString base_root);
 
@@ -129,13 +148,26 @@ class HttpMetaCache : public QObject {
    private:
     // create a new stale entry, given the parameters
     auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
+    // if the file still is what the entry describes. updates the entry's timestamp if it only got touched
+    bool checkFile(const QString& real_path, MetaEntry& entry, bool& touched) const;
 
-    struct EntryMap {
-        QString base_path;
-        QMap<QString, MetaEntryPtr> entry_list;
+    using Key = QPair<QString, QString>;  // base, resource path
+    struct Shard {
+        mutable QMutex lock;
+        QHash<Key, MetaEntryPtr> entries;
     };
+    static constexpr int s_shardCount = 16;
+
+    Shard& shardFor(const Key& key) { return m_shards[qHash(key) % s_shardCount]; }
+    // drop the entry, unless it was replaced in the meantime
+    void forget(const Key& key, const MetaEntryPtr& entry);
+
+    // base id -> base path
+    mutable QReadWriteLock m_bases_lock;
+    QMap<QString, QString> m_bases;
+    std::array<Shard, s_shardCount> m_shards;
+    std::atomic_bool m_trust_file_stat{ false };
 
-    QMap<QString, EntryMap> m_entries;
     QString m_index_file;
     QTimer saveBatchingTimer;
 };
@@ -118,6 +118,8 @@ void NetRequest::executeTask()
     if (rep == nullptr)  // it failed
         return;
     m_reply.reset(rep);
+    if (auto size = m_sink->readBufferSize(); size > 0)
+        rep->setReadBufferSize(size);
     connect(rep, &QNetworkReply::uploadProgress, this, &NetRequest::onProgress);
     connect(rep, &QNetworkReply::downloadProgress, this, &NetRequest::onProgress);
     connect(rep, &QNetworkReply::finished, this, &NetRequest::downloadFinished);
@@ -306,6 +308,9 @@ void NetRequest::downloadFinished()
 void NetRequest::downloadReadyRead()
 {
     if (m_state == State::Running) {
+        // the data stays in the reply, which stops reading from the network once its buffer is full
+        if (!m_sink->canWrite())
+            return;
         auto data = m_reply->readAll();
         m_state = m_sink->write(data);
         if (m_state == State::Failed) {
@@ -317,6 +322,12 @@ void NetRequest::downloadReadyRead()
     }
 }
 
+void NetRequest::resumeReading()
+{
+    if (m_state == State::Running && m_reply && m_reply->bytesAvailable() > 0)
+        downloadReadyRead();
+}
+
 auto NetRequest::abort() -> bool
 {
     m_state = State::AbortedByUser;
@@ -78,6 +78,10 @@ class NetRequest : public Task {
     QNetworkReply::NetworkError error() const;
     QString errorString() const;
 
+   public slots:
+    //! Hands the data waiting in the reply to a sink that held it back, see Sink::canWrite()
+    void resumeReading();
+
    private:
     auto handleRedirect() -> bool;
     virtual QNetworkReply* getReply(QNetworkRequest&) = 0;
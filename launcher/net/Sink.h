@@ -52,6 +52,11 @@ class Sink {
 
     virtual auto hasLocalData() -> bool = 0;
 
+    //! If the sink takes more data right now. While it does not, the data waits in the reply, see NetRequest::resumeReading()
+    virtual auto canWrite() -> bool { return true; }
+    //! How much of the reply may wait for the sink before the network is no longer read, 0 for no limit
+    virtual auto readBufferSize() const -> qint64 { return 0; }
+
     QString failReason() const { return m_fail_reason; }
 
     void addValidator(Validator* validator)
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <functional>
+
+#include "Sink.h"
+
+namespace Net {
+
+/*
+ * Sink object for downloads that hands every chunk to a consumer as it arrives, for data that is processed while
+ * the download is still running. Nothing is stored, so there is never local data to fall back on.
+ */
+class StreamSink : public Sink {
+   public:
+    //! Called when the request (re)starts: anything received before has to be thrown away
+    using Begin = std::function<bool()>;
+    using Consume = std::function<bool(const QByteArray&)>;
+    //! If the consumer takes more data right now, for consumers that would otherwise fall behind the network
+    using Ready = std::function<bool()>;
+
+    StreamSink(Begin begin, Consume consume, Ready ready = {})
+        : m_begin(std::move(begin)), m_consume(std::move(consume)), m_ready(std::move(ready))
+    {}
+    virtual ~StreamSink() = default;
+
+   public:
+    auto init(QNetworkRequest& request) -> Task::State override
+    {
+        if (!m_begin()) {
+            m_fail_reason = "Failed to start the consumer";
+            return Task::State::Failed;
+        }
+        if (initAllValidators(request))
+            return Task::State::Running;
+        m_fail_reason = "Failed to initialize validators";
+        return Task::State::Failed;
+    }
+
+    auto write(QByteArray& data) -> Task::State override
+    {
+        if (!m_consume(data)) {
+            m_fail_reason = "Failed to process the data";
+            return Task::State::Failed;
+        }
+        if (writeAllValidators(data))
+            return Task::State::Running;
+        m_fail_reason = "Failed to write validators";
+        return Task::State::Failed;
+    }
+
+    auto abort() -> Task::State override
+    {
+        failAllValidators();
+        m_fail_reason = "Aborted";
+        return Task::State::Failed;
+    }
+
+    auto finalize(QNetworkReply& reply) -> Task::State override
+    {
+        if (finalizeAllValidators(reply))
+            return Task::State::Succeeded;
+        m_fail_reason = "Failed to finalize validators";
+        return Task::State::Failed;
+    }
+
+    auto hasLocalData() -> bool override { return false; }
+
+    auto canWrite() -> bool override { return !m_ready || m_ready(); }
+    auto readBufferSize() const -> qint64 override { return m_ready ? s_read_buffer_size : 0; }
+
+   protected:
+    Begin m_begin;
+    Consume m_consume;
+    Ready m_ready;
+
+    static constexpr qint64 s_read_buffer_size = 1024 * 1024;
+};
+}  // namespace Net
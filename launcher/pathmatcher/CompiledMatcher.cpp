@@ -0,0 +1,219 @@
+#include "CompiledMatcher.h"
+
+#include <QDebug>
+#include <algorithm>
+
+static bool isGlob(const QString& segment)
+{
+    return segment.contains('*') || segment.contains('?') || segment.contains('[');
+}
+
+CompiledMatcher::CompiledMatcher()
+{
+    // the root
+    m_nodes.append(Node());
+}
+
+CompiledMatcher& CompiledMatcher::caseSensitive(bool cs)
+{
+    m_caseSensitive = cs;
+    return *this;
+}
+
+CompiledMatcher& CompiledMatcher::addPrefix(const QString& prefix)
+{
+    auto dir = prefix.endsWith('/');
+    addSegments(prefix.split('/', Qt::SkipEmptyParts), !dir, dir, true);
+    return *this;
+}
+
+CompiledMatcher& CompiledMatcher::addGlob(const QString& glob)
+{
+    auto dir = glob.endsWith('/');
+    addSegments(glob.split('/', Qt::SkipEmptyParts), !dir, dir, false);
+    return *this;
+}
+
+CompiledMatcher& CompiledMatcher::addGitignore(const QString& pattern)
+{
+    auto line = pattern.trimmed();
+    if (line.isEmpty() || line.startsWith('#'))
+        return *this;
+    if (line.startsWith('!')) {
+        qWarning() << "Negated ignore patterns are not supported:" << line;
+        return *this;
+    }
+
+    auto dir = line.endsWith('/');
+    if (dir)
+        line.chop(1);
+    // a slash at the start or in the middle ties the pattern to the root
+    auto segments = line.split('/', Qt::SkipEmptyParts);
+    if (!line.contains('/'))
+        segments.prepend("**");
+    // a name may be a folder, and then everything in it goes too
+    addSegments(segments, !dir, true, false);
+    return *this;
+}
+
+int CompiledMatcher::child(int node, const QString& segment, bool literal)
+{
+    auto key = m_caseSensitive ? segment : segment.toLower();
+    if (literal || !isGlob(key)) {
+        if (auto it = m_nodes[node].literals.constFind(key); it != m_nodes[node].literals.constEnd())
+            return *it;
+        m_nodes.append(Node());
+        int next = static_cast<int>(m_nodes.size() - 1);
+        m_nodes[node].literals.insert(key, next);
+        return next;
+    }
+
+    auto regex = QRegularExpression::wildcardToRegularExpression(key);
+    for (auto& [expression, next] : m_nodes[node].globs) {
+        if (expression.pattern() == regex)
+            return next;
+    }
+    m_nodes.append(Node());
+    int next = static_cast<int>(m_nodes.size() - 1);
+    m_nodes[node].globs.append({ QRegularExpression(regex), next });
+    return next;
+}
+
+int CompiledMatcher::star(int node)
+{
+    // "**/**" is the same as "**"
+    if (m_nodes[node].loop)
+        return node;
+    if (m_nodes[node].star == -1) {
+        Node loop;
+        loop.loop = true;
+        m_nodes.append(loop);
+        m_nodes[node].star = static_cast<int>(m_nodes.size() - 1);
+    }
+    return m_nodes[node].star;
+}
+
+void CompiledMatcher::addSegments(QStringList segments, bool accept, bool subtree, bool literal)
+{
+    // "dir/**" is everything below dir, but not dir itself
+    if (!literal && !segments.isEmpty() && segments.last() == "**") {
+        segments.removeLast();
+        accept = false;
+        subtree = true;
+    }
+
+    int node = 0;
+    for (auto& segment : segments) {
+        node = !literal && segment == "**" ? star(node) : child(node, segment, literal);
+    }
+    m_nodes[node].accept |= accept;
+    m_nodes[node].subtree |= subtree;
+    invalidate();
+}
+
+void CompiledMatcher::invalidate()
+{
+    QMutexLocker locker(&m_lock);
+    m_states.clear();
+    m_stateIds.clear();
+    m_rootState = -1;
+}
+
+void CompiledMatcher::closure(QVector<int>& nodes, int node) const
+{
+    while (node != -1 && !nodes.contains(node)) {
+        nodes.append(node);
+        // a "**" may also stand for no folder at all
+        node = m_nodes[node].star;
+    }
+}
+
+int CompiledMatcher::state(QVector<int> nodes) const
+{
+    std::sort(nodes.begin(), nodes.end());
+    if (auto it = m_stateIds.constFind(nodes); it != m_stateIds.constEnd())
+        return *it;
+
+    State state;
+    for (auto node : nodes) {
+        state.accept |= m_nodes[node].accept;
+        state.subtree |= m_nodes[node].subtree;
+    }
+    state.nodes = nodes;
+    m_states.append(state);
+    int id = static_cast<int>(m_states.size() - 1);
+    m_stateIds.insert(nodes, id);
+    return id;
+}
+
+int CompiledMatcher::step(int from, const QString& segment, bool remember) const
+{
+    // nothing below can stop matching
+    if (m_states[from].subtree)
+        return from;
+
+    auto key = m_caseSensitive ? segment : segment.toLower();
+    if (remember) {
+        if (auto it = m_states[from].next.constFind(key); it != m_states[from].next.constEnd())
+            return *it;
+    }
+
+    QVector<int> next;
+    for (auto index : m_states[from].nodes) {
+        auto& node = m_nodes[index];
+        if (node.loop)
+            closure(next, index);
+        if (auto it = node.literals.constFind(key); it != node.literals.constEnd())
+            closure(next, *it);
+        for (auto& [expression, child] : node.globs) {
+            if (expression.match(key).hasMatch())
+                closure(next, child);
+        }
+    }
+
+    auto to = state(next);
+    if (remember)
+        m_states[from].next.insert(key, to);
+    return to;
+}
+
+int CompiledMatcher::walk(const QStringList& folders) const
+{
+    if (m_rootState == -1) {
+        QVector<int> root;
+        closure(root, 0);
+        m_rootState = state(root);
+    }
+    auto current = m_rootState;
+    for (auto& folder : folders) {
+        current = step(current, folder, true);
+        if (m_states[current].subtree || m_states[current].nodes.isEmpty())
+            break;
+    }
+    return current;
+}
+
+bool CompiledMatcher::matches(const QString& string) const
+{
+    auto segments = string.split('/', Qt::SkipEmptyParts);
+    if (segments.isEmpty())
+        return false;
+    auto file = segments.takeLast();
+
+    QMutexLocker locker(&m_lock);
+    auto folder = walk(segments);
+    if (m_states[folder].subtree)
+        return true;
+    return m_states[step(folder, file, false)].accept;
+}
+
+IPathMatcher::Subtree CompiledMatcher::matchesUnder(const QString& folder) const
+{
+    QMutexLocker locker(&m_lock);
+    auto state = walk(folder.split('/', Qt::SkipEmptyParts));
+    if (m_states[state].subtree)
+        return Subtree::All;
+    if (m_states[state].nodes.isEmpty())
+        return Subtree::None;
+    return Subtree::Some;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QVector>
+#include "IPathMatcher.h"
+
+/**
+ * Many prefixes, globs and gitignore patterns folded into one automaton over the folders of a path.
+ *
+ * A path is read one folder at a time, instead of being tested against every rule in turn. The state reached for each
+ * folder is remembered, so the paths in one folder only pay for their file name, and matchesUnder() tells a walk which
+ * folders it can skip entirely.
+ */
+class CompiledMatcher : public IPathMatcher {
+   public:
+    CompiledMatcher();
+    virtual ~CompiledMatcher() {}
+
+    /// like SimplePrefixMatcher: "dir/" matches everything below dir, anything else only that exact path
+    CompiledMatcher& addPrefix(const QString& prefix);
+    /// a pattern from the root. `*` and `?` stay within one folder, `**` stands for any number of folders
+    CompiledMatcher& addGlob(const QString& glob);
+    /// a .gitignore line. patterns without a slash match at any depth, and a folder matches everything below it.
+    /// negations ("!pattern") are not supported and get ignored
+    CompiledMatcher& addGitignore(const QString& pattern);
+    /// has to be set before adding patterns
+    CompiledMatcher& caseSensitive(bool cs = true);
+
+    bool matches(const QString& string) const override;
+    Subtree matchesUnder(const QString& folder) const override;
+
+   private:
+    struct Node {
+        QHash<QString, int> literals;
+        QList<std::pair<QRegularExpression, int>> globs;
+        /// the node for a `**` following this one
+        int star = -1;
+        /// a `**` node, which takes any folder and stays
+        bool loop = false;
+        /// a path ending here matches
+        bool accept = false;
+        /// every path below here matches
+        bool subtree = false;
+    };
+    struct State {
+        QVector<int> nodes;
+        bool accept = false;
+        bool subtree = false;
+        /// only for folders, the file names would make this grow with the tree
+        QHash<QString, int> next;
+    };
+
+    int child(int node, const QString& segment, bool literal);
+    int star(int node);
+    /// marks the end of a pattern made of `segments` starting at the root
+    void addSegments(QStringList segments, bool accept, bool subtree, bool literal);
+    void closure(QVector<int>& nodes, int node) const;
+    int state(QVector<int> nodes) const;
+    int step(int state, const QString& segment, bool remember) const;
+    /// walks the folders of the path, returns the state it ends in
+    int walk(const QStringList& folders) const;
+    void invalidate();
+
+    QList<Node> m_nodes;
+    bool m_caseSensitive = true;
+
+    /// built lazily while matching
+    mutable QMutex m_lock;
+    mutable QList<State> m_states;
+    mutable QHash<QVector<int>, int> m_stateIds;
+    mutable int m_rootState = -1;
+};
@@ -9,4 +9,9 @@ class IPathMatcher {
    public:
     virtual ~IPathMatcher() {}
     virtual bool matches(const QString& string) const = 0;
+
+    /// what matches() says about every path below a folder
+    enum class Subtree { None, Some, All };
+    /// lets walks skip whole folders. matchers that can't tell say Some
+    virtual Subtree matchesUnder([[maybe_unused]] const QString& folder) const { return Subtree::Some; }
 };
@@ -36,11 +36,17 @@
 #include "ConcurrentTask.h"
 
 #include <QDebug>
+#include <QThread>
+#include <utility>
 #include "tasks/Task.h"
 
 ConcurrentTask::ConcurrentTask(QString task_name, int max_concurrent) : Task(), m_total_max_size(max_concurrent)
 {
     setObjectName(task_name);
+
+    m_progress_timer.setSingleShot(true);
+    m_progress_timer.setInterval(s_progress_interval);
+    connect(&m_progress_timer, &QTimer::timeout, this, &ConcurrentTask::flushProgress);
 }
 
 ConcurrentTask::~ConcurrentTask()
@@ -58,6 +64,7 @@ auto ConcurrentTask::getStepProgress() const -> TaskStepProgressList
 
 void ConcurrentTask::addTask(Task::Ptr task)
 {
+    task->setTraceParent(getUid());
     m_queue.append(task);
 }
 
@@ -70,6 +77,7 @@ void ConcurrentTask::executeTask()
 bool ConcurrentTask::abort()
 {
     m_queue.clear();
+    flushProgress();
 
     if (m_doing.isEmpty()) {
         // Don't call emitAborted() here, we want to bypass the 'is the task running' check
@@ -105,6 +113,13 @@ void ConcurrentTask::clear()
     m_queue.clear();
     m_task_progress.clear();
 
+    m_progress_timer.stop();
+    m_dirty_nested.clear();
+    m_pending_steps.clear();
+    m_pending_order.clear();
+    m_state_dirty = false;
+    m_forward = {};
+
     m_progress = 0;
 }
 
@@ -118,6 +133,9 @@ void ConcurrentTask::executeNextSubTask()
     }
     if (m_queue.isEmpty()) {
         if (m_doing.isEmpty()) {
+            // make sure the last frame gets out before we're done
+            flushProgress();
+
             if (m_failed.isEmpty()) {
                 emitSucceeded();
             } else if (m_failed.count() == 1) {
@@ -157,7 +175,7 @@ void ConcurrentTask::startSubTask(Task::Ptr next)
 
     connect(next.get(), &Task::status, this, [this, next](QString msg) { subTaskStatus(next, msg); });
     connect(next.get(), &Task::details, this, [this, next](QString msg) { subTaskDetails(next, msg); });
-    connect(next.get(), &Task::stepProgress, this, &ConcurrentTask::stepProgress);
+    connect(next.get(), &Task::stepProgress, this, &ConcurrentTask::queueStepProgress);
 
     connect(next.get(), &Task::progress, this, [this, next](qint64 current, qint64 total) { subTaskProgress(next, current, total); });
 
@@ -166,7 +184,12 @@ void ConcurrentTask::startSubTask(Task::Ptr next)
     auto task_progress = std::make_shared<TaskStepProgress>(next->getUid());
     m_task_progress.insert(next->getUid(), task_progress);
 
-    updateState();
+    // nested tasks report to us, and get flushed on our timer instead of their own
+    if (auto nested = qobject_cast<ConcurrentTask*>(next.get()); nested && nested->thread() == thread())
+        nested->m_progress_root = m_progress_root ? m_progress_root.data() : this;
+
+    m_state_dirty = true;
+    scheduleProgressFlush();
 
     QMetaObject::invokeMethod(next.get(), &Task::start, Qt::QueuedConnection);
 }
@@ -184,8 +207,8 @@ void ConcurrentTask::subTaskFinished(Task::Ptr task, TaskStepState state)
 
     disconnect(task.get(), 0, this, 0);
 
-    emit stepProgress(task_progress);
-    updateState();
+    queueStepProgress(task_progress);
+    m_state_dirty = true;
     QMetaObject::invokeMethod(this, &ConcurrentTask::executeNextSubTask, Qt::QueuedConnection);
 }
 
@@ -205,11 +228,8 @@ void ConcurrentTask::subTaskStatus(Task::Ptr task, const QString& msg)
     task_progress->status = msg;
     task_progress->state = TaskStepState::Running;
 
-    emit stepProgress(*task_progress);
-
-    if (totalSize() == 1) {
-        setStatus(msg);
-    }
+    m_forward.status = true;
+    queueStepProgress(*task_progress);
 }
 
 void ConcurrentTask::subTaskDetails(Task::Ptr task, const QString& msg)
@@ -218,11 +238,8 @@ void ConcurrentTask::subTaskDetails(Task::Ptr task, const QString& msg)
     task_progress->details = msg;
     task_progress->state = TaskStepState::Running;
 
-    emit stepProgress(*task_progress);
-
-    if (totalSize() == 1) {
-        setDetails(msg);
-    }
+    m_forward.details = true;
+    queueStepProgress(*task_progress);
 }
 
 void ConcurrentTask::subTaskProgress(Task::Ptr task, qint64 current, qint64 total)
@@ -231,12 +248,71 @@ void ConcurrentTask::subTaskProgress(Task::Ptr task, qint64 current, qint64 tota
 
     task_progress->update(current, total);
 
-    emit stepProgress(*task_progress);
-    updateState();
+    m_forward.progress = true;
+    queueStepProgress(*task_progress);
+}
+
+void ConcurrentTask::queueStepProgress(TaskStepProgress const& task_progress)
+{
+    if (!m_pending_steps.contains(task_progress.uid))
+        m_pending_order.append(task_progress.uid);
+    m_pending_steps.insert(task_progress.uid, task_progress);
+
+    scheduleProgressFlush();
+}
+
+void ConcurrentTask::scheduleProgressFlush()
+{
+    if (auto root = m_progress_root.data()) {
+        if (!root->m_dirty_nested.contains(this))
+            root->m_dirty_nested.append(this);
+        root->scheduleProgressFlush();
+        return;
+    }
+
+    // the timer belongs to our thread, and the task may be poked from elsewhere (e.g. when run() on a pool)
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &ConcurrentTask::scheduleProgressFlush, Qt::QueuedConnection);
+        return;
+    }
+
+    if (!m_progress_timer.isActive())
+        m_progress_timer.start();
+}
 
-    if (totalSize() == 1) {
-        setProgress(task_progress->current, task_progress->total);
+void ConcurrentTask::flushProgress()
+{
+    m_progress_timer.stop();
+
+    // Nested tasks flush into us, so they go first. Flushing one may mark its parent dirty again.
+    while (!m_dirty_nested.isEmpty()) {
+        if (auto nested = m_dirty_nested.takeFirst())
+            nested->flushProgress();
+    }
+
+    if (m_state_dirty) {
+        m_state_dirty = false;
+        updateState();
     }
+
+    auto forward = std::exchange(m_forward, {});
+    if (totalSize() == 1 && m_task_progress.size() == 1) {
+        auto task_progress = m_task_progress.begin().value();
+        if (forward.status)
+            setStatus(task_progress->status);
+        if (forward.details)
+            setDetails(task_progress->details);
+        if (forward.progress)
+            setProgress(task_progress->current, task_progress->total);
+    }
+
+    auto pending = std::exchange(m_pending_steps, {});
+    for (auto const& uid : std::exchange(m_pending_order, {}))
+        emit stepProgress(pending.value(uid));
+
+    // something reacting to the emissions above may have queued more
+    if (!m_pending_steps.isEmpty() || !m_dirty_nested.isEmpty() || m_state_dirty)
+        scheduleProgressFlush();
 }
 
 void ConcurrentTask::updateState()
@@ -36,8 +36,10 @@
 #pragma once
 
 #include <QHash>
+#include <QPointer>
 #include <QQueue>
 #include <QSet>
+#include <QTimer>
 #include <QUuid>
 #include <memory>
 
@@ -46,6 +48,10 @@
 /*!
  * Runs a list of tasks concurrently (according to `max_concurrent` parameter).
  * Behaviour is the same as regular Task (e.g. starts using start())
+ *
+ * Progress coming from sub-tasks is not forwarded as it arrives. It is collected and pushed out
+ * at most once per progress frame, by a single timer owned by the outermost ConcurrentTask.
+ * Up-to-date per-task detail is always available through getStepProgress().
  */
 class ConcurrentTask : public Task {
     Q_OBJECT
@@ -86,6 +92,9 @@ class ConcurrentTask : public Task {
     void subTaskDetails(Task::Ptr task, const QString& msg);
     void subTaskProgress(Task::Ptr task, qint64 current, qint64 total);
 
+    /** Pushes out everything that changed since the last progress frame. */
+    void flushProgress();
+
    protected:
     // NOTE: This is not thread-safe.
     unsigned int totalSize() const { return static_cast<unsigned int>(m_queue.size() + m_doing.size() + m_done.size()); }
@@ -94,6 +103,11 @@ class ConcurrentTask : public Task {
 
     void startSubTask(Task::Ptr task);
 
+    //! Marks the aggregated state as changed, to be pushed out on the next progress frame
+    void scheduleProgressFlush();
+    //! Queues a sub-task's progress for the next progress frame, replacing any older one for the same step
+    void queueStepProgress(TaskStepProgress const& task_progress);
+
    protected:
     QQueue<Task::Ptr> m_queue;
 
@@ -105,4 +119,24 @@ class ConcurrentTask : public Task {
     QHash<QUuid, std::shared_ptr<TaskStepProgress>> m_task_progress;
 
     int m_total_max_size;
+
+   private:
+    // Progress coalescing, see flushProgress()
+    static constexpr int s_progress_interval = 33;  // ms, ~30 frames per second
+
+    QTimer m_progress_timer;
+    // ConcurrentTask that owns the timer, when this one runs nested inside another
+    QPointer<ConcurrentTask> m_progress_root;
+    // nested tasks with pending progress, only used by the root
+    QList<QPointer<ConcurrentTask>> m_dirty_nested;
+
+    QHash<QUuid, TaskStepProgress> m_pending_steps;
+    QList<QUuid> m_pending_order;
+    bool m_state_dirty = false;
+    // what the only sub-task changed, forwarded as our own when there is just one
+    struct {
+        bool progress = false;
+        bool status = false;
+        bool details = false;
+    } m_forward;
 };
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "Executor.h"
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+
+#include <algorithm>
+#include <mutex>
+
+namespace Executor {
+
+struct CancelToken::State {
+    std::atomic_bool cancelled = false;
+    QMutex lock;
+    QList<QFuture<void>> futures;
+};
+
+CancelToken::CancelToken() : m_state(std::make_shared<State>()) {}
+
+void CancelToken::cancel() const
+{
+    m_state->cancelled = true;
+
+    QMutexLocker locker(&m_state->lock);
+    for (auto& future : m_state->futures)
+        future.cancel();
+}
+
+bool CancelToken::isCancelled() const
+{
+    return m_state->cancelled;
+}
+
+std::atomic_bool* CancelToken::flag() const
+{
+    return &m_state->cancelled;
+}
+
+void CancelToken::track(QFuture<void> future) const
+{
+    QMutexLocker locker(&m_state->lock);
+    m_state->futures.removeIf([](const QFuture<void>& tracked) { return tracked.isFinished(); });
+    if (m_state->cancelled)
+        future.cancel();
+    m_state->futures.append(future);
+}
+
+void CancelToken::waitForFinished() const
+{
+    QList<QFuture<void>> futures;
+    {
+        QMutexLocker locker(&m_state->lock);
+        futures = m_state->futures;
+    }
+    for (auto& future : futures)
+        future.waitForFinished();
+}
+
+static void configure(QThreadPool& pool, const char* name, int threads, QThread::Priority threadPriority)
+{
+    pool.setObjectName(name);
+    pool.setMaxThreadCount(threads);
+    pool.setThreadPriority(threadPriority);
+}
+
+QThreadPool* pool(Kind kind, Priority priority)
+{
+    // like the global pool, these wait for their work when they are destroyed on exit
+    static QThreadPool compute;
+    static QThreadPool io;
+    static QThreadPool background;
+    static std::once_flag configured;
+    std::call_once(configured, [] {
+        configure(compute, "ComputePool", QThread::idealThreadCount(), QThread::InheritPriority);
+        configure(io, "IOPool", std::clamp(QThread::idealThreadCount() * 2, 4, 16), QThread::InheritPriority);
+        configure(background, "BackgroundPool", 2, QThread::LowPriority);
+    });
+
+    if (priority == Priority::Background)
+        return &background;
+    return kind == Kind::Compute ? &compute : &io;
+}
+
+void start(Kind kind, Priority priority, QRunnable* runnable)
+{
+    pool(kind, priority)->start(runnable, static_cast<int>(priority));
+}
+
+}  // namespace Executor
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QFuture>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * Where the launcher runs its background work, instead of QThreadPool::globalInstance().
+ *
+ * Work is sorted by what it waits on and how soon it is needed:
+ *  - Compute work (hashing, parsing) runs on one thread per core.
+ *  - IO work (copying, extracting, walking folders) runs on a wider pool, since its threads mostly wait on the disk.
+ *  - Background work of either kind runs on a small pool of low priority threads, so it can never hold up anything a
+ *    user is waiting on. A slow world size scan no longer delays the mod list.
+ * Within a pool, interactive work is taken before normal work.
+ *
+ * Waiting on a job that has not started yet runs it on the waiting thread instead of blocking, so a thread waiting on
+ * queued work picks up that work itself.
+ */
+namespace Executor {
+
+enum class Kind { Compute, IO };
+
+/** Within a pool, queued work of a higher priority starts first. */
+enum class Priority { Background = 0, Normal = 1, Interactive = 2 };
+
+/**
+ * Cancellation shared between a task and the work it started. Copies refer to the same state.
+ *
+ * Cancelling drops tracked work that has not started yet. Running work has to check isCancelled() or flag() itself.
+ * Tasks keep one and cancel it from abort().
+ */
+class CancelToken {
+   public:
+    CancelToken();
+
+    void cancel() const;
+    bool isCancelled() const;
+    /** For code that takes a plain flag, like FS::copy::cancelled(). Valid as long as a copy of the token is. */
+    std::atomic_bool* flag() const;
+
+    /** Cancels the future along with the token, right away if the token already is. */
+    void track(QFuture<void> future) const;
+    /** Waits for all tracked work to end. */
+    void waitForFinished() const;
+
+   private:
+    struct State;
+    std::shared_ptr<State> m_state;
+};
+
+QThreadPool* pool(Kind kind, Priority priority = Priority::Normal);
+
+/** Runs the callable on the pool for its kind and priority. */
+template <typename Function>
+auto run(Kind kind, Priority priority, Function&& function)
+{
+    return QtConcurrent::task(std::forward<Function>(function)).onThreadPool(*pool(kind, priority)).withPriority(static_cast<int>(priority)).spawn();
+}
+
+/** Like run(), with the work dropped if the token gets cancelled before it starts. */
+template <typename Function>
+auto run(Kind kind, Priority priority, const CancelToken& token, Function&& function)
+{
+    auto future = run(kind, priority, std::forward<Function>(function));
+    token.track(QFuture<void>(future));
+    return future;
+}
+
+/** Starts a runnable, such as a Task, on the pool for its kind and priority. */
+void start(Kind kind, Priority priority, QRunnable* runnable);
+
+}  // namespace Executor
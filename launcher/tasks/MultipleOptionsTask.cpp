@@ -41,11 +41,13 @@ MultipleOptionsTask::MultipleOptionsTask(const QString& task_name) : ConcurrentT
 void MultipleOptionsTask::executeNextSubTask()
 {
     if (m_done.size() != m_failed.size()) {
+        flushProgress();
         emitSucceeded();
         return;
     }
 
     if (m_queue.isEmpty()) {
+        flushProgress();
         emitFailed(tr("All attempts have failed!"));
         qWarning() << "All attempts have failed!";
         return;
@@ -38,6 +38,8 @@
 
 #include <QDebug>
 
+#include "TaskTrace.h"
+
 Q_LOGGING_CATEGORY(taskLogC, "launcher.task")
 
 Task::Task(bool show_debug) : m_show_debug(show_debug)
@@ -103,7 +105,11 @@ void Task::start()
     }
     // NOTE: only fall through to here in end states
     m_state = State::Running;
+    if (TaskTrace::isEnabled())
+        TaskTrace::taskStarted(this);
     emit started();
+
+    TaskTrace::ExecutionScope scope(this);
     executeTask();
 }
 
@@ -116,6 +122,8 @@ void Task::emitFailed(QString reason)
     }
     m_state = State::Failed;
     m_failReason = reason;
+    if (TaskTrace::isEnabled())
+        TaskTrace::taskFinished(this);
     qCCritical(taskLogC) << "Task" << describe() << "failed: " << reason;
     emit failed(reason);
     emit finished();
@@ -130,6 +138,8 @@ void Task::emitAborted()
     }
     m_state = State::AbortedByUser;
     m_failReason = "Aborted.";
+    if (TaskTrace::isEnabled())
+        TaskTrace::taskFinished(this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "aborted.";
     emit aborted();
@@ -144,6 +154,8 @@ void Task::emitSucceeded()
         return;
     }
     m_state = State::Succeeded;
+    if (TaskTrace::isEnabled())
+        TaskTrace::taskFinished(this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "succeeded";
     emit succeeded();
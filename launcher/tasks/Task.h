@@ -121,11 +121,15 @@ class Task : public QObject, public QRunnable {
     QString getStatus() { return m_status; }
     QString getDetails() { return m_details; }
 
-    qint64 getProgress() { return m_progress; }
-    qint64 getTotalProgress() { return m_progressTotal; }
+    qint64 getProgress() const { return m_progress; }
+    qint64 getTotalProgress() const { return m_progressTotal; }
     virtual auto getStepProgress() const -> TaskStepProgressList { return {}; }
 
-    QUuid getUid() { return m_uid; }
+    QUuid getUid() const { return m_uid; }
+
+    //! The task this one is a part of, as shown in task traces.
+    QUuid traceParent() const { return m_traceParent; }
+    void setTraceParent(QUuid parent) { m_traceParent = parent; }
 
    protected:
     void logWarning(const QString& line);
@@ -197,8 +201,8 @@ class Task : public QObject, public QRunnable {
     QString m_failReason = "";
     QString m_status;
     QString m_details;
-    int m_progress = 0;
-    int m_progressTotal = 100;
+    qint64 m_progress = 0;
+    qint64 m_progressTotal = 100;
 
     // TODO: Nuke in favor of QLoggingCategory
     bool m_show_debug = true;
@@ -207,4 +211,5 @@ class Task : public QObject, public QRunnable {
     // Change using setAbortStatus
     bool m_can_abort = false;
     QUuid m_uid;
+    QUuid m_traceParent;
 };
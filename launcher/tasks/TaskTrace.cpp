@@ -0,0 +1,330 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "TaskTrace.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+#include "FileSystem.h"
+#include "tasks/Task.h"
+
+namespace TaskTrace {
+
+namespace {
+struct Span {
+    QString type;
+    QString name;
+    QUuid id;
+    QUuid parent;
+    int thread = 0;
+    qint64 begin = 0;
+    qint64 end = 0;
+    Task::State state = Task::State::Running;
+    qint64 progress = 0;
+    qint64 total = 0;
+};
+
+struct Histogram {
+    QString type;
+    QList<qint64> durations;  // in microseconds, sorted
+    qint64 totalDuration = 0;
+};
+
+// upper bounds of the histogram buckets, in milliseconds
+constexpr std::array<qint64, 15> s_bucketBounds = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000 };
+
+// far more than a busy session produces, it only keeps a forgotten trace from using up the memory
+constexpr qsizetype s_maxSpans = 200000;
+
+QMutex s_lock;
+QHash<const Task*, Span> s_open;
+QList<Span> s_spans;
+qsizetype s_dropped = 0;
+QHash<Qt::HANDLE, int> s_threads;
+QStringList s_threadNames;
+
+thread_local const Task* t_executing = nullptr;
+
+qint64 now()
+{
+    static const auto s_epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+// call with s_lock held
+int currentThreadIndex()
+{
+    auto handle = QThread::currentThreadId();
+    if (auto index = s_threads.constFind(handle); index != s_threads.constEnd())
+        return *index;
+
+    auto thread = QThread::currentThread();
+    auto name = thread->objectName();
+    if (auto app = QCoreApplication::instance(); app && app->thread() == thread)
+        name = "Main thread";
+    else if (name.isEmpty())
+        name = QString("Thread %1").arg(s_threadNames.size());
+
+    s_threadNames.append(name);
+    s_threads.insert(handle, s_threadNames.size());
+    return s_threadNames.size();
+}
+
+QString stateName(Task::State state)
+{
+    switch (state) {
+        case Task::State::Succeeded:
+            return "succeeded";
+        case Task::State::Failed:
+            return "failed";
+        case Task::State::AbortedByUser:
+            return "aborted";
+        default:
+            return "running";
+    }
+}
+
+// call with s_lock held
+QList<Histogram> histograms()
+{
+    QHash<QString, Histogram> by_type;
+    for (auto& span : s_spans) {
+        auto& histogram = by_type[span.type];
+        histogram.type = span.type;
+        histogram.durations.append(span.end - span.begin);
+        histogram.totalDuration += span.end - span.begin;
+    }
+    auto result = by_type.values();
+    for (auto& histogram : result)
+        std::sort(histogram.durations.begin(), histogram.durations.end());
+    // the types that cost the most time overall first
+    std::sort(result.begin(), result.end(), [](const Histogram& a, const Histogram& b) { return a.totalDuration > b.totalDuration; });
+    return result;
+}
+
+double percentileMs(const QList<qint64>& sorted, double percentile)
+{
+    auto index = std::min<qsizetype>(sorted.size() - 1, static_cast<qsizetype>(percentile * sorted.size()));
+    return sorted.at(index) / 1000.0;
+}
+
+QList<qint64> bucketCounts(const QList<qint64>& sorted)
+{
+    QList<qint64> counts(s_bucketBounds.size() + 1, 0);
+    for (auto duration : sorted) {
+        auto bucket = std::lower_bound(s_bucketBounds.begin(), s_bucketBounds.end(), duration, [](qint64 bound, qint64 duration) {
+            return bound * 1000 < duration;
+        });
+        counts[bucket - s_bucketBounds.begin()]++;
+    }
+    return counts;
+}
+}  // namespace
+
+void setEnabled(bool enabled)
+{
+    if (g_enabled.exchange(enabled) == enabled)
+        return;
+    qDebug() << "Task tracing" << (enabled ? "enabled" : "disabled");
+    if (!enabled) {
+        // these won't be told they finished anymore
+        QMutexLocker locker(&s_lock);
+        s_open.clear();
+    }
+}
+
+bool enabledByEnvironment()
+{
+    auto value = qEnvironmentVariable("ALLAUNCHER_TASK_TRACE");
+    return !value.isEmpty() && value != "0";
+}
+
+void taskStarted(const Task* task)
+{
+    Span span;
+    span.type = task->metaObject()->className();
+    span.name = task->objectName();
+    span.id = task->getUid();
+    span.parent = task->traceParent();
+    if (span.parent.isNull() && t_executing && t_executing != task)
+        span.parent = t_executing->getUid();
+    span.begin = now();
+
+    QMutexLocker locker(&s_lock);
+    span.thread = currentThreadIndex();
+    s_open.insert(task, span);
+}
+
+void taskFinished(const Task* task)
+{
+    auto end = now();
+
+    QMutexLocker locker(&s_lock);
+    auto open = s_open.find(task);
+    // started before tracing was switched on
+    if (open == s_open.end())
+        return;
+    auto span = *open;
+    s_open.erase(open);
+
+    if (s_spans.size() >= s_maxSpans) {
+        s_dropped++;
+        return;
+    }
+    span.end = end;
+    span.state = task->getState();
+    span.progress = task->getProgress();
+    span.total = task->getTotalProgress();
+    s_spans.append(span);
+}
+
+ExecutionScope::ExecutionScope(const Task* task)
+{
+    if (!isEnabled())
+        return;
+    m_active = true;
+    m_previous = t_executing;
+    t_executing = task;
+}
+
+ExecutionScope::~ExecutionScope()
+{
+    if (m_active)
+        t_executing = m_previous;
+}
+
+QByteArray toChromeTrace()
+{
+    QMutexLocker locker(&s_lock);
+
+    QJsonArray events;
+    for (int i = 0; i < s_threadNames.size(); i++) {
+        events.append(QJsonObject{
+            { "ph", "M" }, { "name", "thread_name" }, { "pid", 1 }, { "tid", i + 1 }, { "args", QJsonObject{ { "name", s_threadNames.at(i) } } } });
+    }
+    for (auto& span : s_spans) {
+        QJsonObject args{ { "id", span.id.toString(QUuid::WithoutBraces) },
+                          { "result", stateName(span.state) },
+                          { "progress", span.progress },
+                          { "total", span.total } };
+        if (!span.parent.isNull())
+            args["parent"] = span.parent.toString(QUuid::WithoutBraces);
+        events.append(QJsonObject{ { "name", span.name.isEmpty() ? span.type : QString("%1 %2").arg(span.type, span.name) },
+                                   { "cat", span.type },
+                                   { "ph", "X" },
+                                   { "ts", span.begin },
+                                   { "dur", span.end - span.begin },
+                                   { "pid", 1 },
+                                   { "tid", span.thread },
+                                   { "args", args } });
+    }
+
+    QJsonObject latency;
+    for (auto& histogram : histograms()) {
+        QJsonArray buckets;
+        auto counts = bucketCounts(histogram.durations);
+        for (qsizetype i = 0; i < counts.size(); i++) {
+            buckets.append(QJsonObject{ { "le", i < qsizetype(s_bucketBounds.size()) ? QJsonValue(s_bucketBounds[i]) : QJsonValue("inf") },
+                                        { "count", counts.at(i) } });
+        }
+        latency[histogram.type] = QJsonObject{ { "count", histogram.durations.size() },
+                                               { "p50Ms", percentileMs(histogram.durations, 0.5) },
+                                               { "p90Ms", percentileMs(histogram.durations, 0.9) },
+                                               { "p99Ms", percentileMs(histogram.durations, 0.99) },
+                                               { "maxMs", histogram.durations.last() / 1000.0 },
+                                               { "totalMs", histogram.totalDuration / 1000.0 },
+                                               { "bucketsMs", buckets } };
+    }
+
+    QJsonObject root{ { "traceEvents", events },
+                      { "displayTimeUnit", "ms" },
+                      { "otherData", QJsonObject{ { "droppedTasks", s_dropped }, { "latencyHistogram", latency } } } };
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QString latencyHistogram()
+{
+    QMutexLocker locker(&s_lock);
+
+    QString out;
+    QTextStream stream(&out);
+    stream << "Task latency by type, in milliseconds. Buckets are counts of tasks up to";
+    for (auto bound : s_bucketBounds)
+        stream << ' ' << bound;
+    stream << " ms and above.\n";
+    for (auto& histogram : histograms()) {
+        stream << histogram.type << ": " << histogram.durations.size() << " tasks, total " << histogram.totalDuration / 1000.0
+               << ", p50 " << percentileMs(histogram.durations, 0.5) << ", p90 " << percentileMs(histogram.durations, 0.9) << ", p99 "
+               << percentileMs(histogram.durations, 0.99) << ", max " << histogram.durations.last() / 1000.0 << "\n    buckets:";
+        for (auto count : bucketCounts(histogram.durations))
+            stream << ' ' << count;
+        stream << '\n';
+    }
+    if (s_dropped)
+        stream << s_dropped << " tasks were not recorded because the trace was full\n";
+    return out;
+}
+
+QString dump(const QString& folder)
+{
+    {
+        QMutexLocker locker(&s_lock);
+        if (s_spans.isEmpty())
+            return {};
+    }
+    if (!FS::ensureFolderPathExists(folder))
+        return {};
+
+    auto base = FS::PathCombine(folder, QString("task-trace-%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+    QFile trace(base + ".json");
+    QFile histogram(base + ".txt");
+    if (!trace.open(QIODevice::WriteOnly | QIODevice::Truncate) || !histogram.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Couldn't write the task trace to" << folder;
+        return {};
+    }
+    trace.write(toChromeTrace());
+    histogram.write(latencyHistogram().toUtf8());
+    clear();
+
+    qDebug() << "Wrote task trace to" << trace.fileName();
+    return trace.fileName();
+}
+
+void clear()
+{
+    QMutexLocker locker(&s_lock);
+    s_spans.clear();
+    s_dropped = 0;
+}
+
+}  // namespace TaskTrace
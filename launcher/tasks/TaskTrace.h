@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QUuid>
+
+#include <atomic>
+
+class Task;
+
+/**
+ * Opt-in record of every task that runs: when it started and ended, on which thread, under which parent task and how
+ * far its progress got, which is the number of bytes for downloads and file operations.
+ *
+ * It is switched on from the settings or with the ALLAUNCHER_TASK_TRACE environment variable. While it is off, tasks
+ * only pay for one relaxed atomic load when they start and finish.
+ */
+namespace TaskTrace {
+
+inline std::atomic_bool g_enabled = false;
+
+inline bool isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+void setEnabled(bool enabled);
+/** Whether ALLAUNCHER_TASK_TRACE asks for tracing regardless of the settings. */
+bool enabledByEnvironment();
+
+void taskStarted(const Task* task);
+void taskFinished(const Task* task);
+
+/** Makes the task the parent of tasks started on this thread while it is executing. */
+class ExecutionScope {
+   public:
+    explicit ExecutionScope(const Task* task);
+    ~ExecutionScope();
+
+   private:
+    bool m_active = false;
+    const Task* m_previous = nullptr;
+};
+
+/** Everything recorded so far, in the Chrome trace event format that chrome://tracing and ui.perfetto.dev open. */
+QByteArray toChromeTrace();
+/** How long tasks took, by type. */
+QString latencyHistogram();
+/**
+ * Writes the trace and the histogram into the folder and forgets them.
+ * \return the path of the trace, or an empty string if there was nothing to write or it failed
+ */
+QString dump(const QString& folder);
+void clear();
+
+}  // namespace TaskTrace
@@ -219,11 +219,30 @@ void ResourceUpdateDialog::checkCandidates()
             static FlameAPI api;
 
             auto dependencyExtraInfo = depTask->getExtraInfo();
+            auto dependencies = depTask->getDependecies();
+
+            // CurseForge hands out changelogs one file at a time, so get all of them in one go
+            QHash<QString, std::shared_ptr<QByteArray>> flameChangelogs;
+            auto changelogTask = makeShared<ConcurrentTask>("Get changelogs");
+            for (const auto& dep : dependencies) {
+                if (dep->pack->provider != ModPlatform::ResourceProvider::FLAME)
+                    continue;
+                auto response = std::make_shared<QByteArray>();
+                flameChangelogs.insert(dep->version.fileId.toString(), response);
+                changelogTask->addTask(api.getModFileChangelog(dep->version.addonId.toInt(), dep->version.fileId.toInt(), response));
+            }
+            if (!flameChangelogs.isEmpty()) {
+                ProgressDialog progress_dialog_changelogs(m_parent);
+                progress_dialog_changelogs.setSkipButton(true, tr("Skip"));
+                progress_dialog_changelogs.setWindowTitle(tr("Getting changelogs..."));
+                // the changelogs are nice to have, carry on whatever happens to them
+                progress_dialog_changelogs.execWithTask(changelogTask.get());
+            }
 
-            for (const auto& dep : depTask->getDependecies()) {
+            for (const auto& dep : dependencies) {
                 auto changelog = dep->version.changelog;
-                if (dep->pack->provider == ModPlatform::ResourceProvider::FLAME)
-                    changelog = api.getModFileChangelog(dep->version.addonId.toInt(), dep->version.fileId.toInt());
+                if (auto response = flameChangelogs.value(dep->version.fileId.toString()); response)
+                    changelog = FlameAPI::loadDataString(*response);
                 auto download_task = makeShared<ResourceDownloadTask>(dep->pack, dep->version, m_resource_model);
                 auto extraInfo = dependencyExtraInfo.value(dep->version.addonId.toString());
                 CheckUpdateTask::Update updatable = {
@@ -68,8 +68,34 @@ static void viewItemTextLayout(QTextLayout& textLayout, int lineWidth, qreal& he
     textLayout.endLayout();
 }
 
+size_t qHash(const TextLayoutKey& key, size_t seed)
+{
+    return qHashMulti(seed, key.text, key.font, key.width, key.alignment, key.direction);
+}
+
 ListViewDelegate::ListViewDelegate(QObject* parent) : QStyledItemDelegate(parent) {}
 
+const CachedTextLayout* ListViewDelegate::textLayout(const QStyleOptionViewItem& opt, int width) const
+{
+    const auto alignment = QStyle::visualAlignment(opt.direction, opt.displayAlignment);
+    const TextLayoutKey key{ opt.text, opt.font.key(), width, static_cast<int>(alignment), static_cast<int>(opt.direction) };
+    if (auto cached = m_textLayoutCache.object(key)) {
+        return cached;
+    }
+
+    auto cached = new CachedTextLayout;
+    QTextOption textOption;
+    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    textOption.setTextDirection(opt.direction);
+    textOption.setAlignment(alignment);
+    cached->layout.setTextOption(textOption);
+    cached->layout.setFont(opt.font);
+    cached->layout.setText(opt.text);
+    viewItemTextLayout(cached->layout, width, cached->height, cached->widthUsed);
+    m_textLayoutCache.insert(key, cached);
+    return cached;
+}
+
 void drawSelectionRect(QPainter* painter, const QStyleOptionViewItem& option, const QRect& rect)
 {
     if ((option.state & QStyle::State_Selected))
@@ -159,23 +185,6 @@ void drawBadges(QPainter* painter, const QStyleOptionViewItem& option, BaseInsta
     painter->translate(-option.rect.topLeft());
 }
 
-static QSize viewItemTextSize(const QStyleOptionViewItem* option)
-{
-    QStyle* style = option->widget ? option->widget->style() : QApplication::style();
-    QTextOption textOption;
-    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    QTextLayout textLayout;
-    textLayout.setTextOption(textOption);
-    textLayout.setFont(option->font);
-    textLayout.setText(option->text);
-    const int textMargin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, option, option->widget) + 1;
-    QRect bounds(0, 0, 100 - 2 * textMargin, 600);
-    qreal height = 0, widthUsed = 0;
-    viewItemTextLayout(textLayout, bounds.width(), height, widthUsed);
-    const QSize size(qCeil(widthUsed), qCeil(height));
-    return QSize(size.width() + 2 * textMargin, size.height());
-}
-
 void ListViewDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
 {
     QStyleOptionViewItem opt = option;
@@ -286,24 +295,16 @@ void ListViewDelegate::paint(QPainter* painter, const QStyleOptionViewItem& opti
     }
 
     // draw the text
-    QTextOption textOption;
-    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    textOption.setTextDirection(opt.direction);
-    textOption.setAlignment(QStyle::visualAlignment(opt.direction, opt.displayAlignment));
-    QTextLayout textLayout;
-    textLayout.setTextOption(textOption);
-    textLayout.setFont(opt.font);
-    textLayout.setText(opt.text);
-
-    qreal width, height;
-    viewItemTextLayout(textLayout, textRect.width(), height, width);
+    auto cachedLayout = textLayout(opt, textRect.width());
+    const QTextLayout& layout = cachedLayout->layout;
 
-    const int lineCount = textLayout.lineCount();
+    const int lineCount = layout.lineCount();
 
-    const QRect layoutRect = QStyle::alignedRect(opt.direction, opt.displayAlignment, QSize(textRect.width(), int(height)), textRect);
+    const QRect layoutRect =
+        QStyle::alignedRect(opt.direction, opt.displayAlignment, QSize(textRect.width(), int(cachedLayout->height)), textRect);
     const QPointF position = layoutRect.topLeft();
     for (int i = 0; i < lineCount; ++i) {
-        const QTextLine line = textLayout.lineAt(i);
+        const QTextLine line = layout.lineAt(i);
         line.draw(painter, position);
     }
 
@@ -331,8 +332,7 @@ QSize ListViewDelegate::sizeHint(const QStyleOptionViewItem& option, const QMode
     QStyle* style = opt.widget ? opt.widget->style() : QApplication::style();
     const int textMargin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, &option, opt.widget) + 1;
     int height = 48 + textMargin * 2 + 5;  // TODO: turn constants into variables
-    QSize szz = viewItemTextSize(&opt);
-    height += szz.height();
+    height += qCeil(textLayout(opt, 100 - 2 * textMargin)->height);
     // FIXME: maybe the icon items could scale and keep proportions?
     QSize sz(100, height);
     return sz;
@@ -17,6 +17,29 @@
 
 #include <QCache>
 #include <QStyledItemDelegate>
+#include <QTextLayout>
+
+/// the wrapped title of an item only depends on these, so its layout can be reused across paints
+struct TextLayoutKey {
+    QString text;
+    QString font;
+    int width;
+    int alignment;
+    int direction;
+
+    bool operator==(const TextLayoutKey& other) const
+    {
+        return width == other.width && alignment == other.alignment && direction == other.direction && text == other.text &&
+               font == other.font;
+    }
+};
+size_t qHash(const TextLayoutKey& key, size_t seed = 0);
+
+struct CachedTextLayout {
+    QTextLayout layout;
+    qreal height = 0;
+    qreal widthUsed = 0;
+};
 
 class ListViewDelegate : public QStyledItemDelegate {
     Q_OBJECT
@@ -38,4 +61,10 @@ class ListViewDelegate : public QStyledItemDelegate {
 
    private slots:
     void editingDone();
+
+   private:
+    /// the title of the item wrapped to the given width. the returned pointer is only valid until the next call.
+    const CachedTextLayout* textLayout(const QStyleOptionViewItem& option, int width) const;
+
+    mutable QCache<TextLayoutKey, CachedTextLayout> m_textLayoutCache{ 1024 };
 };
@@ -47,6 +47,7 @@
 #include <QPersistentModelIndex>
 #include <QScrollBar>
 #include <QtMath>
+#include <algorithm>
 
 #include "VisualGroup.h"
 #include "ui/themes/CatPainter.h"
@@ -89,26 +90,55 @@ void InstanceView::setModel(QAbstractItemModel* model)
     QAbstractItemView::setModel(model);
     connect(model, &QAbstractItemModel::modelReset, this, &InstanceView::modelReset);
     connect(model, &QAbstractItemModel::rowsRemoved, this, &InstanceView::rowsRemoved);
+    // sorting moves rows around without saying which, so every group is looked at again. before the view lays itself out
+    connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &InstanceView::modelReset);
+    connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, &InstanceView::modelReset);
 }
 
-void InstanceView::dataChanged([[maybe_unused]] const QModelIndex& topLeft,
-                               [[maybe_unused]] const QModelIndex& bottomRight,
-                               [[maybe_unused]] const QList<int>& roles)
+void InstanceView::dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles)
 {
+    // only the text and the group affect the layout, anything else (progress, icons, ...) just needs a repaint
+    if (!roles.isEmpty() && !roles.contains(Qt::DisplayRole) && !roles.contains(InstanceViewRoles::GroupRole)) {
+        for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+            update(model()->index(row, 0));
+        }
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        markGroupDirty(row);
+    }
     scheduleDelayedItemsLayout();
 }
-void InstanceView::rowsInserted([[maybe_unused]] const QModelIndex& parent, [[maybe_unused]] int start, [[maybe_unused]] int end)
+void InstanceView::rowsInserted([[maybe_unused]] const QModelIndex& parent, int start, int end)
 {
+    if (!m_allGroupsDirty && start <= m_rowGroups.size()) {
+        for (int row = start; row <= end; row++) {
+            const QString group = model()->index(row, 0).data(InstanceViewRoles::GroupRole).toString();
+            m_rowGroups.insert(row, group);
+            m_dirtyGroups.insert(group);
+        }
+    } else {
+        markAllGroupsDirty();
+    }
     scheduleDelayedItemsLayout();
 }
 
-void InstanceView::rowsAboutToBeRemoved([[maybe_unused]] const QModelIndex& parent, [[maybe_unused]] int start, [[maybe_unused]] int end)
+void InstanceView::rowsAboutToBeRemoved([[maybe_unused]] const QModelIndex& parent, int start, int end)
 {
+    if (!m_allGroupsDirty && end < m_rowGroups.size()) {
+        for (int row = start; row <= end; row++) {
+            m_dirtyGroups.insert(m_rowGroups[row]);
+        }
+        m_rowGroups.remove(start, end - start + 1);
+    } else {
+        markAllGroupsDirty();
+    }
     scheduleDelayedItemsLayout();
 }
 
 void InstanceView::modelReset()
 {
+    markAllGroupsDirty();
     scheduleDelayedItemsLayout();
 }
 
@@ -117,6 +147,25 @@ void InstanceView::rowsRemoved()
     scheduleDelayedItemsLayout();
 }
 
+void InstanceView::markGroupDirty(int row)
+{
+    if (m_allGroupsDirty || row >= m_rowGroups.size()) {
+        markAllGroupsDirty();
+        return;
+    }
+    // the row may have left its old group, so both the old and the current group need a new flow
+    const QString group = model()->index(row, 0).data(InstanceViewRoles::GroupRole).toString();
+    m_dirtyGroups.insert(m_rowGroups[row]);
+    m_dirtyGroups.insert(group);
+    m_rowGroups[row] = group;
+}
+
+void InstanceView::markAllGroupsDirty()
+{
+    m_allGroupsDirty = true;
+    m_dirtyGroups.clear();
+}
+
 void InstanceView::currentChanged(const QModelIndex& current, const QModelIndex& previous)
 {
     QAbstractItemView::currentChanged(current, previous);
@@ -178,29 +227,55 @@ void InstanceView::updateGeometries()
 {
     m_geometryCache.clear();
 
-    QMap<LocaleString, VisualGroup*> cats;
+    // the group of each row is kept up to date as rows change, it only has to be asked for after a reset
+    const int rowCount = model()->rowCount();
+    if (m_allGroupsDirty || m_rowGroups.size() != rowCount) {
+        m_allGroupsDirty = true;
+        m_rowGroups.resize(rowCount);
+        for (int i = 0; i < rowCount; ++i) {
+            m_rowGroups[i] = model()->index(i, 0).data(InstanceViewRoles::GroupRole).toString();
+        }
+    }
+
+    // sort the rows into their groups in one pass over the model
+    QMap<LocaleString, QList<QModelIndex>> members;
+    for (int i = 0; i < rowCount; ++i) {
+        members[m_rowGroups[i]].append(model()->index(i, 0));
+    }
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        const QString groupName = model()->index(i, 0).data(InstanceViewRoles::GroupRole).toString();
-        if (!cats.contains(groupName)) {
-            VisualGroup* old = this->category(groupName);
-            if (old) {
-                auto cat = new VisualGroup(old);
-                cats.insert(groupName, cat);
-                cat->update();
-            } else {
-                auto cat = new VisualGroup(groupName, this);
-                if (m_fVisibility) {
-                    cat->collapsed = m_fVisibility(groupName);
-                }
-                cats.insert(groupName, cat);
-                cat->update();
+    // reuse the existing groups, only flow those whose items changed
+    QHash<QString, VisualGroup*> groupsByName;
+    QList<VisualGroup*> groups;
+    groups.reserve(members.size());
+    for (auto it = members.cbegin(); it != members.cend(); ++it) {
+        const QString& groupName = it.key();
+        VisualGroup* cat = m_groupsByName.take(groupName);
+        if (!cat) {
+            cat = new VisualGroup(groupName, this);
+            if (m_fVisibility) {
+                cat->collapsed = m_fVisibility(groupName);
             }
         }
+        const bool itemsChanged = cat->setItems(it.value());
+        if (itemsChanged || m_allGroupsDirty || m_dirtyGroups.contains(groupName)) {
+            cat->update();
+        }
+        groupsByName.insert(groupName, cat);
+        groups.append(cat);
     }
 
-    qDeleteAll(m_groups);
-    m_groups = cats.values();
+    // what is left over has no items anymore
+    for (auto cat : m_groupsByName) {
+        if (cat == m_pressedCategory) {
+            m_pressedCategory = nullptr;
+        }
+    }
+    qDeleteAll(m_groupsByName);
+    m_groupsByName = groupsByName;
+    m_groups = groups;
+    m_dirtyGroups.clear();
+    m_allGroupsDirty = false;
+
     updateScrollbar();
     viewport()->update();
 }
@@ -222,23 +297,28 @@ VisualGroup* InstanceView::category(const QModelIndex& index) const
 
 VisualGroup* InstanceView::category(const QString& cat) const
 {
-    for (auto group : m_groups) {
-        if (group->text == cat) {
-            return group;
-        }
-    }
-    return nullptr;
+    return m_groupsByName.value(cat, nullptr);
+}
+
+int InstanceView::groupIndexAtOrBelow(int y) const
+{
+    auto it = std::partition_point(m_groups.cbegin(), m_groups.cend(),
+                                   [y](const VisualGroup* group) { return group->verticalPosition() + group->totalHeight() <= y; });
+    return static_cast<int>(it - m_groups.cbegin());
 }
 
 VisualGroup* InstanceView::categoryAt(const QPoint& pos, VisualGroup::HitResults& result) const
 {
-    for (auto group : m_groups) {
-        result = group->hitScan(pos);
-        if (result != VisualGroup::NoHit) {
-            return group;
-        }
-    }
     result = VisualGroup::NoHit;
+    const int groupIndex = groupIndexAtOrBelow(pos.y());
+    if (groupIndex >= m_groups.size()) {
+        return nullptr;
+    }
+    auto group = m_groups.at(groupIndex);
+    result = group->hitScan(pos);
+    if (result != VisualGroup::NoHit) {
+        return group;
+    }
     return nullptr;
 }
 
@@ -507,10 +587,17 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
         return;
     }
 
+    // only groups and rows intersecting the exposed area get painted
+    const QRect exposed = event->rect().translated(offset());
+    const int firstGroup = groupIndexAtOrBelow(exposed.top());
+
     int wpWidth = viewport()->width();
     option.rect.setWidth(wpWidth);
-    for (int i = 0; i < m_groups.size(); ++i) {
+    for (int i = firstGroup; i < m_groups.size(); ++i) {
         VisualGroup* category = m_groups.at(i);
+        if (category->verticalPosition() > exposed.bottom()) {
+            break;
+        }
         int y = category->verticalPosition();
         y -= verticalOffset();
         QRect backup = option.rect;
@@ -520,28 +607,41 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
         option.rect.setLeft(m_leftMargin);
         option.rect.setRight(wpWidth - m_rightMargin);
         category->drawHeader(&painter, option);
-        y += category->totalHeight() + m_categoryMargin;
         option.rect = backup;
     }
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        const QModelIndex index = model()->index(i, 0);
-        if (isIndexHidden(index)) {
-            continue;
+    for (int i = firstGroup; i < m_groups.size(); ++i) {
+        VisualGroup* category = m_groups.at(i);
+        if (category->verticalPosition() > exposed.bottom()) {
+            break;
         }
-        Qt::ItemFlags flags = index.flags();
-        option.rect = visualRect(index);
-        option.features |= QStyleOptionViewItem::WrapText;
-        if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index)) {
-            option.state |= selectionModel()->isSelected(index) ? QStyle::State_Selected : QStyle::State_None;
-        } else {
-            option.state &= ~QStyle::State_Selected;
+        if (category->collapsed) {
+            continue;
         }
-        option.state |= (index == currentIndex()) ? QStyle::State_HasFocus : QStyle::State_None;
-        if (!(flags & Qt::ItemIsEnabled)) {
-            option.state &= ~QStyle::State_Enabled;
+        const int bodyTop = category->verticalPosition() + category->headerHeight() + 5;
+        for (auto& row : category->rows) {
+            if (bodyTop + row.top > exposed.bottom()) {
+                break;
+            }
+            if (bodyTop + row.top + row.height < exposed.top()) {
+                continue;
+            }
+            for (auto& index : row.items) {
+                Qt::ItemFlags flags = index.flags();
+                option.rect = visualRect(index);
+                option.features |= QStyleOptionViewItem::WrapText;
+                if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index)) {
+                    option.state |= selectionModel()->isSelected(index) ? QStyle::State_Selected : QStyle::State_None;
+                } else {
+                    option.state &= ~QStyle::State_Selected;
+                }
+                option.state |= (index == currentIndex()) ? QStyle::State_HasFocus : QStyle::State_None;
+                if (!(flags & Qt::ItemIsEnabled)) {
+                    option.state &= ~QStyle::State_Enabled;
+                }
+                itemDelegate()->paint(&painter, option, index);
+            }
         }
-        itemDelegate()->paint(&painter, option, index);
     }
 
     /*
@@ -582,6 +682,7 @@ void InstanceView::resizeEvent([[maybe_unused]] QResizeEvent* event)
     if (newItemsPerRow != m_currentItemsPerRow) {
         m_currentCursorColumn = -1;
         m_currentItemsPerRow = newItemsPerRow;
+        markAllGroupsDirty();
         updateGeometries();
     } else {
         updateScrollbar();
@@ -732,11 +833,27 @@ QModelIndex InstanceView::indexAt(const QPoint& point) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        QModelIndex index = model()->index(i, 0);
-        if (visualRect(index).contains(point)) {
-            return index;
-        }
+    const QPoint geometryPos = point + offset();
+    const int groupIndex = groupIndexAtOrBelow(geometryPos.y());
+    if (groupIndex >= m_groups.size()) {
+        return QModelIndex();
+    }
+    const VisualGroup* group = m_groups.at(groupIndex);
+    if (group->collapsed) {
+        return QModelIndex();
+    }
+
+    const int bodyTop = group->verticalPosition() + group->headerHeight() + 5;
+    const int row = group->rowAt(geometryPos.y() - bodyTop);
+    const int column = (geometryPos.x() - m_spacing) / (itemWidth() + m_spacing);
+    if (row < 0 || geometryPos.x() < m_spacing || column >= group->rows[row].size()) {
+        return QModelIndex();
+    }
+
+    // items in a row can be shorter than the row itself
+    const QModelIndex index = group->rows[row].items[column];
+    if (visualRect(index).contains(point)) {
+        return index;
     }
     return QModelIndex();
 }
@@ -745,12 +862,21 @@ void InstanceView::setSelection(const QRect& rect, const QItemSelectionModel::Se
 {
     executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        QModelIndex index = model()->index(i, 0);
-        QRect itemRect = visualRect(index);
-        if (itemRect.intersects(rect)) {
-            selectionModel()->select(index, commands);
-            update(itemRect.translated(-offset()));
+    const QRect area = rect.normalized().translated(offset());
+    for (int i = groupIndexAtOrBelow(area.top()); i < m_groups.size(); ++i) {
+        const VisualGroup* group = m_groups.at(i);
+        if (group->verticalPosition() > area.bottom()) {
+            break;
+        }
+        if (group->collapsed) {
+            continue;
+        }
+        for (auto& index : group->items()) {
+            QRect itemRect = visualRect(index);
+            if (itemRect.intersects(rect)) {
+                selectionModel()->select(index, commands);
+                update(itemRect.translated(-offset()));
+            }
         }
     }
 }
@@ -36,9 +36,11 @@
 #pragma once
 
 #include <QCache>
+#include <QHash>
 #include <QLineEdit>
 #include <QListView>
 #include <QScrollBar>
+#include <QSet>
 #include <functional>
 #include "VisualGroup.h"
 #include "ui/themes/CatPainter.h"
@@ -115,7 +117,14 @@ class InstanceView : public QAbstractItemView {
 
    private:
     friend struct VisualGroup;
+    /// groups, sorted by name and by vertical position
     QList<VisualGroup*> m_groups;
+    QHash<QString, VisualGroup*> m_groupsByName;
+    /// group name of every model row, updated along with the rows unless all groups are dirty anyway
+    QList<QString> m_rowGroups;
+    /// groups that need to be flowed again on the next layout
+    QSet<QString> m_dirtyGroups;
+    bool m_allGroupsDirty = true;
 
     visibilityFunction m_fVisibility;
 
@@ -135,18 +144,22 @@ class InstanceView : public QAbstractItemView {
     QPoint m_pressedPosition;
     QPersistentModelIndex m_pressedIndex;
     bool m_pressedAlreadySelected;
-    VisualGroup* m_pressedCategory;
+    VisualGroup* m_pressedCategory = nullptr;
     QItemSelectionModel::SelectionFlag m_ctrlDragSelectionFlag;
     QPoint m_lastDragPosition;
 
     VisualGroup* category(const QModelIndex& index) const;
     VisualGroup* category(const QString& cat) const;
     VisualGroup* categoryAt(const QPoint& pos, VisualGroup::HitResults& result) const;
+    /// index into m_groups of the first group whose bottom edge is below y
+    int groupIndexAtOrBelow(int y) const;
 
     int itemsPerRow() const { return m_currentItemsPerRow; };
     int contentWidth() const;
 
    private: /* methods */
+    void markGroupDirty(int row);
+    void markAllGroupsDirty();
     int itemWidth() const;
     int calculateItemsPerRow() const;
     int verticalScrollToValue(const QModelIndex& index, const QRect& rect, QListView::ScrollHint hint) const;
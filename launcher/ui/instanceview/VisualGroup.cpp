@@ -41,6 +41,7 @@
 #include <QModelIndex>
 #include <QPainter>
 #include <QtMath>
+#include <algorithm>
 #include <utility>
 
 #include "InstanceView.h"
@@ -52,7 +53,7 @@ VisualGroup::VisualGroup(const VisualGroup* other) : view(other->view), text(oth
 void VisualGroup::update()
 {
     auto temp_items = items();
-    auto itemsPerRow = view->itemsPerRow();
+    auto itemsPerRow = qMax(1, view->itemsPerRow());
 
     int numRows = qMax(1, qCeil((qreal)temp_items.size() / (qreal)itemsPerRow));
     rows = QList<VisualRow>(numRows);
@@ -87,6 +88,45 @@ void VisualGroup::update()
     rows[currentRow].top = offsetFromTop;
 }
 
+bool VisualGroup::setItems(const QList<QModelIndex>& newItems)
+{
+    bool same = newItems.size() == m_items.size();
+    for (int i = 0; same && i < newItems.size(); i++) {
+        same = m_items[i] == newItems[i];
+    }
+    if (!same) {
+        m_items.clear();
+        m_items.reserve(newItems.size());
+        for (auto& item : newItems) {
+            m_items.append(item);
+        }
+        return true;
+    }
+    // same items in the same order, but their rows may have shifted. the flow stays valid, only refresh the indices.
+    int i = 0;
+    for (auto& row : rows) {
+        for (auto& item : row.items) {
+            if (i < newItems.size()) {
+                item = newItems[i++];
+            }
+        }
+    }
+    return false;
+}
+
+int VisualGroup::rowAt(int y) const
+{
+    auto it = std::upper_bound(rows.cbegin(), rows.cend(), y, [](int pos, const VisualRow& row) { return pos < row.top; });
+    if (it == rows.cbegin()) {
+        return -1;
+    }
+    --it;
+    if (y >= it->top + it->height) {
+        return -1;
+    }
+    return static_cast<int>(it - rows.cbegin());
+}
+
 QPair<int, int> VisualGroup::positionOf(const QModelIndex& index) const
 {
     int y = 0;
@@ -255,10 +295,10 @@ int VisualGroup::verticalPosition() const
 QList<QModelIndex> VisualGroup::items() const
 {
     QList<QModelIndex> indices;
-    for (int i = 0; i < view->model()->rowCount(); ++i) {
-        const QModelIndex index = view->model()->index(i, 0);
-        if (index.data(InstanceViewRoles::GroupRole).toString() == text) {
-            indices.append(index);
+    indices.reserve(m_items.size());
+    for (auto& item : m_items) {
+        if (item.isValid()) {
+            indices.append(item);
         }
     }
     return indices;
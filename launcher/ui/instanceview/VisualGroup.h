@@ -36,6 +36,7 @@
 #pragma once
 
 #include <QList>
+#include <QPersistentModelIndex>
 #include <QRect>
 #include <QString>
 #include <QStyleOption>
@@ -64,11 +65,16 @@ struct VisualGroup {
     QList<VisualRow> rows;
     int firstItemIndex = 0;
     int m_verticalPosition = 0;
+    /// the items of this group, in model order. kept persistent so they survive row moves in other groups.
+    QList<QPersistentModelIndex> m_items;
 
     /* logic */
-    /// update the internal list of items and flow them into the rows.
+    /// flow the current items into the rows.
     void update();
 
+    /// replace the items of this group. returns true if membership or order changed and the group needs to be flowed again.
+    bool setItems(const QList<QModelIndex>& items);
+
     /// draw the header at y-position.
     void drawHeader(QPainter* painter, const QStyleOptionViewItem& option) const;
 
@@ -99,6 +105,9 @@ struct VisualGroup {
     /// x/y position of the given item inside the group (in items!)
     QPair<int, int> positionOf(const QModelIndex& index) const;
 
+    /// index of the visual row containing the relative y position, or -1
+    int rowAt(int y) const;
+
     enum HitResult { NoHit = 0x0, TextHit = 0x1, CheckboxHit = 0x2, HeaderHit = 0x4, BodyHit = 0x8 };
     Q_DECLARE_FLAGS(HitResults, HitResult)
 
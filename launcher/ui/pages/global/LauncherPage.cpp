@@ -214,6 +214,7 @@ void LauncherPage::applySettings()
     s->set("NumberOfConcurrentDownloads", ui->numberOfConcurrentDownloadsSpinBox->value());
     s->set("NumberOfManualRetries", ui->numberOfManualRetriesSpinBox->value());
     s->set("RequestTimeout", ui->timeoutSecondsSpinBox->value());
+    s->set("TaskTracing", ui->taskTracingCheckBox->isChecked());
 
     // Console settings
     s->set("ConsoleMaxLines", ui->lineLimitSpinBox->value());
@@ -276,6 +277,7 @@ void LauncherPage::loadSettings()
     ui->numberOfConcurrentDownloadsSpinBox->setValue(s->get("NumberOfConcurrentDownloads").toInt());
     ui->numberOfManualRetriesSpinBox->setValue(s->get("NumberOfManualRetries").toInt());
     ui->timeoutSecondsSpinBox->setValue(s->get("RequestTimeout").toInt());
+    ui->taskTracingCheckBox->setChecked(s->get("TaskTracing").toBool());
 
     // Console settings
     ui->lineLimitSpinBox->setValue(s->get("ConsoleMaxLines").toInt());
@@ -520,8 +520,22 @@ void FlameManagedPackPage::suggestVersion()
     }
     auto version = m_pack.versions.at(index);
 
-    ui->changelogTextBrowser->setHtml(
-        StringUtils::htmlListPatch(m_api.getModFileChangelog(m_inst->getManagedPackID().toInt(), version.fileId)));
+    ui->changelogTextBrowser->setText(tr("Fetching changelogs..."));
+
+    if (m_changelog_job && m_changelog_job->isRunning())
+        m_changelog_job->abort();
+
+    auto response = std::make_shared<QByteArray>();
+    auto fileId = version.fileId;
+    m_changelog_job = m_api.getModFileChangelog(m_inst->getManagedPackID().toInt(), fileId, response);
+    connect(m_changelog_job.get(), &Task::succeeded, this, [this, response, fileId] {
+        // another version may have been picked in the meantime
+        auto index = ui->versionsComboBox->currentIndex();
+        if (index < 0 || index >= m_pack.versions.length() || m_pack.versions.at(index).fileId != fileId)
+            return;
+        ui->changelogTextBrowser->setHtml(StringUtils::htmlListPatch(FlameAPI::loadDataString(*response)));
+    });
+    m_changelog_job->start();
 
     ManagedPackPage::suggestVersion();
 }
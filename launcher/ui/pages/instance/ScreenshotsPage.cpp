@@ -40,9 +40,12 @@
 #include "ui_ScreenshotsPage.h"
 
 #include <QClipboard>
+#include <QCryptographicHash>
+#include <QDirIterator>
 #include <QEvent>
 #include <QFileIconProvider>
 #include <QFileSystemModel>
+#include <QImageReader>
 #include <QKeyEvent>
 #include <QLineEdit>
 #include <QMap>
@@ -51,6 +54,7 @@
 #include <QMutableListIterator>
 #include <QPainter>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QSet>
 #include <QStyledItemDelegate>
 
@@ -62,6 +66,7 @@
 #include "net/NetJob.h"
 #include "screenshots/ImgurAlbumCreation.h"
 #include "screenshots/ImgurUpload.h"
+#include "tasks/Executor.h"
 #include "tasks/SequentialTask.h"
 
 #include <DesktopServices.h>
@@ -83,31 +88,56 @@ class ThumbnailingResult : public QObject {
 
 class ThumbnailRunnable : public QRunnable {
    public:
-    ThumbnailRunnable(QString path, SharedIconCachePtr cache)
+    ThumbnailRunnable(QString path, SharedIconCachePtr cache, QString thumbnailDir)
     {
         m_path = path;
         m_cache = cache;
+        m_thumbnailDir = thumbnailDir;
     }
     void run()
     {
         QFileInfo info(m_path);
-        if (info.isDir())
-            return;
-        if ((info.suffix().compare("png", Qt::CaseInsensitive) != 0))
+        if (info.isDir() || (info.suffix().compare("png", Qt::CaseInsensitive) != 0)) {
+            m_resultEmitter.emitResultsFailed(m_path);
             return;
-        if (!m_cache->stale(m_path))
+        }
+        if (!m_cache->stale(m_path)) {
+            m_resultEmitter.emitResultsReady(m_path);
             return;
-        QImage image(m_path);
+        }
+        QImage square = loadStoredThumbnail(info);
+        if (square.isNull()) {
+            square = createThumbnail();
+            if (square.isNull()) {
+                m_resultEmitter.emitResultsFailed(m_path);
+                qDebug() << "Error loading screenshot: " + m_path + ". Perhaps too large?";
+                return;
+            }
+            storeThumbnail(info, square);
+        }
+
+        QIcon icon(QPixmap::fromImage(square));
+        m_cache->add(m_path, icon);
+        m_resultEmitter.emitResultsReady(m_path);
+    }
+
+    QImage createThumbnail() const
+    {
+        QImageReader reader(m_path);
+        const QSize size = reader.size();
+        // let the decoder scale down, so a 4K screenshot never sits in memory at full size
+        if (size.isValid() && (size.width() > 512 || size.height() > 512)) {
+            reader.setScaledSize(size.scaled(512, 512, Qt::KeepAspectRatio));
+        }
+        QImage image = reader.read();
         if (image.isNull()) {
-            m_resultEmitter.emitResultsFailed(m_path);
-            qDebug() << "Error loading screenshot: " + m_path + ". Perhaps too large?";
-            return;
+            return {};
         }
         QImage small;
         if (image.width() > image.height())
-            small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
+            small = image.scaledToWidth(256, Qt::SmoothTransformation);
         else
-            small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
+            small = image.scaledToHeight(256, Qt::SmoothTransformation);
         QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
         QImage square(QSize(256, 256), QImage::Format_ARGB32);
         square.fill(Qt::transparent);
@@ -115,12 +145,68 @@ class ThumbnailRunnable : public QRunnable {
         QPainter painter(&square);
         painter.drawImage(offset, small);
         painter.end();
+        return square;
+    }
 
-        QIcon icon(QPixmap::fromImage(square));
-        m_cache->add(m_path, icon);
-        m_resultEmitter.emitResultsReady(m_path);
+    // Thumbnails are stored like the freedesktop.org thumbnail spec does it: named after the md5 of the file URI, with the
+    // modification time and size of the original stored inside the PNG, so a changed screenshot is never shown with an old thumbnail.
+    QString thumbnailPath(const QFileInfo& info) const
+    {
+        auto hash = QCryptographicHash::hash(fileUri(info).toUtf8(), QCryptographicHash::Md5);
+        return FS::PathCombine(m_thumbnailDir, QString::fromLatin1(hash.toHex()) + ".png");
     }
+    static QString fileUri(const QFileInfo& info) { return QUrl::fromLocalFile(info.absoluteFilePath()).toString(QUrl::FullyEncoded); }
+
+    static bool describes(QImageReader& reader, const QFileInfo& info)
+    {
+        return reader.text("Thumb::URI") == fileUri(info) &&
+               reader.text("Thumb::MTime") == QString::number(info.lastModified().toSecsSinceEpoch()) &&
+               reader.text("Thumb::Size") == QString::number(info.size());
+    }
+
+    QImage loadStoredThumbnail(const QFileInfo& info) const
+    {
+        QImageReader reader(thumbnailPath(info));
+        if (!describes(reader, info)) {
+            return {};
+        }
+        return reader.read();
+    }
+
+    // the thumbnails of all instances share one folder, so this goes by the screenshot each of them names
+    static void pruneStoredThumbnails(const QString& thumbnailDir)
+    {
+        QDirIterator it(thumbnailDir, { "*.png" }, QDir::Files);
+        while (it.hasNext()) {
+            auto path = it.next();
+            bool current;
+            {
+                QImageReader reader(path);
+                QFileInfo screenshot(QUrl(reader.text("Thumb::URI")).toLocalFile());
+                current = screenshot.isFile() && describes(reader, screenshot);
+            }
+            if (!current) {
+                QFile::remove(path);
+            }
+        }
+    }
+
+    void storeThumbnail(const QFileInfo& info, QImage thumbnail) const
+    {
+        if (!FS::ensureFolderPathExists(m_thumbnailDir)) {
+            return;
+        }
+        thumbnail.setText("Thumb::URI", fileUri(info));
+        thumbnail.setText("Thumb::MTime", QString::number(info.lastModified().toSecsSinceEpoch()));
+        thumbnail.setText("Thumb::Size", QString::number(info.size()));
+        QSaveFile file(thumbnailPath(info));
+        if (file.open(QIODevice::WriteOnly) && thumbnail.save(&file, "PNG")) {
+            file.commit();
+        }
+    }
+
     QString m_path;
+    QString m_thumbnailDir;
     SharedIconCachePtr m_cache;
     ThumbnailingResult m_resultEmitter;
 };
@@ -133,9 +219,18 @@ class FilterModel : public QIdentityProxyModel {
     explicit FilterModel(QObject* parent = 0) : QIdentityProxyModel(parent)
     {
         m_thumbnailingPool.setMaxThreadCount(4);
+        m_thumbnailDir = QDir("cache/screenshots").absolutePath();
         m_thumbnailCache = std::make_shared<SharedIconCache>();
         m_thumbnailCache->add("placeholder", APPLICATION->getThemedIcon("screenshot-placeholder"));
         connect(&watcher, &QFileSystemWatcher::fileChanged, this, &FilterModel::fileChanged);
+
+        // screenshots that were deleted or changed since leave their thumbnails behind, clear those once per run
+        static bool s_pruned = false;
+        if (!s_pruned) {
+            s_pruned = true;
+            Executor::run(Executor::Kind::IO, Executor::Priority::Background,
+                          [dir = m_thumbnailDir] { ThumbnailRunnable::pruneStoredThumbnails(dir); });
+        }
     }
     virtual ~FilterModel()
     {
@@ -165,6 +260,7 @@ class FilterModel : public QIdentityProxyModel {
                 return temp;
             }
             if (!m_failed.contains(filePath)) {
+                // views only keep asking for what they paint, so whatever is asked for again goes first
                 ((FilterModel*)this)->thumbnailImage(filePath);
             }
             return (m_thumbnailCache->get("placeholder"));
@@ -190,14 +286,37 @@ class FilterModel : public QIdentityProxyModel {
    private:
     void thumbnailImage(QString path)
     {
-        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
+        if (auto queued = m_pending.value(path)) {
+            // not started yet, move it to the front of the queue
+            if (m_thumbnailingPool.tryTake(queued)) {
+                m_thumbnailingPool.start(queued, ++m_priority);
+            }
+            return;
+        }
+        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache, m_thumbnailDir);
         connect(&runnable->m_resultEmitter, &ThumbnailingResult::resultsReady, this, &FilterModel::thumbnailReady);
         connect(&runnable->m_resultEmitter, &ThumbnailingResult::resultsFailed, this, &FilterModel::thumbnailFailed);
-        m_thumbnailingPool.start(runnable);
+        m_pending.insert(path, runnable);
+        m_thumbnailingPool.start(runnable, ++m_priority);
     }
    private slots:
-    void thumbnailReady(QString path) { emit layoutChanged(); }
-    void thumbnailFailed(QString path) { m_failed.insert(path); }
+    void thumbnailReady(QString path)
+    {
+        m_pending.remove(path);
+        auto model = qobject_cast<QFileSystemModel*>(sourceModel());
+        if (!model) {
+            return;
+        }
+        auto index = mapFromSource(model->index(path));
+        if (index.isValid()) {
+            emit dataChanged(index, index, { Qt::DecorationRole });
+        }
+    }
+    void thumbnailFailed(QString path)
+    {
+        m_pending.remove(path);
+        m_failed.insert(path);
+    }
     void fileChanged(QString filepath)
     {
         m_thumbnailCache->setStale(filepath);
@@ -211,7 +330,11 @@ class FilterModel : public QIdentityProxyModel {
 
    private:
     SharedIconCachePtr m_thumbnailCache;
+    QString m_thumbnailDir;
     QThreadPool m_thumbnailingPool;
+    /// thumbnails that were queued but did not finish yet. only used to re-prioritize, the pool owns them
+    QHash<QString, QRunnable*> m_pending;
+    int m_priority = 0;
     QSet<QString> m_failed;
     QSet<QString> watched;
     QFileSystemWatcher watcher;
@@ -4,6 +4,7 @@
 #include "modplatform/ModIndex.h"
 #include "modplatform/ResourceAPI.h"
 #include "modplatform/flame/FlameAPI.h"
+#include "modplatform/helpers/ApiResponseCache.h"
 #include "ui/widgets/ProjectItem.h"
 
 #include "net/ApiDownload.h"
@@ -186,16 +187,16 @@ void ListModel::performPaginatedSearch()
     ResourceAPI::SortingMethod sort{};
     sort.index = currentSort + 1;
 
-    auto netJob = makeShared<NetJob>("Flame::Search", APPLICATION->network());
     auto searchUrl =
         FlameAPI().getSearchURL({ ModPlatform::ResourceType::Modpack, nextSearchOffset, currentSearchTerm, sort, m_filter->loaders,
                                   m_filter->versions, ModPlatform::Side::NoSide, m_filter->categoryIds, m_filter->openSource });
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(searchUrl.value()), response));
-    jobPtr = netJob;
+    auto job = APPLICATION->apiResponseCache()->get(QUrl(searchUrl.value()), response, ApiResponseCache::SearchMaxAge);
+    // cached responses finish right away, so connect before starting
+    connect(job.get(), &Task::succeeded, this, &ListModel::searchRequestFinished);
+    connect(job.get(), &Task::failed, this, &ListModel::searchRequestFailed);
+    jobPtr = job;
     jobPtr->start();
-    connect(netJob.get(), &NetJob::succeeded, this, &ListModel::searchRequestFinished);
-    connect(netJob.get(), &NetJob::failed, this, &ListModel::searchRequestFailed);
 }
 
 void ListModel::searchWithTerm(const QString& term, int sort, std::shared_ptr<ModFilterWidget::Filter> filter, bool filterChanged)
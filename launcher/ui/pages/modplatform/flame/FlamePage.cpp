@@ -321,10 +321,24 @@ void FlamePage::updateUi()
     }
 
     text += "<hr>";
-    text += api.getModDescription(current.addonId).toUtf8();
 
     ui->packDescription->setHtml(StringUtils::htmlListPatch(text + current.description));
     ui->packDescription->flush();
+
+    if (m_descriptionTask && m_descriptionTask->isRunning())
+        m_descriptionTask->abort();
+
+    auto response = std::make_shared<QByteArray>();
+    auto addonId = current.addonId;
+    m_descriptionTask = api.getModDescription(addonId, response);
+    connect(m_descriptionTask.get(), &Task::succeeded, this, [this, response, addonId, text] {
+        // the selection may have moved on while this was loading
+        if (current.addonId != addonId)
+            return;
+        ui->packDescription->setHtml(StringUtils::htmlListPatch(text + FlameAPI::loadDataString(*response) + current.description));
+        ui->packDescription->flush();
+    });
+    m_descriptionTask->start();
 }
 QString FlamePage::getSerachTerm() const
 {
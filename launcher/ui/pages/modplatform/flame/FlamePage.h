@@ -102,4 +102,5 @@ class FlamePage : public QWidget, public ModpackProviderBasePage {
 
     std::unique_ptr<ModFilterWidget> m_filterWidget;
     Task::Ptr m_categoriesTask;
+    Task::Ptr m_descriptionTask;
 };
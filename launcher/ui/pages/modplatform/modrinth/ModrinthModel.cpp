@@ -38,6 +38,7 @@
 
 #include "BuildConfig.h"
 #include "Json.h"
+#include "modplatform/helpers/ApiResponseCache.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "net/NetJob.h"
 #include "ui/widgets/ProjectItem.h"
@@ -157,10 +158,9 @@ void ModpackListModel::performPaginatedSearch()
         ModrinthAPI().getSearchURL({ ModPlatform::ResourceType::Modpack, nextSearchOffset, currentSearchTerm, sort, m_filter->loaders,
                                      m_filter->versions, ModPlatform::Side::NoSide, m_filter->categoryIds, m_filter->openSource });
 
-    auto netJob = makeShared<NetJob>("Modrinth::SearchModpack", APPLICATION->network());
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(searchUrl.value()), m_allResponse));
+    auto job = APPLICATION->apiResponseCache()->get(QUrl(searchUrl.value()), m_allResponse, ApiResponseCache::SearchMaxAge);
 
-    connect(netJob.get(), &NetJob::succeeded, this, [this] {
+    connect(job.get(), &Task::succeeded, this, [this] {
         QJsonParseError parseError{};
 
         QJsonDocument doc = QJsonDocument::fromJson(*m_allResponse, &parseError);
@@ -173,9 +173,9 @@ void ModpackListModel::performPaginatedSearch()
 
         searchRequestFinished(doc);
     });
-    connect(netJob.get(), &NetJob::failed, this, &ModpackListModel::searchRequestFailed);
+    connect(job.get(), &Task::failed, this, &ModpackListModel::searchRequestFailed);
 
-    jobPtr = netJob;
+    jobPtr = job;
     jobPtr->start();
 }
 
@@ -349,11 +349,14 @@ void ModpackListModel::searchRequestForOneSucceeded(QJsonDocument& doc)
 
 void ModpackListModel::searchRequestFailed(QString)
 {
-    auto failed_action = dynamic_cast<NetJob*>(jobPtr.get())->getFailedActions().at(0);
-    if (failed_action->replyStatusCode() == -1) {
+    int status_code = -1;
+    if (auto* job = dynamic_cast<ApiResponseTask*>(jobPtr.get()))
+        status_code = job->replyStatusCode();
+
+    if (status_code == -1) {
         // Network error
         QMessageBox::critical(nullptr, tr("Error"), tr("A network error occurred. Could not load modpacks."));
-    } else if (failed_action->replyStatusCode() == 409) {
+    } else if (status_code == 409) {
         // 409 Gone, notify user to update
         QMessageBox::critical(nullptr, tr("Error"),
                               //: %1 refers to the launcher itself
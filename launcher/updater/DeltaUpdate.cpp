@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "DeltaUpdate.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+
+#include "FileSystem.h"
+#include "Json.h"
+#include "net/ChecksumValidator.h"
+#include "net/Download.h"
+
+const QString DeltaUpdate::installedManifestName = QStringLiteral("release_files.json");
+// what the full release archives ship to tell the updater what they consist of
+static const QString archiveManifestName = QStringLiteral("manifest.txt");
+
+static bool isInsideRelease(const QString& path)
+{
+    auto clean = QDir::cleanPath(path);
+    return !clean.isEmpty() && clean != "." && QDir::isRelativePath(clean) && !clean.startsWith("../") && clean != "..";
+}
+
+/** The files below @p dir that manifest.txt names, as top level names and patterns or as paths. */
+static QStringList filesFromArchiveManifest(const QDir& dir)
+{
+    QString contents;
+    try {
+        contents = QString::fromUtf8(FS::read(dir.absoluteFilePath(archiveManifestName)));
+    } catch (const FS::FileSystemException&) {
+        return {};
+    }
+
+    QStringList files;
+    auto add = [&files, &dir](const QString& path) {
+        auto relative = dir.relativeFilePath(path);
+        if (!files.contains(relative))
+            files.append(relative);
+    };
+    for (auto entry : contents.split('\n')) {
+        entry = entry.trimmed();
+        if (!isInsideRelease(entry))
+            continue;
+        QFileInfoList matches;
+        if (entry.contains('/'))
+            matches.append(QFileInfo(dir.absoluteFilePath(entry)));
+        else
+            matches = dir.entryInfoList({ entry }, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+        for (auto& match : matches) {
+            if (match.isDir() && !match.isSymLink()) {
+                QDirIterator it(match.absoluteFilePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+                while (it.hasNext())
+                    add(it.next());
+            } else if (match.exists()) {
+                add(match.absoluteFilePath());
+            }
+        }
+    }
+    return files;
+}
+
+std::optional<DeltaUpdate> DeltaUpdate::fromManifest(const QByteArray& data, const QUrl& url, QString* error)
+{
+    DeltaUpdate update;
+    update.m_data = data;
+    try {
+        auto doc = Json::requireDocument(data, "Release manifest");
+        auto root = Json::requireObject(doc, "Release manifest");
+        if (auto version = Json::ensureInteger(root, "formatVersion", 1); version != 1)
+            throw Json::JsonException(QObject::tr("Unsupported manifest format version %1").arg(version));
+
+        // files are looked up next to the manifest unless it says otherwise
+        auto base = Json::ensureString(root, "base", "./");
+        if (!base.endsWith('/'))
+            base += '/';
+        update.m_base = url.resolved(QUrl(base));
+
+        for (auto value : Json::requireArray(root, "files")) {
+            auto obj = Json::requireObject(value, "File");
+            File file;
+            file.path = QDir::cleanPath(Json::requireString(obj, "path"));
+            file.size = static_cast<qint64>(Json::requireDouble(obj, "size"));
+            file.sha256 = Json::requireString(obj, "sha256").toLower();
+            file.executable = Json::ensureBoolean(obj, QString("executable"), false);
+            // the manifest decides what gets written, so it must not point outside the installation
+            if (!isInsideRelease(file.path))
+                throw Json::JsonException(QObject::tr("Invalid file path '%1'").arg(file.path));
+            update.m_files.append(file);
+        }
+    } catch (const Json::JsonException& e) {
+        if (error)
+            *error = e.cause();
+        return std::nullopt;
+    }
+    return update;
+}
+
+void DeltaUpdate::plan(const QString& root)
+{
+    m_root = root;
+    m_changed.clear();
+    m_removed.clear();
+
+    QDir dir(root);
+    QSet<QString> listed;
+    for (auto& file : m_files) {
+        listed.insert(file.path);
+        QFileInfo info(dir.absoluteFilePath(file.path));
+        // the size already tells most changed files apart, without reading them
+        if (!info.isFile() || info.size() != file.size || sha256(info.absoluteFilePath()) != file.sha256)
+            m_changed.append(file);
+    }
+
+    QStringList installed_files;
+    auto installed_path = dir.absoluteFilePath(installedManifestName);
+    if (QFileInfo(installed_path).isFile()) {
+        try {
+            if (auto installed = fromManifest(FS::read(installed_path), QUrl::fromLocalFile(installed_path))) {
+                for (auto& file : installed->m_files)
+                    installed_files.append(file.path);
+            }
+        } catch (const FS::FileSystemException& e) {
+            qWarning() << "Unable to read the installed release manifest:" << e.cause();
+        }
+    } else {
+        // installed from a full archive, which only leaves the list of what it unpacked
+        installed_files = filesFromArchiveManifest(dir);
+    }
+    for (auto& path : installed_files) {
+        if (!listed.contains(path) && path != installedManifestName && QFileInfo::exists(dir.absoluteFilePath(path)))
+            m_removed.append(path);
+    }
+}
+
+qint64 DeltaUpdate::downloadSize() const
+{
+    qint64 size = 0;
+    for (auto& file : m_changed)
+        size += file.size;
+    return size;
+}
+
+QUrl DeltaUpdate::urlFor(const File& file) const
+{
+    QUrl relative;
+    relative.setPath(file.path);
+    return m_base.resolved(relative);
+}
+
+bool DeltaUpdate::stageLocal(const QString& staging, QString* error) const
+{
+    for (auto& file : m_changed) {
+        auto source = urlFor(file).toLocalFile();
+        auto target = FS::PathCombine(staging, file.path);
+        FS::ensureFilePathExists(target);
+        QFile::remove(target);
+        if (!QFile::copy(source, target)) {
+            if (error)
+                *error = QObject::tr("Unable to copy %1").arg(source);
+            return false;
+        }
+        if (sha256(target) != file.sha256) {
+            if (error)
+                *error = QObject::tr("%1 does not match the release manifest").arg(source);
+            return false;
+        }
+    }
+    return true;
+}
+
+NetJob::Ptr DeltaUpdate::stageJob(const QString& staging, shared_qobject_ptr<QNetworkAccessManager> network) const
+{
+    auto job = makeShared<NetJob>("DeltaUpdate", network);
+    for (auto& file : m_changed) {
+        auto download = Net::Download::makeFile(urlFor(file), FS::PathCombine(staging, file.path));
+        download->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha256, file.sha256));
+        job->addNetAction(download);
+    }
+    return job;
+}
+
+static bool moveFile(const QString& from, const QString& to)
+{
+    FS::ensureFilePathExists(to);
+    QFile::remove(to);
+    if (QFile::rename(from, to))
+        return true;
+    // staging or backup may be on another filesystem
+    return QFile::copy(from, to) && QFile::remove(from);
+}
+
+bool DeltaUpdate::apply(const QString& staging, const QString& backup, QString* error) const
+{
+    QDir root(m_root);
+    QStringList backed_up;
+    QStringList installed;
+
+    auto fail = [&](const QString& reason) {
+        for (auto& path : installed)
+            QFile::remove(root.absoluteFilePath(path));
+        for (auto it = backed_up.crbegin(); it != backed_up.crend(); ++it)
+            moveFile(FS::PathCombine(backup, *it), root.absoluteFilePath(*it));
+        if (error)
+            *error = reason;
+        return false;
+    };
+
+    // running executables and loaded libraries can be renamed even where they can not be overwritten
+    for (auto& file : m_changed) {
+        auto target = root.absoluteFilePath(file.path);
+        QFileInfo existing(target);
+        bool replaced = existing.exists();
+        auto permissions = replaced ? existing.permissions() : QFile::Permissions();
+        if (replaced) {
+            if (!moveFile(target, FS::PathCombine(backup, file.path)))
+                return fail(QObject::tr("Unable to back up %1").arg(target));
+            backed_up.append(file.path);
+        }
+        if (!moveFile(FS::PathCombine(staging, file.path), target))
+            return fail(QObject::tr("Unable to install %1").arg(target));
+        installed.append(file.path);
+
+        if (file.executable)
+            permissions |= QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner | QFile::ExeGroup | QFile::ExeOther;
+        if (replaced || file.executable)
+            QFile::setPermissions(target, permissions);
+    }
+    for (auto& path : m_removed) {
+        if (!moveFile(root.absoluteFilePath(path), FS::PathCombine(backup, path)))
+            return fail(QObject::tr("Unable to back up %1").arg(root.absoluteFilePath(path)));
+        backed_up.append(path);
+    }
+
+    try {
+        FS::write(root.absoluteFilePath(installedManifestName), m_data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Unable to save the release manifest:" << e.cause();
+    }
+    return true;
+}
+
+QString DeltaUpdate::sha256(const QString& file)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&f))
+        return {};
+    return QString::fromLatin1(hash.result().toHex());
+}
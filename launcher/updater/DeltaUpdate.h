@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  ALLauncher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+#include <optional>
+
+#include "QObjectPtr.h"
+#include "net/NetJob.h"
+
+/**
+ * Updates an installation by replacing only the files that differ from a release's file manifest.
+ *
+ * A manifest lists every file of a release build:
+ *
+ *     { "formatVersion": 1, "base": "files/", "files": [ { "path": "bin/allauncher", "size": 1234, "sha256": "...", "executable": true } ] }
+ *
+ * Files are fetched from "base", resolved against the manifest's own URL, or from next to the manifest when there is no
+ * base. That way a plain directory holding a manifest and the unpacked release can stand in for the release server.
+ */
+class DeltaUpdate {
+   public:
+    struct File {
+        QString path;
+        qint64 size = 0;
+        QString sha256;
+        bool executable = false;
+    };
+
+    /** Name of the copy of the manifest kept in the installation, used to find files a later release drops. */
+    static const QString installedManifestName;
+
+    /** Reads a manifest that was fetched from @p url. */
+    static std::optional<DeltaUpdate> fromManifest(const QByteArray& data, const QUrl& url, QString* error = nullptr);
+
+    /**
+     * Compares the manifest with the installation in @p root.
+     * What the installed release consists of comes from its saved manifest, or from manifest.txt after a full install.
+     */
+    void plan(const QString& root);
+
+    /** Files that are missing or differ from the release, valid after plan(). */
+    const QList<File>& changed() const { return m_changed; }
+    /** Files of the installed release that this one no longer has. */
+    const QStringList& removed() const { return m_removed; }
+    qint64 downloadSize() const;
+    QUrl urlFor(const File& file) const;
+    bool isLocal() const { return m_base.isLocalFile(); }
+
+    /** Copies the changed files from a local release into @p staging, checking each of them. */
+    bool stageLocal(const QString& staging, QString* error = nullptr) const;
+    /** Downloads the changed files into @p staging, checking each of them. */
+    NetJob::Ptr stageJob(const QString& staging, shared_qobject_ptr<QNetworkAccessManager> network) const;
+
+    /**
+     * Moves the files that are replaced or removed into @p backup, then moves the staged files in.
+     * Puts the backed up files back when that fails half way.
+     */
+    bool apply(const QString& staging, const QString& backup, QString* error = nullptr) const;
+
+    static QString sha256(const QString& file);
+
+   private:
+    QByteArray m_data;
+    QUrl m_base;
+    QList<File> m_files;
+
+    QString m_root;
+    QList<File> m_changed;
+    QStringList m_removed;
+};
@@ -63,6 +63,7 @@ namespace fs = std::filesystem;
 
 #include "net/Download.h"
 #include "net/RawHeaderProxy.h"
+#include "updater/DeltaUpdate.h"
 
 #include "MMCZip.h"
 
@@ -115,7 +116,9 @@ PrismUpdaterApp::PrismUpdaterApp(int& argc, char** argv) : QApplication(argc, ar
           { { "l", "list" }, tr("List available releases.") },
           { "debug", tr("Log debug to console.") },
           { { "S", "select-ui" }, tr("Select the version to install with a GUI.") },
-          { { "D", "allow-downgrade" }, tr("Allow the updater to downgrade to previous versions.") } });
+          { { "D", "allow-downgrade" }, tr("Allow the updater to downgrade to previous versions.") },
+          { "delta-source", tr("Look for release file manifests in this directory or url instead of the release assets."),
+            tr("directory or url") } });
 
     parser.addHelpOption();
     parser.addVersionOption();
@@ -187,6 +190,12 @@ PrismUpdaterApp::PrismUpdaterApp(int& argc, char** argv) : QApplication(argc, ar
 
     m_allowPreRelease = parser.isSet("pre-release");
 
+    if (auto delta_source = parser.value("delta-source"); !delta_source.isEmpty()) {
+        m_deltaSource = QUrl::fromUserInput(delta_source, QDir::currentPath(), QUrl::AssumeLocalFile);
+        if (!m_deltaSource.path().endsWith('/'))
+            m_deltaSource.setPath(m_deltaSource.path() + '/');
+    }
+
     QString origCwdPath = QDir::currentPath();
     QString binPath = applicationDirPath();
 
@@ -593,9 +602,24 @@ void PrismUpdaterApp::moveAndFinishUpdate(QDir target)
         }
         i++;
     }
+
+    // a later delta update removes what the installed release's manifest lists, so one left by an earlier update is stale
+    auto shipped_manifest = app_dir.absoluteFilePath(DeltaUpdate::installedManifestName);
+    auto installed_manifest = target.absoluteFilePath(DeltaUpdate::installedManifestName);
+    if (QFileInfo(shipped_manifest).isFile()) {
+        error |= copy(shipped_manifest);
+    } else if (QFileInfo::exists(installed_manifest)) {
+        logUpdate(tr("Removing the file manifest of the previous release: %1").arg(installed_manifest));
+        FS::deletePath(installed_manifest);
+    }
     progress.setValue(i);
     QCoreApplication::processEvents();
 
+    finishUpdate(target, error);
+}
+
+void PrismUpdaterApp::finishUpdate(QDir target, bool error)
+{
     if (error) {
         logUpdate(tr("There were errors installing the update."));
         auto fail_marker = FS::PathCombine(m_dataPath, ".prism_launcher_update.fail");
@@ -690,6 +714,10 @@ QList<GitHubReleaseAsset> PrismUpdaterApp::validReleaseArtifacts(const GitHubRel
             qDebug() << "Rejecting zsync file" << asset.name;
             continue;
         }
+        if (asset.name.endsWith(".files.json")) {
+            qDebug() << "Rejecting file manifest" << asset.name;
+            continue;
+        }
         if (!m_isAppimage && asset.name.toLower().endsWith("appimage")) {
             qDebug() << "Rejecting" << asset.name << "because it is an AppImage";
             continue;
@@ -777,6 +805,12 @@ void PrismUpdaterApp::performUpdate(const GitHubRelease& release)
     }
 
     qDebug() << "will install" << selected_asset;
+    auto is_archive = selected_asset.name.endsWith(".zip") || selected_asset.name.endsWith(".tar.gz");
+    if (!m_isAppimage && is_archive) {
+        if (auto update = fetchDeltaManifest(selected_asset); update && performDeltaInstall(*update))
+            return;
+    }
+
     auto file = downloadAsset(selected_asset);
 
     if (!file.exists()) {
@@ -875,9 +909,8 @@ bool write_lock_file(const QString& path, QDateTime timestamp, QString from, QSt
     return true;
 }
 
-void PrismUpdaterApp::performInstall(QFileInfo file)
+bool PrismUpdaterApp::beginUpdate()
 {
-    qDebug() << "starting install";
     auto update_lock_path = FS::PathCombine(m_dataPath, ".prism_launcher_update.lock");
     QFileInfo update_lock(update_lock_path);
     if (update_lock.exists()) {
@@ -914,7 +947,8 @@ void PrismUpdaterApp::performInstall(QFileInfo file)
             case QMessageBox::RejectRole:
                 [[fallthrough]];
             default:
-                return showFatalErrorMessage(tr("Update Aborted"), tr("The update attempt was aborted"));
+                showFatalErrorMessage(tr("Update Aborted"), tr("The update attempt was aborted"));
+                return false;
         }
     }
     clearUpdateLog();
@@ -923,6 +957,16 @@ void PrismUpdaterApp::performInstall(QFileInfo file)
     FS::write(changelog_path, m_install_release.body.toUtf8());
 
     logUpdate(tr("Updating from %1 to %2").arg(m_prismVersion).arg(m_install_release.tag_name));
+    return true;
+}
+
+void PrismUpdaterApp::performInstall(QFileInfo file)
+{
+    qDebug() << "starting install";
+    if (!beginUpdate())
+        return;
+
+    auto update_lock_path = FS::PathCombine(m_dataPath, ".prism_launcher_update.lock");
     if (m_isPortable || file.fileName().endsWith(".zip") || file.fileName().endsWith(".tar.gz")) {
         write_lock_file(update_lock_path, QDateTime::currentDateTime(), m_prismVersion, m_install_release.tag_name, m_rootPath, m_dataPath);
         logUpdate(tr("Updating portable install at %1").arg(m_rootPath));
@@ -942,6 +986,102 @@ void PrismUpdaterApp::performInstall(QFileInfo file)
     }
 }
 
+std::optional<DeltaUpdate> PrismUpdaterApp::fetchDeltaManifest(const GitHubReleaseAsset& asset)
+{
+    auto manifest_name = asset.name + ".files.json";
+    QUrl manifest_url;
+    if (m_deltaSource.isValid()) {
+        manifest_url = m_deltaSource.resolved(QUrl(manifest_name));
+    } else {
+        for (auto& other : m_install_release.assets) {
+            if (other.name == manifest_name)
+                manifest_url = QUrl(other.browser_download_url);
+        }
+    }
+    if (!manifest_url.isValid()) {
+        qDebug() << "No file manifest for" << asset.name << "- installing the full archive";
+        return std::nullopt;
+    }
+
+    qDebug() << "reading file manifest" << manifest_url;
+    QByteArray data;
+    if (manifest_url.isLocalFile()) {
+        try {
+            data = FS::read(manifest_url.toLocalFile());
+        } catch (const FS::FileSystemException& e) {
+            qWarning() << "Unable to read the file manifest:" << e.cause();
+            return std::nullopt;
+        }
+    } else {
+        auto response = std::make_shared<QByteArray>();
+        auto download = Net::Download::makeByteArray(manifest_url, response);
+        download->setNetwork(m_network);
+        auto progress_dialog = ProgressDialog();
+        progress_dialog.adjustSize();
+        progress_dialog.execWithTask(download.get());
+        if (!download->wasSuccessful()) {
+            qWarning() << "Unable to download the file manifest:" << download->failReason();
+            return std::nullopt;
+        }
+        data = *response;
+    }
+
+    QString error;
+    auto update = DeltaUpdate::fromManifest(data, manifest_url, &error);
+    if (!update)
+        qWarning() << "Invalid file manifest" << manifest_url << ":" << error;
+    return update;
+}
+
+bool PrismUpdaterApp::performDeltaInstall(DeltaUpdate& update)
+{
+    update.plan(m_rootPath);
+    if (!beginUpdate())
+        return true;
+
+    auto update_lock_path = FS::PathCombine(m_dataPath, ".prism_launcher_update.lock");
+    write_lock_file(update_lock_path, QDateTime::currentDateTime(), m_prismVersion, m_install_release.tag_name, m_rootPath, m_dataPath);
+    logUpdate(tr("Updating the changed files of %1: %2 to replace (%3), %4 to remove")
+                  .arg(m_rootPath)
+                  .arg(update.changed().size())
+                  .arg(StringUtils::humanReadableFileSize(update.downloadSize()))
+                  .arg(update.removed().size()));
+
+    auto staging = FS::PathCombine(m_dataPath, "prism_launcher_update_delta");
+    FS::deletePath(staging);
+    FS::ensureFolderPathExists(staging);
+
+    QString error;
+    bool staged = false;
+    if (update.isLocal()) {
+        staged = update.stageLocal(staging, &error);
+    } else {
+        auto job = update.stageJob(staging, m_network);
+        auto progress_dialog = ProgressDialog();
+        progress_dialog.adjustSize();
+        progress_dialog.execWithTask(job.get());
+        staged = job->wasSuccessful();
+        error = job->failReason();
+    }
+
+    if (staged) {
+        auto backup_dir = makeBackupDir();
+        if (update.apply(staging, backup_dir, &error)) {
+            FS::deletePath(staging);
+            logUpdate(tr("Backed up the replaced files to %1").arg(backup_dir));
+            finishUpdate(QDir(m_rootPath), false);
+            return true;
+        }
+    }
+
+    // nothing was replaced, so the full archive can still be installed over the same files
+    logUpdate(tr("Updating the changed files failed: %1").arg(error));
+    logUpdate(tr("Falling back to installing the full release archive"));
+    FS::deletePath(staging);
+    FS::deletePath(update_lock_path);
+    return false;
+}
+
 void PrismUpdaterApp::unpackAndInstall(QFileInfo archive)
 {
     logUpdate(tr("Backing up install"));
@@ -1018,14 +1158,8 @@ void PrismUpdaterApp::backupAppDir()
         logUpdate("manifest.txt empty or missing. making best guess at files to back up.");
     }
     logUpdate(tr("Backing up:\n  %1").arg(file_list.join(",\n  ")));
-    static const QRegularExpression s_replaceRegex("[" + QRegularExpression::escape("\\/:*?\"<>|") + "]");
     auto app_dir = QDir(m_rootPath);
-    auto backup_dir =
-        FS::PathCombine(app_dir.absolutePath(),
-                        QStringLiteral("backup_") + QString(m_prismVersion).replace(s_replaceRegex, QString("_")) + "-" + m_prismGitCommit);
-    FS::ensureFolderPathExists(backup_dir);
-    auto backup_marker_path = FS::PathCombine(m_dataPath, ".prism_launcher_update_backup_path.txt");
-    FS::write(backup_marker_path, backup_dir.toUtf8());
+    auto backup_dir = makeBackupDir();
 
     QProgressDialog progress(tr("Backing up install at %1").arg(m_rootPath), "", 0, file_list.length());
     progress.setCancelButton(nullptr);
@@ -1072,6 +1206,17 @@ void PrismUpdaterApp::backupAppDir()
     QCoreApplication::processEvents();
 }
 
+QString PrismUpdaterApp::makeBackupDir()
+{
+    static const QRegularExpression s_replaceRegex("[" + QRegularExpression::escape("\\/:*?\"<>|") + "]");
+    auto backup_dir = FS::PathCombine(
+        m_rootPath, QStringLiteral("backup_") + QString(m_prismVersion).replace(s_replaceRegex, QString("_")) + "-" + m_prismGitCommit);
+    FS::ensureFolderPathExists(backup_dir);
+    auto backup_marker_path = FS::PathCombine(m_dataPath, ".prism_launcher_update_backup_path.txt");
+    FS::write(backup_marker_path, backup_dir.toUtf8());
+    return backup_dir;
+}
+
 std::optional<QDir> PrismUpdaterApp::unpackArchive(QFileInfo archive)
 {
     auto temp_extract_path = FS::PathCombine(m_dataPath, "prism_launcher_update_release");
@@ -44,6 +44,7 @@
 #include "FileSystem.h"
 
 #include "GitHubRelease.h"
+#include "updater/DeltaUpdate.h"
 
 class PrismUpdaterApp : public QApplication {
     // friends for the purpose of limiting access to deprecated stuff
@@ -78,15 +79,21 @@ class PrismUpdaterApp : public QApplication {
     QList<GitHubReleaseAsset> validReleaseArtifacts(const GitHubRelease& release);
     GitHubReleaseAsset selectAsset(const QList<GitHubReleaseAsset>& assets);
     void performUpdate(const GitHubRelease& release);
+    bool beginUpdate();
     void performInstall(QFileInfo file);
     void unpackAndInstall(QFileInfo file);
     void backupAppDir();
+    QString makeBackupDir();
     std::optional<QDir> unpackArchive(QFileInfo file);
 
     QFileInfo downloadAsset(const GitHubReleaseAsset& asset);
+    std::optional<DeltaUpdate> fetchDeltaManifest(const GitHubReleaseAsset& asset);
+    /** Replaces only the files that changed, returns false when the full archive has to be installed instead. */
+    bool performDeltaInstall(DeltaUpdate& update);
     bool callAppImageUpdate();
 
     void moveAndFinishUpdate(QDir target);
+    void finishUpdate(QDir target, bool error);
 
    public slots:
     void downloadError(QString reason);
@@ -107,6 +114,7 @@ class PrismUpdaterApp : public QApplication {
     QString m_appimagePath;
     QString m_prismExecutable;
     QUrl m_prismRepoUrl;
+    QUrl m_deltaSource;
     Version m_userSelectedVersion;
     bool m_checkOnly;
     bool m_forceUpdate;
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Writes the file manifest the updater uses to replace only the files that changed between releases.
+
+Usage: release_manifest.py <release directory> [--base <url>]
+
+The manifest is saved as release_files.json inside the release directory, which is also where the updater keeps the
+manifest of the installed release. See launcher/updater/DeltaUpdate.h for the format.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import stat
+import sys
+
+MANIFEST_NAME = "release_files.json"
+
+
+def sha256(path):
+    digest = hashlib.sha256()
+    with open(path, "rb") as file:
+        for chunk in iter(lambda: file.read(1024 * 1024), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("root", help="the unpacked release")
+    parser.add_argument("--base", help="where the files of the release are downloaded from, instead of next to the manifest")
+    args = parser.parse_args()
+
+    files = []
+    for folder, dirs, names in os.walk(args.root):
+        dirs.sort()
+        for name in sorted(names):
+            full = os.path.join(folder, name)
+            path = os.path.relpath(full, args.root).replace(os.sep, "/")
+            if path == MANIFEST_NAME or os.path.islink(full):
+                continue
+            mode = os.stat(full).st_mode
+            entry = {"path": path, "size": os.path.getsize(full), "sha256": sha256(full)}
+            if os.name != "nt" and mode & stat.S_IXUSR:
+                entry["executable"] = True
+            files.append(entry)
+
+    manifest = {"formatVersion": 1}
+    if args.base:
+        manifest["base"] = args.base
+    manifest["files"] = files
+
+    with open(os.path.join(args.root, MANIFEST_NAME), "w", encoding="utf-8") as out:
+        json.dump(manifest, out, indent=1)
+        out.write("\n")
+    print(f"{len(files)} files listed in {os.path.join(args.root, MANIFEST_NAME)}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+#include <QTimer>
+
+#include <minecraft/auth/AuthFlow.h>
+
+#include <algorithm>
+
+/* Answers every request after a short delay, so that requests made at the same time overlap. "slow" ones take seconds. */
+class StandInServer : public QObject {
+    Q_OBJECT
+
+   public:
+    StandInServer()
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, &StandInServer::accept);
+        m_server.listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url(const QString& path) const { return QUrl(QString("http://127.0.0.1:%1/%2").arg(m_server.serverPort()).arg(path)); }
+
+    QStringList requested;
+    int open = 0;
+    int maxOpen = 0;
+
+   private:
+    void accept()
+    {
+        while (auto socket = m_server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+                auto request = socket->peek(socket->bytesAvailable());
+                if (!request.contains("\r\n\r\n"))
+                    return;
+                socket->readAll();
+
+                // "GET /path HTTP/1.1"
+                auto path = QString::fromUtf8(request.split(' ').value(1)).mid(1);
+                requested.append(path);
+                maxOpen = std::max(maxOpen, ++open);
+
+                QTimer::singleShot(path.startsWith("slow") ? 5000 : 50, socket, [this, socket, path] {
+                    open--;
+                    QString status = path.startsWith("fail") ? "500 Internal Server Error" : "200 OK";
+                    socket->write(QString("HTTP/1.1 %1\r\nContent-Length: 2\r\nConnection: close\r\n\r\n{}").arg(status).toUtf8());
+                    socket->disconnectFromHost();
+                });
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    QTcpServer m_server;
+};
+
+/* Fetches one URL from the stand-in server. */
+class RequestStep : public AuthStep {
+    Q_OBJECT
+
+   public:
+    RequestStep(AccountData* data, QNetworkAccessManager* network, QUrl url) : AuthStep(data), m_network(network), m_url(url) {}
+
+    QString describe() override { return m_url.path(); }
+
+   public slots:
+    void perform() override
+    {
+        m_reply = m_network->get(QNetworkRequest(m_url));
+        connect(m_reply, &QNetworkReply::finished, this, [this] {
+            m_reply->deleteLater();
+            if (m_reply->error() != QNetworkReply::NoError) {
+                emit finished(AccountTaskState::STATE_FAILED_SOFT, m_reply->errorString());
+                return;
+            }
+            emit finished(AccountTaskState::STATE_WORKING, describe());
+        });
+    }
+
+    void abort() override
+    {
+        aborted = true;
+        if (m_reply)
+            m_reply->abort();
+    }
+
+    bool aborted = false;
+
+   private:
+    QNetworkAccessManager* m_network;
+    QUrl m_url;
+    QPointer<QNetworkReply> m_reply;
+};
+
+class StandInFlow : public AuthFlow {
+    Q_OBJECT
+
+   public:
+    StandInFlow(AccountData* data) : AuthFlow(data) {}
+    using AuthFlow::addStep;
+};
+
+class AuthFlowTest : public QObject {
+    Q_OBJECT
+
+    AuthStep::Ptr step(const QString& path)
+    {
+        return makeShared<RequestStep>(&m_data, &m_network, m_server.url(path));
+    }
+
+    StandInServer m_server;
+    QNetworkAccessManager m_network;
+    AccountData m_data;
+
+   private slots:
+    void initTestCase() { m_data.type = AccountType::Offline; }
+
+    void init()
+    {
+        m_server.requested.clear();
+        m_server.open = 0;
+        m_server.maxOpen = 0;
+    }
+
+    void test_independentStepsOverlap()
+    {
+        StandInFlow flow(&m_data);
+        auto login = flow.addStep(step("login"));
+        auto profile = flow.addStep(step("profile"), { login });
+        flow.addStep(step("entitlements"), { login });
+        flow.addStep(step("xbox"), { login });
+        flow.addStep(step("skin"), { profile });
+
+        flow.start();
+        QTRY_VERIFY_WITH_TIMEOUT(flow.isFinished(), 10000);
+
+        QVERIFY2(flow.wasSuccessful(), qPrintable(flow.failReason()));
+        QCOMPARE(m_server.requested.size(), 5);
+        QCOMPARE(m_server.requested.first(), "login");
+        QVERIFY(m_server.requested.indexOf("skin") > m_server.requested.indexOf("profile"));
+        // profile, entitlements and xbox have nothing to wait for but the login
+        QVERIFY(m_server.maxOpen >= 3);
+    }
+
+    void test_failureStopsTheFlow()
+    {
+        StandInFlow flow(&m_data);
+        auto login = flow.addStep(step("login"));
+        auto profile = flow.addStep(step("fail/profile"), { login });
+        flow.addStep(step("entitlements"), { login });
+        flow.addStep(step("skin"), { profile });
+
+        flow.start();
+        QTRY_VERIFY_WITH_TIMEOUT(flow.isFinished(), 10000);
+
+        QVERIFY(!flow.wasSuccessful());
+        QCOMPARE(flow.taskState(), AccountTaskState::STATE_FAILED_SOFT);
+        QCOMPARE(m_data.accountState, AccountState::Errored);
+        QVERIFY(!m_server.requested.contains("skin"));
+    }
+
+    void test_failureAbortsStepsInFlight()
+    {
+        StandInFlow flow(&m_data);
+        auto login = flow.addStep(step("login"));
+        flow.addStep(step("fail/profile"), { login });
+        auto entitlements = makeShared<RequestStep>(&m_data, &m_network, m_server.url("slow/entitlements"));
+        flow.addStep(entitlements, { login });
+
+        QElapsedTimer timer;
+        timer.start();
+        flow.start();
+        QTRY_VERIFY_WITH_TIMEOUT(flow.isFinished(), 10000);
+
+        QVERIFY(!flow.wasSuccessful());
+        QVERIFY(flow.failReason().contains("fail/profile"));
+        // the slow sibling was dropped instead of waited for
+        QVERIFY(entitlements->aborted);
+        QVERIFY(timer.elapsed() < 5000);
+
+        // and what it reports once its reply is gone does not touch the finished flow
+        QTest::qWait(100);
+        QCOMPARE(flow.taskState(), AccountTaskState::STATE_FAILED_SOFT);
+        QVERIFY(flow.failReason().contains("fail/profile"));
+    }
+};
+
+QTEST_GUILESS_MAIN(AuthFlowTest)
+
+#include "AuthFlow_test.moc"
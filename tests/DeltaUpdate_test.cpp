@@ -0,0 +1,163 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <updater/DeltaUpdate.h>
+
+class DeltaUpdateTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_release;
+    QString m_install;
+
+    void writeFile(const QString& path, const QByteArray& data)
+    {
+        QVERIFY(FS::ensureFilePathExists(path));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    /** Lays out a release in a plain directory, the way the release server would serve it. */
+    QByteArray makeRelease(const QMap<QString, QByteArray>& files)
+    {
+        QJsonArray list;
+        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+            writeFile(FS::PathCombine(m_release, it.key()), it.value());
+            auto sha256 = QCryptographicHash::hash(it.value(), QCryptographicHash::Sha256).toHex();
+            list.append(QJsonObject{ { "path", it.key() }, { "size", it.value().size() }, { "sha256", QString::fromLatin1(sha256) } });
+        }
+        auto manifest = QJsonDocument(QJsonObject{ { "formatVersion", 1 }, { "files", list } }).toJson();
+        writeFile(FS::PathCombine(m_release, "release.files.json"), manifest);
+        return manifest;
+    }
+
+    std::optional<DeltaUpdate> loadRelease()
+    {
+        auto path = FS::PathCombine(m_release, "release.files.json");
+        return DeltaUpdate::fromManifest(readFile(path), QUrl::fromLocalFile(path));
+    }
+
+   private slots:
+    void init()
+    {
+        m_release = FS::PathCombine(m_dir.path(), "release");
+        m_install = FS::PathCombine(m_dir.path(), "install");
+        FS::deletePath(m_release);
+        FS::deletePath(m_install);
+    }
+
+    void test_onlyChangedFilesAreReplaced()
+    {
+        auto old_manifest = makeRelease({ { "bin/launcher", "old launcher" }, { "lib/same.so", "unchanged" }, { "lib/gone.so", "dropped" } });
+        for (auto file : { "bin/launcher", "lib/same.so", "lib/gone.so" })
+            writeFile(FS::PathCombine(m_install, file), readFile(FS::PathCombine(m_release, file)));
+        writeFile(FS::PathCombine(m_install, DeltaUpdate::installedManifestName), old_manifest);
+        writeFile(FS::PathCombine(m_install, "user.cfg"), "not part of any release");
+
+        FS::deletePath(m_release);
+        makeRelease({ { "bin/launcher", "new launcher" }, { "lib/same.so", "unchanged" }, { "lib/added.so", "added" } });
+
+        auto update = loadRelease();
+        QVERIFY(update.has_value());
+        update->plan(m_install);
+
+        QCOMPARE(update->changed().size(), 2);
+        QCOMPARE(update->changed()[0].path, "bin/launcher");
+        QCOMPARE(update->changed()[1].path, "lib/added.so");
+        QCOMPARE(update->removed(), QStringList{ "lib/gone.so" });
+        QCOMPARE(update->downloadSize(), qint64(QByteArray("new launcher").size() + QByteArray("added").size()));
+        QVERIFY(update->isLocal());
+
+        auto staging = FS::PathCombine(m_dir.path(), "staging");
+        auto backup = FS::PathCombine(m_dir.path(), "backup");
+        QString error;
+        QVERIFY2(update->stageLocal(staging, &error), qPrintable(error));
+        QVERIFY2(update->apply(staging, backup, &error), qPrintable(error));
+
+        QCOMPARE(readFile(FS::PathCombine(m_install, "bin/launcher")), QByteArray("new launcher"));
+        QCOMPARE(readFile(FS::PathCombine(m_install, "lib/same.so")), QByteArray("unchanged"));
+        QCOMPARE(readFile(FS::PathCombine(m_install, "lib/added.so")), QByteArray("added"));
+        QCOMPARE(readFile(FS::PathCombine(m_install, "user.cfg")), QByteArray("not part of any release"));
+        QVERIFY(!QFile::exists(FS::PathCombine(m_install, "lib/gone.so")));
+
+        // only what was replaced or removed ends up in the backup
+        QCOMPARE(readFile(FS::PathCombine(backup, "bin/launcher")), QByteArray("old launcher"));
+        QCOMPARE(readFile(FS::PathCombine(backup, "lib/gone.so")), QByteArray("dropped"));
+        QVERIFY(!QFile::exists(FS::PathCombine(backup, "lib/same.so")));
+
+        // the installation now matches the release
+        update->plan(m_install);
+        QVERIFY(update->changed().isEmpty());
+        QVERIFY(update->removed().isEmpty());
+    }
+
+    void test_filesDroppedSinceAFullInstallAreRemoved()
+    {
+        // a full archive leaves no release manifest, only the list of what it unpacked
+        for (auto file : { "bin/launcher", "lib/same.so", "lib/gone.so", "qt.conf" })
+            writeFile(FS::PathCombine(m_install, file), "old");
+        writeFile(FS::PathCombine(m_install, "manifest.txt"), "bin\nlib\nqt.*\n");
+        writeFile(FS::PathCombine(m_install, "user.cfg"), "not part of any release");
+
+        makeRelease({ { "bin/launcher", "new launcher" }, { "lib/same.so", "unchanged" }, { "manifest.txt", "bin\nlib\n" } });
+        auto update = loadRelease();
+        QVERIFY(update.has_value());
+        update->plan(m_install);
+
+        auto removed = update->removed();
+        removed.sort();
+        QCOMPARE(removed, (QStringList{ "lib/gone.so", "qt.conf" }));
+    }
+
+    void test_corruptFileIsRejected()
+    {
+        makeRelease({ { "bin/launcher", "new launcher" } });
+        writeFile(FS::PathCombine(m_release, "bin/launcher"), "tampered with");
+
+        auto update = loadRelease();
+        QVERIFY(update.has_value());
+        update->plan(m_install);
+        QCOMPARE(update->changed().size(), 1);
+        QVERIFY(!update->stageLocal(FS::PathCombine(m_dir.path(), "staging")));
+    }
+
+    void test_pathsOutsideTheInstallationAreRejected()
+    {
+        QJsonObject file{ { "path", "../escaped" }, { "size", 1 }, { "sha256", "00" } };
+        auto manifest = QJsonDocument(QJsonObject{ { "files", QJsonArray{ file } } }).toJson();
+        QString error;
+        QVERIFY(!DeltaUpdate::fromManifest(manifest, QUrl::fromLocalFile(m_release + "/release.files.json"), &error).has_value());
+        QVERIFY(!error.isEmpty());
+    }
+
+    void test_baseIsRelativeToTheManifest()
+    {
+        QJsonObject file{ { "path", "bin/launcher" }, { "size", 1 }, { "sha256", "00" } };
+        auto manifest = QJsonDocument(QJsonObject{ { "base", "files" }, { "files", QJsonArray{ file } } }).toJson();
+        auto update = DeltaUpdate::fromManifest(manifest, QUrl("https://example.com/releases/1.0/release.files.json"));
+        QVERIFY(update.has_value());
+        update->plan(m_install);
+        QCOMPARE(update->urlFor(update->changed().first()), QUrl("https://example.com/releases/1.0/files/bin/launcher"));
+        QVERIFY(!update->isLocal());
+    }
+};
+
+QTEST_GUILESS_MAIN(DeltaUpdateTest)
+
+#include "DeltaUpdate_test.moc"
@@ -0,0 +1,73 @@
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+
+#include <tasks/Executor.h>
+
+#include <atomic>
+
+class ExecutorTest : public QObject {
+    Q_OBJECT
+
+    /* Keeps every thread of the pool busy until released. */
+    static void occupy(QThreadPool* pool, QSemaphore& started, QSemaphore& release)
+    {
+        for (int i = 0; i < pool->maxThreadCount(); i++) {
+            pool->start([&started, &release] {
+                started.release();
+                release.acquire();
+            });
+        }
+        started.acquire(pool->maxThreadCount());
+    }
+
+   private slots:
+    void test_interactiveGoesFirst()
+    {
+        auto pool = Executor::pool(Executor::Kind::IO);
+        QSemaphore started, release;
+        occupy(pool, started, release);
+
+        QStringList order;
+        QMutex lock;
+        auto record = [&order, &lock](QString name) {
+            QMutexLocker locker(&lock);
+            order.append(name);
+        };
+        auto normal = Executor::run(Executor::Kind::IO, Executor::Priority::Normal, [&record] { record("normal"); });
+        auto interactive = Executor::run(Executor::Kind::IO, Executor::Priority::Interactive, [&record] { record("interactive"); });
+
+        // a single free thread takes the most urgent work first, then goes on with the rest
+        // (waiting on the futures here would run them on this thread instead)
+        release.release();
+        QTRY_VERIFY(interactive.isFinished() && normal.isFinished());
+        QCOMPARE(order, QStringList({ "interactive", "normal" }));
+
+        release.release(pool->maxThreadCount() - 1);
+    }
+
+    void test_cancelDropsQueuedWork()
+    {
+        auto pool = Executor::pool(Executor::Kind::Compute, Executor::Priority::Background);
+        QSemaphore started, release;
+        occupy(pool, started, release);
+
+        std::atomic_bool ran = false;
+        Executor::CancelToken token;
+        auto future = Executor::run(Executor::Kind::Compute, Executor::Priority::Background, token, [&ran] { ran = true; });
+        token.cancel();
+        QVERIFY(token.isCancelled());
+        QVERIFY(*token.flag());
+
+        release.release(pool->maxThreadCount());
+        token.waitForFinished();
+        pool->waitForDone();
+
+        QVERIFY(future.isCanceled());
+        QVERIFY(!ran);
+    }
+};
+
+QTEST_GUILESS_MAIN(ExecutorTest)
+
+#include "Executor_test.moc"
@@ -306,6 +306,60 @@ class FileSystemTest : public QObject {
         }
     }
 
+    void test_copy_parallel()
+    {
+        QTemporaryDir tempDir;
+        tempDir.setAutoRemove(true);
+
+        QDir source_dir(FS::PathCombine(tempDir.path(), "source"));
+        QByteArray expected_contents;
+        qint64 expected_bytes = 0;
+        for (int i = 0; i < 64; i++) {
+            // a few of them are large enough to need more than one chunk
+            auto contents = QByteArray(i % 16 == 0 ? 3 * 1024 * 1024 + i : i * 37, static_cast<char>('a' + i % 26));
+            FS::write(FS::PathCombine(source_dir.path(), QString("dir%1").arg(i % 4), QString("file%1").arg(i)), contents);
+            expected_bytes += contents.size();
+            if (i == 16)
+                expected_contents = contents;
+        }
+
+        QDir target_dir(FS::PathCombine(tempDir.path(), "target"));
+        FS::copy c(source_dir.path(), target_dir.path());
+        c.maxWorkers(4);
+
+        qint64 scanned_bytes = -1;
+        qint64 last_progress = 0;
+        bool monotonic = true;
+        connect(&c, &FS::copy::scanned, [&scanned_bytes](qsizetype, qint64 bytes) { scanned_bytes = bytes; });
+        connect(&c, &FS::copy::progress, [&last_progress, &monotonic](qint64 copied, qint64) {
+            monotonic &= copied >= last_progress;
+            last_progress = copied;
+        });
+
+        QVERIFY(c());
+        QCOMPARE(c.totalCopied(), 64);
+        QCOMPARE(c.totalFailed(), 0);
+        QCOMPARE(scanned_bytes, expected_bytes);
+        QCOMPARE(c.totalBytes(), expected_bytes);
+        QCOMPARE(last_progress, expected_bytes);
+        QVERIFY(monotonic);
+        QCOMPARE(FS::read(FS::PathCombine(target_dir.path(), "dir0", "file16")), expected_contents);
+    }
+
+    void test_copy_cancelled()
+    {
+        QString folder = QFINDTESTDATA("testdata/FileSystem/test_folder");
+        QTemporaryDir tempDir;
+        tempDir.setAutoRemove(true);
+
+        std::atomic_bool cancelled = true;
+        FS::copy c(folder, FS::PathCombine(tempDir.path(), "test_folder"));
+        c.cancelled(&cancelled);
+
+        QVERIFY(!c());
+        QCOMPARE(c.totalCopied(), 0);
+    }
+
     void test_getDesktop() { QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation)); }
 
     void test_link()
@@ -1,3 +1,4 @@
+#include <QBuffer>
 #include <QTest>
 
 #include <GZip.h>
@@ -45,6 +46,46 @@ class GZipTest : public QObject {
             fib(prev, cur);
         } while (cur < size);
     }
+
+    void test_InflateDevice()
+    {
+        QByteArray plain;
+        for (int i = 0; i < 200000; i++) {
+            plain.append(QByteArray::number(i));
+        }
+        QByteArray compressed;
+        QVERIFY(GZip::zip(plain, compressed));
+
+        QBuffer source(&compressed);
+        QVERIFY(source.open(QIODevice::ReadOnly));
+        GZip::InflateDevice inflate(&source);
+        QVERIFY(inflate.open(QIODevice::ReadOnly));
+
+        // read in odd sized pieces to cross the internal buffer boundaries
+        QByteArray out;
+        char chunk[1000];
+        qint64 read;
+        while ((read = inflate.read(chunk, sizeof(chunk))) > 0) {
+            out.append(chunk, read);
+        }
+        QCOMPARE(read, qint64(0));
+        QCOMPARE(out, plain);
+    }
+
+    void test_InflateDeviceTruncated()
+    {
+        QByteArray plain(100000, 'a');
+        QByteArray compressed;
+        QVERIFY(GZip::zip(plain, compressed));
+        compressed.chop(compressed.size() / 2);
+
+        QBuffer source(&compressed);
+        QVERIFY(source.open(QIODevice::ReadOnly));
+        GZip::InflateDevice inflate(&source);
+        QVERIFY(inflate.open(QIODevice::ReadOnly));
+        QVERIFY(inflate.readAll().size() < plain.size());
+        QVERIFY(!inflate.errorString().isEmpty());
+    }
 };
 
 QTEST_GUILESS_MAIN(GZipTest)
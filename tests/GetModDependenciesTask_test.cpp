@@ -0,0 +1,214 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/MinecraftInstance.h>
+#include <minecraft/mod/tasks/GetModDependenciesTask.h>
+#include <settings/INISettingsObject.h>
+#include <ui/pages/modplatform/ModModel.h>
+
+using Deps = QList<std::shared_ptr<GetModDependenciesTask::PackDependency>>;
+
+/* Answers right away, or never when held, until it is aborted. */
+class ReplyTask : public Task {
+    Q_OBJECT
+
+   public:
+    ReplyTask(std::function<void()> reply, bool hold) : m_reply(std::move(reply)), m_hold(hold) { setAbortable(true); }
+
+   protected:
+    void executeTask() override
+    {
+        if (m_hold)
+            return;
+        m_reply();
+        emitSucceeded();
+    }
+
+   private:
+    std::function<void()> m_reply;
+    bool m_hold;
+};
+
+/* A Modrinth-like API that counts what is asked of it. */
+class DependencyAPI : public ResourceAPI {
+   public:
+    //! the version each project id or version id leads to
+    QHash<QString, QJsonObject> versions;
+    bool hold = false;
+
+    mutable QHash<QString, int> project_lookups;
+    mutable QHash<QString, int> version_lookups;
+
+    auto getSortingMethods() const -> QList<SortingMethod> override { return {}; }
+
+    Task::Ptr getProject(QString addonId, std::shared_ptr<QByteArray> response) const override
+    {
+        project_lookups[addonId]++;
+        return makeShared<ReplyTask>([addonId, response] { *response = QJsonDocument(project(addonId)).toJson(); }, hold);
+    }
+    Task::Ptr getProjects(QStringList addonIds, std::shared_ptr<QByteArray> response) const override
+    {
+        QJsonArray projects;
+        for (auto& addonId : addonIds) {
+            project_lookups[addonId]++;
+            projects.append(project(addonId));
+        }
+        return makeShared<ReplyTask>([projects, response] { *response = QJsonDocument(projects).toJson(); }, hold);
+    }
+    Task::Ptr getDependencyVersion(DependencySearchArgs&& args, DependencySearchCallbacks&& callbacks) const override
+    {
+        auto dep = args.dependency;
+        auto key = dep.addonId.toString().isEmpty() ? dep.version : dep.addonId.toString();
+        version_lookups[key]++;
+        auto version = versions.value(key);
+        return makeShared<ReplyTask>(
+            [dep, version, callbacks] {
+                // a version id is answered with that version, a project with a list of versions
+                auto doc = dep.version.isEmpty() ? QJsonDocument(QJsonArray{ version }) : QJsonDocument(version);
+                callbacks.on_succeed(doc, dep);
+            },
+            hold);
+    }
+
+    static QJsonObject project(const QString& addonId) { return { { "id", addonId }, { "title", addonId } }; }
+};
+
+class DependencyModel : public ResourceDownload::ModModel {
+    Q_OBJECT
+
+   public:
+    explicit DependencyModel(BaseInstance& instance) : ModModel(instance, nullptr) {}
+
+    QString metaEntryBase() const override { return {}; }
+    void loadIndexedPack(ModPlatform::IndexedPack& pack, QJsonObject& obj) override { pack.name = obj.value("title").toString(); }
+    void loadExtraPackInfo(ModPlatform::IndexedPack&, QJsonObject&) override {}
+    void loadIndexedPackVersions(ModPlatform::IndexedPack&, QJsonArray&) override {}
+    ModPlatform::IndexedVersion loadDependencyVersions(const ModPlatform::Dependency&, QJsonArray& arr) override
+    {
+        auto obj = arr.first().toObject();
+        ModPlatform::IndexedVersion version;
+        version.addonId = obj.value("project_id").toString();
+        version.fileId = obj.value("id").toString();
+        version.version = obj.value("id").toString();
+        version.fileName = obj.value("project_id").toString() + ".jar";
+        version.mcVersion = { "1.20.1" };
+        version.loaders = ModPlatform::Fabric;
+        for (auto value : obj.value("dependencies").toArray()) {
+            ModPlatform::Dependency dep;
+            dep.addonId = value.toObject().value("project_id").toString();
+            dep.type = ModPlatform::DependencyType::REQUIRED;
+            version.dependencies.append(dep);
+        }
+        return version;
+    }
+    QJsonArray documentToArray(QJsonDocument& doc) const override { return doc.array(); }
+};
+
+class GetModDependenciesTaskTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    SettingsObjectPtr m_settings;
+    std::unique_ptr<MinecraftInstance> m_instance;
+
+    static QJsonObject version(const QString& addonId, const QString& id, const QStringList& dependencies = {})
+    {
+        QJsonArray deps;
+        for (auto& dep : dependencies)
+            deps.append(QJsonObject{ { "project_id", dep } });
+        return { { "project_id", addonId }, { "id", id }, { "dependencies", deps } };
+    }
+
+    static std::shared_ptr<GetModDependenciesTask::PackDependency> selected(const QString& addonId,
+                                                                            QList<ModPlatform::Dependency> dependencies)
+    {
+        auto pack = std::make_shared<ModPlatform::IndexedPack>();
+        pack->addonId = addonId;
+        pack->provider = ModPlatform::ResourceProvider::MODRINTH;
+        ModPlatform::IndexedVersion version;
+        version.addonId = addonId;
+        version.fileName = addonId + ".jar";
+        version.mcVersion = { "1.20.1" };
+        version.loaders = ModPlatform::Fabric;
+        version.dependencies = dependencies;
+        return std::make_shared<GetModDependenciesTask::PackDependency>(pack, version);
+    }
+
+    GetModDependenciesTask::Ptr task(std::shared_ptr<DependencyAPI> api, Deps selected)
+    {
+        GetModDependenciesTask::Provider flame{ ModPlatform::ResourceProvider::FLAME, std::make_shared<DependencyModel>(*m_instance),
+                                                std::make_shared<DependencyAPI>() };
+        GetModDependenciesTask::Provider modrinth{ ModPlatform::ResourceProvider::MODRINTH, std::make_shared<DependencyModel>(*m_instance),
+                                                   api };
+        return makeShared<GetModDependenciesTask>(Version("1.20.1"), ModPlatform::Fabric, QList<Mod*>{}, selected, flame, modrinth);
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_settings = std::make_shared<INISettingsObject>(FS::PathCombine(m_dir.path(), "launcher.cfg"));
+        // what every instance refers to in the global settings
+        for (auto name : { "ShowGameTime", "RecordGameTime", "PreLaunchCommand", "WrapperCommand", "PostExitCommand", "ShowConsole",
+                           "AutoCloseConsole", "ShowConsoleOnError", "LogPrePostOutput", "ConsoleMaxLines", "ConsoleOverflowStop" })
+            m_settings->registerSetting(QString(name), QVariant());
+        auto root = FS::PathCombine(m_dir.path(), "instance");
+        m_instance = std::make_unique<MinecraftInstance>(
+            m_settings, std::make_shared<INISettingsObject>(FS::PathCombine(root, "instance.cfg")), root);
+    }
+
+    // "lib" is needed by both mods, "api" by id from one and by its version alone from the other
+    void test_lookedUpOnce()
+    {
+        auto api = std::make_shared<DependencyAPI>();
+        api->versions.insert("lib", version("lib", "lib-1", { "core" }));
+        api->versions.insert("api", version("api", "api-1", { "core" }));
+        api->versions.insert("api-1", version("api", "api-1", { "core" }));
+        api->versions.insert("core", version("core", "core-1"));
+
+        auto required = ModPlatform::DependencyType::REQUIRED;
+        auto check = task(api, { selected("a", { { "lib", required, {} }, { {}, required, "api-1" } }),
+                                 selected("b", { { "lib", required, {} }, { "api", required, {} } }) });
+        QSignalSpy succeeded(check.get(), &Task::succeeded);
+        check->start();
+        QTRY_COMPARE(succeeded.count(), 1);
+
+        QStringList found;
+        for (auto& dep : check->getDependecies())
+            found.append(dep->pack->addonId.toString());
+        found.sort();
+        QCOMPARE(found, QStringList({ "api", "core", "lib" }));
+
+        // the version alone has to be looked up to learn its project, which isn't looked up again after that
+        QCOMPARE(api->version_lookups, (QHash<QString, int>{ { "lib", 1 }, { "api", 1 }, { "api-1", 1 }, { "core", 1 } }));
+        QCOMPARE(api->project_lookups, (QHash<QString, int>{ { "lib", 1 }, { "api", 1 }, { "core", 1 } }));
+    }
+
+    void test_abort()
+    {
+        auto api = std::make_shared<DependencyAPI>();
+        api->hold = true;
+        auto check = task(api, { selected("a", { { "lib", ModPlatform::DependencyType::REQUIRED, {} } }) });
+        QSignalSpy aborted(check.get(), &Task::aborted);
+        QSignalSpy failed(check.get(), &Task::failed);
+
+        // nothing is running yet
+        QVERIFY(check->abort());
+        QCOMPARE(aborted.count(), 0);
+
+        check->start();
+        QTRY_VERIFY(!api->version_lookups.isEmpty());
+        QVERIFY(check->abort());
+        QCOMPARE(aborted.count(), 1);
+        QCOMPARE(failed.count(), 0);
+        QCOMPARE(check->getState(), Task::State::AbortedByUser);
+    }
+};
+
+QTEST_GUILESS_MAIN(GetModDependenciesTaskTest)
+
+#include "GetModDependenciesTask_test.moc"
@@ -0,0 +1,128 @@
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QtConcurrent>
+
+#include <FileSystem.h>
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+
+    // writes the file and records it in the cache, like a finished download would
+    void store(HttpMetaCache& cache, const QString& path, const QByteArray& data)
+    {
+        auto entry = cache.resolveEntry("test", path);
+        QVERIFY(FS::ensureFilePathExists(entry->getFullPath()));
+        QFile file(entry->getFullPath());
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        file.close();
+
+        entry->setMD5Sum(QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex()));
+        entry->setLocalChangedTimestamp(QFileInfo(file).lastModified().toUTC().toMSecsSinceEpoch());
+        entry->makeEternal(true);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+    }
+
+    void touch(HttpMetaCache& cache, const QString& path)
+    {
+        QFile file(FS::PathCombine(cache.getBasePath("test"), path));
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTimeUtc().addSecs(-3600), QFileDevice::FileModificationTime));
+    }
+
+   private slots:
+    void test_resolveEntries()
+    {
+        HttpMetaCache cache;
+        cache.addBase("test", m_dir.filePath("entries"));
+        QStringList paths;
+        for (int i = 0; i < 100; i++) {
+            paths.append(QString("file%1").arg(i));
+            if (i % 2 == 0)
+                store(cache, paths.last(), QByteArray::number(i));
+        }
+
+        auto entries = cache.resolveEntries("test", paths);
+        QCOMPARE(entries.size(), paths.size());
+        for (int i = 0; i < entries.size(); i++) {
+            QCOMPARE(entries[i]->getFullPath(), FS::PathCombine(m_dir.filePath("entries"), paths[i]));
+            QCOMPARE(entries[i]->isStale(), i % 2 != 0);
+        }
+    }
+
+    void test_concurrentResolve()
+    {
+        HttpMetaCache cache;
+        cache.addBase("test", m_dir.filePath("concurrent"));
+        store(cache, "shared", "data");
+        touch(cache, "shared");
+
+        // every thread hashes the touched file and updates the same entry
+        QList<int> runs(64);
+        auto stale = QtConcurrent::blockingMapped<QList<bool>>(runs, [&cache](int) { return cache.resolveEntry("test", "shared")->isStale(); });
+        QVERIFY(!stale.contains(true));
+    }
+
+    void test_trustFileStat()
+    {
+        HttpMetaCache cache;
+        cache.addBase("test", m_dir.filePath("trust"));
+        store(cache, "hashed", "data");
+        store(cache, "trusted", "data");
+        touch(cache, "hashed");
+        touch(cache, "trusted");
+
+        // the content is the same, so hashing keeps the entry
+        QVERIFY(!cache.resolveEntry("test", "hashed")->isStale());
+
+        cache.setTrustFileStat(true);
+        QVERIFY(cache.resolveEntry("test", "trusted")->isStale());
+    }
+
+    void test_prune()
+    {
+        HttpMetaCache cache;
+        cache.addBase("test", m_dir.filePath("prune"));
+        store(cache, "fresh", "data");
+        store(cache, "recently_expired", "data");
+        store(cache, "long_expired", "data");
+        store(cache, "eternal", "data");
+        auto now = QDateTime::currentMSecsSinceEpoch();
+        auto expire = [&cache](const QString& path, qint64 stored_at) {
+            auto entry = cache.getEntry("test", path);
+            entry->makeEternal(false);
+            entry->setMaximumAge(3600);
+            entry->setLocalChangedTimestamp(stored_at);
+        };
+        expire("fresh", now);
+        expire("recently_expired", now - 2 * 3600 * 1000);
+        expire("long_expired", now - 30ll * 24 * 3600 * 1000);
+        {
+            QFile orphan(FS::PathCombine(cache.getBasePath("test"), "orphan"));
+            QVERIFY(orphan.open(QIODevice::WriteOnly));
+        }
+
+        cache.prune("test", 7 * 24 * 3600);
+
+        auto exists = [&cache](const QString& path) { return QFile::exists(FS::PathCombine(cache.getBasePath("test"), path)); };
+        for (auto path : { "fresh", "recently_expired", "eternal" }) {
+            QVERIFY(cache.getEntry("test", path));
+            QVERIFY(exists(path));
+        }
+        QVERIFY(!cache.getEntry("test", "long_expired"));
+        QVERIFY(!exists("long_expired"));
+        QVERIFY(!exists("orphan"));
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
@@ -0,0 +1,182 @@
+#include <QDateTime>
+#include <QDir>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <icons/FileIconEngine.h>
+#include <icons/IconList.h>
+
+class IconListTest : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_icons;
+    QString m_cache;
+
+    // a file that differs in size and time from what was there before
+    static bool writeIcon(const QString& path, int side, QColor color = Qt::red)
+    {
+        QImage image(side, side, QImage::Format_ARGB32);
+        image.fill(color);
+        if (!FS::ensureFilePathExists(path) || !image.save(path, "PNG"))
+            return false;
+        QFile file(path);
+        return file.open(QIODevice::ReadWrite) &&
+               file.setFileTime(QDateTime::currentDateTime().addSecs(side), QFileDevice::FileModificationTime);
+    }
+
+    static QStringList updatedKeys(const QSignalSpy& spy)
+    {
+        QStringList keys;
+        for (auto& args : spy)
+            keys.append(args.at(0).toString());
+        return keys;
+    }
+
+    // the folders are synced by hand, the watcher would do the same later on
+    std::unique_ptr<IconList> makeList()
+    {
+        auto list = std::make_unique<IconList>(QStringList(), m_icons, m_cache);
+        list->stopWatching();
+        return list;
+    }
+
+    QString path(const QString& name) const { return FS::PathCombine(m_icons, name); }
+
+   private slots:
+    void init()
+    {
+        QVERIFY(m_dir.isValid());
+        m_icons = FS::PathCombine(m_dir.path(), "icons");
+        m_cache = FS::PathCombine(m_dir.path(), "cache");
+        QVERIFY(FS::ensureFolderPathExists(m_icons));
+        QVERIFY(writeIcon(path("stone.png"), 16));
+    }
+
+    void cleanup()
+    {
+        QDir(m_icons).removeRecursively();
+        QDir(m_cache).removeRecursively();
+    }
+
+    void test_add()
+    {
+        // not an image, so never listed
+        QFile notes(path("notes.txt"));
+        QVERIFY(notes.open(QIODevice::WriteOnly));
+        notes.write("stone, dirt, ore");
+        notes.close();
+
+        auto list = makeList();
+        QCOMPARE(list->rowCount(), 1);
+        QVERIFY(list->iconFileExists("stone"));
+
+        QSignalSpy updated(list.get(), &IconList::iconUpdated);
+        QSignalSpy inserted(list.get(), &QAbstractItemModel::rowsInserted);
+
+        // nothing changed, nothing is read again
+        list->directoryChanged(m_icons);
+        QCOMPARE(updated.count(), 0);
+
+        QVERIFY(writeIcon(path("dirt.png"), 16));
+        QVERIFY(writeIcon(path("blocks/ore.png"), 16));
+        list->directoryChanged(m_icons);
+        QCOMPARE(inserted.count(), 2);
+        QCOMPARE(updatedKeys(updated), QStringList({ "dirt", "ore" }));
+        QCOMPARE(list->rowCount(), 3);
+
+        QStringList keys;
+        for (int row = 0; row < list->rowCount(); row++)
+            keys.append(list->data(list->index(row), Qt::UserRole).toString());
+        QCOMPARE(keys, QStringList({ "dirt", "ore", "stone" }));
+        QCOMPARE(list->data(list->index(1), Qt::DisplayRole).toString(), QString("blocks » ore"));
+        QCOMPARE(QFileInfo(list->icon("ore")->getFilePath()).absoluteFilePath(), QFileInfo(path("blocks/ore.png")).absoluteFilePath());
+    }
+
+    void test_replace()
+    {
+        auto list = makeList();
+        QCOMPARE(list->getIcon("stone").availableSizes(), QList<QSize>({ QSize(16, 16) }));
+
+        // a size that has to be scaled to is kept in the cache
+        auto cached = FileIconEngine::cacheFolder(m_cache, path("stone.png"));
+        QCOMPARE(list->getIcon("stone").pixmap(QSize(8, 8)).size(), QSize(8, 8));
+        QCOMPARE(QDir(cached).entryList(QDir::Files).size(), 1);
+
+        QSignalSpy updated(list.get(), &IconList::iconUpdated);
+        QSignalSpy changed(list.get(), &QAbstractItemModel::dataChanged);
+        QVERIFY(writeIcon(path("stone.png"), 32, Qt::blue));
+        list->directoryChanged(m_icons);
+
+        QCOMPARE(updatedKeys(updated), QStringList({ "stone" }));
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(list->rowCount(), 1);
+        QVERIFY(!QFileInfo::exists(cached));
+        auto icon = list->getIcon("stone");
+        QCOMPARE(icon.availableSizes(), QList<QSize>({ QSize(32, 32) }));
+        QCOMPARE(icon.pixmap(QSize(32, 32)).toImage().pixelColor(0, 0), QColor(Qt::blue));
+    }
+
+    void test_remove()
+    {
+        QVERIFY(writeIcon(path("dirt.png"), 16));
+        QVERIFY(writeIcon(path("blocks/ore.png"), 16));
+        QVERIFY(writeIcon(path("blocks/rare/gem.png"), 16));
+        auto list = makeList();
+        QCOMPARE(list->rowCount(), 4);
+
+        QSignalSpy updated(list.get(), &IconList::iconUpdated);
+        QSignalSpy removed(list.get(), &QAbstractItemModel::rowsRemoved);
+
+        QVERIFY(QFile::remove(path("dirt.png")));
+        list->directoryChanged(m_icons);
+        QCOMPARE(updatedKeys(updated), QStringList({ "dirt" }));
+        QCOMPARE(list->getIconIndex("dirt"), -1);
+
+        // a folder that is gone takes the folders below it along
+        QVERIFY(QDir(path("blocks")).removeRecursively());
+        updated.clear();
+        list->directoryChanged(path("blocks"));
+        auto keys = updatedKeys(updated);
+        keys.sort();
+        QCOMPARE(keys, QStringList({ "gem", "ore" }));
+        QCOMPARE(removed.count(), 3);
+        QCOMPARE(list->rowCount(), 1);
+        QVERIFY(list->iconFileExists("stone"));
+    }
+
+    void test_decodedLazily()
+    {
+        QVERIFY(writeIcon(path("big.png"), 64));
+        auto list = makeList();
+        auto cached = FileIconEngine::cacheFolder(m_cache, path("big.png"));
+
+        // only the header is read until a size is drawn
+        auto icon = list->getIcon("big");
+        QCOMPARE(icon.availableSizes(), QList<QSize>({ QSize(64, 64) }));
+        QVERIFY(!QFileInfo::exists(cached));
+
+        // the file's own size is not worth caching
+        QCOMPARE(icon.pixmap(QSize(64, 64)).size(), QSize(64, 64));
+        QVERIFY(!QFileInfo::exists(cached));
+
+        QCOMPARE(icon.pixmap(QSize(24, 24)).size(), QSize(24, 24));
+        auto files = QDir(cached).entryList(QDir::Files);
+        QCOMPARE(files.size(), 1);
+        QVERIFY(files.first().endsWith("-24x24.png"));
+
+        // the next start takes it from the cache instead of the file
+        QImage marker(24, 24, QImage::Format_ARGB32);
+        marker.fill(Qt::green);
+        QVERIFY(marker.save(FS::PathCombine(cached, files.first()), "PNG"));
+        QIcon again(new FileIconEngine(path("big.png"), m_cache));
+        QCOMPARE(again.pixmap(QSize(24, 24)).toImage().pixelColor(0, 0), QColor(Qt::green));
+    }
+};
+
+QTEST_MAIN(IconListTest)
+
+#include "IconList_test.moc"
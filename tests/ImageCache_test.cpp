@@ -0,0 +1,102 @@
+#include <QTest>
+
+#include <ImageCache.h>
+
+#include <thread>
+#include <vector>
+
+class ImageCacheTest : public QObject {
+    Q_OBJECT
+
+    static QImage makeImage(int side, QColor color = Qt::red)
+    {
+        QImage image(side, side, QImage::Format_ARGB32);
+        image.fill(color);
+        return image;
+    }
+
+   private slots:
+    void cleanup() { ImageCache::instance().clear(); }
+
+    void test_InsertFind()
+    {
+        auto& cache = ImageCache::instance();
+        auto key = cache.insert(makeImage(16));
+        QVERIFY(key != 0);
+
+        QImage found;
+        QVERIFY(cache.find(key, &found));
+        QCOMPARE(found.size(), QSize(16, 16));
+        QCOMPARE(found.pixelColor(0, 0), QColor(Qt::red));
+
+        cache.remove(key);
+        QVERIFY(!cache.find(key, &found));
+        QVERIFY(!cache.find(0, &found));
+    }
+
+    void test_EvictsLeastRecentlyUsed()
+    {
+        auto& cache = ImageCache::instance();
+        auto oldLimit = cache.cacheLimit();
+        // 16 shards, room for two 64x64 ARGB images in each
+        cache.setCacheLimit(16 * 2 * 64 * 64 * 4);
+
+        QList<ImageCache::Key> keys;
+        for (int i = 0; i < 16 * 3; i++) {
+            keys << cache.insert(makeImage(64));
+        }
+        QVERIFY(cache.totalCost() <= cache.cacheLimit());
+        // the first round went into every shard first, so it is what got evicted
+        for (int i = 0; i < 16; i++) {
+            QVERIFY(!cache.find(keys[i], nullptr));
+        }
+        for (int i = 16; i < keys.size(); i++) {
+            QVERIFY(cache.find(keys[i], nullptr));
+        }
+
+        cache.setCacheLimit(oldLimit);
+    }
+
+    void test_TooBig()
+    {
+        auto& cache = ImageCache::instance();
+        auto oldLimit = cache.cacheLimit();
+        cache.setCacheLimit(16 * 1024);
+        QCOMPARE(cache.insert(makeImage(256)), ImageCache::Key(0));
+        cache.setCacheLimit(oldLimit);
+    }
+
+    void test_Contention()
+    {
+        static constexpr int threadCount = 8;
+        static constexpr int iterations = 2000;
+        auto& cache = ImageCache::instance();
+
+        QBENCHMARK
+        {
+            std::vector<std::thread> threads;
+            for (int t = 0; t < threadCount; t++) {
+                threads.emplace_back([&cache] {
+                    auto image = makeImage(64, Qt::blue);
+                    QList<ImageCache::Key> own;
+                    for (int i = 0; i < iterations; i++) {
+                        own << cache.insert(image);
+                        QImage found;
+                        cache.find(own[i / 2], &found);
+                    }
+                    for (auto key : own) {
+                        cache.remove(key);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+        QCOMPARE(cache.totalCost(), qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(ImageCacheTest)
+
+#include "ImageCache_test.moc"
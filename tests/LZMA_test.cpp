@@ -0,0 +1,191 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <LZMA.h>
+
+class LZMATest : public QObject {
+    Q_OBJECT
+
+    // what python's lzma.compress(..., format=FORMAT_ALONE) makes of expected()
+    static QByteArray compressed()
+    {
+        return QByteArray::fromHex(
+            "5d00008000ffffffffffffffff0025184ac62094e661beef0c0030666595095d759654946271bbeab0a84ac3c3100d98fa3eaed9b53e9e8fddad"
+            "23f9cee4158646601d0e75794d891fd44a43489d6bb4fd2a0c04cfdc06b1d6cb7de68614920416e9793fa259467a9ddc59da94c4b295a35e5e38"
+            "13b220f3b0d119304d8a65d712912cc2bc223e2fd8d2815e93bf0e40916baf04e18e3b5b78b4f448e4a15db3575861ea4746509ab8c5b729a301"
+            "45df025e465e54be3d25d59def98bbf694c9322b5345a179acc946164f475b58d8ff673a1adcbb56e2b57a5982d3a432c882adb6780a939bf2f0"
+            "138063ccd1e372e616648d976167c9f30ed416f88b478b8f930f9af47a3c9b6a596bb57745aeba3f77f681dc5990e010469967bbcb01558fd728"
+            "c804789d99fff9a20800");
+    }
+
+    static QByteArray expected()
+    {
+        QByteArray data = QByteArray("Java runtime files share a lot of bytes. ").repeated(40);
+        for (int i = 0; i < 256; i++)
+            data.append(static_cast<char>(i));
+        return data;
+    }
+
+    static bool decode(QByteArray input, QByteArray& output, QString* error = nullptr)
+    {
+        QBuffer in(&input);
+        QBuffer out(&output);
+        in.open(QIODevice::ReadOnly);
+        out.open(QIODevice::WriteOnly);
+        return LZMA::decode(&in, &out, error);
+    }
+
+   private slots:
+    void test_decode()
+    {
+        QByteArray output;
+        QString error;
+        QVERIFY2(decode(compressed(), output, &error), qPrintable(error));
+        QCOMPARE(output, expected());
+    }
+
+    void test_knownSize()
+    {
+        // the same stream, with the decoded size in the header instead of "unknown"
+        auto input = compressed();
+        qint64 size = expected().size();
+        for (int i = 0; i < 8; i++)
+            input[5 + i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+
+        QByteArray output;
+        QVERIFY(decode(input, output));
+        QCOMPARE(output, expected());
+
+        // one byte less than the stream holds
+        size--;
+        input[5] = static_cast<char>(size & 0xFF);
+        QVERIFY(!decode(input, output));
+    }
+
+    // streams made by liblzma's .lzma encoder, the one Mojang's runtime files come from
+    void test_streams_data()
+    {
+        QTest::addColumn<QString>("file");
+        QTest::addColumn<qint64>("size");
+        QTest::addColumn<QByteArray>("sha1");
+
+        // 96 KiB through a 4 KiB window: it wraps and is flushed many times over
+        QTest::newRow("window") << "window.lzma" << qint64(98304) << QByteArray("b735a00ef494cde4310fe21f29dfe2152d7ada9a");
+        // a block repeated 168 KiB later, which needs position slots far above 14
+        QTest::newRow("distance") << "distance.lzma" << qint64(185724) << QByteArray("0c449b946121aabc3c754b311d412de9056cbb29");
+        // the same records with the literal and position contexts set apart from the usual 0x5d
+        QTest::newRow("lc0 lp2 pb0") << "lc0lp2pb0.lzma" << qint64(48000) << QByteArray("18599df8e91155eb863a9eb9ff44c5740f129305");
+        QTest::newRow("lc4 lp0 pb4") << "lc4lp0pb4.lzma" << qint64(48000) << QByteArray("18599df8e91155eb863a9eb9ff44c5740f129305");
+        QTest::newRow("lc1 lp3 pb2") << "lc1lp3pb2.lzma" << qint64(28000) << QByteArray("1deaacf560a13530c87a914fea9996c276a3841c");
+    }
+
+    void test_streams()
+    {
+        QFETCH(QString, file);
+        QFETCH(qint64, size);
+        QFETCH(QByteArray, sha1);
+
+        QFile in(QFINDTESTDATA("testdata/LZMA/" + file));
+        QVERIFY(in.open(QIODevice::ReadOnly));
+
+        QByteArray output;
+        QBuffer out(&output);
+        out.open(QIODevice::WriteOnly);
+        QString error;
+        QVERIFY2(LZMA::decode(&in, &out, &error), qPrintable(error));
+
+        QCOMPARE(qint64(output.size()), size);
+        QCOMPARE(QCryptographicHash::hash(output, QCryptographicHash::Sha1).toHex(), sha1);
+    }
+
+    void test_truncated()
+    {
+        QByteArray output;
+        QString error;
+        QVERIFY(!decode(compressed().left(100), output, &error));
+        QVERIFY(!error.isEmpty());
+    }
+
+    // the rest only has to fail cleanly, which the sanitizer builds check for memory errors
+    void test_truncatedAnywhere()
+    {
+        auto input = compressed();
+        for (int cut = 0; cut < input.size(); cut++) {
+            QByteArray output;
+            QString error;
+            QVERIFY2(!decode(input.left(cut), output, &error), qPrintable(QString::number(cut)));
+            QVERIFY(!error.isEmpty());
+        }
+    }
+
+    void test_corrupt_data()
+    {
+        QTest::addColumn<QString>("file");
+
+        QTest::newRow("small") << QString();
+        QTest::newRow("window") << "window.lzma";
+        QTest::newRow("distance") << "distance.lzma";
+        QTest::newRow("lc1 lp3 pb2") << "lc1lp3pb2.lzma";
+    }
+
+    void test_corrupt()
+    {
+        QFETCH(QString, file);
+
+        auto input = compressed();
+        if (!file.isEmpty()) {
+            QFile in(QFINDTESTDATA("testdata/LZMA/" + file));
+            QVERIFY(in.open(QIODevice::ReadOnly));
+            input = in.readAll();
+        }
+
+        QRandomGenerator random(42);
+        for (int round = 0; round < 500; round++) {
+            auto corrupt = input;
+            // every other round hits the header and the first range coder bytes, where most of the state is set up
+            int span = round % 2 ? int(corrupt.size()) : std::min(int(corrupt.size()), 64);
+            for (int flips = random.bounded(1, 5); flips > 0; flips--)
+                corrupt[random.bounded(span)] ^= static_cast<char>(1 << random.bounded(8));
+
+            QByteArray output;
+            QString error;
+            // a flipped bit may still decode to something, otherwise it has to say why
+            if (!decode(corrupt, output, &error))
+                QVERIFY2(!error.isEmpty(), qPrintable(QString::number(round)));
+        }
+    }
+
+    void test_header()
+    {
+        QByteArray output;
+        QString error;
+
+        // lc, lp and pb past their limits
+        auto input = compressed();
+        input[0] = static_cast<char>(9 * 5 * 5);
+        QVERIFY(!decode(input, output, &error));
+        QVERIFY(!error.isEmpty());
+
+        // the largest dictionary is fine, the window only takes what the data fills
+        input = compressed();
+        for (int i = 1; i < 5; i++)
+            input[i] = static_cast<char>(0xFF);
+        output.clear();
+        QVERIFY2(decode(input, output, &error), qPrintable(error));
+        QCOMPARE(output, expected());
+
+        // a decoded size far beyond what the stream holds
+        input = compressed();
+        for (int i = 5; i < 13; i++)
+            input[i] = static_cast<char>(0x7F);
+        output.clear();
+        QVERIFY(!decode(input, output, &error));
+    }
+};
+
+QTEST_GUILESS_MAIN(LZMATest)
+
+#include "LZMA_test.moc"
@@ -0,0 +1,163 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <quazip/quazipnewinfo.h>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+
+class MMCZipTest : public QObject {
+    Q_OBJECT
+
+    static bool addEntry(QuaZip& zip, const QString& name, const QByteArray& data, bool stored)
+    {
+        QuaZipFile file(&zip);
+        if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(name), nullptr, 0, stored ? 0 : Z_DEFLATED))
+            return false;
+        file.write(data);
+        file.close();
+        return file.getZipError() == ZIP_OK;
+    }
+
+    static QByteArray contentsOf(int i) { return QByteArray(i * 531, static_cast<char>('a' + i % 26)); }
+
+   private slots:
+    void test_extractParallel()
+    {
+        QTemporaryDir tempDir;
+        auto archive = FS::PathCombine(tempDir.path(), "test.zip");
+        {
+            QuaZip zip(archive);
+            QVERIFY(zip.open(QuaZip::mdCreate));
+            for (int i = 0; i < 100; i++)
+                QVERIFY(addEntry(zip, QString("pack/dir%1/file%2.txt").arg(i % 7).arg(i), contentsOf(i), i % 2 == 0));
+            QVERIFY(addEntry(zip, "other/file.txt", "not extracted", false));
+            zip.close();
+        }
+
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        auto target = FS::PathCombine(tempDir.path(), "out");
+        qint64 last_progress = 0;
+        MMCZip::ParallelExtractor extractor(&zip, "pack/", target);
+        extractor.workers(4).onProgress([&last_progress](qint64 extracted, qint64, const QString&) { last_progress = extracted; });
+
+        QVERIFY(!extractor().has_value());
+        QCOMPARE(extractor.extracted().size(), 100);
+        QCOMPARE(extractor.extracted().first(), FS::PathCombine(target, "dir0", "file0.txt"));
+        for (int i = 0; i < 100; i++)
+            QCOMPARE(FS::read(FS::PathCombine(target, QString("dir%1").arg(i % 7), QString("file%1.txt").arg(i))), contentsOf(i));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(target, "file.txt")));
+
+        qint64 total = 0;
+        for (int i = 0; i < 100; i++)
+            total += contentsOf(i).size();
+        QCOMPARE(last_progress, total);
+    }
+
+    void test_extractOutsideTarget()
+    {
+        QTemporaryDir tempDir;
+        auto archive = FS::PathCombine(tempDir.path(), "evil.zip");
+        {
+            QuaZip zip(archive);
+            QVERIFY(zip.open(QuaZip::mdCreate));
+            QVERIFY(addEntry(zip, "fine.txt", "fine", false));
+            QVERIFY(addEntry(zip, "../evil.txt", "evil", true));
+            zip.close();
+        }
+
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        auto target = FS::PathCombine(tempDir.path(), "out");
+        MMCZip::ParallelExtractor extractor(&zip, "", target);
+
+        QVERIFY(extractor().has_value());
+        QVERIFY(extractor.extracted().isEmpty());
+        // nothing is written once any entry is refused
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(target, "fine.txt")));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(tempDir.path(), "evil.txt")));
+    }
+
+    void test_writeParallel()
+    {
+        QTemporaryDir tempDir;
+        QByteArray large;
+        for (int i = 0; i < 3 * 1024 * 1024 + 17; i++)
+            large.append(static_cast<char>('a' + (i * 7 + i / 4096) % 26));
+        FS::write(FS::PathCombine(tempDir.path(), "src", "large.txt"), large);
+        FS::write(FS::PathCombine(tempDir.path(), "src", "icon.png"), contentsOf(3));
+        FS::write(FS::PathCombine(tempDir.path(), "src", "empty.txt"), {});
+
+        auto archive = FS::PathCombine(tempDir.path(), "out.zip");
+        {
+            QuaZip zip(archive);
+            QVERIFY(zip.open(QuaZip::mdCreate));
+            MMCZip::ParallelZipWriter writer(&zip);
+            writer.workers(4);
+            writer.addData("index.json", "{}");
+            for (auto name : { "large.txt", "icon.png", "empty.txt" })
+                writer.addFile(FS::PathCombine(tempDir.path(), "src", name), QString("overrides/") + name);
+            QVERIFY(!writer().has_value());
+            zip.close();
+            QCOMPARE(zip.getZipError(), ZIP_OK);
+        }
+
+        QuaZip zip(archive);
+        QVERIFY(zip.open(QuaZip::mdUnzip));
+        QCOMPARE(zip.getFileNameList(), QStringList({ "index.json", "overrides/large.txt", "overrides/icon.png", "overrides/empty.txt" }));
+        auto read = [&zip](const QString& name) {
+            zip.setCurrentFile(name);
+            QuaZipFile file(&zip);
+            file.open(QIODevice::ReadOnly);
+            auto data = file.readAll();
+            file.close();
+            return file.getZipError() == UNZ_OK ? data : QByteArray("crc mismatch");
+        };
+        QCOMPARE(read("index.json"), QByteArray("{}"));
+        QCOMPARE(read("overrides/large.txt"), large);
+        QCOMPARE(read("overrides/icon.png"), contentsOf(3));
+        QCOMPARE(read("overrides/empty.txt"), QByteArray());
+
+        QuaZipFileInfo64 info;
+        zip.setCurrentFile("overrides/icon.png");
+        QVERIFY(zip.getCurrentFileInfo(&info));
+        QCOMPARE(info.method, static_cast<quint16>(0));
+        zip.setCurrentFile("overrides/large.txt");
+        QVERIFY(zip.getCurrentFileInfo(&info));
+        QCOMPARE(info.method, static_cast<quint16>(Z_DEFLATED));
+        QVERIFY(info.compressedSize < info.uncompressedSize);
+    }
+
+    // 16 MiB of compressible text per iteration
+    void benchmark_writeArchive()
+    {
+        QTemporaryDir tempDir;
+        QStringList files;
+        for (int i = 0; i < 64; i++) {
+            QByteArray data;
+            for (int j = 0; j < 256 * 1024; j++)
+                data.append(static_cast<char>('a' + (i * j / 13 + j / 97) % 26));
+            files.append(FS::PathCombine(tempDir.path(), "src", QString("file%1.txt").arg(i)));
+            FS::write(files.last(), data);
+        }
+
+        auto archive = FS::PathCombine(tempDir.path(), "out.zip");
+        QBENCHMARK
+        {
+            QuaZip zip(archive);
+            zip.open(QuaZip::mdCreate);
+            MMCZip::ParallelZipWriter writer(&zip);
+            for (auto& file : files)
+                writer.addFile(file, QFileInfo(file).fileName());
+            writer();
+            zip.close();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MMCZipTest)
+
+#include "MMCZip_test.moc"
@@ -0,0 +1,84 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include <minecraft/mod/Resource.h>
+#include <modplatform/helpers/VersionIndex.h>
+#include <modplatform/modrinth/ModrinthCheckUpdate.h>
+
+class ModrinthCheckUpdateTest : public QObject {
+    Q_OBJECT
+
+    std::list<Version> m_game_versions{ Version("1.20.1") };
+
+    static Resource* resource(QObject* parent, const QString& project_id, const QString& hash)
+    {
+        auto resource = new Resource(QFileInfo(project_id + ".jar"));
+        resource->setParent(parent);
+        Metadata::ModStruct metadata;
+        metadata.slug = project_id.toLower();
+        metadata.project_id = project_id;
+        metadata.provider = ModPlatform::ResourceProvider::MODRINTH;
+        metadata.hash_format = "sha512";
+        metadata.hash = hash;
+        resource->setMetadata(metadata);
+        return resource;
+    }
+
+    // what Modrinth answers for a version whose file is the one that is installed
+    static QJsonObject version(const QString& project_id, const QString& hash)
+    {
+        return QJsonObject{ { "project_id", project_id },
+                            { "id", "IZskON6d" },
+                            { "date_published", "2024-01-01T00:00:00Z" },
+                            { "game_versions", QJsonArray{ "1.20.1" } },
+                            { "loaders", QJsonArray{ "fabric" } },
+                            { "name", "1.0.0" },
+                            { "version_number", "1.0.0" },
+                            { "version_type", "release" },
+                            { "changelog", "" },
+                            { "files", QJsonArray{ QJsonObject{ { "url", "https://cdn.modrinth.com/a.jar" },
+                                                                { "filename", "a.jar" },
+                                                                { "primary", true },
+                                                                { "hashes", QJsonObject{ { "sha512", hash } } } } } } };
+    }
+
+   private slots:
+    void cleanup() { VersionIndex::instance().clear(); }
+
+    // with everything in the index no request is made, and each loader is still only asked once
+    void test_warmIndex()
+    {
+        QObject owner;
+        QList<Resource*> resources{ resource(&owner, "AANobbMI", "aaaa"), resource(&owner, "P7dR8mSH", "bbbb") };
+        QList<ModPlatform::ModLoaderType> loaders{ ModPlatform::Quilt, ModPlatform::Fabric };
+
+        auto& index = VersionIndex::instance();
+        auto key = [this](const QString& project_id, ModPlatform::ModLoaderType loader) {
+            return VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, project_id, ModPlatform::ModLoaderTypes(loader),
+                                     m_game_versions);
+        };
+        // neither has a Quilt build, only the first one has a Fabric build
+        index.insert(key("AANobbMI", ModPlatform::Quilt), {});
+        index.insert(key("P7dR8mSH", ModPlatform::Quilt), {});
+        index.insert(key("AANobbMI", ModPlatform::Fabric), version("AANobbMI", "aaaa"));
+        index.insert(key("P7dR8mSH", ModPlatform::Fabric), {});
+
+        for (int run = 0; run < 2; run++) {
+            ModrinthCheckUpdate check(resources, m_game_versions, loaders, nullptr);
+            QSignalSpy check_failed(&check, &CheckUpdateTask::checkFailed);
+            QSignalSpy succeeded(&check, &Task::succeeded);
+
+            check.start();
+
+            QTRY_COMPARE(succeeded.count(), 1);
+            QCOMPARE(check_failed.count(), 1);
+            QCOMPARE(check_failed.first().first().value<Resource*>(), resources.at(1));
+            QVERIFY(check.getUpdates().empty());
+            QCOMPARE(check.getDependencies().size(), 1);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ModrinthCheckUpdateTest)
+
+#include "ModrinthCheckUpdate_test.moc"
@@ -83,6 +83,48 @@ class PackwizTest : public QObject {
         QCOMPARE(metadata.file_id, 3509043);
         QCOMPARE(metadata.project_id, 327154);
     }
+
+    void index_updateAndRemove()
+    {
+        QTemporaryDir tmp;
+        QDir index_dir(tmp.path());
+
+        Packwiz::V1::Mod mod;
+        mod.slug = "Some-Mod";
+        mod.name = "Some Mod";
+        mod.filename = "some-mod-1.0.jar";
+        mod.provider = ModPlatform::ResourceProvider::MODRINTH;
+        mod.project_id = "AABBCCDD";
+        mod.file_id = "EEFFGGHH";
+        mod.hash_format = "sha512";
+        mod.hash = "abcdef";
+
+        auto index = Packwiz::Index::of(index_dir);
+        QCOMPARE(index, Packwiz::Index::of(QDir(tmp.path() + "/.")));
+
+        index->update(mod);
+        // nothing is written before the flush
+        QVERIFY(!index_dir.exists("Some-Mod.pw.toml"));
+        QCOMPARE(index->mods().size(), 1);
+
+        index->flush();
+        QVERIFY(index_dir.exists("Some-Mod.pw.toml"));
+
+        // lookups don't care about case
+        auto metadata = index->get(QString("some-mod"));
+        QVERIFY(metadata.isValid());
+        QCOMPARE(metadata.name, "Some Mod");
+        QCOMPARE(metadata.slug, "some-mod");
+
+        QVariant project_id("AABBCCDD");
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, project_id).filename, "some-mod-1.0.jar");
+
+        index->remove("SOME-MOD");
+        QVERIFY(!index->get(QString("Some-Mod")).isValid());
+        index->flush();
+        QVERIFY(!index_dir.exists("Some-Mod.pw.toml"));
+        QVERIFY(index->mods().isEmpty());
+    }
 };
 
 QTEST_GUILESS_MAIN(PackwizTest)
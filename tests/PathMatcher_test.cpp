@@ -0,0 +1,85 @@
+#include <QTest>
+
+#include <pathmatcher/CompiledMatcher.h>
+#include <pathmatcher/MultiMatcher.h>
+#include <pathmatcher/SimplePrefixMatcher.h>
+
+class PathMatcherTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_prefixesMatchLikeSimplePrefixMatcher()
+    {
+        QStringList prefixes{ "logs/", "accounts.json", "accounts/", "instances/", "a/b/" };
+        CompiledMatcher compiled;
+        MultiMatcher reference;
+        for (auto& prefix : prefixes) {
+            compiled.addPrefix(prefix);
+            reference.add(std::make_shared<SimplePrefixMatcher>(prefix));
+        }
+
+        QStringList paths{ "logs/latest.log", "logs",           "accounts.json",   "accounts.json.bak", "accounts/x/y.json",
+                           "x/accounts.json", "instances/a/b",  "a/b/c",           "a/bc",              "a/b",
+                           "themes/x",        "logs/deep/a/b/c" };
+        for (auto& path : paths) {
+            QCOMPARE(compiled.matches(path), reference.matches(path));
+        }
+    }
+
+    void test_globs()
+    {
+        CompiledMatcher matcher;
+        matcher.addGlob("*.txt").addGlob("saves/**").addGlob("**/cache/*.bin").addGlob("config/?.cfg");
+
+        QVERIFY(matcher.matches("options.txt"));
+        QVERIFY(!matcher.matches("logs/options.txt"));
+        QVERIFY(matcher.matches("saves/world/level.dat"));
+        QVERIFY(!matcher.matches("saves"));
+        QVERIFY(matcher.matches("cache/a.bin"));
+        QVERIFY(matcher.matches("mods/x/cache/a.bin"));
+        QVERIFY(!matcher.matches("mods/x/cache/a.txt"));
+        QVERIFY(matcher.matches("config/a.cfg"));
+        QVERIFY(!matcher.matches("config/ab.cfg"));
+    }
+
+    void test_gitignore()
+    {
+        CompiledMatcher matcher;
+        matcher.addGitignore("# a comment").addGitignore("*.log").addGitignore("/build/").addGitignore("docs/*.md").addGitignore("!keep.log");
+
+        QVERIFY(matcher.matches("latest.log"));
+        QVERIFY(matcher.matches("logs/old/latest.log"));
+        QVERIFY(matcher.matches("keep.log"));
+        QVERIFY(matcher.matches("build/out/a.o"));
+        QVERIFY(!matcher.matches("src/build/a.o"));
+        QVERIFY(matcher.matches("docs/readme.md"));
+        QVERIFY(!matcher.matches("docs/sub/readme.md"));
+        QVERIFY(!matcher.matches("src/main.cpp"));
+    }
+
+    void test_caseInsensitive()
+    {
+        CompiledMatcher matcher;
+        matcher.caseSensitive(false).addPrefix("Saves/").addGlob("*.TXT");
+
+        QVERIFY(matcher.matches("saves/world/level.dat"));
+        QVERIFY(matcher.matches("readme.txt"));
+    }
+
+    void test_matchesUnder()
+    {
+        CompiledMatcher matcher;
+        matcher.addPrefix(".minecraft/saves/").addGlob(".minecraft/mods/*.jar");
+
+        QVERIFY(matcher.matchesUnder(".minecraft/saves") == IPathMatcher::Subtree::All);
+        QVERIFY(matcher.matchesUnder(".minecraft/saves/world/region") == IPathMatcher::Subtree::All);
+        QVERIFY(matcher.matchesUnder(".minecraft") == IPathMatcher::Subtree::Some);
+        QVERIFY(matcher.matchesUnder(".minecraft/mods") == IPathMatcher::Subtree::Some);
+        QVERIFY(matcher.matchesUnder(".minecraft/config") == IPathMatcher::Subtree::None);
+        QVERIFY(matcher.matchesUnder("libraries") == IPathMatcher::Subtree::None);
+    }
+};
+
+QTEST_GUILESS_MAIN(PathMatcherTest)
+
+#include "PathMatcher_test.moc"
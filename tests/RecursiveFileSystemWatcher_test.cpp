@@ -0,0 +1,215 @@
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <InotifyWatcher.h>
+#include <RecursiveFileSystemWatcher.h>
+#include <pathmatcher/SimplePrefixMatcher.h>
+
+using Type = FileEvent::Type;
+
+class RecursiveFileSystemWatcherTest : public QObject {
+    Q_OBJECT
+
+    static bool touch(const QString& path, const QByteArray& data = "x")
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+            return false;
+        return file.write(data) == data.size();
+    }
+
+    static QStringList changedFolders(const QSignalSpy& spy)
+    {
+        QStringList folders;
+        for (auto& args : spy)
+            folders.append(args.at(0).toString());
+        return folders;
+    }
+
+   private slots:
+    void test_queueFoldsEventsOfOnePath()
+    {
+        FileEventQueue queue;
+        queue.add({ Type::Created, "/a/x" });
+        queue.add({ Type::Modified, "/a/x" });
+        queue.add({ Type::Created, "/a/gone" });
+        queue.add({ Type::Deleted, "/a/gone" });
+        queue.add({ Type::Deleted, "/a/replaced" });
+        queue.add({ Type::Created, "/a/replaced" });
+
+        auto events = queue.take();
+        QCOMPARE(events.size(), 2);
+        QCOMPARE(events[0].path, "/a/x");
+        QVERIFY(events[0].type == Type::Created);
+        QCOMPARE(events[1].path, "/a/replaced");
+        QVERIFY(events[1].type == Type::Modified);
+        QVERIFY(queue.isEmpty());
+    }
+
+    void test_queueFoldsMoves()
+    {
+        FileEventQueue queue;
+        queue.add({ Type::Moved, "/a/y", "/a/x" });
+        queue.add({ Type::Moved, "/a/z", "/a/y" });
+        queue.add({ Type::Created, "/a/new.tmp" });
+        queue.add({ Type::Moved, "/a/new", "/a/new.tmp" });
+        queue.add({ Type::Moved, "/a/back", "/a/there" });
+        queue.add({ Type::Moved, "/a/there", "/a/back" });
+
+        auto events = queue.take();
+        QCOMPARE(events.size(), 3);
+        QVERIFY(events[0].type == Type::Moved);
+        QCOMPARE(events[0].from, "/a/x");
+        QCOMPARE(events[0].path, "/a/z");
+        QVERIFY(events[1].type == Type::Created);
+        QCOMPARE(events[1].path, "/a/new");
+        QVERIFY(events[2].type == Type::Modified);
+        QCOMPARE(events[2].path, "/a/there");
+    }
+
+    void test_queueOverflowReplacesEverything()
+    {
+        FileEventQueue queue;
+        queue.add({ Type::Created, "/a/x" });
+        queue.add({ Type::Overflow, "/a" });
+        queue.add({ Type::Modified, "/a/y" });
+
+        auto events = queue.take();
+        QCOMPARE(events.size(), 1);
+        QVERIFY(events[0].type == Type::Overflow);
+        QCOMPARE(events[0].path, "/a");
+    }
+
+    void test_reportsChangesInNewFolders()
+    {
+        QTemporaryDir tempDir;
+        QDir root(tempDir.path());
+        auto rootPath = root.absolutePath();
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setRootDir(root);
+        watcher.setMatcher(std::make_shared<SimplePrefixMatcher>("deep/"));
+        watcher.enable();
+        QSignalSpy folders(&watcher, &RecursiveFileSystemWatcher::directoryChanged);
+
+        // the folder is created after watching started, and watched from then on
+        QVERIFY(root.mkpath("deep/er"));
+        QTRY_VERIFY(changedFolders(folders).contains(rootPath));
+        auto deeper = FS::PathCombine(rootPath, "deep", "er");
+
+        folders.clear();
+        QVERIFY(touch(FS::PathCombine(deeper, "a.png")));
+        QTRY_VERIFY(changedFolders(folders).contains(deeper));
+        QTRY_COMPARE(watcher.files(), QStringList{ "deep/er/a.png" });
+
+        folders.clear();
+        QVERIFY(QFile::rename(FS::PathCombine(deeper, "a.png"), FS::PathCombine(deeper, "b.png")));
+        QTRY_COMPARE(watcher.files(), QStringList{ "deep/er/b.png" });
+        QVERIFY(changedFolders(folders).contains(deeper));
+
+        folders.clear();
+        QVERIFY(QFile::remove(FS::PathCombine(deeper, "b.png")));
+        QTRY_VERIFY(watcher.files().isEmpty());
+        QVERIFY(changedFolders(folders).contains(deeper));
+
+        watcher.disable();
+    }
+
+    void test_reportsModifiedFiles()
+    {
+        QTemporaryDir tempDir;
+        QDir root(tempDir.path());
+        auto path = root.absoluteFilePath("icon.png");
+        QVERIFY(touch(path));
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setRootDir(root);
+        watcher.setWatchFiles(true);
+        watcher.enable();
+        QSignalSpy files(&watcher, &RecursiveFileSystemWatcher::fileChanged);
+        QSignalSpy events(&watcher, &RecursiveFileSystemWatcher::fileEvents);
+
+        QVERIFY(touch(path, "more"));
+        QTRY_VERIFY(!files.isEmpty());
+        QCOMPARE(files.first().at(0).toString(), path);
+        QVERIFY(!events.isEmpty());
+
+        watcher.disable();
+    }
+
+    void test_maxDepth()
+    {
+        QTemporaryDir tempDir;
+        QDir root(tempDir.path());
+        QVERIFY(root.mkpath("pack/assets"));
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setRootDir(root);
+        watcher.setMaxDepth(1);
+        watcher.enable();
+        QSignalSpy spy(&watcher, &RecursiveFileSystemWatcher::fileEvents);
+        auto reported = [&spy] {
+            QStringList paths;
+            for (auto& args : spy)
+                for (auto& event : args.at(0).value<QList<FileEvent>>())
+                    paths.append(event.path);
+            return paths;
+        };
+
+        // the deep one goes first, it would be reported along with the other one if it was watched
+        QVERIFY(touch(root.absoluteFilePath("pack/assets/a.png")));
+        QVERIFY(touch(root.absoluteFilePath("pack/pack.mcmeta")));
+        QTRY_VERIFY(reported().contains(root.absoluteFilePath("pack/pack.mcmeta")));
+        QTest::qWait(2 * InotifyWatcher::s_debounceMs);
+        QVERIFY(!reported().contains(root.absoluteFilePath("pack/assets/a.png")));
+
+        // a new folder is watched down to the same depth
+        spy.clear();
+        QVERIFY(root.mkpath("other/assets"));
+        QTRY_VERIFY(reported().contains(root.absoluteFilePath("other/assets")));
+        QVERIFY(touch(root.absoluteFilePath("other/assets/b.png")));
+        QVERIFY(touch(root.absoluteFilePath("other/pack.mcmeta")));
+        QTRY_VERIFY(reported().contains(root.absoluteFilePath("other/pack.mcmeta")));
+        QTest::qWait(2 * InotifyWatcher::s_debounceMs);
+        QVERIFY(!reported().contains(root.absoluteFilePath("other/assets/b.png")));
+
+        watcher.disable();
+    }
+
+    void test_fallsBackWhenAFolderCanNotBeWatched()
+    {
+        if (!InotifyWatcher::instance())
+            QSKIP("inotify is not available");
+        QTemporaryDir tempDir;
+        QDir root(tempDir.path());
+        auto rootPath = root.absolutePath();
+        // inotify needs to be able to read a folder to watch it
+        QVERIFY(root.mkdir("locked"));
+        QVERIFY(QFile::setPermissions(root.absoluteFilePath("locked"), QFileDevice::Permissions()));
+        if (QFileInfo(root.absoluteFilePath("locked")).isReadable())
+            QSKIP("permissions are not enforced for this user");
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setRootDir(root);
+        watcher.enable();
+        QSignalSpy events(&watcher, &RecursiveFileSystemWatcher::fileEvents);
+        QSignalSpy folders(&watcher, &RecursiveFileSystemWatcher::directoryChanged);
+
+        QTRY_VERIFY(!events.isEmpty());
+        QCOMPARE(events.first().at(0).value<QList<FileEvent>>().first().type, Type::Overflow);
+
+        // the rest of the tree is still watched
+        folders.clear();
+        QVERIFY(touch(FS::PathCombine(rootPath, "a.png")));
+        QTRY_VERIFY(changedFolders(folders).contains(rootPath));
+
+        watcher.disable();
+        QFile::setPermissions(root.absoluteFilePath("locked"), QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+    }
+};
+
+QTEST_GUILESS_MAIN(RecursiveFileSystemWatcherTest)
+
+#include "RecursiveFileSystemWatcher_test.moc"
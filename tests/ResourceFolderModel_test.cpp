@@ -33,6 +33,7 @@
  *      limitations under the License.
  */
 
+#include <QElapsedTimer>
 #include <QTemporaryDir>
 #include <QTest>
 #include <QTimer>
@@ -243,6 +244,131 @@ class ResourceFolderModelTest : public QObject {
         QVERIFY(res_2.enabled() == initial_enabled_res_2);
         QVERIFY(res_2.internal_id() == id_2);
     }
+
+    void test_singleFileChange()
+    {
+        QTemporaryDir tmp;
+        QDir dir(tmp.path());
+        for (int i = 0; i < 1000; i++) {
+            QFile file(dir.filePath(QString("mod%1.jar").arg(i)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("PK");
+        }
+
+        int inserted = 0;
+        int removed = 0;
+        int changed = 0;
+        ResourceFolderModel model(dir, nullptr, false, false);
+        connect(&model, &QAbstractItemModel::rowsInserted, this, [&inserted](const QModelIndex&, int first, int last) {
+            inserted += last - first + 1;
+        });
+        connect(&model, &QAbstractItemModel::rowsRemoved, this, [&removed](const QModelIndex&, int first, int last) {
+            removed += last - first + 1;
+        });
+        connect(&model, &QAbstractItemModel::dataChanged, this, [&changed](const QModelIndex& top_left, const QModelIndex& bottom_right) {
+            changed += bottom_right.row() - top_left.row() + 1;
+        });
+
+        QElapsedTimer timer;
+        timer.start();
+        { EXEC_UPDATE_TASK(model.update(), QVERIFY) }
+        qDebug() << "Loading 1000 resources took" << timer.elapsed() << "ms";
+        QCOMPARE(model.size(), 1000);
+        inserted = 0;
+
+        // a new file
+        {
+            QFile file(dir.filePath("new.jar"));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("PK");
+        }
+        timer.restart();
+        { EXEC_UPDATE_TASK(model.update({ "new.jar" }), QVERIFY) }
+        qDebug() << "Adding one of 1001 resources took" << timer.elapsed() << "ms";
+        QCOMPARE(model.size(), 1001);
+        QCOMPARE(inserted, 1);
+        QCOMPARE(removed, 0);
+        QCOMPARE(changed, 0);
+        QCOMPARE(model.at(1000).internal_id(), "new.jar");
+
+        // a changed file
+        {
+            QFile file(dir.filePath("mod5.jar"));
+            QVERIFY(file.open(QIODevice::Append));
+            file.write("changed");
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        }
+        { EXEC_UPDATE_TASK(model.update({ "mod5.jar" }), QVERIFY) }
+        QCOMPARE(changed, 1);
+
+        // a removed file
+        QVERIFY(dir.remove("mod7.jar"));
+        { EXEC_UPDATE_TASK(model.update({ "mod7.jar" }), QVERIFY) }
+        QCOMPARE(model.size(), 1000);
+        QCOMPARE(removed, 1);
+        QCOMPARE(inserted, 1);
+        QVERIFY(!model.find("mod7.jar"));
+        QVERIFY(model.find("mod8.jar"));
+    }
+
+    // the same changes as above, but picked up by the watcher
+    void test_watchedChanges()
+    {
+        QTemporaryDir tmp;
+        QDir dir(tmp.path());
+        auto write = [&dir](const QString& name) {
+            QFile file(dir.filePath(name));
+            return file.open(QIODevice::WriteOnly) && file.write("PK") == 2;
+        };
+        QVERIFY(write("mod1.jar"));
+        QVERIFY(write("mod2.jar"));
+        QVERIFY(dir.mkpath("pack/assets"));
+        QVERIFY(write("pack/pack.mcmeta"));
+
+        int inserted = 0;
+        int removed = 0;
+        int changed = 0;
+        ResourceFolderModel model(dir, nullptr, false, false);
+        connect(&model, &QAbstractItemModel::rowsInserted, this, [&inserted](const QModelIndex&, int first, int last) {
+            inserted += last - first + 1;
+        });
+        connect(&model, &QAbstractItemModel::rowsRemoved, this, [&removed](const QModelIndex&, int first, int last) {
+            removed += last - first + 1;
+        });
+        connect(&model, &QAbstractItemModel::dataChanged, this, [&changed](const QModelIndex& top_left, const QModelIndex& bottom_right) {
+            changed += bottom_right.row() - top_left.row() + 1;
+        });
+
+        { EXEC_UPDATE_TASK(model.startWatching(), QVERIFY) }
+        QCOMPARE(model.size(), 3);
+        inserted = 0;
+
+        QVERIFY(write("new.jar"));
+        QTRY_COMPARE(inserted, 1);
+        QVERIFY(model.find("new.jar"));
+
+        {
+            QFile file(dir.filePath("mod1.jar"));
+            QVERIFY(file.open(QIODevice::Append));
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        }
+        QTRY_COMPARE(changed, 1);
+
+        // a new file at the top of a folder resource changes the folder
+        QTest::qWait(20);
+        QVERIFY(write("pack/pack.png"));
+        QTRY_COMPARE(changed, 2);
+
+        QVERIFY(dir.rename("mod2.jar", "renamed.jar"));
+        QTRY_VERIFY(model.find("renamed.jar"));
+        QVERIFY(!model.find("mod2.jar"));
+
+        QVERIFY(dir.remove("new.jar"));
+        QTRY_VERIFY(!model.find("new.jar"));
+        QCOMPARE(model.size(), 3);
+
+        QVERIFY(model.stopWatching());
+    }
 };
 
 QTEST_GUILESS_MAIN(ResourceFolderModelTest)
@@ -0,0 +1,98 @@
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <java/download/StreamingExtractor.h>
+
+class StreamingExtractorTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray archive()
+    {
+        QFile file(QFINDTESTDATA("testdata/StreamingExtractor/runtime.tar"));
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    /* Feeds the archive in small parts, the way a download hands it over. */
+    static bool extract(Java::StreamingExtractor& extractor, const QByteArray& data)
+    {
+        QSignalSpy finished(&extractor, &Java::StreamingExtractor::finished);
+        for (qsizetype i = 0; i < data.size(); i += 700)
+            extractor.write(data.mid(i, 700));
+        extractor.endOfData();
+        if (!finished.wait(5000))
+            return false;
+        return finished.first().first().toBool();
+    }
+
+   private slots:
+    void test_linksResolveAfterCommit()
+    {
+        QTemporaryDir dir;
+        auto target = FS::PathCombine(dir.path(), "java-runtime");
+        auto data = archive();
+        QVERIFY(!data.isEmpty());
+
+        {
+            Java::StreamingExtractor extractor(target, false);
+            QVERIFY(extract(extractor, data));
+            QVERIFY(extractor.commit());
+        }
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(dir.path(), ".java-runtime.partial")));
+
+        QByteArray content("not really a library\n");
+        auto library = FS::PathCombine(target, "lib", "libjli.so");
+        QCOMPARE(FS::read(library), content);
+
+        auto symlink = QFileInfo(FS::PathCombine(target, "bin", "libjli.so"));
+        QVERIFY(symlink.isSymLink());
+        QCOMPARE(symlink.canonicalFilePath(), QFileInfo(library).canonicalFilePath());
+        QCOMPARE(FS::read(symlink.filePath()), content);
+
+        QCOMPARE(FS::read(FS::PathCombine(target, "lib", "libjli.copy.so")), content);
+    }
+
+    void test_failureLeavesTargetAlone()
+    {
+        QTemporaryDir dir;
+        auto target = FS::PathCombine(dir.path(), "java-runtime");
+        QVERIFY(FS::ensureFolderPathExists(target));
+        FS::write(FS::PathCombine(target, "release"), "JAVA_VERSION=\"17\"\n");
+
+        {
+            Java::StreamingExtractor extractor(target, false);
+            // cut off in the middle of a header
+            QVERIFY(!extract(extractor, archive().left(1300)));
+            QVERIFY(!extractor.commit());
+        }
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(dir.path(), ".java-runtime.partial")));
+        QCOMPARE(FS::read(FS::PathCombine(target, "release")), QByteArray("JAVA_VERSION=\"17\"\n"));
+    }
+
+    void test_cancelThrowsAwayStaging()
+    {
+        QTemporaryDir dir;
+        auto target = FS::PathCombine(dir.path(), "java-runtime");
+        auto data = archive();
+
+        {
+            Java::StreamingExtractor extractor(target, false);
+            QSignalSpy finished(&extractor, &Java::StreamingExtractor::finished);
+            extractor.write(data.left(2048));
+            extractor.cancel();
+            QVERIFY(finished.wait(5000));
+            QCOMPARE(finished.first().first().toBool(), false);
+            QVERIFY(!extractor.commit());
+        }
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(dir.path(), ".java-runtime.partial")));
+        QVERIFY(!QFileInfo::exists(target));
+    }
+};
+
+QTEST_GUILESS_MAIN(StreamingExtractorTest)
+
+#include "StreamingExtractor_test.moc"
@@ -6,7 +6,13 @@
 #include <tasks/MultipleOptionsTask.h>
 #include <tasks/SequentialTask.h>
 #include <tasks/Task.h>
+#include <tasks/TaskTrace.h>
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
 #include <array>
 
 /* Does nothing. Only used for testing. */
@@ -34,6 +40,19 @@ class BasicTask_MultiStep : public Task {
     void executeTask() override {}
 };
 
+/* Reports a burst of progress, then finishes a little later. */
+class TickingTask : public Task {
+    Q_OBJECT
+
+   private:
+    void executeTask() override
+    {
+        for (int i = 1; i <= 1000; i++)
+            setProgress(i, 1000);
+        QTimer::singleShot(100, this, &TickingTask::emitSucceeded);
+    }
+};
+
 class BigConcurrentTask : public ConcurrentTask {
     Q_OBJECT
 
@@ -259,6 +278,88 @@ class TaskTest : public QObject {
 
         QVERIFY(!thread.passed_the_deadline);
     }
+
+    void test_coalescedProgress()
+    {
+        auto inner = makeShared<ConcurrentTask>();
+        inner->addTask(makeShared<TickingTask>());
+        inner->addTask(makeShared<TickingTask>());
+
+        auto ticking = makeShared<TickingTask>();
+        ConcurrentTask t;
+        t.addTask(ticking);
+        t.addTask(inner);
+
+        QHash<QUuid, TaskStepProgress> last;
+        int emitted = 0;
+        connect(&t, &Task::stepProgress, [&last, &emitted](TaskStepProgress const& step) {
+            last.insert(step.uid, step);
+            emitted++;
+        });
+
+        t.start();
+        // per-task detail is up to date whenever it is asked for
+        auto ticked = [&t, &ticking] {
+            auto steps = t.getStepProgress();
+            return std::any_of(steps.begin(), steps.end(), [&ticking](auto step) { return step->uid == ticking->getUid() && step->current == 1000; });
+        };
+        QTRY_VERIFY_WITH_TIMEOUT(ticked(), 1000);
+
+        QVERIFY2(QTest::qWaitFor([&t] { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+
+        // the three ticking tasks and the inner one, nowhere near one report per tick
+        QCOMPARE(last.size(), 4);
+        QVERIFY(emitted < 40);
+        for (auto& step : last)
+            QVERIFY(step.state == TaskStepState::Succeeded);
+        QCOMPARE(t.getProgress(), qint64(2));
+        QCOMPARE(t.getTotalProgress(), qint64(2));
+    }
+
+    void test_trace()
+    {
+        auto untraced = makeShared<BasicTask>();
+        untraced->start();
+
+        TaskTrace::clear();
+        TaskTrace::setEnabled(true);
+
+        auto t1 = makeShared<BasicTask>();
+        auto t2 = makeShared<BasicTask>();
+        ConcurrentTask t;
+        t.addTask(t1);
+        t.addTask(t2);
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&t]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+
+        TaskTrace::setEnabled(false);
+        // not recorded while disabled
+        makeShared<BasicTask>()->start();
+
+        auto trace = QJsonDocument::fromJson(TaskTrace::toChromeTrace()).object();
+        QList<QJsonObject> spans;
+        for (auto event : trace["traceEvents"].toArray()) {
+            if (event.toObject()["ph"] == "X")
+                spans.append(event.toObject());
+        }
+        QCOMPARE(spans.size(), 3);
+
+        auto parent = t.getUid().toString(QUuid::WithoutBraces);
+        for (auto& span : spans) {
+            auto args = span["args"].toObject();
+            QCOMPARE(args["result"].toString(), "succeeded");
+            if (args["id"].toString() != parent)
+                QCOMPARE(args["parent"].toString(), parent);
+        }
+
+        auto histogram = trace["otherData"].toObject()["latencyHistogram"].toObject();
+        QCOMPARE(histogram["BasicTask"].toObject()["count"].toInt(), 2);
+        QCOMPARE(histogram["ConcurrentTask"].toObject()["count"].toInt(), 1);
+        QVERIFY(TaskTrace::latencyHistogram().contains("BasicTask: 2 tasks"));
+
+        TaskTrace::clear();
+    }
 };
 
 QTEST_GUILESS_MAIN(TaskTest)
@@ -0,0 +1,58 @@
+#include <QTest>
+
+#include <modplatform/helpers/VersionIndex.h>
+
+class VersionIndexTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void cleanup()
+    {
+        VersionIndex::instance().clear();
+        VersionIndex::instance().setTtl(VersionIndex::DefaultTtl);
+    }
+
+    void test_keysTellLookupsApart()
+    {
+        std::list<Version> game_versions{ Version("1.20.1") };
+        auto key = VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "AANobbMI", ModPlatform::Fabric, game_versions);
+
+        QCOMPARE(VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "AANobbMI", ModPlatform::Fabric, game_versions), key);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::FLAME, "AANobbMI", ModPlatform::Fabric, game_versions) != key);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "P7dR8mSH", ModPlatform::Fabric, game_versions) != key);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "AANobbMI", ModPlatform::Quilt, game_versions) != key);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "AANobbMI", {}, game_versions) != key);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::MODRINTH, "AANobbMI", ModPlatform::Fabric, { Version("1.21") }) != key);
+
+        // the order of the instance's loaders picks between versions too
+        auto fabric_first = VersionIndex::key(ModPlatform::ResourceProvider::FLAME, "AANobbMI", {}, game_versions,
+                                              { ModPlatform::Fabric, ModPlatform::Quilt });
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::FLAME, "AANobbMI", {}, game_versions) != fabric_first);
+        QVERIFY(VersionIndex::key(ModPlatform::ResourceProvider::FLAME, "AANobbMI", {}, game_versions,
+                                  { ModPlatform::Quilt, ModPlatform::Fabric }) != fabric_first);
+    }
+
+    void test_servesVersionsWhileFresh()
+    {
+        auto& index = VersionIndex::instance();
+        QJsonObject version{ { "id", "IZskON6d" }, { "version_number", "0.92.2" } };
+
+        QVERIFY(!index.find("a").has_value());
+        index.insert("a", version);
+        index.insert("none", {});
+
+        QVERIFY(index.find("a").has_value());
+        QCOMPARE(*index.find("a"), version);
+        // knowing that there is no version is worth keeping too
+        QVERIFY(index.find("none").has_value());
+        QVERIFY(index.find("none")->isEmpty());
+
+        index.setTtl(0);
+        QVERIFY(!index.find("a").has_value());
+        QVERIFY(!index.find("none").has_value());
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionIndexTest)
+
+#include "VersionIndex_test.moc"